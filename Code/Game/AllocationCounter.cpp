@@ -0,0 +1,98 @@
+#include "Game/AllocationCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+#if defined(GAME_TRACK_ALLOCATIONS)
+namespace
+{
+	thread_local uint64_t t_allocationCount = 0;
+	thread_local uint64_t t_allocatedBytes = 0;
+
+	void* CountedAllocate(size_t size)
+	{
+		++t_allocationCount;
+		t_allocatedBytes += size;
+
+		void* memory = std::malloc(size == 0 ? 1 : size);
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+}
+
+// The nothrow forms forward to these by default, so four replacements cover every unaligned new
+void* operator new(size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+#endif
+
+bool AllocationCounter::IsTracking()
+{
+#if defined(GAME_TRACK_ALLOCATIONS)
+	return true;
+#else
+	return false;
+#endif
+}
+
+uint64_t AllocationCounter::GetThreadAllocationCount()
+{
+#if defined(GAME_TRACK_ALLOCATIONS)
+	return t_allocationCount;
+#else
+	return 0;
+#endif
+}
+
+uint64_t AllocationCounter::GetThreadAllocatedBytes()
+{
+#if defined(GAME_TRACK_ALLOCATIONS)
+	return t_allocatedBytes;
+#else
+	return 0;
+#endif
+}
+
+ScopedAllocationCount::ScopedAllocationCount()
+	:m_startCount(AllocationCounter::GetThreadAllocationCount())
+	,m_startBytes(AllocationCounter::GetThreadAllocatedBytes())
+{
+}
+
+uint64_t ScopedAllocationCount::GetAllocationCount() const
+{
+	return AllocationCounter::GetThreadAllocationCount() - m_startCount;
+}
+
+uint64_t ScopedAllocationCount::GetAllocatedBytes() const
+{
+	return AllocationCounter::GetThreadAllocatedBytes() - m_startBytes;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+// -----------------------------------------------------------------------------
+// Global operator new/delete are replaced to count heap allocations per thread. The count
+// is one thread-local increment, so it stays on in release for the benchmark commands.
+#if !defined(GAME_DISABLE_ALLOCATION_TRACKING)
+#define GAME_TRACK_ALLOCATIONS
+#endif
+// -----------------------------------------------------------------------------
+class AllocationCounter
+{
+public:
+	static bool IsTracking();
+	static uint64_t GetThreadAllocationCount();
+	static uint64_t GetThreadAllocatedBytes();
+};
+// -----------------------------------------------------------------------------
+// Allocations made on the calling thread since construction
+class ScopedAllocationCount
+{
+public:
+	ScopedAllocationCount();
+
+	uint64_t GetAllocationCount() const;
+	uint64_t GetAllocatedBytes() const;
+
+private:
+	uint64_t m_startCount = 0;
+	uint64_t m_startBytes = 0;
+};
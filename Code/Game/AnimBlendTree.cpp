@@ -0,0 +1,259 @@
+#include "Game/AnimBlendTree.hpp"
+#include "Game/GameCommon.h"
+
+#if defined(GAME_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+void PoseBuffer::Resize(int numBones)
+{
+	m_numBones = numBones;
+	m_numPaddedBones = (numBones + 3) & ~3;
+	m_positionX.assign(m_numPaddedBones, 0.f);
+	m_positionY.assign(m_numPaddedBones, 0.f);
+	m_positionZ.assign(m_numPaddedBones, 0.f);
+	m_rotationX.assign(m_numPaddedBones, 0.f);
+	m_rotationY.assign(m_numPaddedBones, 0.f);
+	m_rotationZ.assign(m_numPaddedBones, 0.f);
+	m_rotationW.assign(m_numPaddedBones, 1.f);
+}
+
+void PoseBuffer::SetBone(int boneIndex, Vec3 const& localPosition, RotationQuat const& localRotation)
+{
+	SetBonePosition(boneIndex, localPosition);
+	SetBoneRotation(boneIndex, localRotation);
+}
+
+void PoseBuffer::SetBonePosition(int boneIndex, Vec3 const& localPosition)
+{
+	m_positionX[boneIndex] = localPosition.x;
+	m_positionY[boneIndex] = localPosition.y;
+	m_positionZ[boneIndex] = localPosition.z;
+}
+
+void PoseBuffer::SetBoneRotation(int boneIndex, RotationQuat const& localRotation)
+{
+	m_rotationX[boneIndex] = localRotation.x;
+	m_rotationY[boneIndex] = localRotation.y;
+	m_rotationZ[boneIndex] = localRotation.z;
+	m_rotationW[boneIndex] = localRotation.w;
+}
+
+Vec3 PoseBuffer::GetBonePosition(int boneIndex) const
+{
+	return Vec3(m_positionX[boneIndex], m_positionY[boneIndex], m_positionZ[boneIndex]);
+}
+
+RotationQuat PoseBuffer::GetBoneRotation(int boneIndex) const
+{
+	return RotationQuat(m_rotationX[boneIndex], m_rotationY[boneIndex], m_rotationZ[boneIndex], m_rotationW[boneIndex]);
+}
+
+void PoseBuffer::ApplyToSkeleton(Skeleton& skeleton) const
+{
+	for (int boneIndex = 0; boneIndex < m_numBones; ++boneIndex)
+	{
+		Bone& bone = skeleton.m_bones[boneIndex];
+		bone.SetLocalBonePosition(GetBonePosition(boneIndex));
+		bone.SetLocalBoneRotation(GetBoneRotation(boneIndex).GetAsEngineQuat());
+	}
+}
+
+PoseBuffer PoseBuffer::MakeFromSkeleton(Skeleton const& skeleton)
+{
+	PoseBuffer pose;
+	int numBones = static_cast<int>(skeleton.m_bones.size());
+	pose.Resize(numBones);
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+	{
+		pose.SetBone(boneIndex, skeleton.m_bones[boneIndex].m_localPosition, GetLocalBoneRotation(skeleton, boneIndex));
+	}
+	return pose;
+}
+
+BoneMask MakeBoneMask(PoseBuffer const& pose, float weight)
+{
+	return BoneMask(pose.m_numPaddedBones, weight);
+}
+
+RotationQuat GetLocalBoneRotation(Skeleton const& skeleton, int boneIndex)
+{
+	Bone const& bone = skeleton.m_bones[boneIndex];
+	RigidTransform parentWorld = bone.m_parentBoneIndex >= 0 ? RigidTransform::MakeFromMat44(skeleton.m_bones[bone.m_parentBoneIndex].m_worldBoneTransform) : RigidTransform::MakeFromMat44(skeleton.m_skeletonModelTransform);
+	RigidTransform world = RigidTransform::MakeFromMat44(bone.m_worldBoneTransform);
+	return (parentWorld.GetInverse() * world).m_rotation;
+}
+
+void BlendPoses(PoseBlendInput const* inputs, int inputCount, PoseBuffer& out_pose)
+{
+	if (inputCount <= 0)
+	{
+		return;
+	}
+
+	PoseBuffer const& reference = *inputs[0].m_pose;
+	if (out_pose.m_numPaddedBones != reference.m_numPaddedBones)
+	{
+		out_pose.Resize(reference.m_numBones);
+	}
+
+#if defined(GAME_USE_SSE2)
+	__m128 const zero = _mm_setzero_ps();
+	__m128 const signBit = _mm_set1_ps(-0.f);
+	for (int boneIndex = 0; boneIndex < reference.m_numPaddedBones; boneIndex += 4)
+	{
+		__m128 referenceX = _mm_loadu_ps(&reference.m_rotationX[boneIndex]);
+		__m128 referenceY = _mm_loadu_ps(&reference.m_rotationY[boneIndex]);
+		__m128 referenceZ = _mm_loadu_ps(&reference.m_rotationZ[boneIndex]);
+		__m128 referenceW = _mm_loadu_ps(&reference.m_rotationW[boneIndex]);
+
+		__m128 weightSum = zero;
+		__m128 positionX = zero, positionY = zero, positionZ = zero;
+		__m128 rotationX = zero, rotationY = zero, rotationZ = zero, rotationW = zero;
+		for (int inputIndex = 0; inputIndex < inputCount; ++inputIndex)
+		{
+			PoseBlendInput const& input = inputs[inputIndex];
+			PoseBuffer const& pose = *input.m_pose;
+			__m128 weight = _mm_set1_ps(input.m_weight);
+			if (input.m_boneMask)
+			{
+				weight = _mm_mul_ps(weight, _mm_loadu_ps(&input.m_boneMask[boneIndex]));
+			}
+			weightSum = _mm_add_ps(weightSum, weight);
+
+			positionX = _mm_add_ps(positionX, _mm_mul_ps(weight, _mm_loadu_ps(&pose.m_positionX[boneIndex])));
+			positionY = _mm_add_ps(positionY, _mm_mul_ps(weight, _mm_loadu_ps(&pose.m_positionY[boneIndex])));
+			positionZ = _mm_add_ps(positionZ, _mm_mul_ps(weight, _mm_loadu_ps(&pose.m_positionZ[boneIndex])));
+
+			__m128 x = _mm_loadu_ps(&pose.m_rotationX[boneIndex]);
+			__m128 y = _mm_loadu_ps(&pose.m_rotationY[boneIndex]);
+			__m128 z = _mm_loadu_ps(&pose.m_rotationZ[boneIndex]);
+			__m128 w = _mm_loadu_ps(&pose.m_rotationW[boneIndex]);
+			__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, referenceX), _mm_mul_ps(y, referenceY)), _mm_add_ps(_mm_mul_ps(z, referenceZ), _mm_mul_ps(w, referenceW)));
+			__m128 signedWeight = _mm_xor_ps(weight, _mm_and_ps(_mm_cmplt_ps(dot, zero), signBit));
+			rotationX = _mm_add_ps(rotationX, _mm_mul_ps(signedWeight, x));
+			rotationY = _mm_add_ps(rotationY, _mm_mul_ps(signedWeight, y));
+			rotationZ = _mm_add_ps(rotationZ, _mm_mul_ps(signedWeight, z));
+			rotationW = _mm_add_ps(rotationW, _mm_mul_ps(signedWeight, w));
+		}
+
+		// Lanes with no weight fall back to the first input
+		__m128 hasWeight = _mm_cmpgt_ps(weightSum, zero);
+		__m128 inverseWeightSum = _mm_div_ps(_mm_set1_ps(1.f), _mm_or_ps(_mm_and_ps(hasWeight, weightSum), _mm_andnot_ps(hasWeight, _mm_set1_ps(1.f))));
+		positionX = _mm_or_ps(_mm_and_ps(hasWeight, _mm_mul_ps(positionX, inverseWeightSum)), _mm_andnot_ps(hasWeight, _mm_loadu_ps(&reference.m_positionX[boneIndex])));
+		positionY = _mm_or_ps(_mm_and_ps(hasWeight, _mm_mul_ps(positionY, inverseWeightSum)), _mm_andnot_ps(hasWeight, _mm_loadu_ps(&reference.m_positionY[boneIndex])));
+		positionZ = _mm_or_ps(_mm_and_ps(hasWeight, _mm_mul_ps(positionZ, inverseWeightSum)), _mm_andnot_ps(hasWeight, _mm_loadu_ps(&reference.m_positionZ[boneIndex])));
+		rotationX = _mm_or_ps(_mm_and_ps(hasWeight, rotationX), _mm_andnot_ps(hasWeight, referenceX));
+		rotationY = _mm_or_ps(_mm_and_ps(hasWeight, rotationY), _mm_andnot_ps(hasWeight, referenceY));
+		rotationZ = _mm_or_ps(_mm_and_ps(hasWeight, rotationZ), _mm_andnot_ps(hasWeight, referenceZ));
+		rotationW = _mm_or_ps(_mm_and_ps(hasWeight, rotationW), _mm_andnot_ps(hasWeight, referenceW));
+
+		__m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rotationX, rotationX), _mm_mul_ps(rotationY, rotationY)), _mm_add_ps(_mm_mul_ps(rotationZ, rotationZ), _mm_mul_ps(rotationW, rotationW)));
+		__m128 inverseLength = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(_mm_max_ps(lengthSquared, _mm_set1_ps(0.000001f))));
+
+		_mm_storeu_ps(&out_pose.m_positionX[boneIndex], positionX);
+		_mm_storeu_ps(&out_pose.m_positionY[boneIndex], positionY);
+		_mm_storeu_ps(&out_pose.m_positionZ[boneIndex], positionZ);
+		_mm_storeu_ps(&out_pose.m_rotationX[boneIndex], _mm_mul_ps(rotationX, inverseLength));
+		_mm_storeu_ps(&out_pose.m_rotationY[boneIndex], _mm_mul_ps(rotationY, inverseLength));
+		_mm_storeu_ps(&out_pose.m_rotationZ[boneIndex], _mm_mul_ps(rotationZ, inverseLength));
+		_mm_storeu_ps(&out_pose.m_rotationW[boneIndex], _mm_mul_ps(rotationW, inverseLength));
+	}
+#else
+	for (int boneIndex = 0; boneIndex < reference.m_numPaddedBones; ++boneIndex)
+	{
+		RotationQuat referenceRotation = reference.GetBoneRotation(boneIndex);
+		float weightSum = 0.f;
+		Vec3 position = Vec3::ZERO;
+		RotationQuat rotation(0.f, 0.f, 0.f, 0.f);
+		for (int inputIndex = 0; inputIndex < inputCount; ++inputIndex)
+		{
+			PoseBlendInput const& input = inputs[inputIndex];
+			float weight = input.m_boneMask ? input.m_weight * input.m_boneMask[boneIndex] : input.m_weight;
+			weightSum += weight;
+
+			position = position + input.m_pose->GetBonePosition(boneIndex) * weight;
+			RotationQuat q = input.m_pose->GetBoneRotation(boneIndex);
+			float dot = q.x * referenceRotation.x + q.y * referenceRotation.y + q.z * referenceRotation.z + q.w * referenceRotation.w;
+			float signedWeight = dot < 0.f ? -weight : weight;
+			rotation = RotationQuat(rotation.x + q.x * signedWeight, rotation.y + q.y * signedWeight, rotation.z + q.z * signedWeight, rotation.w + q.w * signedWeight);
+		}
+
+		if (weightSum > 0.f)
+		{
+			rotation.Normalize();
+			out_pose.SetBone(boneIndex, position * (1.f / weightSum), rotation);
+		}
+		else
+		{
+			out_pose.SetBone(boneIndex, reference.GetBonePosition(boneIndex), referenceRotation);
+		}
+	}
+#endif
+}
+
+void AnimCrossfadePlayer::Initialize(PoseBuffer const* restPose, float fadeSeconds)
+{
+	m_restPose = restPose;
+	m_fadeSeconds = fadeSeconds;
+	m_currentPose = *restPose;
+	m_previousPose = *restPose;
+	m_blendedPose = *restPose;
+}
+
+void AnimCrossfadePlayer::SetClip(AnimClip const* clip, float timeSeconds)
+{
+	if (clip != m_currentClip && m_currentClip)
+	{
+		m_previousClip = m_currentClip;
+		m_previousTime = m_currentTime;
+		m_fadeElapsed = 0.f;
+	}
+	m_currentClip = clip;
+	m_currentTime = timeSeconds;
+}
+
+// Called before SetClip each frame, so the outgoing clip advances in step with the incoming one
+void AnimCrossfadePlayer::Update(float deltaSeconds)
+{
+	if (!IsFading())
+	{
+		return;
+	}
+
+	m_previousTime += deltaSeconds;
+	m_fadeElapsed += deltaSeconds;
+	if (m_fadeElapsed >= m_fadeSeconds)
+	{
+		m_previousClip = nullptr;
+	}
+}
+
+// Without blending the fade still runs its clock, the outgoing clip just isn't sampled
+void AnimCrossfadePlayer::Evaluate(Skeleton& skeleton, bool allowsBlending)
+{
+	if (!m_currentClip)
+	{
+		return;
+	}
+
+	m_currentClip->SamplePose(m_currentTime, *m_restPose, m_currentPose);
+	if (!IsFading() || !allowsBlending)
+	{
+		m_currentPose.ApplyToSkeleton(skeleton);
+		skeleton.UpdateSkeletonPose();
+		return;
+	}
+
+	m_previousClip->SamplePose(m_previousTime, *m_restPose, m_previousPose);
+	float fadeIn = SmoothStep3(GetClamped(m_fadeElapsed / m_fadeSeconds, 0.f, 1.f));
+	PoseBlendInput const inputs[2] = { { &m_previousPose, 1.f - fadeIn, nullptr }, { &m_currentPose, fadeIn, nullptr } };
+	BlendPoses(inputs, 2, m_blendedPose);
+	m_blendedPose.ApplyToSkeleton(skeleton);
+	skeleton.UpdateSkeletonPose();
+}
+
+bool AnimCrossfadePlayer::IsFading() const
+{
+	return m_previousClip != nullptr && m_fadeSeconds > 0.f;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "Game/RigidTransform.hpp"
+#include "Engine/Skeleton/Skeleton.hpp"
+#include <vector>
+// -----------------------------------------------------------------------------
+// Local pose in structure-of-arrays form: one array per channel, padded to a multiple of
+// four bones so a blend handles four bones per instruction. Padding bones sit at identity.
+struct PoseBuffer
+{
+	int m_numBones = 0;
+	int m_numPaddedBones = 0;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	std::vector<float> m_rotationX;
+	std::vector<float> m_rotationY;
+	std::vector<float> m_rotationZ;
+	std::vector<float> m_rotationW;
+
+	void Resize(int numBones);
+	void SetBone(int boneIndex, Vec3 const& localPosition, RotationQuat const& localRotation);
+	void SetBonePosition(int boneIndex, Vec3 const& localPosition);
+	void SetBoneRotation(int boneIndex, RotationQuat const& localRotation);
+	Vec3 GetBonePosition(int boneIndex) const;
+	RotationQuat GetBoneRotation(int boneIndex) const;
+
+	// Writes every bone's local position and rotation; the caller runs UpdateSkeletonPose
+	void ApplyToSkeleton(Skeleton& skeleton) const;
+	static PoseBuffer MakeFromSkeleton(Skeleton const& skeleton);
+};
+// -----------------------------------------------------------------------------
+// Per-bone weight multiplier for one blend input, padded like PoseBuffer. 0 keeps a bone out of that input.
+typedef std::vector<float> BoneMask;
+BoneMask MakeBoneMask(PoseBuffer const& pose, float weight);
+
+// Rotation relative to the parent, read back from the world matrices; the engine's Quat hides its components
+RotationQuat GetLocalBoneRotation(Skeleton const& skeleton, int boneIndex);
+// -----------------------------------------------------------------------------
+struct PoseBlendInput
+{
+	PoseBuffer const* m_pose = nullptr;
+	float			  m_weight = 0.f;
+	float const*	  m_boneMask = nullptr;		// Optional, m_numPaddedBones entries
+};
+
+// N-way blend in one pass over the bones: weighted lerp of positions, nlerp of rotations with every
+// input flipped into the first one's hemisphere. Bones whose weights sum to zero take the first input.
+void BlendPoses(PoseBlendInput const* inputs, int inputCount, PoseBuffer& out_pose);
+// -----------------------------------------------------------------------------
+// Anything the player can sample into a local pose. Baked and procedural clips both implement it,
+// so a state machine can mix them freely. Channels a clip doesn't animate come from restPose.
+class AnimClip
+{
+public:
+	virtual ~AnimClip() = default;
+	virtual void SamplePose(float timeSeconds, PoseBuffer const& restPose, PoseBuffer& out_pose) const = 0;
+};
+// -----------------------------------------------------------------------------
+// Smooths instant state switches. The state machine still decides what plays and when and
+// reports the clip and its time here each frame; when the clip changes the previous one keeps
+// running and fades out over m_fadeSeconds.
+class AnimCrossfadePlayer
+{
+public:
+	void Initialize(PoseBuffer const* restPose, float fadeSeconds);
+
+	void SetClip(AnimClip const* clip, float timeSeconds);
+	void Update(float deltaSeconds);
+	void Evaluate(Skeleton& skeleton, bool allowsBlending = true);
+
+	bool IsFading() const;
+
+private:
+	PoseBuffer const* m_restPose = nullptr;
+	PoseBuffer m_currentPose;
+	PoseBuffer m_previousPose;
+	PoseBuffer m_blendedPose;
+
+	AnimClip const* m_currentClip = nullptr;
+	AnimClip const* m_previousClip = nullptr;
+	float m_currentTime = 0.f;
+	float m_previousTime = 0.f;
+	float m_fadeSeconds = 0.25f;
+	float m_fadeElapsed = 0.f;
+};
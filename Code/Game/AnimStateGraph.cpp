@@ -0,0 +1,177 @@
+#include "Game/AnimStateGraph.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+// A duplicate or colliding name is reported but still registered, so IDs stay in the order
+// callers added them; lookups by that name resolve to the first state that took it
+AnimStateId AnimStateGraph::AddState(std::string const& name)
+{
+	AnimNameHash nameHash = HashAnimName(name.c_str());
+	if (FindState(nameHash) != INVALID_ANIM_ID)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, Stringf("Animation state '%s' duplicates or collides with an existing state name", name.c_str()));
+	}
+
+	m_stateNames.push_back(name);
+	m_stateHashes.push_back(nameHash);
+	ResizeTransitionTable(GetNumStates(), GetNumTriggers());
+	return GetNumStates() - 1;
+}
+
+AnimTriggerId AnimStateGraph::AddTrigger(std::string const& name)
+{
+	AnimNameHash nameHash = HashAnimName(name.c_str());
+	if (FindTrigger(nameHash) != INVALID_ANIM_ID)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, Stringf("Animation trigger '%s' duplicates or collides with an existing trigger name", name.c_str()));
+	}
+
+	m_triggerNames.push_back(name);
+	m_triggerHashes.push_back(nameHash);
+	ResizeTransitionTable(GetNumStates(), GetNumTriggers() - 1);
+	return GetNumTriggers() - 1;
+}
+
+void AnimStateGraph::AddTransition(AnimStateId fromState, AnimTriggerId trigger, AnimStateId toState)
+{
+	if (fromState < 0 || fromState >= GetNumStates() || trigger < 0 || trigger >= GetNumTriggers() || toState < 0 || toState >= GetNumStates())
+	{
+		return;
+	}
+	m_transitions[fromState * GetNumTriggers() + trigger] = toState;
+}
+
+void AnimStateGraph::AddTransition(AnimNameHash fromState, AnimNameHash trigger, AnimNameHash toState)
+{
+	AddTransition(FindState(fromState), FindTrigger(trigger), FindState(toState));
+}
+
+// A linear scan over a handful of hashes; only setup and the string wrappers come through here
+AnimStateId AnimStateGraph::FindState(AnimNameHash nameHash) const
+{
+	for (int stateIndex = 0; stateIndex < GetNumStates(); ++stateIndex)
+	{
+		if (m_stateHashes[stateIndex] == nameHash)
+		{
+			return stateIndex;
+		}
+	}
+	return INVALID_ANIM_ID;
+}
+
+AnimTriggerId AnimStateGraph::FindTrigger(AnimNameHash nameHash) const
+{
+	for (int triggerIndex = 0; triggerIndex < GetNumTriggers(); ++triggerIndex)
+	{
+		if (m_triggerHashes[triggerIndex] == nameHash)
+		{
+			return triggerIndex;
+		}
+	}
+	return INVALID_ANIM_ID;
+}
+
+AnimStateId AnimStateGraph::GetTransitionTarget(AnimStateId state, AnimTriggerId trigger) const
+{
+	if (state < 0 || state >= GetNumStates() || trigger < 0 || trigger >= GetNumTriggers())
+	{
+		return INVALID_ANIM_ID;
+	}
+	return m_transitions[state * GetNumTriggers() + trigger];
+}
+
+std::string const& AnimStateGraph::GetStateName(AnimStateId state) const
+{
+	static std::string const s_invalidName = "Invalid";
+	if (state < 0 || state >= GetNumStates())
+	{
+		return s_invalidName;
+	}
+	return m_stateNames[state];
+}
+
+int AnimStateGraph::GetNumStates() const
+{
+	return static_cast<int>(m_stateNames.size());
+}
+
+int AnimStateGraph::GetNumTriggers() const
+{
+	return static_cast<int>(m_triggerNames.size());
+}
+
+// Setup-time only: re-lays the table out for the current trigger count, keeping existing transitions
+void AnimStateGraph::ResizeTransitionTable(int numStates, int oldNumTriggers)
+{
+	int numTriggers = GetNumTriggers();
+	std::vector<AnimStateId> transitions(static_cast<size_t>(numStates) * numTriggers, INVALID_ANIM_ID);
+	int oldNumStates = oldNumTriggers > 0 ? static_cast<int>(m_transitions.size()) / oldNumTriggers : 0;
+	for (int stateIndex = 0; stateIndex < oldNumStates; ++stateIndex)
+	{
+		for (int triggerIndex = 0; triggerIndex < oldNumTriggers; ++triggerIndex)
+		{
+			transitions[stateIndex * numTriggers + triggerIndex] = m_transitions[stateIndex * oldNumTriggers + triggerIndex];
+		}
+	}
+	m_transitions.swap(transitions);
+}
+
+void AnimStateInstance::Initialize(AnimStateGraph const* graph, AnimStateId initialState)
+{
+	m_graph = graph;
+	m_currentState = initialState;
+	m_stateTime = 0.f;
+}
+
+void AnimStateInstance::Update(float deltaSeconds)
+{
+	m_stateTime += deltaSeconds;
+}
+
+// Re-entering the current state keeps its time, so repeated requests don't restart the clip
+void AnimStateInstance::SetState(AnimStateId state)
+{
+	if (state == m_currentState || state < 0 || state >= m_graph->GetNumStates())
+	{
+		return;
+	}
+	m_currentState = state;
+	m_stateTime = 0.f;
+}
+
+// Triggers with no transition out of the current state are ignored
+bool AnimStateInstance::TriggerTransition(AnimTriggerId trigger)
+{
+	AnimStateId targetState = m_graph->GetTransitionTarget(m_currentState, trigger);
+	if (targetState == INVALID_ANIM_ID)
+	{
+		return false;
+	}
+	SetState(targetState);
+	return true;
+}
+
+AnimStateId AnimStateInstance::GetCurrentState() const
+{
+	return m_currentState;
+}
+
+float AnimStateInstance::GetStateTime() const
+{
+	return m_stateTime;
+}
+
+void AnimStateInstance::SetState(std::string const& stateName)
+{
+	SetState(m_graph->FindState(HashAnimName(stateName.c_str())));
+}
+
+bool AnimStateInstance::TriggerTransition(std::string const& triggerName)
+{
+	return TriggerTransition(m_graph->FindTrigger(HashAnimName(triggerName.c_str())));
+}
+
+std::string const& AnimStateInstance::GetCurrentStateName() const
+{
+	return m_graph->GetStateName(m_currentState);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+// -----------------------------------------------------------------------------
+typedef uint32_t AnimNameHash;
+typedef int		 AnimStateId;
+typedef int		 AnimTriggerId;
+constexpr int INVALID_ANIM_ID = -1;
+
+// FNV-1a; constexpr so names written in code hash at compile time
+constexpr AnimNameHash HashAnimName(char const* name)
+{
+	AnimNameHash hash = 2166136261u;
+	for (; *name != '\0'; ++name)
+	{
+		hash = (hash ^ static_cast<uint8_t>(*name)) * 16777619u;
+	}
+	return hash;
+}
+
+// Forces a literal's hash into a compile-time constant: ANIM_NAME("Idle")
+#define ANIM_NAME(literal) (std::integral_constant<AnimNameHash, HashAnimName(literal)>::value)
+// -----------------------------------------------------------------------------
+// States, triggers and transitions for one kind of animal, shared by all its instances.
+// Names are only used at setup and by tools: registering hands back dense IDs, and the
+// transition table is a flat array of target states indexed by [state][trigger].
+class AnimStateGraph
+{
+public:
+	AnimStateId   AddState(std::string const& name);
+	AnimTriggerId AddTrigger(std::string const& name);
+	void AddTransition(AnimStateId fromState, AnimTriggerId trigger, AnimStateId toState);
+	void AddTransition(AnimNameHash fromState, AnimNameHash trigger, AnimNameHash toState);
+
+	AnimStateId   FindState(AnimNameHash nameHash) const;
+	AnimTriggerId FindTrigger(AnimNameHash nameHash) const;
+	AnimStateId   GetTransitionTarget(AnimStateId state, AnimTriggerId trigger) const;
+	std::string const& GetStateName(AnimStateId state) const;
+	int GetNumStates() const;
+	int GetNumTriggers() const;
+
+private:
+	void ResizeTransitionTable(int numStates, int oldNumTriggers);
+
+private:
+	std::vector<std::string>  m_stateNames;
+	std::vector<AnimNameHash> m_stateHashes;
+	std::vector<std::string>  m_triggerNames;
+	std::vector<AnimNameHash> m_triggerHashes;
+	std::vector<AnimStateId>  m_transitions;
+};
+// -----------------------------------------------------------------------------
+// Per-instance playback of a shared graph: the current state and how long it has been playing.
+// The std::string overloads hash and look up on every call and are meant for the dev console.
+struct AnimStateInstance
+{
+	AnimStateGraph const* m_graph = nullptr;
+	AnimStateId m_currentState = INVALID_ANIM_ID;
+	float		m_stateTime = 0.f;
+
+	void Initialize(AnimStateGraph const* graph, AnimStateId initialState);
+	void Update(float deltaSeconds);
+	void SetState(AnimStateId state);
+	bool TriggerTransition(AnimTriggerId trigger);
+	AnimStateId GetCurrentState() const;
+	float GetStateTime() const;
+
+	void SetState(std::string const& stateName);
+	bool TriggerTransition(std::string const& triggerName);
+	std::string const& GetCurrentStateName() const;
+};
@@ -1,17 +1,30 @@
 #include "Game/AnimalMode.hpp"
 #include "Game/App.h"
 #include "Game/Terrain.hpp"
-#include "Game/Snake.hpp"
-#include "Game/Spider.hpp"
-#include "Game/Octopus.hpp"
+#include "Game/AllocationCounter.hpp"
 #include "Engine/Core/DebugRender.hpp"
 #include "Engine/Core/VertexUtils.h"
 #include "Engine/Animation/Animation.hpp"
 #include "Engine/Math/SmoothNoise.hpp"
 #include "Engine/Input/InputSystem.h"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+#if defined(_DEBUG)
+bool AnimalMode::s_isAllocationAuditStrict = true;
+#else
+bool AnimalMode::s_isAllocationAuditStrict = false;
+#endif
+float AnimalMode::s_simulationHz = 60.f;
+int AnimalMode::s_maxSimulationStepsPerFrame = 4;
 
 AnimalMode::AnimalMode(App* owner)
-	:Game(owner)
+	:Game(owner),
+	 m_spatialGrid(Vec2(0.f, 0.f), Vec2(static_cast<float>(TERRAIN_SIZE) * TERRAIN_SCALE, static_cast<float>(TERRAIN_SIZE) * TERRAIN_SCALE), SPATIAL_GRID_CELL_SIZE)
 {
 }
 
@@ -21,7 +34,7 @@ void AnimalMode::StartUp()
 	m_cameraPos = Vec3(-16.5f, -0.5f, 7.f);
 
 	// Initialize terrain
-	m_terrain = new Terrain(Vec3::ZERO);
+	m_terrain = new Terrain(Vec3::ZERO, TERRAIN_SIZE, &m_threadPool);
 	m_terrain->InitializeTerrainHills();
 
 	// Get skybox textures
@@ -31,37 +44,34 @@ void AnimalMode::StartUp()
 	m_skyBoxRightTexture = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/stormydays_rt.png");
 	m_skyBoxTopTexture = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/stormydays_up.png");
 	m_skyBoxBottomTexture = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/stormydays_dn.png");
+	BuildSkyBoxVerts();
 
 	InitializeAnimals();
 }
 
 void AnimalMode::InitializeAnimals()
 {
+	// Snakes register with the runner as they initialize
+	m_snakeBehaviors.Initialize(&Snake::GetBehaviorGraph(), &m_timerWheel, 2);
+
 	// Initialize the skeletons
-	m_snake = new Snake(this, Vec3(25.f, 25.f, 0.f));
-	m_snakeStationary = new Snake(this, Vec3(0.f, -10.f, 0.f));
-	m_spider = new Spider(this, Vec3(85.f, 30.f, 0.f));
-	m_spider2 = new Spider(this, Vec3(50.f, 50.f, 0.f));
-	m_spiderStationary = new Spider(this, Vec3(0.f, -15.f, 0.f));
-	m_octopus = new Octopus(this, Vec3(40.f, 45.f, 0.f));
-	m_octopusStationary = new Octopus(this, Vec3(0.f, -5.f, 1.f));
-
-	m_spider2->SetSpeed(3.5f);
-	m_spider2->SetIsRoaming(true);
-	m_spider2->SetIsCurlingLegs(true);
+	m_snakes.Create(this, Vec3(25.f, 25.f, 0.f));
+	EntityHandle snakeStationary = m_snakes.Create(this, Vec3(0.f, -10.f, 0.f));
+	m_spiders.Create(this, Vec3(85.f, 30.f, 0.f));
+	EntityHandle spiderRoaming = m_spiders.Create(this, Vec3(50.f, 50.f, 0.f));
+	EntityHandle spiderStationary = m_spiders.Create(this, Vec3(0.f, -15.f, 0.f));
+	m_octopuses.Create(this, Vec3(40.f, 45.f, 0.f));
+	EntityHandle octopusStationary = m_octopuses.Create(this, Vec3(0.f, -5.f, 1.f));
+
+	Spider* roamingSpider = m_spiders.Get(spiderRoaming);
+	roamingSpider->SetSpeed(3.5f);
+	roamingSpider->SetIsRoaming(true);
+	roamingSpider->SetIsCurlingLegs(true);
 
 	// Set stationary
-	m_octopusStationary->SetIsStationary(true);
-	m_snakeStationary->SetIsStationary(true);
-	m_spiderStationary->SetIsStationary(true);
-
-	m_allEntities.push_back(m_snake);
-	m_allEntities.push_back(m_snakeStationary);
-	m_allEntities.push_back(m_spider);
-	m_allEntities.push_back(m_spider2);
-	m_allEntities.push_back(m_spiderStationary);
-	m_allEntities.push_back(m_octopus);
-	m_allEntities.push_back(m_octopusStationary);
+	m_octopuses.Get(octopusStationary)->SetIsStationary(true);
+	m_snakes.Get(snakeStationary)->SetIsStationary(true);
+	m_spiders.Get(spiderStationary)->SetIsStationary(true);
 }
 
 void AnimalMode::Update()
@@ -69,11 +79,75 @@ void AnimalMode::Update()
 	double deltaSeconds = g_theApp->m_gameClock->GetDeltaSeconds();
 	double totalTime = g_theApp->m_gameClock->GetTotalSeconds();
 	double frameRate = Clock::GetSystemClock().GetFrameRate();
+	FrameProfiler::BeginFrame();
+	UpdateCrowdProfile();
+
+	// Scored against last frame's camera; the camera moves after the entities update
+	m_significanceManager.SetCamera(m_cameraPos, GetCameraFwdNormal(), ANIMAL_CAMERA_FOV_DEGREES, ANIMAL_CAMERA_FAR_PLANE);
+	UpdateViewFrustum();
+
+	// Simulation runs in fixed steps, so hair and movement behave the same at any frame rate.
+	// Timers and behavior step with it regardless of significance; only what is due does any work.
+	float stepSeconds = 1.f / s_simulationHz;
+	m_simulationAccumulator += static_cast<float>(deltaSeconds);
+	m_numSimulationStepsLastFrame = 0;
+	m_numFellAsleepLastFrame = 0;
+	m_numWokeLastFrame = 0;
+	m_workerUpdateAllocations = 0;
+	uint64_t entityUpdateAllocationCount = 0;
+	while (m_simulationAccumulator >= stepSeconds && m_numSimulationStepsLastFrame < s_maxSimulationStepsPerFrame)
+	{
+		++m_simulationStep;
+		{
+			ScopedFrameTimer behaviorTimer(FRAME_SUBSYSTEM_BEHAVIOR);
+			m_timerWheel.Advance(stepSeconds);
+			m_snakeBehaviors.Tick();
+		}
+
+		ScopedAllocationCount stepAllocations;
+		SimulateEntities(stepSeconds);
+		entityUpdateAllocationCount += stepAllocations.GetAllocationCount();
+		m_simulationAccumulator -= stepSeconds;
+		++m_numSimulationStepsLastFrame;
+	}
 
-	UpdateEntities(static_cast<float>(deltaSeconds));
+	// A hitch longer than the step budget is dropped rather than caught up on over later frames
+	if (m_simulationAccumulator >= stepSeconds)
+	{
+		m_simulationAccumulator = fmodf(m_simulationAccumulator, stepSeconds);
+	}
+
+	ScopedAllocationCount meshAllocations;
+	UpdateEntityMeshes(m_simulationAccumulator / stepSeconds);
+	entityUpdateAllocationCount += meshAllocations.GetAllocationCount();
+	AuditEntityUpdateAllocations(entityUpdateAllocationCount + m_workerUpdateAllocations);
+
+	// After the entity work, which reads terrain heights from the workers
+	m_terrain->Update(m_cameraPos, m_viewFrustum);
 
 	std::string timeScaleText = Stringf("Time: %0.2fs FPS: %0.2f", totalTime, frameRate);
 	DebugAddScreenText(timeScaleText, m_gameSceneBounds, 15.f, Vec2(0.98f, 0.97f), 0.f);
+	if (AllocationCounter::IsTracking())
+	{
+		std::string allocationText = Stringf("Update allocations: %llu", m_lastEntityUpdateAllocations);
+		DebugAddScreenText(allocationText, m_gameSceneBounds, 15.f, Vec2(0.98f, 0.945f), 0.f);
+	}
+	std::string significanceText = Stringf("Significance full %d reduced %d low %d minimal %d", m_significanceManager.GetNumEntitiesInTier(SIGNIFICANCE_FULL),
+		m_significanceManager.GetNumEntitiesInTier(SIGNIFICANCE_REDUCED), m_significanceManager.GetNumEntitiesInTier(SIGNIFICANCE_LOW), m_significanceManager.GetNumEntitiesInTier(SIGNIFICANCE_MINIMAL));
+	DebugAddScreenText(significanceText, m_gameSceneBounds, 15.f, Vec2(0.98f, 0.92f), 0.f);
+	std::string cullingText = Stringf("Frustum culled %d of %d | sim %.0f Hz, %d steps, hair x%d", m_numEntitiesCulled, GetNumAnimals(),
+		s_simulationHz, m_numSimulationStepsLastFrame, Spider::s_hairSubsteps);
+	DebugAddScreenText(cullingText, m_gameSceneBounds, 15.f, Vec2(0.98f, 0.87f), 0.f);
+	std::string sleepText = Stringf("Asleep %d of %d | fell asleep %d, woke %d", m_numEntitiesAsleep, GetNumAnimals(), m_numFellAsleepLastFrame, m_numWokeLastFrame);
+	DebugAddScreenText(sleepText, m_gameSceneBounds, 15.f, Vec2(0.98f, 0.845f), 0.f);
+	std::string terrainText = Stringf("Terrain %d samples | chunks resident %d, drawn %d, %.1f MB", m_terrain->GetNumSamplesPerSide(),
+		m_terrain->GetNumResidentChunks(), m_terrain->GetNumChunksDrawn(), static_cast<double>(m_terrain->GetResidentBytes()) / (1024.0 * 1024.0));
+	DebugAddScreenText(terrainText, m_gameSceneBounds, 15.f, Vec2(0.98f, 0.82f), 0.f);
+	std::string profileText = Stringf("Animals %d | behavior %.2f pose %.2f hair %.2f verts %.2f draw %.2f ms", GetNumAnimals(),
+		FrameProfiler::GetLastFrameMilliseconds(FRAME_SUBSYSTEM_BEHAVIOR), FrameProfiler::GetLastFrameMilliseconds(FRAME_SUBSYSTEM_POSE),
+		FrameProfiler::GetLastFrameMilliseconds(FRAME_SUBSYSTEM_HAIR), FrameProfiler::GetLastFrameMilliseconds(FRAME_SUBSYSTEM_VERTS),
+		FrameProfiler::GetLastFrameMilliseconds(FRAME_SUBSYSTEM_DRAW));
+	DebugAddScreenText(profileText, m_gameSceneBounds, 15.f, Vec2(0.98f, 0.895f), 0.f);
 	DebugAddScreenText("Animal Mode", m_gameSceneBounds, 20.f, Vec2(0.f, 0.97f), 0.f);
 	DebugAddScreenText("[I] Invert terrain", m_gameSceneBounds, 15.f, Vec2(0.f, 0.945f), 0.f);
 	DebugAddScreenText("[V] Toggle animal verts", m_gameSceneBounds, 15.f, Vec2(0.f, 0.925f), 0.f);
@@ -83,14 +157,18 @@ void AnimalMode::Update()
 	{
 		m_terrain->m_areHillsInverted = !m_terrain->m_areHillsInverted;
 		m_terrain->InitializeTerrainHills();
+		WakeAllEntities();
 	}
 	if (g_theInput->WasKeyJustPressed('G'))
 	{
 		m_isSkeletonBeingDrawn = !m_isSkeletonBeingDrawn;
+		WakeAllEntities();
+		ResetAllocationAudit();
 	}
 	if (g_theInput->WasKeyJustPressed('V'))
 	{
 		m_isAnimalVertsBeingDrawn = !m_isAnimalVertsBeingDrawn;
+		ResetAllocationAudit();
 	}
 
 	AdjustForPauseAndTimeDistortion(static_cast<float>(deltaSeconds));
@@ -131,15 +209,9 @@ void AnimalMode::DeleteTerrain()
 
 void AnimalMode::DeleteEntities()
 {
-	for (int entityIndex = 0; entityIndex < static_cast<int>(m_allEntities.size()); ++entityIndex)
-	{
-		Entity*& entity = m_allEntities[entityIndex];
-		if (entity != nullptr)
-		{
-			delete entity;
-			entity = nullptr;
-		}
-	}
+	m_snakes.Clear();
+	m_spiders.Clear();
+	m_octopuses.Clear();
 }
 
 void AnimalMode::UpdateCameras(float deltaSeconds)
@@ -153,34 +225,250 @@ void AnimalMode::UpdateCameras(float deltaSeconds)
 	m_cameraOrientation.m_rollDegrees = GetClamped(m_cameraOrientation.m_rollDegrees, -45.f, 45.f);
 
 	m_gameWorldCamera.SetPositionAndOrientation(m_cameraPos, m_cameraOrientation);
-	m_gameWorldCamera.SetPerspectiveView(2.f, 60.f, 0.1f, 750.f);
+	m_gameWorldCamera.SetPerspectiveView(ANIMAL_CAMERA_ASPECT, ANIMAL_CAMERA_FOV_DEGREES, ANIMAL_CAMERA_NEAR_PLANE, ANIMAL_CAMERA_FAR_PLANE);
+}
+
+// Left and up follow the camera's yaw-pitch-roll convention: roll turns them about forward
+void AnimalMode::UpdateViewFrustum()
+{
+	Vec3 forward = GetCameraFwdNormal();
+	float yawDegrees = m_cameraOrientation.m_yawDegrees;
+	Vec3 unrolledLeft = Vec3(-SinDegrees(yawDegrees), CosDegrees(yawDegrees), 0.f);
+	Vec3 unrolledUp = CrossProduct3D(forward, unrolledLeft).GetNormalized();
+	float rollDegrees = m_cameraOrientation.m_rollDegrees;
+	Vec3 left = unrolledLeft * CosDegrees(rollDegrees) + unrolledUp * SinDegrees(rollDegrees);
+	Vec3 up = unrolledUp * CosDegrees(rollDegrees) - unrolledLeft * SinDegrees(rollDegrees);
+	m_viewFrustum.SetFromCamera(m_cameraPos, forward, left, up, ANIMAL_CAMERA_FOV_DEGREES + ANIMAL_CULL_FOV_MARGIN_DEGREES, ANIMAL_CAMERA_ASPECT,
+		ANIMAL_CAMERA_NEAR_PLANE, ANIMAL_CAMERA_FAR_PLANE);
+}
+
+void AnimalMode::SimulateEntities(float stepSeconds)
+{
+	m_significanceManager.BeginFrame();
+	int entityIndex = 0;
+	SimulateSpecies(m_snakes, stepSeconds, entityIndex);
+	SimulateSpecies(m_spiders, stepSeconds, entityIndex);
+	SimulateSpecies(m_octopuses, stepSeconds, entityIndex);
+}
+
+// One pass per species keeps a single Simulate body hot in the instruction cache; the call is
+// qualified with the species so it is bound statically rather than through the vtable.
+// entityIndex runs across species so the significance stagger stays spread over all animals.
+// Scoring writes the manager's tier counts and the grid is only moved between species, so both
+// stay on this thread; the simulation goes wide.
+template <typename T>
+void AnimalMode::SimulateSpecies(EntityPool<T>& pool, float stepSeconds, int& entityIndex)
+{
+	m_slotsToUpdate.clear();
+	for (int slot = 0; slot < pool.GetNumSlots(); ++slot)
+	{
+		if (!pool.IsSlotAlive(slot))
+		{
+			continue;
+		}
+
+		T& entity = pool.GetSlot(slot);
+		m_significanceManager.ScoreEntity(entity);
+
+		// Entities on a slower tier get the time they skipped in one step
+		entity.m_pendingDeltaSeconds += stepSeconds;
+		if (m_significanceManager.ShouldUpdateEntity(entity, entityIndex))
+		{
+			m_slotsToUpdate.push_back(slot);
+		}
+		++entityIndex;
+	}
+
+	auto simulateRange = [this, &pool](int begin, int end)
+	{
+		ScopedAllocationCount rangeAllocations;
+		for (int updateIndex = begin; updateIndex < end; ++updateIndex)
+		{
+			T& entity = pool.GetSlot(m_slotsToUpdate[updateIndex]);
+			entity.T::Simulate(entity.m_pendingDeltaSeconds);
+			entity.m_pendingDeltaSeconds = 0.f;
+			entity.m_wasSimulated = !entity.m_isAsleep;
+		}
+		if (ThreadPool::GetThreadIndex() != 0)
+		{
+			m_workerUpdateAllocations += rangeAllocations.GetAllocationCount();
+		}
+	};
+	m_threadPool.ParallelFor(static_cast<int>(m_slotsToUpdate.size()), ENTITY_UPDATE_GRAIN_SIZE, simulateRange);
+
+	// Later species steer against where this one ended up; sleepers haven't moved
+	for (int slot : m_slotsToUpdate)
+	{
+		T& entity = pool.GetSlot(slot);
+		m_numFellAsleepLastFrame += entity.m_sleepTransition > 0 ? 1 : 0;
+		m_numWokeLastFrame += entity.m_sleepTransition < 0 ? 1 : 0;
+		if (!entity.m_isAsleep)
+		{
+			m_spatialGrid.MoveProxy(entity.m_spatialProxy, Vec2(entity.m_worldPosition.x, entity.m_worldPosition.y));
+		}
+	}
+}
+
+void AnimalMode::UpdateEntityMeshes(float interpolation)
+{
+	m_numEntitiesCulled = 0;
+	m_numEntitiesAsleep = 0;
+	UpdateSpeciesMeshes(m_snakes, interpolation);
+	UpdateSpeciesMeshes(m_spiders, interpolation);
+	UpdateSpeciesMeshes(m_octopuses, interpolation);
+}
+
+// Once per frame, after the simulation steps. Tested against the bounds from each entity's last
+// step; a mesh is rebuilt when the pose moved or the entity comes into view with stale verts.
+// Entities simulated every step draw between their last two poses, so they move smoothly at any
+// frame rate; slower tiers draw their latest pose, since their previous one spans several steps.
+template <typename T>
+void AnimalMode::UpdateSpeciesMeshes(EntityPool<T>& pool, float interpolation)
+{
+	m_slotsToUpdate.clear();
+	for (int slot = 0; slot < pool.GetNumSlots(); ++slot)
+	{
+		if (!pool.IsSlotAlive(slot))
+		{
+			continue;
+		}
+
+		T& entity = pool.GetSlot(slot);
+		entity.m_isVisible = m_viewFrustum.IsSphereVisible(entity.m_boundsCenter, entity.m_boundsRadius);
+		if (!entity.m_isVisible)
+		{
+			++m_numEntitiesCulled;
+		}
+
+		// A sleeper's two poses match, so its cached verts stay good until it wakes
+		m_numEntitiesAsleep += entity.m_isAsleep ? 1 : 0;
+		bool isInterpolated = entity.m_lod.m_updateInterval <= 1 && !entity.m_isAsleep;
+		if (entity.m_wasSimulated || (entity.m_isVisible && (entity.m_areVertsStale || isInterpolated)))
+		{
+			m_slotsToUpdate.push_back(slot);
+		}
+	}
+
+	auto meshRange = [this, &pool, interpolation](int begin, int end)
+	{
+		ScopedAllocationCount rangeAllocations;
+		for (int updateIndex = begin; updateIndex < end; ++updateIndex)
+		{
+			T& entity = pool.GetSlot(m_slotsToUpdate[updateIndex]);
+			entity.T::UpdateMesh(entity.m_lod.m_updateInterval <= 1 ? interpolation : 1.f);
+			entity.m_wasSimulated = false;
+		}
+		if (ThreadPool::GetThreadIndex() != 0)
+		{
+			m_workerUpdateAllocations += rangeAllocations.GetAllocationCount();
+		}
+	};
+	m_threadPool.ParallelFor(static_cast<int>(m_slotsToUpdate.size()), ENTITY_UPDATE_GRAIN_SIZE, meshRange);
+}
+
+void AnimalMode::WakeAllEntities()
+{
+	WakeSpecies(m_snakes);
+	WakeSpecies(m_spiders);
+	WakeSpecies(m_octopuses);
+}
+
+template <typename T>
+void AnimalMode::WakeSpecies(EntityPool<T>& pool)
+{
+	for (int slot = 0; slot < pool.GetNumSlots(); ++slot)
+	{
+		if (pool.IsSlotAlive(slot))
+		{
+			pool.GetSlot(slot).WakeUp();
+		}
+	}
+}
+
+// Builds a new world of the given size and a spatial grid to cover it. Animals keep their
+// positions; any left outside a smaller world stand on its clamped edge cells.
+void AnimalMode::ResizeTerrain(int numSamplesPerSide)
+{
+	bool areHillsInverted = m_terrain->m_areHillsInverted;
+	DeleteTerrain();
+	m_terrain = new Terrain(Vec3::ZERO, numSamplesPerSide, &m_threadPool);
+	m_terrain->m_areHillsInverted = areHillsInverted;
+	m_terrain->InitializeTerrainHills();
+
+	// Keep the grid's cell count bounded on very large worlds
+	float worldSize = m_terrain->GetWorldSize();
+	float cellSize = GetMax(SPATIAL_GRID_CELL_SIZE, worldSize / 1024.f);
+	m_spatialGrid = SpatialGrid(Vec2(0.f, 0.f), Vec2(worldSize, worldSize), cellSize);
+	AddSpeciesToSpatialGrid(m_snakes);
+	AddSpeciesToSpatialGrid(m_spiders);
+	AddSpeciesToSpatialGrid(m_octopuses);
+	WakeAllEntities();
 }
 
-void AnimalMode::UpdateEntities(float deltaSeconds)
+template <typename T>
+void AnimalMode::AddSpeciesToSpatialGrid(EntityPool<T>& pool)
 {
-	for (int entityIndex = 0; entityIndex < static_cast<int>(m_allEntities.size()); ++entityIndex)
+	for (int slot = 0; slot < pool.GetNumSlots(); ++slot)
 	{
-		Entity*& entity = m_allEntities[entityIndex];
-		if (entity)
+		if (pool.IsSlotAlive(slot))
 		{
-			entity->Update(deltaSeconds);
+			T& entity = pool.GetSlot(slot);
+			entity.m_spatialProxy = m_spatialGrid.AddProxy(&entity, Vec2(entity.m_worldPosition.x, entity.m_worldPosition.y));
 		}
 	}
 }
 
+void AnimalMode::AuditEntityUpdateAllocations(uint64_t allocationCount)
+{
+	m_lastEntityUpdateAllocations = allocationCount;
+
+	// Vertex buffers and poses grow during the first frames after start up or a toggle
+	if (m_allocationAuditWarmUpFrames > 0)
+	{
+		--m_allocationAuditWarmUpFrames;
+		return;
+	}
+
+	// Strict mode stops on the first steady-state allocation; otherwise it is only logged
+	if (allocationCount > 0)
+	{
+		std::string message = Stringf("AnimalMode entity update allocated %llu times in steady state", allocationCount);
+		GUARANTEE_OR_DIE(!s_isAllocationAuditStrict, message);
+		g_theDevConsole->AddLine(Rgba8::RED, message);
+		ResetAllocationAudit();
+	}
+}
+
+void AnimalMode::ResetAllocationAudit()
+{
+	m_allocationAuditWarmUpFrames = ALLOCATION_AUDIT_WARM_UP_FRAMES;
+}
+
 void AnimalMode::RenderEntities() const
 {
-	for (int entityIndex = 0; entityIndex < static_cast<int>(m_allEntities.size()); ++entityIndex)
+	ScopedFrameTimer drawTimer(FRAME_SUBSYSTEM_DRAW);
+	RenderSpecies(m_snakes);
+	RenderSpecies(m_spiders);
+	RenderSpecies(m_octopuses);
+}
+
+template <typename T>
+void AnimalMode::RenderSpecies(EntityPool<T> const& pool) const
+{
+	for (int slot = 0; slot < pool.GetNumSlots(); ++slot)
 	{
-		Entity* entity = m_allEntities[entityIndex];
-		if (entity)
+		if (pool.IsSlotAlive(slot))
 		{
-			entity->Render();
+			T const& entity = pool.GetSlot(slot);
+			if (entity.m_isVisible)
+			{
+				entity.T::Render();
+			}
 		}
 	}
 }
 
-void AnimalMode::RenderSkyBox() const
+void AnimalMode::BuildSkyBoxVerts()
 {
 	Vec3 dimensionSize = Vec3(50.f, 50.f, 5.f);
 	AABB3 skyBoxBounds = AABB3(Vec3(-5.f, -5.f, -30.f) * dimensionSize, Vec3(5.f, 5.f, 30.f) * dimensionSize);
@@ -196,44 +484,348 @@ void AnimalMode::RenderSkyBox() const
 	Vec3 topRightBack = Vec3(maxs.x, mins.y, maxs.z);
 	Vec3 topLeftBack = Vec3(maxs.x, maxs.y, maxs.z);
 
+	// One quad per face, in the same order as m_skyBoxFaceTextures
+	m_skyBoxVerts.clear();
+	AddVertsForQuad3D(m_skyBoxVerts, bottomLeftFwd, bottomRightFwd, topRightFwd, topLeftFwd);			// FRONT (+X)
+	AddVertsForQuad3D(m_skyBoxVerts, bottomRightBack, bottomLeftBack, topLeftBack, topRightBack);		// BACK (-X)
+	AddVertsForQuad3D(m_skyBoxVerts, bottomLeftBack, bottomLeftFwd, topLeftFwd, topLeftBack);			// LEFT (-Y)
+	AddVertsForQuad3D(m_skyBoxVerts, bottomRightFwd, bottomRightBack, topRightBack, topRightFwd);		// RIGHT (+Y)
+	AddVertsForQuad3D(m_skyBoxVerts, topLeftFwd, topRightFwd, topRightBack, topLeftBack);				// TOP (+Z)
+	AddVertsForQuad3D(m_skyBoxVerts, bottomLeftBack, bottomRightBack, bottomRightFwd, bottomLeftFwd);	// BOTTOM (-Z)
+
+	m_skyBoxFaceTextures[0] = m_skyBoxRightTexture;
+	m_skyBoxFaceTextures[1] = m_skyBoxLeftTexture;
+	m_skyBoxFaceTextures[2] = m_skyBoxBackTexture;
+	m_skyBoxFaceTextures[3] = m_skyBoxFrontTexture;
+	m_skyBoxFaceTextures[4] = m_skyBoxTopTexture;
+	m_skyBoxFaceTextures[5] = m_skyBoxBottomTexture;
+}
+
+void AnimalMode::RenderSkyBox() const
+{
 	g_theRenderer->SetBlendMode(BlendMode::ALPHA);
 	g_theRenderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_NONE);
 	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
 	g_theRenderer->BindShader(nullptr);
 
-	// FRONT (+X)
-	std::vector<Vertex_PCU> frontVerts;
-	AddVertsForQuad3D(frontVerts, bottomLeftFwd, bottomRightFwd, topRightFwd, topLeftFwd);
-	g_theRenderer->BindTexture(m_skyBoxRightTexture);
-	g_theRenderer->DrawVertexArray(frontVerts);
-
-	// BACK (-X)
-	std::vector<Vertex_PCU> backVerts;
-	AddVertsForQuad3D(backVerts, bottomRightBack, bottomLeftBack, topLeftBack, topRightBack);
-	g_theRenderer->BindTexture(m_skyBoxLeftTexture);
-	g_theRenderer->DrawVertexArray(backVerts);
-
-	// LEFT (-Y)
-	std::vector<Vertex_PCU> leftVerts;
-	AddVertsForQuad3D(leftVerts, bottomLeftBack, bottomLeftFwd, topLeftFwd, topLeftBack);
-	g_theRenderer->BindTexture(m_skyBoxBackTexture);
-	g_theRenderer->DrawVertexArray(leftVerts);
-
-	// RIGHT (+Y)
-	std::vector<Vertex_PCU> rightVerts;
-	AddVertsForQuad3D(rightVerts, bottomRightFwd, bottomRightBack, topRightBack, topRightFwd);
-	g_theRenderer->BindTexture(m_skyBoxFrontTexture);
-	g_theRenderer->DrawVertexArray(rightVerts);
-
-	// TOP (+Z)
-	std::vector<Vertex_PCU> topVerts;
-	AddVertsForQuad3D(topVerts, topLeftFwd, topRightFwd, topRightBack, topLeftBack);
-	g_theRenderer->BindTexture(m_skyBoxTopTexture);
-	g_theRenderer->DrawVertexArray(topVerts);
-
-	// BOTTOM (-Z)
-	std::vector<Vertex_PCU> bottomVerts;
-	AddVertsForQuad3D(bottomVerts, bottomLeftBack, bottomRightBack, bottomRightFwd, bottomLeftFwd);
-	g_theRenderer->BindTexture(m_skyBoxBottomTexture);
-	g_theRenderer->DrawVertexArray(bottomVerts);
+	int vertsPerFace = static_cast<int>(m_skyBoxVerts.size()) / NUM_SKYBOX_FACES;
+	for (int faceIndex = 0; faceIndex < NUM_SKYBOX_FACES; ++faceIndex)
+	{
+		g_theRenderer->BindTexture(m_skyBoxFaceTextures[faceIndex]);
+		g_theRenderer->DrawVertexArray(vertsPerFace, m_skyBoxVerts.data() + faceIndex * vertsPerFace);
+	}
+}
+
+bool AnimalMode::Command_SkeletonMemory(EventArgs& args)
+{
+	int instanceCount = args.GetValue("count", 10000);
+
+	SkeletonDefinition const* definitions[] =
+	{
+		&Spider::GetSkeletonDefinition(),
+		&Snake::GetSkeletonDefinition(),
+		&Octopus::GetSkeletonDefinition()
+	};
+
+	// Each animal keeps its current pose plus the previous and drawn poses used for render interpolation
+	int const posesPerInstance = 3;
+
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Skeleton memory, %d instances per species, %d poses per instance:", instanceCount, posesPerInstance));
+	for (SkeletonDefinition const* definition : definitions)
+	{
+		size_t standaloneBytes = definition->GetStandaloneSkeletonBytes();
+		size_t poseBytes = definition->CreateRestPose().GetMemoryBytes();
+		size_t instanceBytes = poseBytes * posesPerInstance;
+		size_t sharedBytes = definition->GetSharedMemoryBytes();
+
+		double beforeMB = static_cast<double>(standaloneBytes) * instanceCount / (1024.0 * 1024.0);
+		double afterMB = static_cast<double>(instanceBytes * instanceCount + sharedBytes) / (1024.0 * 1024.0);
+
+		g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  %-8s %2d bones  per instance: %6zu B -> %6zu B (%zu B per pose)  shared: %6zu B  total: %7.2f MB -> %7.2f MB",
+			definition->GetName().c_str(), definition->GetNumBones(), standaloneBytes, instanceBytes, poseBytes, sharedBytes, beforeMB, afterMB));
+	}
+	return true;
+}
+
+bool AnimalMode::Command_AllocationAudit(EventArgs& args)
+{
+	s_isAllocationAuditStrict = args.GetValue("strict", s_isAllocationAuditStrict);
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Allocation audit: tracking %s, strict %s",
+		AllocationCounter::IsTracking() ? "on" : "off", s_isAllocationAuditStrict ? "on" : "off"));
+	return true;
+}
+
+// Scattered uniformly over the terrain, away from its edges. Parked animals hold still and go to
+// sleep once settled.
+void AnimalMode::SpawnAnimals(AnimalSpecies species, int count, bool areParked)
+{
+	float const edgeMargin = 2.f;
+	float const maxCoordinate = m_terrain->GetWorldSize() - edgeMargin;
+	for (int spawnIndex = 0; spawnIndex < count; ++spawnIndex)
+	{
+		Vec3 position;
+		position.x = g_rng->RollRandomFloatInRange(edgeMargin, maxCoordinate);
+		position.y = g_rng->RollRandomFloatInRange(edgeMargin, maxCoordinate);
+		position.z = m_terrain->GetHeightAtXY(position.x, position.y);
+
+		Entity* entity = nullptr;
+		switch (species)
+		{
+			case ANIMAL_SPECIES_SNAKE:	 entity = m_snakes.Get(m_snakes.Create(this, position)); break;
+			case ANIMAL_SPECIES_SPIDER:
+			{
+				Spider* spider = m_spiders.Get(m_spiders.Create(this, position));
+				spider->SetIsRoaming(!areParked);
+				entity = spider;
+				break;
+			}
+			case ANIMAL_SPECIES_OCTOPUS: entity = m_octopuses.Get(m_octopuses.Create(this, position)); break;
+			default: break;
+		}
+		if (entity && areParked)
+		{
+			entity->SetIsParked(true);
+		}
+	}
+
+	// New animals grow their buffers over the next few frames
+	ResetAllocationAudit();
+}
+
+int AnimalMode::GetNumAnimals(AnimalSpecies species) const
+{
+	switch (species)
+	{
+		case ANIMAL_SPECIES_SNAKE:	 return m_snakes.GetNumAlive();
+		case ANIMAL_SPECIES_SPIDER:	 return m_spiders.GetNumAlive();
+		case ANIMAL_SPECIES_OCTOPUS: return m_octopuses.GetNumAlive();
+		default:					 return 0;
+	}
+}
+
+int AnimalMode::GetNumAnimals() const
+{
+	return m_snakes.GetNumAlive() + m_spiders.GetNumAlive() + m_octopuses.GetNumAlive();
+}
+
+// Runs at the top of Update, when the profiler holds the whole of the previous frame
+void AnimalMode::UpdateCrowdProfile()
+{
+	CrowdProfileSweep& sweep = m_crowdProfile;
+	if (!sweep.m_isRunning)
+	{
+		return;
+	}
+
+	if (sweep.m_frameInStep >= sweep.m_warmUpFrames)
+	{
+		sweep.m_currentStep.m_frameMilliseconds += Clock::GetSystemClock().GetDeltaSeconds() * 1000.0;
+		for (int subsystemIndex = 0; subsystemIndex < NUM_FRAME_SUBSYSTEMS; ++subsystemIndex)
+		{
+			sweep.m_currentStep.m_subsystemMilliseconds[subsystemIndex] += FrameProfiler::GetLastFrameMilliseconds(static_cast<FrameSubsystem>(subsystemIndex));
+		}
+	}
+	++sweep.m_frameInStep;
+	if (sweep.m_frameInStep < sweep.m_warmUpFrames + sweep.m_measuredFrames)
+	{
+		return;
+	}
+
+	CrowdProfileStep step = sweep.m_currentStep;
+	step.m_entityCount = GetNumAnimals(sweep.m_species);
+	step.m_frameMilliseconds /= sweep.m_measuredFrames;
+	for (double& milliseconds : step.m_subsystemMilliseconds)
+	{
+		milliseconds /= sweep.m_measuredFrames;
+	}
+	sweep.m_steps.push_back(step);
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  %6d %-8s frame %7.2fms | behavior %6.2f pose %6.2f hair %6.2f verts %6.2f draw %6.2f",
+		step.m_entityCount, GetSpeciesName(sweep.m_species), step.m_frameMilliseconds,
+		step.m_subsystemMilliseconds[FRAME_SUBSYSTEM_BEHAVIOR], step.m_subsystemMilliseconds[FRAME_SUBSYSTEM_POSE],
+		step.m_subsystemMilliseconds[FRAME_SUBSYSTEM_HAIR], step.m_subsystemMilliseconds[FRAME_SUBSYSTEM_VERTS], step.m_subsystemMilliseconds[FRAME_SUBSYSTEM_DRAW]));
+
+	sweep.m_targetCount *= 2;
+	if (sweep.m_targetCount > sweep.m_maxCount)
+	{
+		FinishCrowdProfile();
+		return;
+	}
+	sweep.m_currentStep = CrowdProfileStep();
+	sweep.m_frameInStep = 0;
+	SpawnAnimals(sweep.m_species, sweep.m_targetCount - GetNumAnimals(sweep.m_species));
+}
+
+void AnimalMode::FinishCrowdProfile()
+{
+	CrowdProfileSweep& sweep = m_crowdProfile;
+	sweep.m_isRunning = false;
+
+	std::string directory = "Data/Profiles";
+	std::error_code errorCode;
+	std::filesystem::create_directories(directory, errorCode);
+	std::string filePath = directory + "/" + sweep.m_outputName + ".csv";
+	std::ofstream file(filePath);
+	if (!file)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, Stringf("Failed to write crowd profile to %s", filePath.c_str()));
+		return;
+	}
+
+	file << "species,count,frame_ms";
+	for (int subsystemIndex = 0; subsystemIndex < NUM_FRAME_SUBSYSTEMS; ++subsystemIndex)
+	{
+		file << "," << FrameProfiler::GetSubsystemName(static_cast<FrameSubsystem>(subsystemIndex)) << "_ms";
+	}
+	file << "\n";
+	for (CrowdProfileStep const& step : sweep.m_steps)
+	{
+		file << GetSpeciesName(sweep.m_species) << "," << step.m_entityCount << "," << step.m_frameMilliseconds;
+		for (double milliseconds : step.m_subsystemMilliseconds)
+		{
+			file << "," << milliseconds;
+		}
+		file << "\n";
+	}
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Wrote %s", filePath.c_str()));
+}
+
+AnimalSpecies AnimalMode::GetSpeciesForName(std::string const& name)
+{
+	std::string lowerName = name;
+	for (char& character : lowerName)
+	{
+		character = static_cast<char>(tolower(static_cast<unsigned char>(character)));
+	}
+	for (int speciesIndex = 0; speciesIndex < NUM_ANIMAL_SPECIES; ++speciesIndex)
+	{
+		AnimalSpecies species = static_cast<AnimalSpecies>(speciesIndex);
+		if (lowerName == GetSpeciesName(species))
+		{
+			return species;
+		}
+	}
+	return ANIMAL_SPECIES_INVALID;
+}
+
+char const* AnimalMode::GetSpeciesName(AnimalSpecies species)
+{
+	static char const* const s_names[NUM_ANIMAL_SPECIES] = { "snake", "spider", "octopus" };
+	return species >= 0 && species < NUM_ANIMAL_SPECIES ? s_names[species] : "invalid";
+}
+
+AnimalMode* AnimalMode::GetActiveAnimalMode()
+{
+	if (g_theApp == nullptr || g_theApp->GetCurrentGameMode() != GAME_MODE_ANIMALS)
+	{
+		return nullptr;
+	}
+	return static_cast<AnimalMode*>(g_theGame);
+}
+
+bool AnimalMode::Command_Spawn(EventArgs& args)
+{
+	AnimalMode* animalMode = GetActiveAnimalMode();
+	if (animalMode == nullptr)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, "Spawn only works in AnimalMode");
+		return false;
+	}
+
+	std::string speciesName = args.GetValue("type", std::string("spider"));
+	AnimalSpecies species = GetSpeciesForName(speciesName);
+	if (species == ANIMAL_SPECIES_INVALID)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, Stringf("Unknown animal type '%s', expected snake, spider or octopus", speciesName.c_str()));
+		return false;
+	}
+
+	int count = GetClamped(args.GetValue("count", 100), 0, 100000);
+	bool areParked = args.GetValue("parked", false);
+	animalMode->SpawnAnimals(species, count, areParked);
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Spawned %d %s%s, %d animals in total", count, areParked ? "parked " : "", GetSpeciesName(species), animalMode->GetNumAnimals()));
+	return true;
+}
+
+bool AnimalMode::Command_ProfileCrowd(EventArgs& args)
+{
+	AnimalMode* animalMode = GetActiveAnimalMode();
+	if (animalMode == nullptr)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, "ProfileCrowd only works in AnimalMode");
+		return false;
+	}
+
+	std::string speciesName = args.GetValue("type", std::string("spider"));
+	AnimalSpecies species = GetSpeciesForName(speciesName);
+	if (species == ANIMAL_SPECIES_INVALID)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, Stringf("Unknown animal type '%s', expected snake, spider or octopus", speciesName.c_str()));
+		return false;
+	}
+
+	CrowdProfileSweep& sweep = animalMode->m_crowdProfile;
+	sweep = CrowdProfileSweep();
+	sweep.m_species = species;
+	sweep.m_targetCount = GetMax(args.GetValue("start", sweep.m_targetCount), 1);
+	sweep.m_maxCount = GetMax(args.GetValue("max", sweep.m_maxCount), sweep.m_targetCount);
+	sweep.m_warmUpFrames = GetMax(args.GetValue("warmup", sweep.m_warmUpFrames), 0);
+	sweep.m_measuredFrames = GetMax(args.GetValue("frames", sweep.m_measuredFrames), 1);
+	sweep.m_outputName = args.GetValue("out", Stringf("Crowd_%s", GetSpeciesName(species)));
+	sweep.m_isRunning = true;
+
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Crowd profile, %s from %d to %d, %d frames per step after %d to settle, ms per frame",
+		GetSpeciesName(species), sweep.m_targetCount, sweep.m_maxCount, sweep.m_measuredFrames, sweep.m_warmUpFrames));
+	animalMode->SpawnAnimals(species, sweep.m_targetCount - animalMode->GetNumAnimals(species));
+	return true;
+}
+
+bool AnimalMode::Command_ParallelUpdate(EventArgs& args)
+{
+	AnimalMode* animalMode = GetActiveAnimalMode();
+	if (animalMode == nullptr)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, "ParallelUpdate only works in AnimalMode");
+		return false;
+	}
+
+	ThreadPool& threadPool = animalMode->m_threadPool;
+	threadPool.SetIsSerial(!args.GetValue("enabled", !threadPool.IsSerial()));
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Entity update: %s, %d threads, %d entities per grain",
+		threadPool.IsSerial() ? "serial" : "parallel", threadPool.GetNumThreads(), ENTITY_UPDATE_GRAIN_SIZE));
+	return true;
+}
+
+bool AnimalMode::Command_SimulationRate(EventArgs& args)
+{
+	s_simulationHz = GetClamped(args.GetValue("hz", s_simulationHz), 5.f, 480.f);
+	s_maxSimulationStepsPerFrame = GetClamped(args.GetValue("maxsteps", s_maxSimulationStepsPerFrame), 1, 32);
+	Spider::s_hairSubsteps = GetClamped(args.GetValue("hair", Spider::s_hairSubsteps), 1, 16);
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Simulation: %.1f Hz, up to %d steps per frame, hair at %.1f Hz",
+		s_simulationHz, s_maxSimulationStepsPerFrame, s_simulationHz * static_cast<float>(Spider::s_hairSubsteps)));
+	return true;
+}
+
+bool AnimalMode::Command_Sleep(EventArgs& args)
+{
+	Entity::s_isSleepEnabled = args.GetValue("enabled", Entity::s_isSleepEnabled);
+	Entity::s_sleepDelaySteps = GetClamped(args.GetValue("delay", Entity::s_sleepDelaySteps), 1, 6000);
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Entity sleep %s, after %d unchanged steps", Entity::s_isSleepEnabled ? "on" : "off", Entity::s_sleepDelaySteps));
+	return true;
+}
+
+bool AnimalMode::Command_TerrainSize(EventArgs& args)
+{
+	AnimalMode* animalMode = GetActiveAnimalMode();
+	if (animalMode == nullptr)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, "TerrainSize only works in AnimalMode");
+		return false;
+	}
+
+	int numSamplesPerSide = GetClamped(args.GetValue("size", TERRAIN_SIZE), 2, 65536);
+	animalMode->ResizeTerrain(numSamplesPerSide);
+	Terrain const& terrain = *animalMode->m_terrain;
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Terrain: %d samples per side, %d chunks resident, %.1f MB", numSamplesPerSide,
+		terrain.GetNumResidentChunks(), static_cast<double>(terrain.GetResidentBytes()) / (1024.0 * 1024.0)));
+	return true;
 }
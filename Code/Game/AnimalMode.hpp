@@ -1,13 +1,64 @@
 #pragma once
 #include "Game/Game.h"
-#include "Engine/Animation/AnimStateMachine.hpp"
+#include "Game/SignificanceManager.hpp"
+#include "Game/BehaviorGraph.hpp"
+#include "Game/EntityPool.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/ThreadPool.hpp"
+#include "Game/SpatialGrid.hpp"
+#include "Game/ViewFrustum.hpp"
+#include "Game/Snake.hpp"
+#include "Game/Spider.hpp"
+#include "Game/Octopus.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include <atomic>
+#include <string>
+#include <vector>
 // -----------------------------------------------------------------------------
 class App;
-class Entity;
 class Terrain;
-class Snake;
-class Spider;
-class Octopus;
+// -----------------------------------------------------------------------------
+constexpr int NUM_SKYBOX_FACES = 6;
+constexpr int ALLOCATION_AUDIT_WARM_UP_FRAMES = 60;
+constexpr int ENTITY_UPDATE_GRAIN_SIZE = 4;
+constexpr float SPATIAL_GRID_CELL_SIZE = 2.f;
+constexpr float ANIMAL_CAMERA_FOV_DEGREES = 60.f;
+constexpr float ANIMAL_CAMERA_FAR_PLANE = 750.f;
+constexpr float ANIMAL_CAMERA_NEAR_PLANE = 0.1f;
+constexpr float ANIMAL_CAMERA_ASPECT = 2.f;
+constexpr float ANIMAL_CULL_FOV_MARGIN_DEGREES = 10.f;	// Culling uses last frame's camera, so allow it to turn
+// -----------------------------------------------------------------------------
+enum AnimalSpecies
+{
+	ANIMAL_SPECIES_INVALID = -1,
+	ANIMAL_SPECIES_SNAKE,
+	ANIMAL_SPECIES_SPIDER,
+	ANIMAL_SPECIES_OCTOPUS,
+	NUM_ANIMAL_SPECIES
+};
+
+struct CrowdProfileStep
+{
+	int	   m_entityCount = 0;
+	double m_frameMilliseconds = 0.0;
+	double m_subsystemMilliseconds[NUM_FRAME_SUBSYSTEMS] = {};
+};
+
+// Spawns one species up to each count in turn, doubling from the start count, and averages the
+// frame profiler over a number of frames at every step once the new animals have settled
+struct CrowdProfileSweep
+{
+	bool		  m_isRunning = false;
+	AnimalSpecies m_species = ANIMAL_SPECIES_SPIDER;
+	int			  m_targetCount = 250;
+	int			  m_maxCount = 4000;
+	int			  m_warmUpFrames = 30;
+	int			  m_measuredFrames = 120;
+	int			  m_frameInStep = 0;
+	std::string	  m_outputName;
+	CrowdProfileStep m_currentStep;
+	std::vector<CrowdProfileStep> m_steps;
+};
 // -----------------------------------------------------------------------------
 class AnimalMode : public Game 
 {
@@ -23,30 +74,78 @@ public:
 
 	// Updating
 	void UpdateCameras(float deltaSeconds);
-	void UpdateEntities(float deltaSeconds);
+	void UpdateViewFrustum();
+	void SimulateEntities(float stepSeconds);
+	template <typename T> void SimulateSpecies(EntityPool<T>& pool, float stepSeconds, int& entityIndex);
+	void UpdateEntityMeshes(float interpolation);
+	template <typename T> void UpdateSpeciesMeshes(EntityPool<T>& pool, float interpolation);
+	void WakeAllEntities();
+	template <typename T> void WakeSpecies(EntityPool<T>& pool);
+	void ResizeTerrain(int numSamplesPerSide);
+	template <typename T> void AddSpeciesToSpatialGrid(EntityPool<T>& pool);
+	void AuditEntityUpdateAllocations(uint64_t allocationCount);
+	void ResetAllocationAudit();
 
 	// Rendering
 	void RenderEntities() const;
+	template <typename T> void RenderSpecies(EntityPool<T> const& pool) const;
+	void BuildSkyBoxVerts();
 	void RenderSkyBox() const;
 
 	// Destruction
 	void DeleteTerrain();
 	void DeleteEntities();
 
+	// Crowds
+	void SpawnAnimals(AnimalSpecies species, int count, bool areParked = false);
+	int GetNumAnimals(AnimalSpecies species) const;
+	int GetNumAnimals() const;
+	void UpdateCrowdProfile();
+	void FinishCrowdProfile();
+	static AnimalSpecies GetSpeciesForName(std::string const& name);
+	static char const* GetSpeciesName(AnimalSpecies species);
+	static AnimalMode* GetActiveAnimalMode();
+
+	// Commands
+	static bool Command_SkeletonMemory(EventArgs& args);
+	static bool Command_AllocationAudit(EventArgs& args);
+	static bool Command_Spawn(EventArgs& args);
+	static bool Command_ProfileCrowd(EventArgs& args);
+	static bool Command_ParallelUpdate(EventArgs& args);
+	static bool Command_SimulationRate(EventArgs& args);
+	static bool Command_Sleep(EventArgs& args);
+	static bool Command_TerrainSize(EventArgs& args);
+
 public:
-	// Animals
-	Snake*   m_snake = nullptr;
-	Spider*  m_spider = nullptr;
-	Spider*  m_spider2 = nullptr;
-	Octopus* m_octopus = nullptr;
+	// Shared by the animals, so declared before the pools that are destroyed first
+	ThreadPool m_threadPool;
+	SpatialGrid m_spatialGrid;
+	SignificanceManager m_significanceManager;
+	ViewFrustum m_viewFrustum;
+	int m_numEntitiesCulled = 0;
+	int m_numEntitiesAsleep = 0;
+	int m_numFellAsleepLastFrame = 0;
+	int m_numWokeLastFrame = 0;
+	TimerWheel m_timerWheel;
+	BehaviorRunner m_snakeBehaviors;
 
-	// Stationary animals
-	Snake* m_snakeStationary = nullptr;
-	Spider* m_spiderStationary = nullptr;
-	Octopus* m_octopusStationary = nullptr;
+	// Animals, one pool per species, updated species by species
+	EntityPool<Snake>	m_snakes;
+	EntityPool<Spider>	m_spiders;
+	EntityPool<Octopus> m_octopuses;
 
-	// Entity list
-	std::vector<Entity*> m_allEntities;
+	// Fixed-step simulation; render interpolates across the time left in the accumulator
+	static float s_simulationHz;
+	static int s_maxSimulationStepsPerFrame;
+	float m_simulationAccumulator = 0.f;
+	uint64_t m_simulationStep = 0;		// Frame key for the entities' random streams
+	uint32_t m_nextEntityID = 0;
+	int m_numSimulationStepsLastFrame = 0;
+
+	// Slots due this step or frame; scored serially, then updated in parallel. Entity updates only
+	// read shared state (terrain, definitions, mode flags), so the result does not depend on the order.
+	std::vector<int> m_slotsToUpdate;
+	std::atomic<uint64_t> m_workerUpdateAllocations{ 0 };
 
 	// Terrain
 	Terrain* m_terrain = nullptr;
@@ -58,8 +157,17 @@ public:
 	Texture* m_skyBoxRightTexture = nullptr;
 	Texture* m_skyBoxTopTexture = nullptr;
 	Texture* m_skyBoxBottomTexture = nullptr;
+	Texture* m_skyBoxFaceTextures[NUM_SKYBOX_FACES] = {};
+	std::vector<Vertex_PCU> m_skyBoxVerts;
 
 	// Debug Draw
 	bool m_isSkeletonBeingDrawn = false;
 	bool m_isAnimalVertsBeingDrawn = true;
+
+	// Allocation audit, entity updates must not touch the heap once buffers have grown
+	static bool s_isAllocationAuditStrict;
+	int m_allocationAuditWarmUpFrames = ALLOCATION_AUDIT_WARM_UP_FRAMES;
+	uint64_t m_lastEntityUpdateAllocations = 0;
+
+	CrowdProfileSweep m_crowdProfile;
 };
\ No newline at end of file
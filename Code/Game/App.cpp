@@ -6,6 +6,11 @@
 #include "Game/FABRIKTest.hpp"
 #include "Game/RoboticArm.hpp"
 #include "Game/AnimalMode.hpp"
+#include "Game/IKWorkspaceProfiler.hpp"
+#include "Game/RigAsset.hpp"
+#include "Game/FixedChainIK.hpp"
+#include "Game/Snake.hpp"
+#include "Game/TerrainGenerator.hpp"
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Renderer/Renderer.h"
 #include "Engine/Renderer/Camera.h"
@@ -214,11 +219,69 @@ void App::DevConsoleInterface()
 	g_theDevConsole->AddLine(Rgba8::CYAN, "AnimalMode:");
 	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "I     - Toggle terrain inversion");
 	g_theDevConsole->AddLine(Rgba8::SEAWEED, "----------------------------------------------------------------------");
+	g_theDevConsole->AddLine(Rgba8::CYAN, "COMMANDS:");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "ProfileIKWorkspace rig=arm|armc|ccd|fabrik cells=32 iterations=10 threshold=0.01 deadzone=2.1 threads=0 out=name");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Sweeps a target grid, writes Data/Profiles/<out>_*.ppm slices and <out>.ikvol");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Run armc with deadzone=0 to see which radii actually need the dead zone");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "SkeletonMemory count=10000");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Compares a full Skeleton per animal against a shared definition plus per-instance poses");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "ConvertRig rig=Spider");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Cooks Data/Rigs/<rig>.txt to <rig>.rig (every rig if none given); stale rigs also cook on load");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "BenchmarkFixedChains runs=2000");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Times the fixed-size CCD/FABRIK solvers against the generic ones on the snake, spider leg, octopus arm and robotic arm,");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  with and without loading the chain and writing it back to the skeleton");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "BenchmarkAnimClips instances=256 frames=120");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Times the snake's procedural animations against their baked clips and reports key counts, memory and error");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "BenchmarkPoseBlend runs=20000");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Times 2- and 4-way SoA pose blends of the snake's clips against sampling a single clip");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "SnakeAnimSource baked=true");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Plays the snake's baked clips, or runs their procedural callbacks live through the same player");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "BenchmarkBehavior count=10000 frames=600");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Times the snake's flat event-driven behavior graph against the old per-frame shared_ptr tree");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "Significance enabled=true tier=-1");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Toggles AnimalMode's screen-size LOD tiers, or pins every entity to tier 0-3 for comparison");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "Spawn type=spider count=100 parked=false");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Scatters more snakes, spiders or octopuses over AnimalMode's terrain; parked ones hold still");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "ProfileCrowd type=spider start=250 max=4000 frames=120 warmup=30 out=Crowd_spider");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Doubles the crowd each step and writes frame and per-subsystem ms to Data/Profiles/<out>.csv");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "ParallelUpdate enabled=true");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Runs AnimalMode's entity updates on the thread pool or serially on the main thread");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "SimulationRate hz=60 hair=2 maxsteps=4");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Sets AnimalMode's fixed simulation rate, spider hair substeps per step and the hitch cap");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "Sleep enabled=true delay=60");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Lets animals whose pose inputs hold still for delay steps skip posing and keep their verts");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "TerrainSize size=4096");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Rebuilds AnimalMode's terrain with size samples per side; chunks stream in around the camera");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "BenchmarkTerrainGeneration min=1024 max=8192 scalar=true");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Times whole heightmaps per sample, by SSE2 rows and by tiles across threads, doubling from min to max");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "BenchmarkSpatialGrid count=10000 radius=1.5 frames=60");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Times moving and querying random walkers in the spatial grid against testing all pairs");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "AllocationAudit strict=true");
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  Logs when AnimalMode's entity update allocates after warm-up; strict (default in debug) dies on it instead");
+	g_theDevConsole->AddLine(Rgba8::SEAWEED, "----------------------------------------------------------------------");
 }
 
 void App::SubscribeToEvents()
 {
 	SubscribeEventCallbackFunction("Quit", HandleQuitRequested);
+	SubscribeEventCallbackFunction("ProfileIKWorkspace", IKWorkspaceProfiler::Command_ProfileIKWorkspace);
+	SubscribeEventCallbackFunction("SkeletonMemory", AnimalMode::Command_SkeletonMemory);
+	SubscribeEventCallbackFunction("ConvertRig", RigAsset::Command_ConvertRig);
+	SubscribeEventCallbackFunction("AllocationAudit", AnimalMode::Command_AllocationAudit);
+	SubscribeEventCallbackFunction("BenchmarkFixedChains", FixedChainBenchmark::Command_BenchmarkFixedChains);
+	SubscribeEventCallbackFunction("BenchmarkAnimClips", Snake::Command_BenchmarkAnimClips);
+	SubscribeEventCallbackFunction("BenchmarkPoseBlend", Snake::Command_BenchmarkPoseBlend);
+	SubscribeEventCallbackFunction("BenchmarkBehavior", Snake::Command_BenchmarkBehavior);
+	SubscribeEventCallbackFunction("SnakeAnimSource", Snake::Command_SnakeAnimSource);
+	SubscribeEventCallbackFunction("Significance", SignificanceManager::Command_Significance);
+	SubscribeEventCallbackFunction("Spawn", AnimalMode::Command_Spawn);
+	SubscribeEventCallbackFunction("ProfileCrowd", AnimalMode::Command_ProfileCrowd);
+	SubscribeEventCallbackFunction("ParallelUpdate", AnimalMode::Command_ParallelUpdate);
+	SubscribeEventCallbackFunction("SimulationRate", AnimalMode::Command_SimulationRate);
+	SubscribeEventCallbackFunction("Sleep", AnimalMode::Command_Sleep);
+	SubscribeEventCallbackFunction("TerrainSize", AnimalMode::Command_TerrainSize);
+	SubscribeEventCallbackFunction("BenchmarkTerrainGeneration", TerrainGenerator::Command_BenchmarkTerrainGeneration);
+	SubscribeEventCallbackFunction("BenchmarkSpatialGrid", SpatialGrid::Command_BenchmarkSpatialGrid);
 }
 
 void App::RunFrame()
@@ -0,0 +1,441 @@
+#include "Game/BakedAnimClip.hpp"
+#include "Game/SkeletonDefinition.hpp"
+#include "Game/ThreadPool.hpp"
+#include "Game/GameCommon.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(GAME_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	constexpr int   MAX_BAKED_FRAMES = 65535;
+	constexpr float ROTATION_QUANTIZATION_SCALE = 32767.f;
+	constexpr float POSITION_QUANTIZATION_STEPS = 65535.f;
+
+	float GetQuatDot(RotationQuat const& a, RotationQuat const& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	}
+
+	RotationQuat NLerp(RotationQuat const& a, RotationQuat const& b, float alpha)
+	{
+		RotationQuat result(a.x + (b.x - a.x) * alpha, a.y + (b.y - a.y) * alpha, a.z + (b.z - a.z) * alpha, a.w + (b.w - a.w) * alpha);
+		result.Normalize();
+		return result;
+	}
+
+	// Greedy reduction: each key reaches as far as linear interpolation stays inside tolerance for every sample it skips
+	template <typename SpanFitsFunction>
+	std::vector<int> FitLinearKeys(int numFrames, SpanFitsFunction const& spanFits)
+	{
+		std::vector<int> keyFrames;
+		keyFrames.push_back(0);
+		int startFrame = 0;
+		while (startFrame < numFrames - 1)
+		{
+			int endFrame = startFrame + 1;
+			while (endFrame + 1 < numFrames && spanFits(startFrame, endFrame + 1))
+			{
+				++endFrame;
+			}
+			keyFrames.push_back(endFrame);
+			startFrame = endFrame;
+		}
+		return keyFrames;
+	}
+
+	uint16_t QuantizeUnsigned(float value, float minValue, float scale)
+	{
+		if (scale <= 0.f)
+		{
+			return 0;
+		}
+		return static_cast<uint16_t>(GetClamped(roundf((value - minValue) / scale), 0.f, POSITION_QUANTIZATION_STEPS));
+	}
+
+	int16_t QuantizeSigned(float value)
+	{
+		return static_cast<int16_t>(GetClamped(roundf(value * ROTATION_QUANTIZATION_SCALE), -ROTATION_QUANTIZATION_SCALE, ROTATION_QUANTIZATION_SCALE));
+	}
+
+#if defined(GAME_USE_SSE2)
+	// Both key types are four 16-bit lanes; widen to four floats with one load and one unpack
+	__m128 LoadPositionKey(BakedPositionKey const& key)
+	{
+		__m128i packed = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(&key));
+		return _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+	}
+
+	__m128 LoadRotationKey(BakedRotationKey const& key)
+	{
+		__m128i packed = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(&key));
+		return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16));
+	}
+#endif
+}
+
+BakedAnimClip BakedAnimClip::Bake(std::string const& name, float durationSeconds, bool isLooping, AnimationSampler const& sampler, Skeleton const& restSkeleton, BakedAnimSettings const& settings)
+{
+	BakedAnimClip clip;
+	clip.m_name = name;
+	clip.m_duration = GetMax(durationSeconds, 0.f);
+	clip.m_isLooping = isLooping;
+	clip.m_numFrames = GetClamped(static_cast<int>(ceilf(clip.m_duration * settings.m_sampleRate)) + 1, 2, MAX_BAKED_FRAMES);
+	clip.m_sampleRate = clip.m_duration > 0.f ? static_cast<float>(clip.m_numFrames - 1) / clip.m_duration : settings.m_sampleRate;
+
+	int numFrames = clip.m_numFrames;
+	int numBones = static_cast<int>(restSkeleton.m_bones.size());
+
+	// Every sample starts from rest, so a channel the sampler never writes reads back as rest
+	Skeleton skeleton = restSkeleton;
+	skeleton.UpdateSkeletonPose();
+	std::vector<RotationQuat> restRotations;
+	restRotations.reserve(numBones);
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+	{
+		restRotations.push_back(GetLocalBoneRotation(skeleton, boneIndex));
+	}
+
+	std::vector<Vec3> positionSamples(static_cast<size_t>(numFrames) * numBones);
+	std::vector<RotationQuat> rotationSamples(static_cast<size_t>(numFrames) * numBones);
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		skeleton = restSkeleton;
+		sampler(skeleton, GetMin(static_cast<float>(frame) / clip.m_sampleRate, clip.m_duration));
+		skeleton.UpdateSkeletonPose();
+		for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+		{
+			size_t sampleIndex = static_cast<size_t>(boneIndex) * numFrames + frame;
+			positionSamples[sampleIndex] = skeleton.m_bones[boneIndex].m_localPosition;
+			rotationSamples[sampleIndex] = GetLocalBoneRotation(skeleton, boneIndex);
+
+			// Keep consecutive samples in one hemisphere so interpolating between keys takes the short way
+			if (frame > 0 && GetQuatDot(rotationSamples[sampleIndex - 1], rotationSamples[sampleIndex]) < 0.f)
+			{
+				RotationQuat& q = rotationSamples[sampleIndex];
+				q = RotationQuat(-q.x, -q.y, -q.z, -q.w);
+			}
+		}
+	}
+
+	float minRotationDot = cosf(settings.m_rotationToleranceRadians * 0.5f);
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+	{
+		Vec3 const* positions = &positionSamples[static_cast<size_t>(boneIndex) * numFrames];
+		RotationQuat const* rotations = &rotationSamples[static_cast<size_t>(boneIndex) * numFrames];
+		Vec3 restPosition = restSkeleton.m_bones[boneIndex].m_localPosition;
+
+		bool isPositionAnimated = false;
+		bool isRotationAnimated = false;
+		for (int frame = 0; frame < numFrames; ++frame)
+		{
+			isPositionAnimated = isPositionAnimated || (positions[frame] - restPosition).GetLengthSquared() > 0.0000001f;
+			isRotationAnimated = isRotationAnimated || fabsf(GetQuatDot(rotations[frame], restRotations[boneIndex])) < 0.9999999f;
+		}
+
+		if (isPositionAnimated)
+		{
+			std::vector<int> keyFrames = FitLinearKeys(numFrames, [positions, &settings](int startFrame, int endFrame)
+			{
+				float inverseSpan = 1.f / static_cast<float>(endFrame - startFrame);
+				for (int frame = startFrame + 1; frame < endFrame; ++frame)
+				{
+					float alpha = static_cast<float>(frame - startFrame) * inverseSpan;
+					Vec3 interpolated = positions[startFrame] + (positions[endFrame] - positions[startFrame]) * alpha;
+					if ((interpolated - positions[frame]).GetLength() > settings.m_positionTolerance)
+					{
+						return false;
+					}
+				}
+				return true;
+			});
+
+			Vec3 rangeMin = positions[0];
+			Vec3 rangeMax = positions[0];
+			for (int frame : keyFrames)
+			{
+				rangeMin = Vec3(GetMin(rangeMin.x, positions[frame].x), GetMin(rangeMin.y, positions[frame].y), GetMin(rangeMin.z, positions[frame].z));
+				rangeMax = Vec3(GetMax(rangeMax.x, positions[frame].x), GetMax(rangeMax.y, positions[frame].y), GetMax(rangeMax.z, positions[frame].z));
+			}
+
+			BakedTrack track;
+			track.m_boneIndex = boneIndex;
+			track.m_firstKey = static_cast<int>(clip.m_positionKeys.size());
+			track.m_keyCount = static_cast<int>(keyFrames.size());
+			track.m_rangeMin = rangeMin;
+			track.m_rangeScale = (rangeMax - rangeMin) * (1.f / POSITION_QUANTIZATION_STEPS);
+			for (int frame : keyFrames)
+			{
+				BakedPositionKey key;
+				key.m_value[0] = QuantizeUnsigned(positions[frame].x, rangeMin.x, track.m_rangeScale.x);
+				key.m_value[1] = QuantizeUnsigned(positions[frame].y, rangeMin.y, track.m_rangeScale.y);
+				key.m_value[2] = QuantizeUnsigned(positions[frame].z, rangeMin.z, track.m_rangeScale.z);
+				clip.m_positionKeys.push_back(key);
+				clip.m_positionKeyFrames.push_back(static_cast<uint16_t>(frame));
+			}
+			clip.m_positionTracks.push_back(track);
+		}
+
+		if (isRotationAnimated)
+		{
+			std::vector<int> keyFrames = FitLinearKeys(numFrames, [rotations, minRotationDot](int startFrame, int endFrame)
+			{
+				float inverseSpan = 1.f / static_cast<float>(endFrame - startFrame);
+				for (int frame = startFrame + 1; frame < endFrame; ++frame)
+				{
+					float alpha = static_cast<float>(frame - startFrame) * inverseSpan;
+					RotationQuat interpolated = NLerp(rotations[startFrame], rotations[endFrame], alpha);
+					if (fabsf(GetQuatDot(interpolated, rotations[frame])) < minRotationDot)
+					{
+						return false;
+					}
+				}
+				return true;
+			});
+
+			BakedTrack track;
+			track.m_boneIndex = boneIndex;
+			track.m_firstKey = static_cast<int>(clip.m_rotationKeys.size());
+			track.m_keyCount = static_cast<int>(keyFrames.size());
+			for (int frame : keyFrames)
+			{
+				BakedRotationKey key;
+				key.m_value[0] = QuantizeSigned(rotations[frame].x);
+				key.m_value[1] = QuantizeSigned(rotations[frame].y);
+				key.m_value[2] = QuantizeSigned(rotations[frame].z);
+				key.m_value[3] = QuantizeSigned(rotations[frame].w);
+				clip.m_rotationKeys.push_back(key);
+				clip.m_rotationKeyFrames.push_back(static_cast<uint16_t>(frame));
+			}
+			clip.m_rotationTracks.push_back(track);
+		}
+	}
+
+	clip.m_positionKeys.shrink_to_fit();
+	clip.m_positionKeyFrames.shrink_to_fit();
+	clip.m_rotationKeys.shrink_to_fit();
+	clip.m_rotationKeyFrames.shrink_to_fit();
+	return clip;
+}
+
+// Writes only the channels the clip animates, then updates the pose like the procedural callbacks do
+void BakedAnimClip::Evaluate(Skeleton& skeleton, float timeSeconds) const
+{
+	float frame = GetFrameAtTime(timeSeconds);
+	for (BakedTrack const& track : m_positionTracks)
+	{
+		skeleton.m_bones[track.m_boneIndex].SetLocalBonePosition(SamplePositionTrack(track, frame));
+	}
+	for (BakedTrack const& track : m_rotationTracks)
+	{
+		skeleton.m_bones[track.m_boneIndex].SetLocalBoneRotation(SampleRotationTrack(track, frame).GetAsEngineQuat());
+	}
+	skeleton.UpdateSkeletonPose();
+}
+
+// Channels the clip doesn't animate come from the rest pose, so blends fade them back to rest
+void BakedAnimClip::SamplePose(float timeSeconds, PoseBuffer const& restPose, PoseBuffer& out_pose) const
+{
+	out_pose = restPose;
+	float frame = GetFrameAtTime(timeSeconds);
+	for (BakedTrack const& track : m_positionTracks)
+	{
+		out_pose.SetBonePosition(track.m_boneIndex, SamplePositionTrack(track, frame));
+	}
+	for (BakedTrack const& track : m_rotationTracks)
+	{
+		out_pose.SetBoneRotation(track.m_boneIndex, SampleRotationTrack(track, frame));
+	}
+}
+
+// Track-major over many instances, so each track's keys stay in cache while every instance samples it.
+// Only local channels are written; world transforms are left for the caller's pose update.
+void BakedAnimClip::EvaluateBatch(BakedAnimClip const& clip, float const* timesSeconds, SkeletonPose* poses, int count)
+{
+	constexpr int MAX_BATCH_FRAMES = 256;
+	float frames[MAX_BATCH_FRAMES];
+	for (int batchStart = 0; batchStart < count; batchStart += MAX_BATCH_FRAMES)
+	{
+		int batchCount = GetMin(count - batchStart, MAX_BATCH_FRAMES);
+		for (int instanceIndex = 0; instanceIndex < batchCount; ++instanceIndex)
+		{
+			frames[instanceIndex] = clip.GetFrameAtTime(timesSeconds[batchStart + instanceIndex]);
+		}
+
+		for (BakedTrack const& track : clip.m_positionTracks)
+		{
+			for (int instanceIndex = 0; instanceIndex < batchCount; ++instanceIndex)
+			{
+				poses[batchStart + instanceIndex].m_localPositions[track.m_boneIndex] = clip.SamplePositionTrack(track, frames[instanceIndex]);
+			}
+		}
+		for (BakedTrack const& track : clip.m_rotationTracks)
+		{
+			for (int instanceIndex = 0; instanceIndex < batchCount; ++instanceIndex)
+			{
+				poses[batchStart + instanceIndex].m_localRotations[track.m_boneIndex] = clip.SampleRotationTrack(track, frames[instanceIndex]).GetAsEngineQuat();
+			}
+		}
+	}
+}
+
+std::string const& BakedAnimClip::GetName() const
+{
+	return m_name;
+}
+
+float BakedAnimClip::GetDuration() const
+{
+	return m_duration;
+}
+
+int BakedAnimClip::GetNumPositionTracks() const
+{
+	return static_cast<int>(m_positionTracks.size());
+}
+
+int BakedAnimClip::GetNumRotationTracks() const
+{
+	return static_cast<int>(m_rotationTracks.size());
+}
+
+int BakedAnimClip::GetNumKeys() const
+{
+	return static_cast<int>(m_positionKeys.size() + m_rotationKeys.size());
+}
+
+int BakedAnimClip::GetNumSampledFrames() const
+{
+	return m_numFrames;
+}
+
+size_t BakedAnimClip::GetMemoryBytes() const
+{
+	return sizeof(BakedAnimClip) + m_name.capacity()
+		+ (m_positionTracks.capacity() + m_rotationTracks.capacity()) * sizeof(BakedTrack)
+		+ m_positionKeys.capacity() * sizeof(BakedPositionKey) + m_rotationKeys.capacity() * sizeof(BakedRotationKey)
+		+ (m_positionKeyFrames.capacity() + m_rotationKeyFrames.capacity()) * sizeof(uint16_t);
+}
+
+float BakedAnimClip::GetFrameAtTime(float timeSeconds) const
+{
+	if (m_isLooping && m_duration > 0.f)
+	{
+		timeSeconds = fmodf(timeSeconds, m_duration);
+		if (timeSeconds < 0.f)
+		{
+			timeSeconds += m_duration;
+		}
+	}
+	return GetClamped(timeSeconds * m_sampleRate, 0.f, static_cast<float>(m_numFrames - 1));
+}
+
+// Index of the key at or before frame; the span ends at the next key, or holds on the last one
+int BakedAnimClip::FindKeySpan(BakedTrack const& track, std::vector<uint16_t> const& keyFrames, float frame, float& out_alpha) const
+{
+	uint16_t const* firstFrame = keyFrames.data() + track.m_firstKey;
+	uint16_t const* lastFrame = firstFrame + track.m_keyCount;
+	uint16_t const* nextKey = std::upper_bound(firstFrame, lastFrame, frame, [](float value, uint16_t keyFrame) { return value < static_cast<float>(keyFrame); });
+	int spanStart = GetMax(static_cast<int>(nextKey - firstFrame) - 1, 0);
+	if (spanStart >= track.m_keyCount - 1)
+	{
+		out_alpha = 0.f;
+		return track.m_firstKey + track.m_keyCount - 1;
+	}
+
+	float startFrame = static_cast<float>(firstFrame[spanStart]);
+	float endFrame = static_cast<float>(firstFrame[spanStart + 1]);
+	out_alpha = (frame - startFrame) / (endFrame - startFrame);
+	return track.m_firstKey + spanStart;
+}
+
+Vec3 BakedAnimClip::SamplePositionTrack(BakedTrack const& track, float frame) const
+{
+	float alpha = 0.f;
+	int keyIndex = FindKeySpan(track, m_positionKeyFrames, frame, alpha);
+	int nextKeyIndex = GetMin(keyIndex + 1, track.m_firstKey + track.m_keyCount - 1);
+
+#if defined(GAME_USE_SSE2)
+	__m128 startKey = LoadPositionKey(m_positionKeys[keyIndex]);
+	__m128 endKey = LoadPositionKey(m_positionKeys[nextKeyIndex]);
+	__m128 blended = _mm_add_ps(startKey, _mm_mul_ps(_mm_sub_ps(endKey, startKey), _mm_set1_ps(alpha)));
+	__m128 scale = _mm_set_ps(0.f, track.m_rangeScale.z, track.m_rangeScale.y, track.m_rangeScale.x);
+	__m128 offset = _mm_set_ps(0.f, track.m_rangeMin.z, track.m_rangeMin.y, track.m_rangeMin.x);
+	alignas(16) float result[4];
+	_mm_store_ps(result, _mm_add_ps(_mm_mul_ps(blended, scale), offset));
+	return Vec3(result[0], result[1], result[2]);
+#else
+	BakedPositionKey const& startKey = m_positionKeys[keyIndex];
+	BakedPositionKey const& endKey = m_positionKeys[nextKeyIndex];
+	float result[3];
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float start = static_cast<float>(startKey.m_value[axis]);
+		result[axis] = start + (static_cast<float>(endKey.m_value[axis]) - start) * alpha;
+	}
+	return Vec3(track.m_rangeMin.x + result[0] * track.m_rangeScale.x, track.m_rangeMin.y + result[1] * track.m_rangeScale.y, track.m_rangeMin.z + result[2] * track.m_rangeScale.z);
+#endif
+}
+
+// Normalized lerp; the quantization scale cancels out in the normalize
+RotationQuat BakedAnimClip::SampleRotationTrack(BakedTrack const& track, float frame) const
+{
+	float alpha = 0.f;
+	int keyIndex = FindKeySpan(track, m_rotationKeyFrames, frame, alpha);
+	int nextKeyIndex = GetMin(keyIndex + 1, track.m_firstKey + track.m_keyCount - 1);
+
+#if defined(GAME_USE_SSE2)
+	__m128 startKey = LoadRotationKey(m_rotationKeys[keyIndex]);
+	__m128 endKey = LoadRotationKey(m_rotationKeys[nextKeyIndex]);
+	__m128 blended = _mm_add_ps(startKey, _mm_mul_ps(_mm_sub_ps(endKey, startKey), _mm_set1_ps(alpha)));
+	__m128 squared = _mm_mul_ps(blended, blended);
+	__m128 lengthSquared = _mm_add_ps(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 3, 0, 1)));
+	lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(1, 0, 3, 2)));
+	alignas(16) float result[4];
+	_mm_store_ps(result, _mm_div_ps(blended, _mm_sqrt_ps(_mm_max_ps(lengthSquared, _mm_set1_ps(1.f)))));
+	return RotationQuat(result[0], result[1], result[2], result[3]);
+#else
+	BakedRotationKey const& startKey = m_rotationKeys[keyIndex];
+	BakedRotationKey const& endKey = m_rotationKeys[nextKeyIndex];
+	float result[4];
+	for (int component = 0; component < 4; ++component)
+	{
+		float start = static_cast<float>(startKey.m_value[component]);
+		result[component] = start + (static_cast<float>(endKey.m_value[component]) - start) * alpha;
+	}
+	RotationQuat rotation(result[0], result[1], result[2], result[3]);
+	rotation.Normalize();
+	return rotation;
+#endif
+}
+
+
+ProceduralAnimClip::ProceduralAnimClip(std::string const& name, AnimationSampler const& sampler, Skeleton const& restSkeleton)
+	: m_name(name)
+	, m_sampler(sampler)
+{
+	m_workingSkeletons.assign(ThreadPool::GetMaxNumThreads(), restSkeleton);
+}
+
+// Starts from rest like a bake does, so a channel the sampler never writes reads back as rest
+void ProceduralAnimClip::SamplePose(float timeSeconds, PoseBuffer const& restPose, PoseBuffer& out_pose) const
+{
+	Skeleton& skeleton = m_workingSkeletons[ThreadPool::GetThreadIndex()];
+	restPose.ApplyToSkeleton(skeleton);
+	m_sampler(skeleton, timeSeconds);
+	skeleton.UpdateSkeletonPose();
+
+	out_pose = restPose;
+	for (int boneIndex = 0; boneIndex < restPose.m_numBones; ++boneIndex)
+	{
+		out_pose.SetBone(boneIndex, skeleton.m_bones[boneIndex].m_localPosition, GetLocalBoneRotation(skeleton, boneIndex));
+	}
+}
+
+std::string const& ProceduralAnimClip::GetName() const
+{
+	return m_name;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+#include "Game/RigidTransform.hpp"
+#include "Game/AnimBlendTree.hpp"
+#include "Engine/Skeleton/Skeleton.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+// -----------------------------------------------------------------------------
+struct SkeletonPose;
+// -----------------------------------------------------------------------------
+// Same signature as the engine's Animation callbacks, so any of them can be baked
+typedef std::function<void(Skeleton&, float)> AnimationSampler;
+// -----------------------------------------------------------------------------
+struct BakedAnimSettings
+{
+	float m_sampleRate = 30.f;
+	float m_positionTolerance = 0.001f;		// Max distance a dropped key may be from the line through its neighbours
+	float m_rotationToleranceRadians = 0.002f;
+};
+// -----------------------------------------------------------------------------
+// Positions are quantized to 16 bits across the track's range; rotations are 16-bit
+// signed components renormalized on load. Both are 8 bytes so a key is one 64-bit load.
+struct BakedPositionKey
+{
+	uint16_t m_value[3] = {};
+	uint16_t m_padding = 0;
+};
+
+struct BakedRotationKey
+{
+	int16_t m_value[4] = {};
+};
+
+struct BakedTrack
+{
+	int  m_boneIndex = 0;
+	int  m_firstKey = 0;
+	int  m_keyCount = 0;
+	Vec3 m_rangeMin;			// Positions only
+	Vec3 m_rangeScale;
+};
+// -----------------------------------------------------------------------------
+// A procedural animation sampled on a fixed grid and reduced to the keys linear interpolation
+// needs. Only the bone channels the sampler actually moves get a track, so applying a clip
+// leaves everything else alone, exactly like the callback it came from. Clips are immutable
+// after baking and can be shared by every instance of a species.
+class BakedAnimClip : public AnimClip
+{
+public:
+	BakedAnimClip() = default;
+
+	static BakedAnimClip Bake(std::string const& name, float durationSeconds, bool isLooping, AnimationSampler const& sampler, Skeleton const& restSkeleton, BakedAnimSettings const& settings = BakedAnimSettings());
+
+	void Evaluate(Skeleton& skeleton, float timeSeconds) const;
+	virtual void SamplePose(float timeSeconds, PoseBuffer const& restPose, PoseBuffer& out_pose) const override;
+	static void EvaluateBatch(BakedAnimClip const& clip, float const* timesSeconds, SkeletonPose* poses, int count);
+
+	std::string const& GetName() const;
+	float GetDuration() const;
+	int GetNumPositionTracks() const;
+	int GetNumRotationTracks() const;
+	int GetNumKeys() const;
+	int GetNumSampledFrames() const;
+	size_t GetMemoryBytes() const;
+
+private:
+	float GetFrameAtTime(float timeSeconds) const;
+	Vec3 SamplePositionTrack(BakedTrack const& track, float frame) const;
+	RotationQuat SampleRotationTrack(BakedTrack const& track, float frame) const;
+	int FindKeySpan(BakedTrack const& track, std::vector<uint16_t> const& keyFrames, float frame, float& out_alpha) const;
+
+private:
+	std::string m_name;
+	float m_duration = 0.f;
+	float m_sampleRate = 30.f;
+	int   m_numFrames = 0;
+	bool  m_isLooping = false;
+	std::vector<BakedTrack> m_positionTracks;
+	std::vector<BakedTrack> m_rotationTracks;
+	std::vector<BakedPositionKey> m_positionKeys;
+	std::vector<BakedRotationKey> m_rotationKeys;
+	std::vector<uint16_t> m_positionKeyFrames;
+	std::vector<uint16_t> m_rotationKeyFrames;
+};
+
+// -----------------------------------------------------------------------------
+// Runs the sampler itself on every evaluation: a full pose update per sample instead of a key
+// lookup, but no bake, so an edited callback plays as written. Each pool thread poses its own
+// working skeleton, so one clip can be shared by every instance of a species like a baked one.
+class ProceduralAnimClip : public AnimClip
+{
+public:
+	ProceduralAnimClip() = default;
+	ProceduralAnimClip(std::string const& name, AnimationSampler const& sampler, Skeleton const& restSkeleton);
+
+	virtual void SamplePose(float timeSeconds, PoseBuffer const& restPose, PoseBuffer& out_pose) const override;
+
+	std::string const& GetName() const;
+
+private:
+	std::string m_name;
+	AnimationSampler m_sampler;
+	mutable std::vector<Skeleton> m_workingSkeletons;	// Indexed by ThreadPool::GetThreadIndex
+};
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "Game/BehaviorGraph.hpp"
+#include "Game/GameCommon.h"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+BehaviorNodeId BehaviorGraph::AddSelector(BehaviorNodeId parent)
+{
+	BehaviorGraphNode node;
+	node.m_type = BEHAVIOR_NODE_SELECTOR;
+	return AddNode(parent, node);
+}
+
+BehaviorNodeId BehaviorGraph::AddSequence(BehaviorNodeId parent)
+{
+	BehaviorGraphNode node;
+	node.m_type = BEHAVIOR_NODE_SEQUENCE;
+	return AddNode(parent, node);
+}
+
+BehaviorNodeId BehaviorGraph::AddAction(BehaviorNodeId parent, BehaviorActionFunction action)
+{
+	BehaviorGraphNode node;
+	node.m_type = BEHAVIOR_NODE_ACTION;
+	node.m_action = action;
+	return AddNode(parent, node);
+}
+
+BehaviorNodeId BehaviorGraph::AddWait(BehaviorNodeId parent, float minSeconds, float maxSeconds)
+{
+	BehaviorGraphNode node;
+	node.m_type = BEHAVIOR_NODE_WAIT;
+	node.m_minWaitSeconds = minSeconds;
+	node.m_maxWaitSeconds = GetMax(minSeconds, maxSeconds);
+	return AddNode(parent, node);
+}
+
+BehaviorGraphNode const& BehaviorGraph::GetNode(BehaviorNodeId node) const
+{
+	return m_nodes[node];
+}
+
+int BehaviorGraph::GetNumNodes() const
+{
+	return static_cast<int>(m_nodes.size());
+}
+
+// Setup-time only: walks the parent's children to append at the end
+BehaviorNodeId BehaviorGraph::AddNode(BehaviorNodeId parent, BehaviorGraphNode const& node)
+{
+	if ((parent == INVALID_BEHAVIOR_ID) != m_nodes.empty())
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, "A behavior graph has exactly one root, added first");
+		return INVALID_BEHAVIOR_ID;
+	}
+	if (parent != INVALID_BEHAVIOR_ID && (parent < 0 || parent >= GetNumNodes() || (m_nodes[parent].m_type != BEHAVIOR_NODE_SELECTOR && m_nodes[parent].m_type != BEHAVIOR_NODE_SEQUENCE)))
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, Stringf("Behavior node parent %d is not a selector or sequence; only composites have children", parent));
+		return INVALID_BEHAVIOR_ID;
+	}
+
+	BehaviorNodeId nodeId = GetNumNodes();
+	m_nodes.push_back(node);
+	m_nodes[nodeId].m_parent = parent;
+	if (parent == INVALID_BEHAVIOR_ID)
+	{
+		return nodeId;
+	}
+
+	if (m_nodes[parent].m_firstChild == INVALID_BEHAVIOR_ID)
+	{
+		m_nodes[parent].m_firstChild = nodeId;
+		return nodeId;
+	}
+	BehaviorNodeId sibling = m_nodes[parent].m_firstChild;
+	while (m_nodes[sibling].m_nextSibling != INVALID_BEHAVIOR_ID)
+	{
+		sibling = m_nodes[sibling].m_nextSibling;
+	}
+	m_nodes[sibling].m_nextSibling = nodeId;
+	return nodeId;
+}
+
+void BehaviorRunner::Initialize(BehaviorGraph const* graph, TimerWheel* timerWheel, int expectedInstances)
+{
+	m_graph = graph;
+	m_timerWheel = timerWheel;
+	m_instances.clear();
+	m_readyInstances.clear();
+	m_runningInstances.clear();
+	m_firstFreeInstance = INVALID_BEHAVIOR_ID;
+	m_numInstances = 0;
+	m_instances.reserve(expectedInstances);
+	m_readyInstances.reserve(expectedInstances);
+	m_runningInstances.reserve(expectedInstances);
+	m_timerWheel->Reserve(expectedInstances);
+}
+
+// New instances start from the root on the next tick. A reused slot may still have a queue entry
+// from its previous owner; that entry now runs the new instance instead.
+BehaviorInstanceId BehaviorRunner::AddInstance(void* context)
+{
+	BehaviorInstanceId instanceId = m_firstFreeInstance;
+	if (instanceId != INVALID_BEHAVIOR_ID)
+	{
+		m_firstFreeInstance = m_instances[instanceId].m_nextFree;
+	}
+	else
+	{
+		instanceId = static_cast<BehaviorInstanceId>(m_instances.size());
+		m_instances.emplace_back();
+	}
+
+	BehaviorInstance& instance = m_instances[instanceId];
+	bool isQueued = instance.m_isQueued;
+	instance = BehaviorInstance();
+	instance.m_context = context;
+	instance.m_random = RandomStream(static_cast<uint32_t>(instanceId), RANDOM_STREAM_BEHAVIOR);
+	instance.m_isQueued = isQueued;
+	QueueInstance(instanceId);
+	++m_numInstances;
+	return instanceId;
+}
+
+// A queued entry for a removed instance is skipped when it comes up
+void BehaviorRunner::RemoveInstance(BehaviorInstanceId instanceId)
+{
+	if (instanceId < 0 || instanceId >= static_cast<int>(m_instances.size()) || m_instances[instanceId].m_context == nullptr)
+	{
+		return;
+	}
+	BehaviorInstance& instance = m_instances[instanceId];
+	m_timerWheel->Cancel(instance.m_wakeTimer);
+	instance.m_context = nullptr;
+	instance.m_activeNode = INVALID_BEHAVIOR_ID;
+	instance.m_nextFree = m_firstFreeInstance;
+	m_firstFreeInstance = instanceId;
+	--m_numInstances;
+}
+
+// Instances re-queued while running (a running action, a finished tree) wait for the next
+// tick, so neither can spin here
+void BehaviorRunner::Tick()
+{
+	m_numInstancesWokenLastTick = 0;
+	m_numNodesVisitedLastTick = 0;
+	m_runningInstances.swap(m_readyInstances);
+	m_readyInstances.clear();
+	if (!m_graph || m_graph->GetNumNodes() == 0)
+	{
+		return;
+	}
+
+	for (BehaviorInstanceId instance : m_runningInstances)
+	{
+		m_instances[instance].m_isQueued = false;
+		if (m_instances[instance].m_context == nullptr)
+		{
+			continue;
+		}
+		++m_numInstancesWokenLastTick;
+		RunInstance(instance);
+	}
+	m_runningInstances.clear();
+}
+
+// Resumes from the parked leaf: a finished wait reports SUCCESS to its parent, a running action
+// is called again, and an idle instance enters at the root. Results then climb the parent links
+// until some composite descends into another child, which runs until a leaf parks again.
+void BehaviorRunner::RunInstance(BehaviorInstanceId instanceId)
+{
+	BehaviorInstance& instance = m_instances[instanceId];
+	BehaviorNodeId nodeId = instance.m_activeNode;
+	BehaviorResult result = BehaviorResult::SUCCESS;
+	bool isEntering = true;
+	if (nodeId == INVALID_BEHAVIOR_ID)
+	{
+		nodeId = 0;
+	}
+	else if (m_graph->GetNode(nodeId).m_type == BEHAVIOR_NODE_WAIT)
+	{
+		isEntering = false;
+	}
+
+	for (;;)
+	{
+		BehaviorGraphNode const& node = m_graph->GetNode(nodeId);
+		if (isEntering)
+		{
+			++m_numNodesVisitedLastTick;
+			switch (node.m_type)
+			{
+				case BEHAVIOR_NODE_SELECTOR:
+				case BEHAVIOR_NODE_SEQUENCE:
+				{
+					if (node.m_firstChild != INVALID_BEHAVIOR_ID)
+					{
+						nodeId = node.m_firstChild;
+						continue;
+					}
+					result = node.m_type == BEHAVIOR_NODE_SEQUENCE ? BehaviorResult::SUCCESS : BehaviorResult::FAILURE;
+					break;
+				}
+				case BEHAVIOR_NODE_ACTION:
+				{
+					result = node.m_action(instance.m_context);
+					if (result == BehaviorResult::RUNNING)
+					{
+						instance.m_activeNode = nodeId;
+						QueueInstance(instanceId);
+						return;
+					}
+					break;
+				}
+				case BEHAVIOR_NODE_WAIT:
+				{
+					float waitSeconds = node.m_minWaitSeconds;
+					if (node.m_maxWaitSeconds > node.m_minWaitSeconds)
+					{
+						waitSeconds = instance.m_random.RollRandomFloatInRange(node.m_minWaitSeconds, node.m_maxWaitSeconds);
+					}
+					instance.m_activeNode = nodeId;
+					instance.m_wakeTimer = m_timerWheel->Schedule(waitSeconds, WakeInstance, this, instanceId);
+					return;
+				}
+			}
+			isEntering = false;
+			continue;
+		}
+
+		// Hand the result to the parent: a sequence moves on after a success, a selector after a failure
+		if (node.m_parent == INVALID_BEHAVIOR_ID)
+		{
+			instance.m_activeNode = INVALID_BEHAVIOR_ID;
+			QueueInstance(instanceId);
+			return;
+		}
+		BehaviorNodeType parentType = m_graph->GetNode(node.m_parent).m_type;
+		BehaviorResult continueResult = parentType == BEHAVIOR_NODE_SEQUENCE ? BehaviorResult::SUCCESS : BehaviorResult::FAILURE;
+		if (result == continueResult && node.m_nextSibling != INVALID_BEHAVIOR_ID)
+		{
+			nodeId = node.m_nextSibling;
+			isEntering = true;
+		}
+		else
+		{
+			nodeId = node.m_parent;
+		}
+	}
+}
+
+void BehaviorRunner::QueueInstance(BehaviorInstanceId instance)
+{
+	if (!m_instances[instance].m_isQueued)
+	{
+		m_instances[instance].m_isQueued = true;
+		m_readyInstances.push_back(instance);
+	}
+}
+
+void BehaviorRunner::WakeInstance(void* runner, int instance)
+{
+	static_cast<BehaviorRunner*>(runner)->QueueInstance(instance);
+}
+
+int BehaviorRunner::GetNumInstances() const
+{
+	return m_numInstances;
+}
+
+int BehaviorRunner::GetNumInstancesWokenLastTick() const
+{
+	return m_numInstancesWokenLastTick;
+}
+
+int BehaviorRunner::GetNumNodesVisitedLastTick() const
+{
+	return m_numNodesVisitedLastTick;
+}
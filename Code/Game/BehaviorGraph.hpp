@@ -0,0 +1,97 @@
+#pragma once
+#include "Game/TimerWheel.hpp"
+#include "Game/RandomStream.hpp"
+#include "Engine/AI/BehaviorNode.hpp"
+#include <vector>
+// -----------------------------------------------------------------------------
+typedef int BehaviorNodeId;
+typedef int BehaviorInstanceId;
+constexpr int INVALID_BEHAVIOR_ID = -1;
+
+// Actions run to completion in one call; RUNNING polls them again next tick
+typedef BehaviorResult (*BehaviorActionFunction)(void* context);
+
+enum BehaviorNodeType
+{
+	BEHAVIOR_NODE_SELECTOR,
+	BEHAVIOR_NODE_SEQUENCE,
+	BEHAVIOR_NODE_ACTION,
+	BEHAVIOR_NODE_WAIT
+};
+
+struct BehaviorGraphNode
+{
+	BehaviorNodeType m_type = BEHAVIOR_NODE_SEQUENCE;
+	BehaviorNodeId	 m_parent = INVALID_BEHAVIOR_ID;
+	BehaviorNodeId	 m_firstChild = INVALID_BEHAVIOR_ID;
+	BehaviorNodeId	 m_nextSibling = INVALID_BEHAVIOR_ID;
+	BehaviorActionFunction m_action = nullptr;
+	float			 m_minWaitSeconds = 0.f;
+	float			 m_maxWaitSeconds = 0.f;
+};
+// -----------------------------------------------------------------------------
+// A behavior tree for one kind of animal, shared by all its instances. Nodes are stored in a
+// flat array linked by index; node 0 is the root. Children run in the order they were added.
+class BehaviorGraph
+{
+public:
+	BehaviorNodeId AddSelector(BehaviorNodeId parent);
+	BehaviorNodeId AddSequence(BehaviorNodeId parent);
+	BehaviorNodeId AddAction(BehaviorNodeId parent, BehaviorActionFunction action);
+	BehaviorNodeId AddWait(BehaviorNodeId parent, float minSeconds, float maxSeconds);
+
+	BehaviorGraphNode const& GetNode(BehaviorNodeId node) const;
+	int GetNumNodes() const;
+
+private:
+	BehaviorNodeId AddNode(BehaviorNodeId parent, BehaviorGraphNode const& node);
+
+private:
+	std::vector<BehaviorGraphNode> m_nodes;
+};
+// -----------------------------------------------------------------------------
+// Everything one instance needs to resume: the leaf it is parked on and the timer that wakes it.
+// The path back to the root is recovered through the parent links, so composites keep no state.
+struct BehaviorInstance
+{
+	void*		   m_context = nullptr;
+	BehaviorNodeId m_activeNode = INVALID_BEHAVIOR_ID;
+	TimerHandle	   m_wakeTimer;
+	RandomStream   m_random;
+	bool		   m_isQueued = false;		// At most one entry in the ready queue at a time
+	BehaviorInstanceId m_nextFree = INVALID_BEHAVIOR_ID;	// Free list link once removed
+};
+// -----------------------------------------------------------------------------
+// Runs every instance of one graph. Instances sit in a contiguous array, with removed slots reused
+// through a free list; wait nodes park them on
+// the timer wheel, whose callback queues them for the next tick. A tick runs only the queued
+// instances and those with an action still running, so sleeping instances cost nothing.
+// A tree that finishes restarts next tick. Advance the wheel before ticking.
+class BehaviorRunner
+{
+public:
+	void Initialize(BehaviorGraph const* graph, TimerWheel* timerWheel, int expectedInstances);
+	BehaviorInstanceId AddInstance(void* context);
+	void RemoveInstance(BehaviorInstanceId instance);
+	void Tick();
+
+	int GetNumInstances() const;
+	int GetNumInstancesWokenLastTick() const;
+	int GetNumNodesVisitedLastTick() const;
+
+private:
+	void RunInstance(BehaviorInstanceId instance);
+	void QueueInstance(BehaviorInstanceId instance);
+	static void WakeInstance(void* runner, int instance);
+
+private:
+	BehaviorGraph const* m_graph = nullptr;
+	TimerWheel*			 m_timerWheel = nullptr;
+	std::vector<BehaviorInstance>	m_instances;
+	std::vector<BehaviorInstanceId> m_readyInstances;
+	std::vector<BehaviorInstanceId> m_runningInstances;
+	BehaviorInstanceId m_firstFreeInstance = INVALID_BEHAVIOR_ID;
+	int	   m_numInstances = 0;
+	int	   m_numInstancesWokenLastTick = 0;
+	int	   m_numNodesVisitedLastTick = 0;
+};
@@ -85,28 +85,28 @@ Skeleton CCDIKTest::CreateTestChain()
 	Bone first;
 	first.m_boneName = "first";
 	first.SetLocalBonePosition(Vec3::ZERO);
-	skeleton.m_bones.push_back(first);
+	skeleton.m_bones.push_back(std::move(first));
 	skeleton.m_bones[0].m_childBoneIndices.push_back(1);
 
 	Bone second;
 	second.m_boneName = "second";
 	second.m_parentBoneIndex = 0;
 	second.SetLocalBonePosition(Vec3::ZAXE);
-	skeleton.m_bones.push_back(second);
+	skeleton.m_bones.push_back(std::move(second));
 	skeleton.m_bones[1].m_childBoneIndices.push_back(2);
 
 	Bone third;
 	third.m_boneName = "third";
 	third.m_parentBoneIndex = 1;
 	third.SetLocalBonePosition(Vec3::ZAXE);
-	skeleton.m_bones.push_back(third);
+	skeleton.m_bones.push_back(std::move(third));
 	skeleton.m_bones[2].m_childBoneIndices.push_back(3);
 
 	Bone fourth;
 	fourth.m_boneName = "fourth";
 	fourth.m_parentBoneIndex = 2;
 	fourth.SetLocalBonePosition(Vec3::ZAXE);
-	skeleton.m_bones.push_back(fourth);
+	skeleton.m_bones.push_back(std::move(fourth));
 	skeleton.m_bones[3].m_childBoneIndices.push_back(4);
 
 	skeleton.UpdateSkeletonPose();
@@ -134,7 +134,7 @@ void CCDIKTest::AddJoint()
 	newBone.m_parentBoneIndex = parentIndex;
 	newBone.SetLocalBonePosition(Vec3::ZAXE);
 	newBone.m_boneName = Stringf("bone_%d", parentIndex + 1);
-	m_skeleton.m_bones.push_back(newBone);
+	m_skeleton.m_bones.push_back(std::move(newBone));
 	m_skeleton.m_bones[parentIndex].m_childBoneIndices.push_back(static_cast<int>(m_skeleton.m_bones.size()) - 1);
 
 	m_skeleton.UpdateSkeletonPose();
@@ -15,7 +15,7 @@ public:
 	void Shutdown() override;
 
 	// Initialization
-	Skeleton CreateTestChain();
+	static Skeleton CreateTestChain();
 
 	// Updating
 	void UpdateCameras(float deltaSeconds);
@@ -1,9 +1,33 @@
 #include "Game/Entity.hpp"
+#include "Game/AnimalMode.hpp"
+#include "Game/GameCommon.h"
+
+constexpr float SEPARATION_STEERING_RATE = 3.f;
+
+bool Entity::s_isSleepEnabled = true;
+int Entity::s_sleepDelaySteps = 60;
+
+bool EntityPoseInputs::operator==(EntityPoseInputs const& other) const
+{
+	return m_position == other.m_position && m_moveDirection == other.m_moveDirection && m_animationTime == other.m_animationTime &&
+		m_animState == other.m_animState && m_animStateTime == other.m_animStateTime && m_lodTier == other.m_lodTier &&
+		m_isMoving == other.m_isMoving && m_isTurning == other.m_isTurning;
+}
 
 Entity::Entity(AnimalMode* mode, Vec3 position)
 	:m_animalMode(mode),
-	 m_worldPosition(position)
+	 m_worldPosition(position),
+	 m_boundsCenter(position)
+{
+	m_entityID = m_animalMode->m_nextEntityID++;
+	m_random = RandomStream(m_entityID, RANDOM_STREAM_GAMEPLAY, m_animalMode->m_simulationStep);
+	m_spatialProxy = m_animalMode->m_spatialGrid.AddProxy(this, Vec2(position.x, position.y));
+}
+
+Entity::~Entity()
 {
+	m_animalMode->m_timerWheel.Cancel(m_turnTimer);
+	m_animalMode->m_spatialGrid.RemoveProxy(m_spatialProxy);
 }
 
 Vec3 Entity::GetWorldPosition() const
@@ -25,3 +49,144 @@ void Entity::SetIsStationary(bool isStationary)
 {
 	m_isStationary = isStationary;
 }
+
+// Keyed by the simulation step, so what an entity draws never depends on which thread ran it
+// or on how many other entities drew before it
+RandomStream& Entity::GetRandomStream()
+{
+	m_random.SetFrame(m_animalMode->m_simulationStep);
+	return m_random;
+}
+
+void Entity::SetIsParked(bool isParked)
+{
+	m_isParked = isParked;
+	if (isParked)
+	{
+		m_isStationary = true;
+	}
+}
+
+void Entity::TurnTowardRandomDirection()
+{
+	float angle = GetRandomStream().RollRandomFloatInRange(0.f, 360.f);
+	Vec2 directionXY = Vec2(CosDegrees(angle), SinDegrees(angle));
+	m_targetMoveDirection = Vec3(directionXY.x, directionXY.y, 0.f).GetNormalized();
+	m_directionInterpTime = 0.f;
+	m_isTurning = true;
+
+	TimerWheel& timerWheel = m_animalMode->m_timerWheel;
+	timerWheel.Cancel(m_turnTimer);
+	m_turnTimer = timerWheel.Schedule(m_directionInterpDuration, FinishTurn, this);
+}
+
+void Entity::UpdateTurn(float deltaSeconds)
+{
+	if (!m_isTurning)
+	{
+		return;
+	}
+
+	m_directionInterpTime += deltaSeconds;
+	float fractionTowardEnd = GetClamped(m_directionInterpTime / m_directionInterpDuration, 0.f, 1.f);
+
+	float easedFraction = SmoothStep3(fractionTowardEnd);
+	m_moveDirection = SLerp(m_moveDirection, m_targetMoveDirection, easedFraction).GetNormalized();
+}
+
+// Bends the heading away from neighbors inside the separation radius, harder the closer they are.
+// Only reads the grid, so it is safe from the parallel update; the grid moves between species.
+void Entity::SteerAwayFromNeighbors(float deltaSeconds)
+{
+	SpatialGrid const& spatialGrid = m_animalMode->m_spatialGrid;
+	Vec2 position(m_worldPosition.x, m_worldPosition.y);
+	float pushX = 0.f;
+	float pushY = 0.f;
+	spatialGrid.ForEachInRadius(position, m_separationRadius, [&](SpatialGridHit const& hit)
+	{
+		if (hit.m_entity == this || hit.m_distanceSquared <= 0.0001f)
+		{
+			return;
+		}
+		Vec2 neighborPosition = spatialGrid.GetProxyPosition(hit.m_proxy);
+		float distance = sqrtf(hit.m_distanceSquared);
+		float strength = (1.f - distance / m_separationRadius) / distance;
+		pushX += (position.x - neighborPosition.x) * strength;
+		pushY += (position.y - neighborPosition.y) * strength;
+	});
+	if (pushX == 0.f && pushY == 0.f)
+	{
+		return;
+	}
+
+	// Animals travel along -m_moveDirection
+	float steeringAmount = SEPARATION_STEERING_RATE * deltaSeconds;
+	Vec3 heading = Vec3(-m_moveDirection.x + pushX * steeringAmount, -m_moveDirection.y + pushY * steeringAmount, 0.f);
+	if (heading.GetLengthSquared() > 0.f)
+	{
+		m_moveDirection = -heading.GetNormalized();
+	}
+}
+
+// Called after the pose is stored, padded by how far the mesh reaches past the bones
+void Entity::UpdateBounds(SkeletonPose const& pose, float boundsPadding)
+{
+	pose.ComputeBoundingSphere(m_boundsCenter, m_boundsRadius);
+	m_boundsRadius += boundsPadding;
+}
+
+// AnimalMode has tested the current bounds against the frustum; verts left unbuilt are stale
+// until the entity is next visible
+bool Entity::BeginMeshUpdate()
+{
+	m_areVertsStale = !m_isVisible;
+	return m_isVisible;
+}
+
+// Species with more inputs (an animation state machine) fill them in on top of these
+EntityPoseInputs Entity::GetPoseInputs() const
+{
+	EntityPoseInputs poseInputs;
+	poseInputs.m_position = m_worldPosition;
+	poseInputs.m_moveDirection = m_moveDirection;
+	poseInputs.m_animationTime = m_animationTime;
+	poseInputs.m_lodTier = static_cast<int>(m_lod.m_tier);
+	poseInputs.m_isMoving = m_isMoving;
+	poseInputs.m_isTurning = m_isTurning;
+	return poseInputs;
+}
+
+// Called once the step's clocks have advanced and before any posing; true means skip the rest.
+// The delay lets secondary motion such as hair settle before the entity freezes.
+bool Entity::TrySleep(EntityPoseInputs const& poseInputs)
+{
+	bool wasAsleep = m_isAsleep;
+	if (s_isSleepEnabled && m_hasSimulated && poseInputs == m_lastPoseInputs)
+	{
+		m_numStepsUnchanged = GetMin(m_numStepsUnchanged + 1, s_sleepDelaySteps);
+	}
+	else
+	{
+		m_numStepsUnchanged = 0;
+	}
+	m_lastPoseInputs = poseInputs;
+	m_isAsleep = s_isSleepEnabled && m_numStepsUnchanged >= s_sleepDelaySteps;
+	m_sleepTransition = (m_isAsleep == wasAsleep) ? 0 : (m_isAsleep ? 1 : -1);
+	return m_isAsleep;
+}
+
+// For changes the pose inputs don't see, like a terrain edit or a debug draw toggle
+void Entity::WakeUp()
+{
+	m_isAsleep = false;
+	m_numStepsUnchanged = 0;
+	m_areVertsStale = true;
+}
+
+void Entity::FinishTurn(void* entity, int payload)
+{
+	UNUSED(payload);
+	Entity* turningEntity = static_cast<Entity*>(entity);
+	turningEntity->m_moveDirection = turningEntity->m_targetMoveDirection;
+	turningEntity->m_isTurning = false;
+}
@@ -1,28 +1,103 @@
 #pragma once
+#include "Game/SignificanceManager.hpp"
+#include "Game/TimerWheel.hpp"
+#include "Game/RandomStream.hpp"
 #include "Engine/Math/Vec3.h"
 // -----------------------------------------------------------------------------
 class AnimalMode;
+struct SkeletonPose;
+// -----------------------------------------------------------------------------
+// What a step builds the pose from. Two steps in a row with the same inputs give the same pose,
+// so once they stop changing the entity can sleep. Terrain edits wake everything explicitly.
+struct EntityPoseInputs
+{
+	Vec3  m_position;
+	Vec3  m_moveDirection;
+	float m_animationTime = 0.f;
+	int   m_animState = -1;
+	float m_animStateTime = 0.f;
+	int   m_lodTier = 0;
+	bool  m_isMoving = false;
+	bool  m_isTurning = false;
+
+	bool operator==(EntityPoseInputs const& other) const;
+};
 // -----------------------------------------------------------------------------
 class Entity
 {
 public:
 	Entity(AnimalMode* mode, Vec3 position);
-	virtual ~Entity() {}
+	virtual ~Entity();
 
 	virtual void Initialize() = 0;
-	virtual void Update(float deltaSeconds) = 0;
+	virtual void Simulate(float deltaSeconds) = 0;
+	virtual void UpdateMesh(float interpolation) = 0;	// Draws at this fraction of the way from the previous pose to the current one
 	virtual void Render() const = 0;
 
 	Vec3 GetWorldPosition() const;
 	void SetWorldPosition(Vec3 const& worldPosition);
 	void SetSpeed(float speed);
 	void SetIsStationary(bool isStationary);
+	void SetIsParked(bool isParked);
+	RandomStream& GetRandomStream();
+	void TurnTowardRandomDirection();
+	void UpdateTurn(float deltaSeconds);
+	void SteerAwayFromNeighbors(float deltaSeconds);
+	void UpdateBounds(SkeletonPose const& pose, float boundsPadding);
+	bool BeginMeshUpdate();
+	EntityPoseInputs GetPoseInputs() const;
+	bool TrySleep(EntityPoseInputs const& poseInputs);
+	void WakeUp();
 
 public:
 	AnimalMode* m_animalMode = nullptr;
+	uint32_t    m_entityID = 0;		// In spawn order; keys the entity's random streams
+	RandomStream m_random;
 	Vec3        m_worldPosition = Vec3::ZERO;
 	bool        m_isMoving = true;
 	bool        m_isStationary = false;
 	Vec3        m_moveDirection = Vec3::XAXE;
 	float       m_speed = 1.5f;
+	float       m_animationTime = 0.f;	// Drives procedural motion, restarts when the entity is reset
+
+	// Turning, ended by a timer rather than by comparing directions every frame
+	Vec3        m_targetMoveDirection = Vec3::XAXE;
+	float       m_directionInterpTime = 0.f;
+	float       m_directionInterpDuration = 10.f;
+	bool        m_isTurning = false;
+	TimerHandle m_turnTimer;
+
+	// Separation, against neighbor positions from the spatial grid as of their last update
+	int         m_spatialProxy = -1;
+	float       m_separationRadius = 1.5f;
+
+	// Culling, a sphere around the posed bones; an entity off screen keeps simulating but builds no mesh
+	Vec3        m_boundsCenter = Vec3::ZERO;
+	float       m_boundsRadius = 0.f;
+	bool        m_isVisible = true;
+	bool        m_areVertsStale = true;
+	bool        m_wasSimulated = false;
+
+	// Drawing between steps; cleared on the first step and whenever the entity is teleported
+	bool        m_hasSimulated = false;
+	bool        m_isPreviousPoseValid = false;
+
+	// Sleep, once the pose inputs have held still for s_sleepDelaySteps steps; an asleep entity skips
+	// posing and keeps its verts. A parked entity is stationary and holds its animation clocks too.
+	bool        m_isParked = false;
+	bool        m_isAsleep = false;
+	int         m_sleepTransition = 0;		// +1 fell asleep this step, -1 woke
+	int         m_numStepsUnchanged = 0;
+	EntityPoseInputs m_lastPoseInputs;
+	static bool s_isSleepEnabled;
+	static int  s_sleepDelaySteps;
+
+	// Significance
+	float       m_boundingRadius = 1.f;
+	float       m_screenFraction = 1.f;
+	float       m_pendingDeltaSeconds = 0.f;
+	EntityLOD   m_lod;
+
+private:
+	static void FinishTurn(void* entity, int payload);
 };
\ No newline at end of file
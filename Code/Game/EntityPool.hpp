@@ -0,0 +1,135 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+// -----------------------------------------------------------------------------
+// Stays safe to hold after the entity is destroyed; the generation no longer matches
+struct EntityHandle
+{
+	int		 m_slot = -1;
+	uint32_t m_generation = 0;
+};
+// -----------------------------------------------------------------------------
+// Owns every entity of one species. Entities are constructed in place in fixed-size blocks, so
+// a species is updated by walking contiguous memory and an entity never moves once created:
+// pointers handed to the timer wheel or behavior runner stay valid until it is destroyed.
+// Freed slots are reused before a new block is added.
+template <typename T>
+class EntityPool
+{
+public:
+	static constexpr int ENTITIES_PER_BLOCK = 64;
+
+	EntityPool() = default;
+	EntityPool(EntityPool const&) = delete;
+	EntityPool& operator=(EntityPool const&) = delete;
+	~EntityPool() { Clear(); }
+
+	template <typename... Args>
+	EntityHandle Create(Args&&... args);
+	void Destroy(EntityHandle const& handle);
+	void Clear();
+
+	T* Get(EntityHandle const& handle) const;
+	bool IsSlotAlive(int slot) const { return m_isSlotAlive[slot] != 0; }
+	T& GetSlot(int slot) const { return *GetSlotAddress(slot); }
+	int GetNumSlots() const { return static_cast<int>(m_generations.size()); }
+	int GetNumAlive() const { return m_numAlive; }
+
+private:
+	struct Block
+	{
+		alignas(T) unsigned char m_storage[sizeof(T) * ENTITIES_PER_BLOCK];
+	};
+
+	T* GetSlotAddress(int slot) const;
+
+private:
+	std::vector<std::unique_ptr<Block>> m_blocks;
+	std::vector<uint32_t> m_generations;
+	std::vector<uint8_t>  m_isSlotAlive;
+	std::vector<int>	  m_freeSlots;
+	int m_numAlive = 0;
+};
+// -----------------------------------------------------------------------------
+template <typename T>
+template <typename... Args>
+EntityHandle EntityPool<T>::Create(Args&&... args)
+{
+	int slot = 0;
+	if (!m_freeSlots.empty())
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		slot = GetNumSlots();
+		if (slot % ENTITIES_PER_BLOCK == 0)
+		{
+			m_blocks.push_back(std::make_unique<Block>());
+		}
+		m_generations.push_back(0);
+		m_isSlotAlive.push_back(0);
+	}
+
+	// Marked alive after construction, so an entity can't find itself half-built while iterating
+	new (GetSlotAddress(slot)) T(std::forward<Args>(args)...);
+	m_isSlotAlive[slot] = 1;
+	++m_numAlive;
+
+	EntityHandle handle;
+	handle.m_slot = slot;
+	handle.m_generation = m_generations[slot];
+	return handle;
+}
+
+template <typename T>
+void EntityPool<T>::Destroy(EntityHandle const& handle)
+{
+	if (Get(handle) == nullptr)
+	{
+		return;
+	}
+	GetSlotAddress(handle.m_slot)->~T();
+	m_isSlotAlive[handle.m_slot] = 0;
+	++m_generations[handle.m_slot];
+	m_freeSlots.push_back(handle.m_slot);
+	--m_numAlive;
+}
+
+template <typename T>
+void EntityPool<T>::Clear()
+{
+	for (int slot = 0; slot < GetNumSlots(); ++slot)
+	{
+		if (IsSlotAlive(slot))
+		{
+			GetSlotAddress(slot)->~T();
+		}
+	}
+	m_blocks.clear();
+	m_generations.clear();
+	m_isSlotAlive.clear();
+	m_freeSlots.clear();
+	m_numAlive = 0;
+}
+
+template <typename T>
+T* EntityPool<T>::Get(EntityHandle const& handle) const
+{
+	if (handle.m_slot < 0 || handle.m_slot >= GetNumSlots() || !IsSlotAlive(handle.m_slot) || m_generations[handle.m_slot] != handle.m_generation)
+	{
+		return nullptr;
+	}
+	return GetSlotAddress(handle.m_slot);
+}
+
+template <typename T>
+T* EntityPool<T>::GetSlotAddress(int slot) const
+{
+	Block* block = m_blocks[slot / ENTITIES_PER_BLOCK].get();
+	return std::launder(reinterpret_cast<T*>(block->m_storage + sizeof(T) * (slot % ENTITIES_PER_BLOCK)));
+}
@@ -14,7 +14,7 @@ public:
 	void Shutdown() override;
 
 	// Initialization
-	Skeleton CreateTestChain();
+	static Skeleton CreateTestChain();
 
 	// Updating
 	void UpdateCameras(float deltaSeconds);
@@ -0,0 +1,194 @@
+#include "Game/FixedChainIK.hpp"
+#include "Game/Snake.hpp"
+#include "Game/Spider.hpp"
+#include "Game/Octopus.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <vector>
+
+namespace
+{
+	// Golden-angle spiral over the sphere, between 30% and 90% of full reach, so every method sees the same targets
+	std::vector<Vec3> MakeBenchmarkTargets(Vec3 const& rootPosition, float chainLength, int targetCount)
+	{
+		constexpr float GOLDEN_ANGLE_RADIANS = 2.39996323f;
+
+		std::vector<Vec3> targets;
+		targets.reserve(targetCount);
+		for (int targetIndex = 0; targetIndex < targetCount; ++targetIndex)
+		{
+			float fraction = (static_cast<float>(targetIndex) + 0.5f) / static_cast<float>(targetCount);
+			float z = 1.f - 2.f * fraction;
+			float ringRadius = sqrtf(GetMax(0.f, 1.f - z * z));
+			float angle = GOLDEN_ANGLE_RADIANS * static_cast<float>(targetIndex);
+			Vec3 direction = Vec3(cosf(angle) * ringRadius, sinf(angle) * ringRadius, z);
+			float reach = chainLength * (0.3f + 0.6f * fmodf(static_cast<float>(targetIndex) * 0.618034f, 1.f));
+			targets.push_back(rootPosition + direction * reach);
+		}
+		return targets;
+	}
+
+	struct BenchmarkResult
+	{
+		double m_microseconds = 0.0;
+		float  m_residualSum = 0.f;
+	};
+
+	template <int N>
+	bool GetChainFromBone(Skeleton const& skeleton, int firstBoneIndex, int (&outBoneIndices)[N])
+	{
+		outBoneIndices[0] = firstBoneIndex;
+		for (int jointIndex = 1; jointIndex < N; ++jointIndex)
+		{
+			Bone const& parentBone = skeleton.m_bones[outBoneIndices[jointIndex - 1]];
+			if (parentBone.m_childBoneIndices.empty())
+			{
+				return false;
+			}
+			outBoneIndices[jointIndex] = static_cast<int>(parentBone.m_childBoneIndices[0]);
+		}
+		return true;
+	}
+
+	std::string FormatResult(char const* label, BenchmarkResult const& result, int runCount)
+	{
+		return Stringf("%s %6.2fus res %.4f", label, result.m_microseconds / runCount, result.m_residualSum / runCount);
+	}
+
+	double GetSpeedup(BenchmarkResult const& baseline, BenchmarkResult const& result)
+	{
+		return baseline.m_microseconds / (result.m_microseconds > 0.0 ? result.m_microseconds : 0.000001);
+	}
+}
+
+template <int N>
+void FixedChainBenchmark::BenchmarkRig(char const* rigName, Skeleton const& restPose, int const (&boneIndices)[N], int runCount, bool isRoboticArm)
+{
+	FixedChain<N> restChain;
+	restChain.Load(restPose, boneIndices);
+	std::vector<int> chainIndices(boneIndices, boneIndices + N);
+	int endEffector = boneIndices[N - 1];
+	std::vector<Vec3> const targets = MakeBenchmarkTargets(restChain.GetJointPosition(0), restChain.m_chainLength, runCount);
+
+	// Generic CCD; the arm's end effector is the parentless claw midpoint, so it goes through the arm's own solver
+	Skeleton skeleton = restPose;
+	BenchmarkResult genericCCD;
+	double startTime = GetCurrentTimeSeconds();
+	for (Vec3 const& target : targets)
+	{
+		skeleton = restPose;
+		if (isRoboticArm)
+		{
+			RoboticArmMode::SolveCCDIK(skeleton, chainIndices, target, endEffector);
+		}
+		else
+		{
+			skeleton.SolveCCDIK(chainIndices, target);
+		}
+		genericCCD.m_residualSum += (skeleton.m_bones[endEffector].GetWorldBonePosition3D() - target).GetLength();
+	}
+	genericCCD.m_microseconds = (GetCurrentTimeSeconds() - startTime) * 1000000.0;
+
+	BenchmarkResult fixedCCD;
+	startTime = GetCurrentTimeSeconds();
+	for (Vec3 const& target : targets)
+	{
+		FixedChain<N> chain = restChain;
+		fixedCCD.m_residualSum += SolveCCD(chain, target).m_residual;
+	}
+	fixedCCD.m_microseconds = (GetCurrentTimeSeconds() - startTime) * 1000000.0;
+
+	// What a frame actually pays: loading the chain from the skeleton, the solve, the write-back and a
+	// full pose update. The arm runs its live solver, which also places the claw midpoint.
+	BenchmarkResult fixedCCDApplied;
+	startTime = GetCurrentTimeSeconds();
+	for (Vec3 const& target : targets)
+	{
+		skeleton = restPose;
+		if (isRoboticArm)
+		{
+			RoboticArmMode::SolveFixedChainCCDIK(skeleton, target);
+		}
+		else
+		{
+			FixedChain<N> chain;
+			chain.Load(skeleton, boneIndices);
+			SolveCCD(chain, target);
+			chain.ApplyToSkeleton(skeleton);
+			skeleton.UpdateSkeletonPose();
+		}
+		fixedCCDApplied.m_residualSum += (skeleton.m_bones[endEffector].GetWorldBonePosition3D() - target).GetLength();
+	}
+	fixedCCDApplied.m_microseconds = (GetCurrentTimeSeconds() - startTime) * 1000000.0;
+
+	BenchmarkResult fixedFABRIK;
+	startTime = GetCurrentTimeSeconds();
+	for (Vec3 const& target : targets)
+	{
+		FixedChain<N> chain = restChain;
+		fixedFABRIK.m_residualSum += SolveFABRIK(chain, target).m_residual;
+	}
+	fixedFABRIK.m_microseconds = (GetCurrentTimeSeconds() - startTime) * 1000000.0;
+
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  %-11s %d joints  %s | %s | %s",
+		rigName, N, FormatResult("generic CCD", genericCCD, runCount).c_str(), FormatResult("fixed CCD", fixedCCD, runCount).c_str(), FormatResult("+load/apply", fixedCCDApplied, runCount).c_str()));
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  %-11s           CCD speedup %.2fx solve only, %.2fx with load and write-back",
+		"", GetSpeedup(genericCCD, fixedCCD), GetSpeedup(genericCCD, fixedCCDApplied)));
+
+	if (isRoboticArm)
+	{
+		g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  %-11s           %s", "", FormatResult("fixed FABRIK", fixedFABRIK, runCount).c_str()));
+		return;
+	}
+
+	BenchmarkResult genericFABRIK;
+	startTime = GetCurrentTimeSeconds();
+	for (Vec3 const& target : targets)
+	{
+		skeleton = restPose;
+		skeleton.SolveFABRIK(chainIndices, target);
+		genericFABRIK.m_residualSum += (skeleton.m_bones[endEffector].GetWorldBonePosition3D() - target).GetLength();
+	}
+	genericFABRIK.m_microseconds = (GetCurrentTimeSeconds() - startTime) * 1000000.0;
+
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  %-11s           %s | %s (%.2fx, solve only)",
+		"", FormatResult("generic FABRIK", genericFABRIK, runCount).c_str(), FormatResult("fixed FABRIK", fixedFABRIK, runCount).c_str(), GetSpeedup(genericFABRIK, fixedFABRIK)));
+}
+
+bool FixedChainBenchmark::Command_BenchmarkFixedChains(EventArgs& args)
+{
+	int runCount = GetMax(args.GetValue("runs", 2000), 1);
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Fixed-size chain solvers vs generic, %d targets per rig, times per solve", runCount));
+
+	// Chains start at a bone the rig's bone table names and follow first children down
+	SkeletonDefinition const& snakeDefinition = Snake::GetSkeletonDefinition();
+	std::vector<int> snakeRootIndices = snakeDefinition.GetBoneTable().GetBoneIndicesWithRole(BONE_ROLE_ROOT);
+	int snakeChain[SNAKE_CHAIN_JOINTS] = {};
+	if (!snakeRootIndices.empty() && GetChainFromBone(snakeDefinition.GetRestSkeleton(), snakeRootIndices[0], snakeChain))
+	{
+		BenchmarkRig("Snake", snakeDefinition.GetRestSkeleton(), snakeChain, runCount, false);
+	}
+
+	// First femur down to its tarsus
+	SkeletonDefinition const& spiderDefinition = Spider::GetSkeletonDefinition();
+	std::vector<int> femurIndices = spiderDefinition.GetBoneTable().GetBoneIndicesWithRole(BONE_ROLE_FEMUR);
+	int spiderLegChain[SPIDER_LEG_CHAIN_JOINTS] = {};
+	if (!femurIndices.empty() && GetChainFromBone(spiderDefinition.GetRestSkeleton(), femurIndices[0], spiderLegChain))
+	{
+		BenchmarkRig("Spider leg", spiderDefinition.GetRestSkeleton(), spiderLegChain, runCount, false);
+	}
+
+	SkeletonDefinition const& octopusDefinition = Octopus::GetSkeletonDefinition();
+	int octopusArmBase = octopusDefinition.GetBoneTable().FindBoneIndex("Arm1_Base");
+	int octopusArmChain[OCTOPUS_ARM_CHAIN_JOINTS] = {};
+	if (octopusArmBase >= 0 && GetChainFromBone(octopusDefinition.GetRestSkeleton(), octopusArmBase, octopusArmChain))
+	{
+		BenchmarkRig("Octopus arm", octopusDefinition.GetRestSkeleton(), octopusArmChain, runCount, false);
+	}
+
+	Skeleton roboticArm = RoboticArmMode::InitializeRoboticArm();
+	RoboticArmMode::UpdateClawMidpoint(roboticArm, ROBOTIC_ARM_CHAIN_BONES[ROBOTIC_ARM_CHAIN_JOINTS - 1]);
+	BenchmarkRig("Robotic arm", roboticArm, ROBOTIC_ARM_CHAIN_BONES, runCount, true);
+	return true;
+}
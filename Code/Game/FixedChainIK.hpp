@@ -0,0 +1,248 @@
+#pragma once
+#include "Game/RoboticArm.hpp"
+#include "Game/RigidTransform.hpp"
+#include "Engine/Skeleton/Skeleton.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Math/MathUtils.h"
+#include <cmath>
+#include <utility>
+// -----------------------------------------------------------------------------
+// Joint counts of the shipped rigs' chains. The robotic arm solves its chain through
+// RoboticArmMode::SolveFixedChainCCDIK; the animals run no IK, so their chains (looked up from
+// each rig's bone table) only feed the benchmark. Dynamic chains stay on the generic solvers.
+constexpr int SNAKE_CHAIN_JOINTS = 5;
+constexpr int SPIDER_LEG_CHAIN_JOINTS = 4;
+constexpr int OCTOPUS_ARM_CHAIN_JOINTS = 3;
+constexpr int ROBOTIC_ARM_CHAIN_JOINTS = 5;
+constexpr int ROBOTIC_ARM_CHAIN_BONES[ROBOTIC_ARM_CHAIN_JOINTS] = { 0, 1, 2, 3, 8 };
+// -----------------------------------------------------------------------------
+// Calls function(std::integral_constant<int, J>) for J = FIRST .. FIRST + COUNT - 1, or counting
+// down from FIRST, so the joint index is a compile-time constant inside the body.
+template <int FIRST, typename Function, int... OFFSETS>
+inline void UnrollAscending(Function&& function, std::integer_sequence<int, OFFSETS...>)
+{
+	(function(std::integral_constant<int, FIRST + OFFSETS>()), ...);
+}
+
+template <int FIRST, int COUNT, typename Function>
+inline void UnrollAscending(Function&& function)
+{
+	UnrollAscending<FIRST>(function, std::make_integer_sequence<int, COUNT>());
+}
+
+template <int FIRST, typename Function, int... OFFSETS>
+inline void UnrollDescending(Function&& function, std::integer_sequence<int, OFFSETS...>)
+{
+	(function(std::integral_constant<int, FIRST - OFFSETS>()), ...);
+}
+
+template <int FIRST, int COUNT, typename Function>
+inline void UnrollDescending(Function&& function)
+{
+	UnrollDescending<FIRST>(function, std::make_integer_sequence<int, COUNT>());
+}
+// -----------------------------------------------------------------------------
+// A chain of N joints, each the parent of the next, held entirely in fixed arrays.
+// Joint 0 keeps its world position; the last joint is the end effector and is never rotated.
+template <int N>
+struct FixedChain
+{
+	static_assert(N >= 2, "A chain needs a root and an end effector");
+	static constexpr int NUM_JOINTS = N;
+
+	int			   m_boneIndices[N] = {};
+	RigidTransform m_rootParentTransform;
+	RigidTransform m_localTransforms[N];		// Relative to the previous joint; [0] is relative to the root's parent
+	RigidTransform m_worldTransforms[N];
+	float		   m_segmentLengths[N - 1] = {};
+	float		   m_chainLength = 0.f;
+
+	void Load(Skeleton const& skeleton, int const (&boneIndices)[N]);
+	void ApplyToSkeleton(Skeleton& skeleton) const;
+	Vec3 GetJointPosition(int jointIndex) const { return m_worldTransforms[jointIndex].m_translation; }
+	Vec3 GetEndEffectorPosition() const { return m_worldTransforms[N - 1].m_translation; }
+	RigidTransform const& GetParentWorldTransform(int jointIndex) const { return jointIndex == 0 ? m_rootParentTransform : m_worldTransforms[jointIndex - 1]; }
+};
+// -----------------------------------------------------------------------------
+template <int N>
+void FixedChain<N>::Load(Skeleton const& skeleton, int const (&boneIndices)[N])
+{
+	// The only matrix to quaternion conversions: reading the engine's world transforms once
+	for (int jointIndex = 0; jointIndex < N; ++jointIndex)
+	{
+		m_boneIndices[jointIndex] = boneIndices[jointIndex];
+		m_worldTransforms[jointIndex] = RigidTransform::MakeFromMat44(skeleton.m_bones[boneIndices[jointIndex]].m_worldBoneTransform);
+	}
+
+	int rootParentIndex = skeleton.m_bones[boneIndices[0]].m_parentBoneIndex;
+	m_rootParentTransform = RigidTransform();
+	if (rootParentIndex >= 0)
+	{
+		m_rootParentTransform = RigidTransform::MakeFromMat44(skeleton.m_bones[rootParentIndex].m_worldBoneTransform);
+	}
+
+	m_localTransforms[0] = m_rootParentTransform.GetInverse() * m_worldTransforms[0];
+	m_chainLength = 0.f;
+	for (int jointIndex = 1; jointIndex < N; ++jointIndex)
+	{
+		m_localTransforms[jointIndex] = m_worldTransforms[jointIndex - 1].GetInverse() * m_worldTransforms[jointIndex];
+		m_segmentLengths[jointIndex - 1] = m_localTransforms[jointIndex].m_translation.GetLength();
+		m_chainLength += m_segmentLengths[jointIndex - 1];
+	}
+}
+
+// Writes the rotated joints back; the caller runs UpdateSkeletonPose once afterwards
+template <int N>
+void FixedChain<N>::ApplyToSkeleton(Skeleton& skeleton) const
+{
+	for (int jointIndex = 0; jointIndex < N - 1; ++jointIndex)
+	{
+		skeleton.m_bones[m_boneIndices[jointIndex]].SetLocalBoneRotation(m_localTransforms[jointIndex].m_rotation.GetAsEngineQuat());
+	}
+}
+// -----------------------------------------------------------------------------
+// Forward kinematics from FIRST_JOINT to the end effector, one straight-line block per joint
+template <int FIRST_JOINT, int N>
+inline void UpdateFixedChainFK(FixedChain<N>& chain)
+{
+	UnrollAscending<FIRST_JOINT, N - FIRST_JOINT>([&chain](auto joint)
+	{
+		constexpr int J = decltype(joint)::value;
+		chain.m_worldTransforms[J] = chain.GetParentWorldTransform(J) * chain.m_localTransforms[J];
+	});
+}
+
+template <int JOINT, int N>
+inline void RotateFixedChainJoint(FixedChain<N>& chain, RotationQuat const& worldDelta)
+{
+	RotationQuat& worldRotation = chain.m_worldTransforms[JOINT].m_rotation;
+	worldRotation = worldDelta * worldRotation;
+	chain.m_localTransforms[JOINT].m_rotation = chain.GetParentWorldTransform(JOINT).m_rotation.GetInverse() * worldRotation;
+	UpdateFixedChainFK<JOINT + 1>(chain);
+}
+// -----------------------------------------------------------------------------
+// Same sweep as RoboticArmMode::SolveCCDIK: last joint to root, FK after every rotation
+template <int N>
+IKSolveStats SolveCCD(FixedChain<N>& chain, Vec3 const& targetPosition, int maxIterations = 10, float threshold = 0.01f)
+{
+	IKSolveStats stats;
+
+	Vec3 rootPosition = chain.GetJointPosition(0);
+	Vec3 clampedTargetPos = targetPosition;
+	if ((targetPosition - rootPosition).GetLength() > chain.m_chainLength)
+	{
+		stats.m_wasUnreachable = true;
+		clampedTargetPos = rootPosition + (targetPosition - rootPosition).GetNormalized() * chain.m_chainLength;
+	}
+
+	for (int iterationIndex = 0; iterationIndex < maxIterations; ++iterationIndex)
+	{
+		stats.m_iterations = iterationIndex + 1;
+
+		UnrollDescending<N - 2, N - 1>([&chain, &clampedTargetPos](auto joint)
+		{
+			constexpr int J = decltype(joint)::value;
+			Vec3 toEndEffector = chain.GetEndEffectorPosition() - chain.GetJointPosition(J);
+			Vec3 toTarget = clampedTargetPos - chain.GetJointPosition(J);
+			if (toEndEffector.GetLengthSquared() < 0.00001f || toTarget.GetLengthSquared() < 0.00001f)
+			{
+				return;
+			}
+
+			toEndEffector.Normalize();
+			toTarget.Normalize();
+			float angle = acosf(GetClamped(DotProduct3D(toEndEffector, toTarget), -1.f, 1.f));
+			Vec3 rotationAxis = CrossProduct3D(toEndEffector, toTarget);
+			if (angle > 0.001f && rotationAxis.GetLengthSquared() > 0.00001f)
+			{
+				RotateFixedChainJoint<J>(chain, RotationQuat::MakeFromAxisAngle(rotationAxis.GetNormalized(), angle));
+			}
+		});
+
+		if ((chain.GetEndEffectorPosition() - clampedTargetPos).GetLength() <= threshold)
+		{
+			stats.m_hasConverged = true;
+			break;
+		}
+	}
+
+	stats.m_residual = (chain.GetEndEffectorPosition() - targetPosition).GetLength();
+	stats.m_hasConverged = stats.m_hasConverged || stats.m_residual <= threshold;
+	return stats;
+}
+// -----------------------------------------------------------------------------
+// Solves joint positions, then turns each joint onto its new segment so the chain stays rigid
+template <int N>
+IKSolveStats SolveFABRIK(FixedChain<N>& chain, Vec3 const& targetPosition, int maxIterations = 10, float threshold = 0.01f)
+{
+	IKSolveStats stats;
+
+	Vec3 joints[N];
+	UnrollAscending<0, N>([&chain, &joints](auto joint)
+	{
+		constexpr int J = decltype(joint)::value;
+		joints[J] = chain.GetJointPosition(J);
+	});
+
+	Vec3 rootPosition = joints[0];
+	if ((targetPosition - rootPosition).GetLength() > chain.m_chainLength)
+	{
+		stats.m_wasUnreachable = true;
+		stats.m_iterations = 1;
+		UnrollAscending<1, N - 1>([&chain, &joints, &targetPosition](auto joint)
+		{
+			constexpr int J = decltype(joint)::value;
+			joints[J] = joints[J - 1] + (targetPosition - joints[J - 1]).GetNormalized() * chain.m_segmentLengths[J - 1];
+		});
+	}
+	else
+	{
+		for (int iterationIndex = 0; iterationIndex < maxIterations; ++iterationIndex)
+		{
+			stats.m_iterations = iterationIndex + 1;
+
+			// Backward reaching
+			joints[N - 1] = targetPosition;
+			UnrollDescending<N - 2, N - 1>([&chain, &joints](auto joint)
+			{
+				constexpr int J = decltype(joint)::value;
+				joints[J] = joints[J + 1] + (joints[J] - joints[J + 1]).GetNormalized() * chain.m_segmentLengths[J];
+			});
+
+			// Forward reaching
+			joints[0] = rootPosition;
+			UnrollAscending<1, N - 1>([&chain, &joints](auto joint)
+			{
+				constexpr int J = decltype(joint)::value;
+				joints[J] = joints[J - 1] + (joints[J] - joints[J - 1]).GetNormalized() * chain.m_segmentLengths[J - 1];
+			});
+
+			if ((joints[N - 1] - targetPosition).GetLength() <= threshold)
+			{
+				break;
+			}
+		}
+	}
+
+	UnrollAscending<0, N - 1>([&chain, &joints](auto joint)
+	{
+		constexpr int J = decltype(joint)::value;
+		Vec3 currentDirection = (chain.GetJointPosition(J + 1) - chain.GetJointPosition(J)).GetNormalized();
+		Vec3 desiredDirection = (joints[J + 1] - chain.GetJointPosition(J)).GetNormalized();
+		RotateFixedChainJoint<J>(chain, RotationQuat::MakeRotationFromTwoVectors(currentDirection, desiredDirection));
+	});
+
+	stats.m_residual = (chain.GetEndEffectorPosition() - targetPosition).GetLength();
+	stats.m_hasConverged = stats.m_residual <= threshold;
+	return stats;
+}
+// -----------------------------------------------------------------------------
+class FixedChainBenchmark
+{
+public:
+	static bool Command_BenchmarkFixedChains(EventArgs& args);
+
+private:
+	template <int N>
+	static void BenchmarkRig(char const* rigName, Skeleton const& restPose, int const (&boneIndices)[N], int runCount, bool isRoboticArm);
+};
@@ -0,0 +1,54 @@
+#include "Game/FrameProfiler.hpp"
+#include "Engine/Core/Time.hpp"
+
+double FrameProfiler::s_currentFrameSeconds[ThreadPool::MAX_THREADS][NUM_FRAME_SUBSYSTEMS] = {};
+double FrameProfiler::s_lastFrameSeconds[NUM_FRAME_SUBSYSTEMS] = {};
+thread_local ScopedFrameTimer* ScopedFrameTimer::s_innermostTimer = nullptr;
+
+void FrameProfiler::BeginFrame()
+{
+	for (int subsystemIndex = 0; subsystemIndex < NUM_FRAME_SUBSYSTEMS; ++subsystemIndex)
+	{
+		s_lastFrameSeconds[subsystemIndex] = 0.0;
+		for (int threadIndex = 0; threadIndex < ThreadPool::GetMaxNumThreads(); ++threadIndex)
+		{
+			s_lastFrameSeconds[subsystemIndex] += s_currentFrameSeconds[threadIndex][subsystemIndex];
+			s_currentFrameSeconds[threadIndex][subsystemIndex] = 0.0;
+		}
+	}
+}
+
+void FrameProfiler::AddTime(FrameSubsystem subsystem, double seconds)
+{
+	s_currentFrameSeconds[ThreadPool::GetThreadIndex()][subsystem] += seconds;
+}
+
+double FrameProfiler::GetLastFrameMilliseconds(FrameSubsystem subsystem)
+{
+	return s_lastFrameSeconds[subsystem] * 1000.0;
+}
+
+char const* FrameProfiler::GetSubsystemName(FrameSubsystem subsystem)
+{
+	static char const* const s_names[NUM_FRAME_SUBSYSTEMS] = { "behavior", "pose", "hair", "verts", "draw" };
+	return s_names[subsystem];
+}
+
+ScopedFrameTimer::ScopedFrameTimer(FrameSubsystem subsystem)
+	:m_subsystem(subsystem),
+	 m_enclosingTimer(s_innermostTimer)
+{
+	s_innermostTimer = this;
+	m_startTime = GetCurrentTimeSeconds();
+}
+
+ScopedFrameTimer::~ScopedFrameTimer()
+{
+	double elapsedSeconds = GetCurrentTimeSeconds() - m_startTime;
+	FrameProfiler::AddTime(m_subsystem, elapsedSeconds - m_nestedSeconds);
+	if (m_enclosingTimer)
+	{
+		m_enclosingTimer->m_nestedSeconds += elapsedSeconds;
+	}
+	s_innermostTimer = m_enclosingTimer;
+}
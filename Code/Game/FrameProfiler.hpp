@@ -0,0 +1,45 @@
+#pragma once
+#include "Game/ThreadPool.hpp"
+// -----------------------------------------------------------------------------
+enum FrameSubsystem
+{
+	FRAME_SUBSYSTEM_BEHAVIOR,
+	FRAME_SUBSYSTEM_POSE,
+	FRAME_SUBSYSTEM_HAIR,
+	FRAME_SUBSYSTEM_VERTS,
+	FRAME_SUBSYSTEM_DRAW,
+	NUM_FRAME_SUBSYSTEMS
+};
+// -----------------------------------------------------------------------------
+// Wall time per subsystem, summed over every entity in a frame. BeginFrame publishes the frame
+// that just ended, so the numbers read during Update cover the previous Update and Render.
+// Timers are exclusive: a nested timer's time is taken out of the one enclosing it. Each
+// ThreadPool thread adds into its own row, so with a parallel update a subsystem's time is
+// CPU time across cores and can exceed the frame. BeginFrame runs while the pool is idle.
+class FrameProfiler
+{
+public:
+	static void BeginFrame();
+	static void AddTime(FrameSubsystem subsystem, double seconds);
+	static double GetLastFrameMilliseconds(FrameSubsystem subsystem);
+	static char const* GetSubsystemName(FrameSubsystem subsystem);
+
+private:
+	static double s_currentFrameSeconds[ThreadPool::MAX_THREADS][NUM_FRAME_SUBSYSTEMS];
+	static double s_lastFrameSeconds[NUM_FRAME_SUBSYSTEMS];
+};
+// -----------------------------------------------------------------------------
+class ScopedFrameTimer
+{
+public:
+	explicit ScopedFrameTimer(FrameSubsystem subsystem);
+	~ScopedFrameTimer();
+
+private:
+	FrameSubsystem	  m_subsystem;
+	double			  m_startTime = 0.0;
+	double			  m_nestedSeconds = 0.0;
+	ScopedFrameTimer* m_enclosingTimer = nullptr;
+
+	static thread_local ScopedFrameTimer* s_innermostTimer;
+};
@@ -0,0 +1,260 @@
+#include "Game/FullBodyIK.hpp"
+#include "Game/RigidTransform.hpp"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <cmath>
+
+void FullBodyIK::Initialize(Skeleton const& skeleton)
+{
+	int boneCount = static_cast<int>(skeleton.m_bones.size());
+	m_hipIndex = skeleton.FindBoneIndexByName("Root/Hip");
+	m_bodyIndex = skeleton.FindBoneIndexByName("Body");
+	m_headIndex = skeleton.FindBoneIndexByName("Head");
+	m_effectors[FULL_BODY_LEFT_HAND].m_boneIndex = skeleton.FindBoneIndexByName("LHand");
+	m_effectors[FULL_BODY_RIGHT_HAND].m_boneIndex = skeleton.FindBoneIndexByName("RHand");
+	m_effectors[FULL_BODY_LEFT_FOOT].m_boneIndex = skeleton.FindBoneIndexByName("LFoot");
+	m_effectors[FULL_BODY_RIGHT_FOOT].m_boneIndex = skeleton.FindBoneIndexByName("RFoot");
+	m_effectors[FULL_BODY_HEAD_LOOK].m_boneIndex = m_headIndex;
+
+	m_restHipPosition = skeleton.m_bones[m_hipIndex].m_localPosition;
+	m_headLength = (skeleton.m_bones[m_headIndex].GetWorldBonePosition3D() - skeleton.m_bones[m_bodyIndex].GetWorldBonePosition3D()).GetLength();
+
+	// Every ancestor of an effector (below the hip) gets that effector's bit
+	m_jointEffectorMasks.assign(boneCount, 0);
+	for (int effectorIndex = 0; effectorIndex < FULL_BODY_EFFECTOR_COUNT; ++effectorIndex)
+	{
+		int boneIndex = skeleton.m_bones[m_effectors[effectorIndex].m_boneIndex].m_parentBoneIndex;
+		while (boneIndex >= 0 && boneIndex != m_hipIndex)
+		{
+			m_jointEffectorMasks[boneIndex] |= (1 << effectorIndex);
+			boneIndex = skeleton.m_bones[boneIndex].m_parentBoneIndex;
+		}
+	}
+
+	std::vector<int> jointDepths(boneCount, 0);
+	m_jointOrder.clear();
+	for (int boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		for (int parentIndex = skeleton.m_bones[boneIndex].m_parentBoneIndex; parentIndex >= 0; parentIndex = skeleton.m_bones[parentIndex].m_parentBoneIndex)
+		{
+			++jointDepths[boneIndex];
+		}
+		if (m_jointEffectorMasks[boneIndex] != 0)
+		{
+			m_jointOrder.push_back(boneIndex);
+		}
+	}
+	std::stable_sort(m_jointOrder.begin(), m_jointOrder.end(), [&jointDepths](int a, int b) { return jointDepths[a] > jointDepths[b]; });
+
+	// The torso moves everything above the hip, so it should give way before the limbs do
+	m_jointDamping.assign(boneCount, 1.f);
+	m_jointDamping[m_bodyIndex] = 0.35f;
+}
+
+void FullBodyIK::SetEffector(FullBodyEffectorType type, Vec3 const& target, float weight)
+{
+	m_effectors[type].m_target = target;
+	m_effectors[type].m_weight = weight;
+	m_effectors[type].m_isEnabled = true;
+}
+
+void FullBodyIK::DisableEffector(FullBodyEffectorType type)
+{
+	m_effectors[type].m_isEnabled = false;
+}
+
+FullBodyEffector const& FullBodyIK::GetEffector(FullBodyEffectorType type) const
+{
+	return m_effectors[type];
+}
+
+FullBodyIKStats FullBodyIK::Solve(Skeleton& skeleton) const
+{
+	FullBodyIKStats stats;
+	double startTime = GetCurrentTimeSeconds();
+
+	stats.m_weightedError = ComputeWeightedError(skeleton);
+	while (stats.m_iterations < m_maxIterations && stats.m_weightedError > m_errorThreshold)
+	{
+		// Deepest joints go first, so a joint's own transform and its parent's are still current when
+		// it is solved; only the effectors below it have moved, and those are tracked here. That leaves
+		// one pose update per sweep instead of one per joint.
+		Vec3 effectorPositions[FULL_BODY_EFFECTOR_COUNT];
+		for (int effectorIndex = 0; effectorIndex < FULL_BODY_EFFECTOR_COUNT; ++effectorIndex)
+		{
+			effectorPositions[effectorIndex] = skeleton.m_bones[m_effectors[effectorIndex].m_boneIndex].GetWorldBonePosition3D();
+		}
+		for (int jointIndex : m_jointOrder)
+		{
+			SolveJoint(skeleton, jointIndex, effectorPositions);
+		}
+		skeleton.UpdateSkeletonPose();
+		ShiftHips(skeleton);
+
+		stats.m_weightedError = ComputeWeightedError(skeleton);
+		++stats.m_iterations;
+	}
+	AimHead(skeleton);
+
+	stats.m_solveMicroseconds = (GetCurrentTimeSeconds() - startTime) * 1000000.0;
+	return stats;
+}
+
+float FullBodyIK::ComputeWeightedError(Skeleton const& skeleton) const
+{
+	float errorSum = 0.f;
+	float weightSum = 0.f;
+	for (int effectorIndex = 0; effectorIndex < FULL_BODY_EFFECTOR_COUNT; ++effectorIndex)
+	{
+		FullBodyEffector const& effector = m_effectors[effectorIndex];
+		if (!effector.m_isEnabled)
+		{
+			continue;
+		}
+		Vec3 effectorPosition = skeleton.m_bones[effector.m_boneIndex].GetWorldBonePosition3D();
+		errorSum += (GetEffectiveTarget(skeleton, effectorIndex) - effectorPosition).GetLength() * effector.m_weight;
+		weightSum += effector.m_weight;
+	}
+	return (weightSum > 0.f) ? errorSum / weightSum : 0.f;
+}
+
+Vec3 FullBodyIK::GetEffectiveTarget(Skeleton const& skeleton, int effectorIndex) const
+{
+	FullBodyEffector const& effector = m_effectors[effectorIndex];
+	if (effectorIndex != FULL_BODY_HEAD_LOOK)
+	{
+		return effector.m_target;
+	}
+
+	// Look-at becomes a point one neck length from the body toward the look target
+	Vec3 bodyPosition = skeleton.m_bones[m_bodyIndex].GetWorldBonePosition3D();
+	Vec3 lookDirection = effector.m_target - bodyPosition;
+	if (lookDirection.GetLengthSquared() < 0.00001f)
+	{
+		return skeleton.m_bones[m_headIndex].GetWorldBonePosition3D();
+	}
+	return bodyPosition + lookDirection.GetNormalized() * m_headLength;
+}
+
+void FullBodyIK::SolveJoint(Skeleton& skeleton, int jointIndex, Vec3 (&effectorPositions)[FULL_BODY_EFFECTOR_COUNT]) const
+{
+	Bone& joint = skeleton.m_bones[jointIndex];
+	Vec3 jointPosition = joint.GetWorldBonePosition3D();
+
+	// Weighted average of each effector's CCD rotation, as axis * angle vectors
+	Vec3  weightedRotation = Vec3::ZERO;
+	float weightSum = 0.f;
+	for (int effectorIndex = 0; effectorIndex < FULL_BODY_EFFECTOR_COUNT; ++effectorIndex)
+	{
+		FullBodyEffector const& effector = m_effectors[effectorIndex];
+		if (!effector.m_isEnabled || (m_jointEffectorMasks[jointIndex] & (1 << effectorIndex)) == 0)
+		{
+			continue;
+		}
+
+		Vec3 toEffector = effectorPositions[effectorIndex] - jointPosition;
+		Vec3 toTarget = GetEffectiveTarget(skeleton, effectorIndex) - jointPosition;
+		if (toEffector.GetLengthSquared() < 0.00001f || toTarget.GetLengthSquared() < 0.00001f)
+		{
+			continue;
+		}
+		toEffector.Normalize();
+		toTarget.Normalize();
+
+		float angle = acosf(GetClamped(DotProduct3D(toEffector, toTarget), -1.f, 1.f));
+		Vec3 axis = CrossProduct3D(toEffector, toTarget);
+		if (angle < 0.0001f || axis.GetLengthSquared() < 0.00000001f)
+		{
+			weightSum += effector.m_weight;
+			continue;
+		}
+		weightedRotation += axis.GetNormalized() * (angle * effector.m_weight);
+		weightSum += effector.m_weight;
+	}
+
+	if (weightSum <= 0.f)
+	{
+		return;
+	}
+	Vec3  rotation = weightedRotation * (m_jointDamping[jointIndex] / weightSum);
+	float angle = rotation.GetLength();
+	if (angle < 0.0001f)
+	{
+		return;
+	}
+	Vec3 worldAxis = rotation * (1.f / angle);
+
+	// Local rotations live in the parent's frame, so bring the world axis into it
+	Vec3 localAxis = worldAxis;
+	if (joint.m_parentBoneIndex >= 0)
+	{
+		Mat44 const& parentTransform = skeleton.m_bones[joint.m_parentBoneIndex].m_worldBoneTransform;
+		localAxis = Vec3(DotProduct3D(worldAxis, parentTransform.GetIBasis3D()), DotProduct3D(worldAxis, parentTransform.GetJBasis3D()), DotProduct3D(worldAxis, parentTransform.GetKBasis3D()));
+	}
+
+	joint.SetLocalBoneRotation(Quat::MakeFromAxisAngle(localAxis, angle) * joint.m_localRotation);
+
+	// Swing the effectors below this joint with it; the world transforms catch up after the sweep
+	RotationQuat worldRotation = RotationQuat::MakeFromAxisAngle(worldAxis, angle);
+	for (int effectorIndex = 0; effectorIndex < FULL_BODY_EFFECTOR_COUNT; ++effectorIndex)
+	{
+		if ((m_jointEffectorMasks[jointIndex] & (1 << effectorIndex)) != 0)
+		{
+			effectorPositions[effectorIndex] = jointPosition + worldRotation.Rotate(effectorPositions[effectorIndex] - jointPosition);
+		}
+	}
+}
+
+void FullBodyIK::ShiftHips(Skeleton& skeleton) const
+{
+	// Move the hip by the weighted mean of what the limbs still miss; look-at doesn't pull the body
+	Vec3  weightedOffset = Vec3::ZERO;
+	float weightSum = 0.f;
+	for (int effectorIndex = 0; effectorIndex < FULL_BODY_HEAD_LOOK; ++effectorIndex)
+	{
+		FullBodyEffector const& effector = m_effectors[effectorIndex];
+		if (!effector.m_isEnabled)
+		{
+			continue;
+		}
+		Vec3 effectorPosition = skeleton.m_bones[effector.m_boneIndex].GetWorldBonePosition3D();
+		weightedOffset += (effector.m_target - effectorPosition) * effector.m_weight;
+		weightSum += effector.m_weight;
+	}
+	if (weightSum <= 0.f)
+	{
+		return;
+	}
+
+	Bone& hip = skeleton.m_bones[m_hipIndex];
+	Vec3 hipOffset = hip.m_localPosition - m_restHipPosition + weightedOffset * (m_hipWeight / weightSum);
+	if (hipOffset.GetLengthSquared() > m_maxHipOffset * m_maxHipOffset)
+	{
+		hipOffset = hipOffset.GetNormalized() * m_maxHipOffset;
+	}
+	hip.SetLocalBonePosition(m_restHipPosition + hipOffset);
+	skeleton.UpdateSkeletonPose();
+}
+
+void FullBodyIK::AimHead(Skeleton& skeleton) const
+{
+	FullBodyEffector const& look = m_effectors[FULL_BODY_HEAD_LOOK];
+	if (!look.m_isEnabled)
+	{
+		return;
+	}
+
+	Bone& head = skeleton.m_bones[m_headIndex];
+	Vec3 lookDirection = look.m_target - head.GetWorldBonePosition3D();
+	if (lookDirection.GetLengthSquared() < 0.00001f)
+	{
+		return;
+	}
+
+	// Head forward is its local x axis, expressed in the body's frame
+	Mat44 const& bodyTransform = skeleton.m_bones[m_bodyIndex].m_worldBoneTransform;
+	Vec3 localDirection = Vec3(DotProduct3D(lookDirection, bodyTransform.GetIBasis3D()), DotProduct3D(lookDirection, bodyTransform.GetJBasis3D()), DotProduct3D(lookDirection, bodyTransform.GetKBasis3D()));
+	head.SetLocalBoneRotation(Quat::MakeRotationFromTwoVectors(Vec3::XAXE, localDirection.GetNormalized()));
+	skeleton.UpdateSkeletonPose();
+}
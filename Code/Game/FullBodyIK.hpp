@@ -0,0 +1,67 @@
+#pragma once
+#include "Engine/Skeleton/Skeleton.hpp"
+#include "Engine/Math/Vec3.h"
+#include <vector>
+// -----------------------------------------------------------------------------
+enum FullBodyEffectorType
+{
+	FULL_BODY_LEFT_HAND,
+	FULL_BODY_RIGHT_HAND,
+	FULL_BODY_LEFT_FOOT,
+	FULL_BODY_RIGHT_FOOT,
+	FULL_BODY_HEAD_LOOK,
+	FULL_BODY_EFFECTOR_COUNT
+};
+// -----------------------------------------------------------------------------
+struct FullBodyEffector
+{
+	int   m_boneIndex = -1;
+	Vec3  m_target = Vec3::ZERO;
+	float m_weight = 1.f;
+	bool  m_isEnabled = false;
+};
+// -----------------------------------------------------------------------------
+struct FullBodyIKStats
+{
+	int	   m_iterations = 0;
+	float  m_weightedError = 0.f;
+	double m_solveMicroseconds = 0.0;
+};
+// -----------------------------------------------------------------------------
+// Weighted multi-effector CCD for Game3D's test mannequin. Every joint rotates toward the
+// weighted average of the effectors below it, and the hip translates to take up what the
+// limbs can't reach, so hands, feet and head are solved together instead of in turn.
+class FullBodyIK
+{
+public:
+	void Initialize(Skeleton const& skeleton);
+	void SetEffector(FullBodyEffectorType type, Vec3 const& target, float weight = 1.f);
+	void DisableEffector(FullBodyEffectorType type);
+	FullBodyEffector const& GetEffector(FullBodyEffectorType type) const;
+
+	FullBodyIKStats Solve(Skeleton& skeleton) const;
+	float ComputeWeightedError(Skeleton const& skeleton) const;
+	Vec3  GetEffectiveTarget(Skeleton const& skeleton, int effectorIndex) const;
+
+public:
+	int   m_maxIterations = 16;
+	float m_errorThreshold = 0.005f;
+	float m_hipWeight = 0.5f;
+	float m_maxHipOffset = 0.75f;
+
+private:
+	void SolveJoint(Skeleton& skeleton, int jointIndex, Vec3 (&effectorPositions)[FULL_BODY_EFFECTOR_COUNT]) const;
+	void ShiftHips(Skeleton& skeleton) const;
+	void AimHead(Skeleton& skeleton) const;
+
+private:
+	FullBodyEffector m_effectors[FULL_BODY_EFFECTOR_COUNT];
+	std::vector<int> m_jointOrder;			// Deepest joints first
+	std::vector<int> m_jointEffectorMasks;	// Per bone, bit per effector that the bone moves
+	std::vector<float> m_jointDamping;
+	int   m_hipIndex = 0;
+	int   m_bodyIndex = -1;
+	int   m_headIndex = -1;
+	float m_headLength = 1.f;
+	Vec3  m_restHipPosition = Vec3::ZERO;
+};
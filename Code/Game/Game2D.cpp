@@ -72,25 +72,25 @@ Skeleton Game2D::CreateTestSkeleton2D()
 	Bone root;
 	root.m_boneName = "Root";
 	root.IsRootBone();
-	skeleton.m_bones.push_back(root);
+	skeleton.m_bones.push_back(std::move(root));
 
 	Bone childBone1;
 	childBone1.m_boneName = "Upper";
 	childBone1.m_parentBoneIndex = 0;
 	childBone1.m_localPosition = Vec3(200.f, 100.f, 0.f);
-	skeleton.m_bones.push_back(childBone1);
+	skeleton.m_bones.push_back(std::move(childBone1));
 
 	Bone childBone2;
 	childBone2.m_boneName = "Lower";
 	childBone2.m_parentBoneIndex = 1;
 	childBone2.m_localPosition = Vec3(400.f, 100.f, 0.f);
-	skeleton.m_bones.push_back(childBone2);
+	skeleton.m_bones.push_back(std::move(childBone2));
 
 	Bone childBone3;
 	childBone3.m_boneName = "End";
 	childBone3.m_parentBoneIndex = 2;
 	childBone3.m_localPosition = Vec3(600.f, -50.f, 0.f);
-	skeleton.m_bones.push_back(childBone3);
+	skeleton.m_bones.push_back(std::move(childBone3));
 
 	skeleton.UpdateSkeletonPose();
 	return skeleton;
@@ -98,14 +98,13 @@ Skeleton Game2D::CreateTestSkeleton2D()
 
 void Game2D::AnimateSkeleton(float deltaSeconds)
 {
-	static float elapsedTime = 0.f;
-	elapsedTime += deltaSeconds;
+	m_animationTime += deltaSeconds;
 
 	Bone* lowerControl = m_skeleton.GetBoneByName("Upper");
 	Bone* lowerArm = m_skeleton.GetBoneByName("Lower");
 
-	float swingAngleDegreesUpper = SmoothStep3(0.5f) * elapsedTime;
-	float swingAngleDegreesLower = SmoothStop5(0.5f) * elapsedTime;
+	float swingAngleDegreesUpper = SmoothStep3(0.5f) * m_animationTime;
+	float swingAngleDegreesLower = SmoothStop5(0.5f) * m_animationTime;
 
 	Quat upperArmRotation = Quat::MakeFromAxisAngle(Vec3::ZAXE, swingAngleDegreesUpper);
 	Quat lowerArmRotation = Quat::MakeFromAxisAngle(Vec3::ZAXE, -swingAngleDegreesLower);
@@ -38,5 +38,6 @@ private:
 	std::vector<Vertex_PCU> m_skeletonVerts;
 	Skeleton m_skeleton;
 	SkeletonStyle m_skeletonStyle;
+	float m_animationTime = 0.f;
 	ConstraintMode m_constraintMode = ConstraintMode::FREE;
 };
\ No newline at end of file
@@ -1,8 +1,12 @@
 #include "Game/Game3D.hpp"
 #include "Game/App.h"
+#include "Game/RigAsset.hpp"
+#include "Game/AllocationCounter.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Core/DebugRender.hpp"
 #include "Engine/Input/InputSystem.h"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
 
 Game3D::Game3D(App* owner)
 	:Game(owner)
@@ -19,12 +23,24 @@ void Game3D::StartUp()
 	m_font->AddVertsForTextInBox2D(m_textVerts, "Mode (F6/F7 for Prev/Next): Two-Bone IK Test (3D)", m_gameSceneBounds, 17.5f, Rgba8::ALICEBLUE, 0.8f, Vec2(0.35f, 0.965f));
 	m_font->AddVertsForTextInBox2D(m_textVerts, "[1] Switch Arms", m_gameSceneBounds, 17.5f, Rgba8::ALICEBLUE, 0.8f, Vec2(0.258f, 0.925f));
 	m_font->AddVertsForTextInBox2D(m_textVerts, "[2] Switch IK on/off, off animates freely", m_gameSceneBounds, 17.5f, Rgba8::ALICEBLUE, 0.8f, Vec2(0.35f, 0.9f));
+	m_font->AddVertsForTextInBox2D(m_textVerts, "[3] Toggle full-body IK (hands, feet, head, hips)", m_gameSceneBounds, 17.5f, Rgba8::ALICEBLUE, 0.8f, Vec2(0.375f, 0.875f));
+	m_font->AddVertsForTextInBox2D(m_textVerts, "[4] Compare full-body vs sequential solves", m_gameSceneBounds, 17.5f, Rgba8::ALICEBLUE, 0.8f, Vec2(0.355f, 0.85f));
 
 	// Initialize skeleton
 	m_skeleton = CreateTestSkeleton();
+	m_boneTable.Build(m_skeleton);
+	m_leftShoulderIndex = m_boneTable.FindBoneIndex("LShoulder");
+	m_rightShoulderIndex = m_boneTable.FindBoneIndex("RShoulder");
 	m_skeleton.AddVertsForSkeleton3D(m_skeletonVerts);
 	float yPosition = SCREEN_SIZE_Y - 30.f;
 	m_skeleton.AddVertsForBoneHierarchy(m_textVerts, *m_font, yPosition);
+
+	// Full-body IK keeps the feet and the idle hand where the rest pose put them
+	m_fullBodyIK.Initialize(m_skeleton);
+	m_restHandPositions[0] = m_skeleton.m_bones[m_boneTable.FindBoneIndex("LHand")].GetWorldBonePosition3D();
+	m_restHandPositions[1] = m_skeleton.m_bones[m_boneTable.FindBoneIndex("RHand")].GetWorldBonePosition3D();
+	m_restFootPositions[0] = m_skeleton.m_bones[m_boneTable.FindBoneIndex("LFoot")].GetWorldBonePosition3D();
+	m_restFootPositions[1] = m_skeleton.m_bones[m_boneTable.FindBoneIndex("RFoot")].GetWorldBonePosition3D();
 }
 
 void Game3D::Update()
@@ -39,10 +55,22 @@ void Game3D::Update()
 	{
 		m_isAnimatingFreely = !m_isAnimatingFreely;
 	}
+	if (g_theInput->WasKeyJustPressed('3'))
+	{
+		m_isFullBodyIKEnabled = !m_isFullBodyIKEnabled;
+	}
+	if (g_theInput->WasKeyJustPressed('4'))
+	{
+		CompareFullBodyAgainstSequential();
+	}
 
 	TargetPosKeyPresses(deltaSeconds);
 
-	if (!m_isAnimatingFreely)
+	if (!m_isAnimatingFreely && m_isFullBodyIKEnabled)
+	{
+		SolveFullBody();
+	}
+	else if (!m_isAnimatingFreely)
 	{
 		ToggleArms();
 	}
@@ -89,6 +117,99 @@ void Game3D::ToggleArms()
 	}
 }
 
+void Game3D::UpdateFullBodyEffectors()
+{
+	FullBodyEffectorType activeHand = m_rightHandSelected ? FULL_BODY_RIGHT_HAND : FULL_BODY_LEFT_HAND;
+	FullBodyEffectorType idleHand = m_rightHandSelected ? FULL_BODY_LEFT_HAND : FULL_BODY_RIGHT_HAND;
+	m_fullBodyIK.SetEffector(activeHand, m_targetPos, 1.f);
+	m_fullBodyIK.SetEffector(idleHand, m_restHandPositions[idleHand == FULL_BODY_RIGHT_HAND ? 1 : 0], 0.25f);
+	m_fullBodyIK.SetEffector(FULL_BODY_LEFT_FOOT, m_restFootPositions[0], 1.f);
+	m_fullBodyIK.SetEffector(FULL_BODY_RIGHT_FOOT, m_restFootPositions[1], 1.f);
+	m_fullBodyIK.SetEffector(FULL_BODY_HEAD_LOOK, m_targetPos, 0.3f);
+}
+
+void Game3D::SolveFullBody()
+{
+	UpdateFullBodyEffectors();
+	m_fullBodyStats = m_fullBodyIK.Solve(m_skeleton);
+
+	for (int effectorIndex = 0; effectorIndex < FULL_BODY_HEAD_LOOK; ++effectorIndex)
+	{
+		FullBodyEffector const& effector = m_fullBodyIK.GetEffector(static_cast<FullBodyEffectorType>(effectorIndex));
+		DebugAddWorldSphere(effector.m_target, 0.15f, 0.f, Rgba8::RED, Rgba8::RED);
+	}
+	std::string statsText = Stringf("Full-body IK: %d iterations, error %.4f, %.1fus", m_fullBodyStats.m_iterations, m_fullBodyStats.m_weightedError, m_fullBodyStats.m_solveMicroseconds);
+	DebugAddScreenText(statsText, AABB2(0.f, 0.f, SCREEN_SIZE_X, SCREEN_SIZE_Y), 15.f, Vec2(0.98f, 0.94f), 0.f);
+
+	if (g_theInput->WasKeyJustPressed('1'))
+	{
+		m_rightHandSelected = !m_rightHandSelected;
+	}
+}
+
+void Game3D::CompareFullBodyAgainstSequential()
+{
+	// Both solvers start every run from the rest pose with the targets SolveFullBody uses
+	constexpr int RUN_COUNT = 500;
+	constexpr int MAX_SEQUENTIAL_PASSES = 16;
+
+	Skeleton const restPose = CreateTestSkeleton();
+	UpdateFullBodyEffectors();
+	FullBodyIK const& fullBodyIK = m_fullBodyIK;
+	Vec3 handTargets[2] = { fullBodyIK.GetEffector(FULL_BODY_LEFT_HAND).m_target, fullBodyIK.GetEffector(FULL_BODY_RIGHT_HAND).m_target };
+	Vec3 footTargets[2] = { fullBodyIK.GetEffector(FULL_BODY_LEFT_FOOT).m_target, fullBodyIK.GetEffector(FULL_BODY_RIGHT_FOOT).m_target };
+	Vec3 lookTarget = fullBodyIK.GetEffector(FULL_BODY_HEAD_LOOK).m_target;
+
+	// Skeleton assignment reuses the bone storage, so anything counted here comes from the solver
+	Skeleton skeleton = restPose;
+	double fullBodyMicroseconds = 0.0;
+	FullBodyIKStats fullBodyStats;
+	ScopedAllocationCount fullBodyAllocations;
+	for (int runIndex = 0; runIndex < RUN_COUNT; ++runIndex)
+	{
+		skeleton = restPose;
+		fullBodyStats = fullBodyIK.Solve(skeleton);
+		fullBodyMicroseconds += fullBodyStats.m_solveMicroseconds;
+	}
+	uint64_t fullBodyAllocationCount = fullBodyAllocations.GetAllocationCount();
+
+	// Sequential: the two-bone arms, then CCD for each leg and the neck, repeated until the error settles
+	double sequentialMicroseconds = 0.0;
+	int sequentialPasses = 0;
+	float sequentialError = 0.f;
+	ScopedAllocationCount sequentialAllocations;
+	for (int runIndex = 0; runIndex < RUN_COUNT; ++runIndex)
+	{
+		skeleton = restPose;
+		double startTime = GetCurrentTimeSeconds();
+		for (sequentialPasses = 0; sequentialPasses < MAX_SEQUENTIAL_PASSES; ++sequentialPasses)
+		{
+			skeleton.SolveTwoBoneIK(8, 10, 11, handTargets[1]);
+			skeleton.SolveTwoBoneIK(7, 9, 12, handTargets[0]);
+			skeleton.SolveCCDIK({ 1, 2 }, footTargets[0]);
+			skeleton.SolveCCDIK({ 3, 5 }, footTargets[1]);
+			skeleton.SolveCCDIK({ 4, 6 }, fullBodyIK.GetEffectiveTarget(skeleton, FULL_BODY_HEAD_LOOK));
+			sequentialError = fullBodyIK.ComputeWeightedError(skeleton);
+			if (sequentialError <= fullBodyIK.m_errorThreshold)
+			{
+				++sequentialPasses;
+				break;
+			}
+		}
+		sequentialMicroseconds += (GetCurrentTimeSeconds() - startTime) * 1000000.0;
+	}
+	uint64_t sequentialAllocationCount = sequentialAllocations.GetAllocationCount();
+
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Full-body vs sequential IK, %d runs from rest pose, look target (%.2f, %.2f, %.2f)", RUN_COUNT, lookTarget.x, lookTarget.y, lookTarget.z));
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  Full-body : %6.2fus/solve, %2d iterations, weighted error %.4f", fullBodyMicroseconds / RUN_COUNT, fullBodyStats.m_iterations, fullBodyStats.m_weightedError));
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  Sequential: %6.2fus/solve, %2d passes,     weighted error %.4f", sequentialMicroseconds / RUN_COUNT, sequentialPasses, sequentialError));
+	if (AllocationCounter::IsTracking())
+	{
+		g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  Allocations per solve: full-body %.2f, sequential %.2f",
+			static_cast<double>(fullBodyAllocationCount) / RUN_COUNT, static_cast<double>(sequentialAllocationCount) / RUN_COUNT));
+	}
+}
+
 void Game3D::TargetPosKeyPresses(double deltaSeconds)
 {
 	if (g_theInput->IsKeyDown('I'))
@@ -142,95 +263,99 @@ void Game3D::Shutdown()
 Skeleton Game3D::CreateTestSkeleton()
 {
 	Skeleton skeleton;
+	if (RigAsset::LoadSkeleton("Mannequin", skeleton))
+	{
+		return skeleton;
+	}
 	skeleton.m_bones.clear();
 
 	Bone root;
 	root.m_boneName = "Root/Hip";
 	root.SetLocalBonePosition(Vec3::ZAXE);
-	skeleton.m_bones.push_back(root);
+	skeleton.m_bones.push_back(std::move(root));
 
 	Bone childBone1;
 	childBone1.m_boneName = "LLeg";
 	childBone1.m_parentBoneIndex = 0;
 	childBone1.SetLocalBonePosition(Vec3(0.f, 1.f, -0.5f));
-	skeleton.m_bones.push_back(childBone1);
+	skeleton.m_bones.push_back(std::move(childBone1));
 	skeleton.m_bones[0].m_childBoneIndices.push_back(1);
 
 	Bone childBone2;
 	childBone2.m_boneName = "LFoot";
 	childBone2.m_parentBoneIndex = 1;
 	childBone2.SetLocalBonePosition(-Vec3::ZAXE);
-	skeleton.m_bones.push_back(childBone2);
+	skeleton.m_bones.push_back(std::move(childBone2));
 	skeleton.m_bones[1].m_childBoneIndices.push_back(2);
 
 	Bone childBone3;
 	childBone3.m_boneName = "RLeg";
 	childBone3.m_parentBoneIndex = 0;
 	childBone3.SetLocalBonePosition(Vec3(0.f, -1.f, -0.5f));
-	skeleton.m_bones.push_back(childBone3);
+	skeleton.m_bones.push_back(std::move(childBone3));
 	skeleton.m_bones[0].m_childBoneIndices.push_back(3);
 
 	Bone childBone4;
 	childBone4.m_boneName = "Body";
 	childBone4.m_parentBoneIndex = 0;
 	childBone4.SetLocalBonePosition(Vec3(0.f, 0.f, 3.f));
-	skeleton.m_bones.push_back(childBone4);
+	skeleton.m_bones.push_back(std::move(childBone4));
 	skeleton.m_bones[0].m_childBoneIndices.push_back(4);
 
 	Bone childBone5;
 	childBone5.m_boneName = "RFoot";
 	childBone5.m_parentBoneIndex = 3;
 	childBone5.SetLocalBonePosition(-Vec3::ZAXE);
-	skeleton.m_bones.push_back(childBone5);
+	skeleton.m_bones.push_back(std::move(childBone5));
 	skeleton.m_bones[3].m_childBoneIndices.push_back(5);
 
 	Bone childBone6;
 	childBone6.m_boneName = "Head";
 	childBone6.m_parentBoneIndex = 4;
 	childBone6.SetLocalBonePosition(Vec3::ZAXE);
-	skeleton.m_bones.push_back(childBone6);
+	skeleton.m_bones.push_back(std::move(childBone6));
 	skeleton.m_bones[4].m_childBoneIndices.push_back(6);
 
 	Bone childBone7;
 	childBone7.m_boneName = "LShoulder";
 	childBone7.m_parentBoneIndex = 4;
 	childBone7.SetLocalBonePosition(Vec3::YAXE);
-	skeleton.m_bones.push_back(childBone7);
+	skeleton.m_bones.push_back(std::move(childBone7));
 	skeleton.m_bones[4].m_childBoneIndices.push_back(7);
 
 	Bone childBone8;
 	childBone8.m_boneName = "RShoulder";
 	childBone8.m_parentBoneIndex = 4;
 	childBone8.SetLocalBonePosition(-Vec3::YAXE);
-	skeleton.m_bones.push_back(childBone8);
+	skeleton.m_bones.push_back(std::move(childBone8));
 	skeleton.m_bones[4].m_childBoneIndices.push_back(8);
 
 	Bone childBone9;
 	childBone9.m_boneName = "LArm";
 	childBone9.m_parentBoneIndex = 7;
 	childBone9.SetLocalBonePosition(Vec3(0.f, 0.5f, -1.f));
-	skeleton.m_bones.push_back(childBone9);
+	skeleton.m_bones.push_back(std::move(childBone9));
 	skeleton.m_bones[7].m_childBoneIndices.push_back(9);
 
 	Bone childBone10;
 	childBone10.m_boneName = "RArm";
 	childBone10.m_parentBoneIndex = 8;
 	childBone10.SetLocalBonePosition(Vec3(0.f, -0.5f, -1.f));
-	skeleton.m_bones.push_back(childBone10);
+	skeleton.m_bones.push_back(std::move(childBone10));
 	skeleton.m_bones[8].m_childBoneIndices.push_back(10);
 
 	Bone childBone11;
 	childBone11.m_boneName = "RHand";
 	childBone11.m_parentBoneIndex = 10;
 	childBone11.SetLocalBonePosition(Vec3(0.f, -0.5f, -0.5f));
-	skeleton.m_bones.push_back(childBone11);
+	skeleton.m_bones.push_back(std::move(childBone11));
 	skeleton.m_bones[10].m_childBoneIndices.push_back(11);
 
 	Bone childBone12;
 	childBone12.m_boneName = "LHand";
 	childBone12.m_parentBoneIndex = 9;
 	childBone12.SetLocalBonePosition(Vec3(0.f, 0.5f, -0.5f));
-	skeleton.m_bones.push_back(childBone12);
+	skeleton.m_bones.push_back(std::move(childBone12));
 	skeleton.m_bones[9].m_childBoneIndices.push_back(12);
 
 	skeleton.UpdateSkeletonPose();
@@ -240,19 +365,18 @@ Skeleton Game3D::CreateTestSkeleton()
 
 void Game3D::AnimateSkeleton(float deltaSeconds)
 {
-	static float elapsedTime = 0.f;
-	elapsedTime += deltaSeconds;
+	m_animationTime += deltaSeconds;
 
-	Bone* leftShoulder = m_skeleton.GetBoneByName("LShoulder");
-	Bone* rightShoulder = m_skeleton.GetBoneByName("RShoulder");
+	Bone& leftShoulder = m_skeleton.m_bones[m_leftShoulderIndex];
+	Bone& rightShoulder = m_skeleton.m_bones[m_rightShoulderIndex];
 
-	float swingAngleDegrees = 2.f * sinf(elapsedTime);
+	float swingAngleDegrees = 2.f * sinf(m_animationTime);
 
 	Quat leftArmRotation = Quat::MakeFromAxisAngle(Vec3::XAXE, swingAngleDegrees);
 	Quat rightArmRotation = Quat::MakeFromAxisAngle(Vec3::XAXE, -swingAngleDegrees);
 
-	leftShoulder->SetLocalBoneRotation(leftArmRotation);
-	rightShoulder->SetLocalBoneRotation(rightArmRotation);
+	leftShoulder.SetLocalBoneRotation(leftArmRotation);
+	rightShoulder.SetLocalBoneRotation(rightArmRotation);
 
 	m_skeleton.UpdateSkeletonPose();
 
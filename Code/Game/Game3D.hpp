@@ -1,5 +1,7 @@
 #pragma once
 #include "Game/Game.h"
+#include "Game/FullBodyIK.hpp"
+#include "Game/SkeletonBoneTable.hpp"
 // -----------------------------------------------------------------------------
 class App;
 // -----------------------------------------------------------------------------
@@ -12,6 +14,9 @@ public:
 	void Update() override;
 
 	void ToggleArms();
+	void UpdateFullBodyEffectors();
+	void SolveFullBody();
+	void CompareFullBodyAgainstSequential();
 
 	void Render() const override;
 	void Shutdown() override;
@@ -34,8 +39,19 @@ private:
 	std::vector<Vertex_PCU> m_skeletonVerts;
 	std::vector<Vertex_PCU> m_textVerts;
 	Skeleton m_skeleton;
+	SkeletonBoneTable m_boneTable;
+	int m_leftShoulderIndex = -1;
+	int m_rightShoulderIndex = -1;
+	float m_animationTime = 0.f;
 
 	Vec3 m_targetPos = Vec3(-1.5f, -2.f, 3.f);
 	bool m_rightHandSelected = true;
 	bool m_isAnimatingFreely = false;
+
+	// Full-body IK
+	FullBodyIK m_fullBodyIK;
+	FullBodyIKStats m_fullBodyStats;
+	bool m_isFullBodyIKEnabled = false;
+	Vec3 m_restHandPositions[2];
+	Vec3 m_restFootPositions[2];
 };
\ No newline at end of file
@@ -10,6 +10,11 @@ class Window;
 struct Vec2;
 struct Rgba8;
 // -----------------------------------------------------------------------------
+// SSE2 is baseline on x64 and on x86 built with /arch:SSE2; vectorized loops fall back to scalar without it
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GAME_USE_SSE2
+#endif
+// -----------------------------------------------------------------------------
 constexpr float SCREEN_SIZE_X = 1600.f;
 constexpr float SCREEN_SIZE_Y = 800.f;
 constexpr float SCREEN_CENTER_X = SCREEN_SIZE_X / 2.f;
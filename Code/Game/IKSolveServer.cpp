@@ -0,0 +1,293 @@
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include "Game/IKSolveServer.hpp"
+#include "Game/RoboticArm.hpp"
+#include "Game/RigidTransform.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <cstring>
+
+// On x86/x64 MSVC volatile reads are acquire loads, so spinning on m_sequence needs no fence;
+// the Interlocked write that publishes the results is the matching release
+static_assert(IKSERVER_SLOT_COUNT >= 4, "Slot sequence states t..t+2 must not collide with the next lap");
+
+IKSolveServer::~IKSolveServer()
+{
+	Shutdown();
+}
+
+bool IKSolveServer::Startup(std::string const& mappingName)
+{
+	DWORD mappingSize = static_cast<DWORD>(sizeof(IKServerHeader));
+	m_mappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, mappingSize, mappingName.c_str());
+	if (m_mappingHandle == nullptr)
+	{
+		OutputDebugStringA(Stringf("IKSolveServer: CreateFileMapping failed (%lu)\n", GetLastError()).c_str());
+		return false;
+	}
+	if (GetLastError() == ERROR_ALREADY_EXISTS)
+	{
+		OutputDebugStringA("IKSolveServer: another server already owns this mapping\n");
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = nullptr;
+		return false;
+	}
+
+	m_header = static_cast<IKServerHeader*>(MapViewOfFile(m_mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, mappingSize));
+	if (m_header == nullptr)
+	{
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = nullptr;
+		return false;
+	}
+
+	memset(m_header, 0, sizeof(IKServerHeader));
+	m_header->m_magic = IKSERVER_MAGIC;
+	m_header->m_version = IKSERVER_VERSION;
+	m_header->m_slotCount = IKSERVER_SLOT_COUNT;
+	m_header->m_maxBatch = IKSERVER_MAX_BATCH;
+	m_header->m_jointCount = IKSERVER_JOINT_COUNT;
+	for (long slotIndex = 0; slotIndex < IKSERVER_SLOT_COUNT; ++slotIndex)
+	{
+		m_header->m_slots[slotIndex].m_sequence = slotIndex;
+		m_header->m_slots[slotIndex].m_abandonedTicket = -1;
+	}
+	m_nextTicket = 0;
+	m_ticketIssuedTicks = 0;
+
+	m_roboticArm = RoboticArmMode::InitializeRoboticArm();
+	m_restRotations.clear();
+	for (Bone const& bone : m_roboticArm.m_bones)
+	{
+		m_restRotations.push_back(bone.m_localRotation);
+	}
+	ResetArmToRestPose();
+
+	InterlockedExchange(&m_header->m_serverState, IKSERVER_STATE_RUNNING);
+	return true;
+}
+
+void IKSolveServer::Run()
+{
+	int spinCount = 0;
+	int yieldCount = 0;
+	while (m_header->m_serverState != IKSERVER_STATE_STOP_REQUESTED)
+	{
+		IKServerSlot& slot = m_header->m_slots[m_nextTicket % IKSERVER_SLOT_COUNT];
+		if (static_cast<unsigned long>(slot.m_sequence) == m_nextTicket + 1)
+		{
+			long ticket = static_cast<long>(m_nextTicket);
+			long doneSequence = static_cast<long>(m_nextTicket + 2);
+			if (slot.m_abandonedTicket != ticket)
+			{
+				SolveSlot(slot);
+			}
+			InterlockedExchange(&slot.m_sequence, doneSequence);
+
+			// The client gave up, so hand the slot to the next lap on its behalf
+			if (slot.m_abandonedTicket == ticket)
+			{
+				InterlockedCompareExchange(&slot.m_sequence, static_cast<long>(m_nextTicket + IKSERVER_SLOT_COUNT), doneSequence);
+			}
+			++m_nextTicket;
+			m_ticketIssuedTicks = 0;
+			spinCount = 0;
+			yieldCount = 0;
+			continue;
+		}
+
+		if (TrySkipStalledTicket(slot))
+		{
+			++m_nextTicket;
+			m_ticketIssuedTicks = 0;
+			continue;
+		}
+
+		// Busy spin first so back to back requests stay in the microsecond range, then back off when idle
+		if (spinCount < IKSERVER_SPINS_BEFORE_YIELD)
+		{
+			++spinCount;
+			YieldProcessor();
+		}
+		else if (yieldCount < IKSERVER_YIELDS_BEFORE_SLEEP)
+		{
+			++yieldCount;
+			SwitchToThread();
+		}
+		else
+		{
+			Sleep(1);
+		}
+	}
+}
+
+void IKSolveServer::Shutdown()
+{
+	if (m_header != nullptr)
+	{
+		InterlockedExchange(&m_header->m_serverState, IKSERVER_STATE_STOPPED);
+		UnmapViewOfFile(m_header);
+		m_header = nullptr;
+	}
+	if (m_mappingHandle != nullptr)
+	{
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = nullptr;
+	}
+}
+
+int IKSolveServer::RunHeadless(char const* commandLine)
+{
+	UNUSED(commandLine);
+
+	IKSolveServer server;
+	if (!server.Startup())
+	{
+		return 1;
+	}
+	server.Run();
+	server.Shutdown();
+	return 0;
+}
+
+bool IKSolveServer::IsHeadlessRequested(char const* commandLine)
+{
+	return commandLine != nullptr && strstr(commandLine, "-ikserver") != nullptr;
+}
+
+void IKSolveServer::SolveSlot(IKServerSlot& slot)
+{
+	uint32_t targetCount = slot.m_targetCount;
+	if (targetCount > IKSERVER_MAX_BATCH)
+	{
+		targetCount = IKSERVER_MAX_BATCH;
+	}
+
+	if (slot.m_requestFlags & IKSERVER_FLAG_NO_SOLVE)
+	{
+		for (uint32_t targetIndex = 0; targetIndex < targetCount; ++targetIndex)
+		{
+			slot.m_results[targetIndex].m_userData = slot.m_targets[targetIndex].m_userData;
+		}
+		return;
+	}
+
+	int	  maxIterations = (slot.m_maxIterations > 0) ? static_cast<int>(slot.m_maxIterations) : IKSERVER_DEFAULT_MAX_ITERATIONS;
+	float threshold = (slot.m_threshold > 0.f) ? slot.m_threshold : IKSERVER_DEFAULT_THRESHOLD;
+	bool  isConstrained = (slot.m_requestFlags & IKSERVER_FLAG_CONSTRAINED) != 0;
+	bool  isWarmStart = (slot.m_requestFlags & IKSERVER_FLAG_WARM_START) != 0;
+
+	for (uint32_t targetIndex = 0; targetIndex < targetCount; ++targetIndex)
+	{
+		IKServerTarget const& target = slot.m_targets[targetIndex];
+		IKServerJointResult& result = slot.m_results[targetIndex];
+
+		if (!isWarmStart)
+		{
+			ResetArmToRestPose();
+		}
+
+		Vec3 targetPosition(target.m_position[0], target.m_position[1], target.m_position[2]);
+		IKSolveStats stats;
+		if (isConstrained)
+		{
+			stats = RoboticArmMode::SolveCCDIKConstrained(m_roboticArm, m_chainIndices, targetPosition, m_endEffector, maxIterations, threshold);
+		}
+		else
+		{
+			stats = RoboticArmMode::SolveFixedChainCCDIK(m_roboticArm, targetPosition, maxIterations, threshold);
+		}
+
+		WriteJointRotations(result);
+		Vec3 effectorPosition = m_roboticArm.m_bones[m_endEffector].GetWorldBonePosition3D();
+		result.m_effectorPosition[0] = effectorPosition.x;
+		result.m_effectorPosition[1] = effectorPosition.y;
+		result.m_effectorPosition[2] = effectorPosition.z;
+		result.m_residual = stats.m_residual;
+		result.m_iterations = static_cast<uint32_t>(stats.m_iterations);
+		result.m_resultFlags = (stats.m_hasConverged ? IKSERVER_RESULT_CONVERGED : 0u) |
+							   (stats.m_wasUnreachable ? IKSERVER_RESULT_UNREACHABLE : 0u) |
+							   (stats.m_wasInDeadZone ? IKSERVER_RESULT_DEAD_ZONE : 0u);
+		result.m_userData = target.m_userData;
+	}
+}
+
+// Tickets are served strictly in order, so one that was handed out and never submitted would stall
+// every later client. Either its own client took the slot and stopped, or the previous lap's client
+// never released its results; past the deadline the slot goes straight to the next lap.
+bool IKSolveServer::TrySkipStalledTicket(IKServerSlot& slot)
+{
+	if (static_cast<unsigned long>(m_header->m_nextTicket) == m_nextTicket)
+	{
+		// Not handed out yet, the ring is just idle
+		m_ticketIssuedTicks = 0;
+		return false;
+	}
+
+	ULONGLONG nowTicks = GetTickCount64();
+	if (m_ticketIssuedTicks == 0)
+	{
+		m_ticketIssuedTicks = nowTicks;
+		return false;
+	}
+	if (nowTicks - m_ticketIssuedTicks < IKSERVER_TICKET_DEADLINE_MS)
+	{
+		return false;
+	}
+
+	long ticket = static_cast<long>(m_nextTicket);
+	long previousLapDone = static_cast<long>(m_nextTicket - IKSERVER_SLOT_COUNT + 2);
+	long nextLap = static_cast<long>(m_nextTicket + IKSERVER_SLOT_COUNT);
+	if (InterlockedCompareExchange(&slot.m_sequence, nextLap, ticket) == ticket ||
+		InterlockedCompareExchange(&slot.m_sequence, nextLap, previousLapDone) == previousLapDone)
+	{
+		OutputDebugStringA(Stringf("IKSolveServer: skipped ticket %lu, not submitted within %d ms\n", m_nextTicket, IKSERVER_TICKET_DEADLINE_MS).c_str());
+		return true;
+	}
+
+	// Submitted just now; the next pass solves it
+	return false;
+}
+
+void IKSolveServer::ResetArmToRestPose()
+{
+	for (int boneIndex = 0; boneIndex < static_cast<int>(m_restRotations.size()); ++boneIndex)
+	{
+		m_roboticArm.m_bones[boneIndex].SetLocalBoneRotation(m_restRotations[boneIndex]);
+	}
+	m_roboticArm.UpdateSkeletonPose();
+	RoboticArmMode::UpdateClawMidpoint(m_roboticArm, m_endEffector);
+}
+
+void IKSolveServer::WriteJointRotations(IKServerJointResult& result) const
+{
+	int jointCount = static_cast<int>(m_roboticArm.m_bones.size());
+	if (jointCount > IKSERVER_JOINT_COUNT)
+	{
+		jointCount = IKSERVER_JOINT_COUNT;
+	}
+
+	for (int boneIndex = 0; boneIndex < jointCount; ++boneIndex)
+	{
+		Bone const& bone = m_roboticArm.m_bones[boneIndex];
+		Vec3 childBasis[3] = { bone.m_worldBoneTransform.GetIBasis3D(), bone.m_worldBoneTransform.GetJBasis3D(), bone.m_worldBoneTransform.GetKBasis3D() };
+
+		// Local basis = parentRotation^T * childRotation, built from dot products of the world bases
+		if (bone.m_parentBoneIndex >= 0)
+		{
+			Mat44 const& parentTransform = m_roboticArm.m_bones[bone.m_parentBoneIndex].m_worldBoneTransform;
+			Vec3 parentI = parentTransform.GetIBasis3D();
+			Vec3 parentJ = parentTransform.GetJBasis3D();
+			Vec3 parentK = parentTransform.GetKBasis3D();
+			for (Vec3& basis : childBasis)
+			{
+				basis = Vec3(DotProduct3D(parentI, basis), DotProduct3D(parentJ, basis), DotProduct3D(parentK, basis));
+			}
+		}
+
+		RotationQuat localRotation = RotationQuat::MakeFromBasis(childBasis[0], childBasis[1], childBasis[2]);
+		result.m_localRotations[boneIndex][0] = localRotation.x;
+		result.m_localRotations[boneIndex][1] = localRotation.y;
+		result.m_localRotations[boneIndex][2] = localRotation.z;
+		result.m_localRotations[boneIndex][3] = localRotation.w;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Game/IKSolveServerProtocol.h"
+#include "Engine/Skeleton/Skeleton.hpp"
+#include <string>
+#include <vector>
+// -----------------------------------------------------------------------------
+constexpr int	IKSERVER_DEFAULT_MAX_ITERATIONS = 10;
+constexpr float IKSERVER_DEFAULT_THRESHOLD = 0.01f;
+constexpr int	IKSERVER_SPINS_BEFORE_YIELD = 4096;
+constexpr int	IKSERVER_YIELDS_BEFORE_SLEEP = 100000;
+// -----------------------------------------------------------------------------
+// Headless robotic arm solver, started with -ikserver instead of the App.
+// Clients talk to it through the shared memory layout in IKSolveServerProtocol.h
+class IKSolveServer
+{
+public:
+	IKSolveServer() = default;
+	~IKSolveServer();
+
+	bool Startup(std::string const& mappingName = IKSERVER_MAPPING_NAME);
+	void Run();
+	void Shutdown();
+
+	static int	RunHeadless(char const* commandLine);
+	static bool IsHeadlessRequested(char const* commandLine);
+
+private:
+	void SolveSlot(IKServerSlot& slot);
+	bool TrySkipStalledTicket(IKServerSlot& slot);
+	void ResetArmToRestPose();
+	void WriteJointRotations(IKServerJointResult& result) const;
+
+private:
+	void*			m_mappingHandle = nullptr;
+	IKServerHeader* m_header = nullptr;
+	unsigned long	m_nextTicket = 0;
+	unsigned long long m_ticketIssuedTicks = 0;		// When m_nextTicket was first seen handed out, 0 = not yet
+
+	Skeleton		 m_roboticArm;
+	std::vector<Quat> m_restRotations;
+	std::vector<int> m_chainIndices = { 0, 1, 2, 3, 8 };
+	int				 m_endEffector = 8;
+};
@@ -0,0 +1,84 @@
+#pragma once
+// Shared between the game (server side) and Code/IKClient, so this header must stay plain C
+#include <stdint.h>
+// -----------------------------------------------------------------------------
+#define IKSERVER_MAPPING_NAME		"Local\\IKSimsSolveServer"
+#define IKSERVER_MAGIC				0x4B49534Bu	// "KSIK"
+#define IKSERVER_VERSION			3u
+#define IKSERVER_SLOT_COUNT			4			// Must be >= 4, see slot sequence notes below
+#define IKSERVER_MAX_BATCH			1024
+#define IKSERVER_JOINT_COUNT		9			// Every bone of RoboticArmMode's arm
+#define IKSERVER_TICKET_DEADLINE_MS	2000		// A ticket handed out but not submitted within this long is skipped
+// -----------------------------------------------------------------------------
+// Server lifetime, written by the server except for STOP_REQUESTED
+#define IKSERVER_STATE_STARTING			0
+#define IKSERVER_STATE_RUNNING			1
+#define IKSERVER_STATE_STOP_REQUESTED	2
+#define IKSERVER_STATE_STOPPED			3
+// -----------------------------------------------------------------------------
+// Request flags
+#define IKSERVER_FLAG_CONSTRAINED	0x1u	// Use the constrained solver with its dead zone
+#define IKSERVER_FLAG_WARM_START	0x2u	// Start each target from the previous solution instead of the rest pose
+#define IKSERVER_FLAG_NO_SOLVE		0x4u	// Round trip only, used to measure transport latency
+// -----------------------------------------------------------------------------
+// Per target result flags
+#define IKSERVER_RESULT_CONVERGED	0x1u
+#define IKSERVER_RESULT_UNREACHABLE	0x2u
+#define IKSERVER_RESULT_DEAD_ZONE	0x4u
+// -----------------------------------------------------------------------------
+typedef struct IKServerTarget
+{
+	float	 m_position[3];
+	uint32_t m_userData;		// Echoed back untouched
+} IKServerTarget;
+// -----------------------------------------------------------------------------
+typedef struct IKServerJointResult
+{
+	float	 m_localRotations[IKSERVER_JOINT_COUNT][4];	// x, y, z, w relative to the parent bone
+	float	 m_effectorPosition[3];
+	float	 m_residual;
+	uint32_t m_iterations;
+	uint32_t m_resultFlags;
+	uint32_t m_userData;
+	uint32_t m_padding;
+} IKServerJointResult;
+// -----------------------------------------------------------------------------
+// Slot handshake (lock-free, any number of clients, one server):
+//   A client takes ticket t = InterlockedIncrement(&m_nextTicket) - 1 and uses slot t % IKSERVER_SLOT_COUNT.
+//   m_sequence == t       slot is free for ticket t; client fills targets in place
+//   m_sequence == t + 1   client published the request
+//   m_sequence == t + 2   server published the results; client reads them in place
+//   m_sequence == t + N   client released the slot for the next lap
+// A client that gives up waiting stores t in m_abandonedTicket. Whichever side sees both the
+// abandon and t + 2 releases the slot, so a timed out client never wedges the ring.
+// A client that dies before submitting can't say so. Once ticket t has been handed out for
+// IKSERVER_TICKET_DEADLINE_MS without reaching t + 1, the server moves the slot from t (or from
+// the previous lap's unreleased t - N + 2) straight to t + N and goes on to t + 1. Submit and End
+// are compare-exchanges, so a client that comes back late finds its ticket gone and fails.
+// Only equality is ever tested, so the counters are free to wrap.
+typedef struct IKServerSlot
+{
+	volatile long m_sequence;
+	volatile long m_abandonedTicket;	// Starts at -1
+	uint32_t m_requestFlags;
+	uint32_t m_targetCount;
+	uint32_t m_maxIterations;	// 0 = server default
+	float	 m_threshold;		// <= 0 = server default
+	uint8_t	 m_padding[40];		// Keep the handshake on its own cache line
+	IKServerTarget		m_targets[IKSERVER_MAX_BATCH];
+	IKServerJointResult m_results[IKSERVER_MAX_BATCH];
+} IKServerSlot;
+// -----------------------------------------------------------------------------
+typedef struct IKServerHeader
+{
+	uint32_t m_magic;
+	uint32_t m_version;
+	uint32_t m_slotCount;
+	uint32_t m_maxBatch;
+	uint32_t m_jointCount;
+	volatile long m_serverState;
+	uint8_t	 m_padding0[40];
+	volatile long m_nextTicket;
+	uint8_t	 m_padding1[60];
+	IKServerSlot m_slots[IKSERVER_SLOT_COUNT];
+} IKServerHeader;
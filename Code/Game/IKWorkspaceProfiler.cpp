@@ -0,0 +1,459 @@
+#include "Game/IKWorkspaceProfiler.hpp"
+#include "Game/CCDIKTest.hpp"
+#include "Game/FABRIKTest.hpp"
+#include "Game/AllocationCounter.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+constexpr int IK_METRIC_ITERATIONS = 0;
+constexpr int IK_METRIC_RESIDUAL = 1;
+constexpr int IK_METRIC_TIME = 2;
+constexpr int IK_RADIAL_BAND_COUNT = 8;
+
+IKWorkspaceProfiler::IKWorkspaceProfiler(IKWorkspaceConfig const& config)
+	:m_config(config)
+{
+	m_config.m_cellsPerAxis = GetClamped(m_config.m_cellsPerAxis, 2, 128);
+	m_config.m_maxIterations = GetMax(m_config.m_maxIterations, 1);
+
+	Skeleton restPose = CreateRig();
+	if (m_config.m_rig == IKProfileRig::ROBOTIC_ARM || m_config.m_rig == IKProfileRig::ROBOTIC_ARM_CONSTRAINED)
+	{
+		m_chainIndices = { 0, 1, 2, 3, 8 };
+		m_endEffector = 8;
+	}
+	else
+	{
+		for (int boneIndex = 0; boneIndex < static_cast<int>(restPose.m_bones.size()); ++boneIndex)
+		{
+			m_chainIndices.push_back(boneIndex);
+		}
+		m_endEffector = m_chainIndices.back();
+	}
+
+	m_rootPosition = restPose.m_bones[m_chainIndices[0]].GetWorldBonePosition3D();
+	for (int chainIndex = 0; chainIndex < static_cast<int>(m_chainIndices.size()) - 1; ++chainIndex)
+	{
+		Vec3 boneA = restPose.m_bones[m_chainIndices[chainIndex]].GetWorldBonePosition3D();
+		Vec3 boneB = restPose.m_bones[m_chainIndices[chainIndex + 1]].GetWorldBonePosition3D();
+		m_chainLength += (boneB - boneA).GetLength();
+	}
+
+	// Sweep a little past full reach so the unreachable shell shows up in the slices
+	float halfExtent = m_chainLength * 1.1f;
+	m_mins = m_rootPosition - Vec3(halfExtent, halfExtent, halfExtent);
+	m_maxs = m_rootPosition + Vec3(halfExtent, halfExtent, halfExtent);
+	if (m_config.m_rig == IKProfileRig::ROBOTIC_ARM || m_config.m_rig == IKProfileRig::ROBOTIC_ARM_CONSTRAINED)
+	{
+		// The arm is bolted to the floor and RoboticArmMode clamps targets to z >= 0
+		m_mins.z = m_rootPosition.z;
+	}
+}
+
+void IKWorkspaceProfiler::Run()
+{
+	int cellsPerAxis = m_config.m_cellsPerAxis;
+	int cellCount = cellsPerAxis * cellsPerAxis * cellsPerAxis;
+	m_cells.assign(cellCount, IKWorkspaceCell());
+
+	m_threadsUsed = m_config.m_threadCount;
+	if (m_threadsUsed <= 0)
+	{
+		m_threadsUsed = static_cast<int>(std::thread::hardware_concurrency());
+	}
+	m_threadsUsed = GetClamped(m_threadsUsed, 1, 64);
+
+	// Workers pull cells off a shared counter; each one owns its own copy of the rig
+	std::atomic<int> nextCellIndex(0);
+	std::atomic<uint64_t> solveAllocations(0);
+	auto worker = [this, &nextCellIndex, &solveAllocations, cellCount]()
+	{
+		Skeleton const restPose = CreateRig();
+		Skeleton rig = restPose;
+		ScopedAllocationCount cellAllocations;
+		for (int cellIndex = nextCellIndex++; cellIndex < cellCount; cellIndex = nextCellIndex++)
+		{
+			SolveCell(rig, restPose, cellIndex);
+		}
+		solveAllocations += cellAllocations.GetAllocationCount();
+	};
+
+	double startTime = GetCurrentTimeSeconds();
+	std::vector<std::thread> threads;
+	for (int threadIndex = 1; threadIndex < m_threadsUsed; ++threadIndex)
+	{
+		threads.emplace_back(worker);
+	}
+	worker();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	m_sweepSeconds = GetCurrentTimeSeconds() - startTime;
+	m_solveAllocations = solveAllocations;
+}
+
+Skeleton IKWorkspaceProfiler::CreateRig() const
+{
+	switch (m_config.m_rig)
+	{
+	case IKProfileRig::CCD_CHAIN:
+		return CCDIKTest::CreateTestChain();
+	case IKProfileRig::FABRIK_CHAIN:
+		return FABRIKTest::CreateTestChain();
+	default:
+	{
+		Skeleton roboticArm = RoboticArmMode::InitializeRoboticArm();
+		RoboticArmMode::UpdateClawMidpoint(roboticArm, 8);
+		return roboticArm;
+	}
+	}
+}
+
+void IKWorkspaceProfiler::SolveCell(Skeleton& rig, Skeleton const& restPose, int cellIndex)
+{
+	// Every cell solves from the rest pose so results don't depend on sweep order
+	rig = restPose;
+	Vec3 target = GetCellCenter(cellIndex);
+	IKWorkspaceCell& cell = m_cells[cellIndex];
+
+	double startTime = GetCurrentTimeSeconds();
+	if (m_config.m_rig == IKProfileRig::ROBOTIC_ARM || m_config.m_rig == IKProfileRig::ROBOTIC_ARM_CONSTRAINED)
+	{
+		IKSolveStats stats;
+		if (m_config.m_rig == IKProfileRig::ROBOTIC_ARM)
+		{
+			stats = RoboticArmMode::SolveCCDIK(rig, m_chainIndices, target, m_endEffector, m_config.m_maxIterations, m_config.m_threshold);
+		}
+		else
+		{
+			stats = RoboticArmMode::SolveCCDIKConstrained(rig, m_chainIndices, target, m_endEffector, m_config.m_maxIterations, m_config.m_threshold, m_config.m_deadZoneRadius);
+		}
+		cell.m_iterations = static_cast<float>(stats.m_iterations);
+		cell.m_residual = stats.m_residual;
+		cell.m_flags |= stats.m_hasConverged ? IK_CELL_CONVERGED : 0;
+		cell.m_flags |= stats.m_wasUnreachable ? IK_CELL_UNREACHABLE : 0;
+		cell.m_flags |= stats.m_wasInDeadZone ? IK_CELL_DEAD_ZONE : 0;
+	}
+	else
+	{
+		// The engine solvers run one pass per call, so count calls until the chain settles
+		int iterations = 0;
+		float residual = 0.f;
+		while (iterations < m_config.m_maxIterations)
+		{
+			if (m_config.m_rig == IKProfileRig::CCD_CHAIN)
+			{
+				rig.SolveCCDIK(m_chainIndices, target);
+			}
+			else
+			{
+				rig.SolveFABRIK(m_chainIndices, target);
+			}
+			++iterations;
+
+			residual = (rig.m_bones[m_endEffector].GetWorldBonePosition3D() - target).GetLength();
+			if (residual <= m_config.m_threshold)
+			{
+				cell.m_flags |= IK_CELL_CONVERGED;
+				break;
+			}
+		}
+		cell.m_iterations = static_cast<float>(iterations);
+		cell.m_residual = residual;
+		if ((target - m_rootPosition).GetLength() > m_chainLength)
+		{
+			cell.m_flags |= IK_CELL_UNREACHABLE;
+		}
+	}
+	cell.m_microseconds = static_cast<float>((GetCurrentTimeSeconds() - startTime) * 1000000.0);
+
+	if (static_cast<int>(cell.m_iterations) >= m_config.m_maxIterations && (cell.m_flags & IK_CELL_CONVERGED) == 0)
+	{
+		cell.m_flags |= IK_CELL_HIT_MAX;
+	}
+}
+
+Vec3 IKWorkspaceProfiler::GetCellCenter(int cellIndex) const
+{
+	int cellsPerAxis = m_config.m_cellsPerAxis;
+	int x = cellIndex % cellsPerAxis;
+	int y = (cellIndex / cellsPerAxis) % cellsPerAxis;
+	int z = cellIndex / (cellsPerAxis * cellsPerAxis);
+
+	Vec3 cellSize = (m_maxs - m_mins) * (1.f / static_cast<float>(cellsPerAxis));
+	return m_mins + Vec3(cellSize.x * (x + 0.5f), cellSize.y * (y + 0.5f), cellSize.z * (z + 0.5f));
+}
+
+bool IKWorkspaceProfiler::WriteSlices(std::string const& directory) const
+{
+	std::string basePath = directory + "/" + m_config.m_outputName;
+	bool success = WriteSlicePPM(basePath + "_iterations.ppm", IK_METRIC_ITERATIONS);
+	success = WriteSlicePPM(basePath + "_residual.ppm", IK_METRIC_RESIDUAL) && success;
+	success = WriteSlicePPM(basePath + "_time.ppm", IK_METRIC_TIME) && success;
+	return success;
+}
+
+bool IKWorkspaceProfiler::WriteSlicePPM(std::string const& filePath, int metric) const
+{
+	// Z slices are tiled left to right, bottom to top, one heat map per slice
+	int cellsPerAxis = m_config.m_cellsPerAxis;
+	int pixelsPerCell = (cellsPerAxis <= 32) ? 4 : 2;
+	int gutter = 2;
+	int tilesPerRow = static_cast<int>(ceilf(sqrtf(static_cast<float>(cellsPerAxis))));
+	int tileRows = (cellsPerAxis + tilesPerRow - 1) / tilesPerRow;
+	int tileSize = cellsPerAxis * pixelsPerCell;
+	int width = tilesPerRow * (tileSize + gutter) + gutter;
+	int height = tileRows * (tileSize + gutter) + gutter;
+
+	// Time is normalized to the 99th percentile so a few preempted cells don't wash out the map
+	float timeScale = 1.f;
+	if (metric == IK_METRIC_TIME)
+	{
+		std::vector<float> times;
+		times.reserve(m_cells.size());
+		for (IKWorkspaceCell const& cell : m_cells)
+		{
+			times.push_back(cell.m_microseconds);
+		}
+		size_t percentileIndex = (times.size() * 99) / 100;
+		std::nth_element(times.begin(), times.begin() + percentileIndex, times.end());
+		timeScale = GetMax(times[percentileIndex], 0.001f);
+	}
+	float logThreshold = log10f(GetMax(m_config.m_threshold, 0.0001f));
+	float logChainLength = log10f(GetMax(m_chainLength, 0.001f));
+
+	std::vector<unsigned char> pixels(width * height * 3, 0);
+	for (int cellIndex = 0; cellIndex < static_cast<int>(m_cells.size()); ++cellIndex)
+	{
+		IKWorkspaceCell const& cell = m_cells[cellIndex];
+		int x = cellIndex % cellsPerAxis;
+		int y = (cellIndex / cellsPerAxis) % cellsPerAxis;
+		int z = cellIndex / (cellsPerAxis * cellsPerAxis);
+
+		float heat = 0.f;
+		if (metric == IK_METRIC_ITERATIONS)
+		{
+			heat = cell.m_iterations / static_cast<float>(m_config.m_maxIterations);
+		}
+		else if (metric == IK_METRIC_RESIDUAL)
+		{
+			heat = RangeMapClamped(log10f(GetMax(cell.m_residual, 0.00001f)), logThreshold, logChainLength, 0.f, 1.f);
+		}
+		else
+		{
+			heat = GetClamped(cell.m_microseconds / timeScale, 0.f, 1.f);
+		}
+
+		// Blue -> green -> red ramp, dead zone in magenta, out of reach darkened
+		float red = GetClamped(heat * 2.f - 1.f, 0.f, 1.f);
+		float green = 1.f - fabsf(heat * 2.f - 1.f);
+		float blue = GetClamped(1.f - heat * 2.f, 0.f, 1.f);
+		if (cell.m_flags & IK_CELL_DEAD_ZONE)
+		{
+			red = 1.f;
+			green = 0.f;
+			blue = 1.f;
+		}
+		if (cell.m_flags & IK_CELL_UNREACHABLE)
+		{
+			red *= 0.35f;
+			green *= 0.35f;
+			blue *= 0.35f;
+		}
+
+		int tileX = z % tilesPerRow;
+		int tileY = z / tilesPerRow;
+		int originX = gutter + tileX * (tileSize + gutter) + x * pixelsPerCell;
+		int originY = gutter + tileY * (tileSize + gutter) + y * pixelsPerCell;
+		for (int pixelY = originY; pixelY < originY + pixelsPerCell; ++pixelY)
+		{
+			// PPM rows run top to bottom, world y runs up
+			int row = height - 1 - pixelY;
+			for (int pixelX = originX; pixelX < originX + pixelsPerCell; ++pixelX)
+			{
+				unsigned char* pixel = &pixels[(row * width + pixelX) * 3];
+				pixel[0] = static_cast<unsigned char>(red * 255.f);
+				pixel[1] = static_cast<unsigned char>(green * 255.f);
+				pixel[2] = static_cast<unsigned char>(blue * 255.f);
+			}
+		}
+	}
+
+	std::ofstream file(filePath, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	std::string header = Stringf("P6\n%d %d\n255\n", width, height);
+	file.write(header.data(), header.size());
+	file.write(reinterpret_cast<char const*>(pixels.data()), pixels.size());
+	return file.good();
+}
+
+bool IKWorkspaceProfiler::WriteVolume(std::string const& directory) const
+{
+	IKWorkspaceVolumeHeader header;
+	header.m_rig = static_cast<uint32_t>(m_config.m_rig);
+	header.m_cellsPerAxis = static_cast<uint32_t>(m_config.m_cellsPerAxis);
+	header.m_mins[0] = m_mins.x;
+	header.m_mins[1] = m_mins.y;
+	header.m_mins[2] = m_mins.z;
+	header.m_maxs[0] = m_maxs.x;
+	header.m_maxs[1] = m_maxs.y;
+	header.m_maxs[2] = m_maxs.z;
+	header.m_rootPosition[0] = m_rootPosition.x;
+	header.m_rootPosition[1] = m_rootPosition.y;
+	header.m_rootPosition[2] = m_rootPosition.z;
+	header.m_maxIterations = static_cast<uint32_t>(m_config.m_maxIterations);
+	header.m_threshold = m_config.m_threshold;
+	header.m_deadZoneRadius = m_config.m_deadZoneRadius;
+
+	std::ofstream file(directory + "/" + m_config.m_outputName + ".ikvol", std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+	file.write(reinterpret_cast<char const*>(m_cells.data()), m_cells.size() * sizeof(IKWorkspaceCell));
+	return file.good();
+}
+
+void IKWorkspaceProfiler::PrintSummary() const
+{
+	struct RadialBand
+	{
+		int	   m_cellCount = 0;
+		int	   m_convergedCount = 0;
+		int	   m_deadZoneCount = 0;
+		int	   m_hitMaxCount = 0;
+		double m_iterationSum = 0.0;
+		double m_residualSum = 0.0;
+		double m_microsecondSum = 0.0;
+	};
+
+	// Bands cover the reachable sphere; anything past full reach lands in the last one
+	float bandWidth = m_chainLength / static_cast<float>(IK_RADIAL_BAND_COUNT);
+	RadialBand bands[IK_RADIAL_BAND_COUNT + 1];
+	RadialBand total;
+	for (int cellIndex = 0; cellIndex < static_cast<int>(m_cells.size()); ++cellIndex)
+	{
+		IKWorkspaceCell const& cell = m_cells[cellIndex];
+		float distance = (GetCellCenter(cellIndex) - m_rootPosition).GetLength();
+		int bandIndex = GetMin(static_cast<int>(distance / bandWidth), IK_RADIAL_BAND_COUNT);
+
+		for (RadialBand* band : { &bands[bandIndex], &total })
+		{
+			band->m_cellCount++;
+			band->m_convergedCount += (cell.m_flags & IK_CELL_CONVERGED) ? 1 : 0;
+			band->m_deadZoneCount += (cell.m_flags & IK_CELL_DEAD_ZONE) ? 1 : 0;
+			band->m_hitMaxCount += (cell.m_flags & IK_CELL_HIT_MAX) ? 1 : 0;
+			band->m_iterationSum += cell.m_iterations;
+			band->m_residualSum += cell.m_residual;
+			band->m_microsecondSum += cell.m_microseconds;
+		}
+	}
+
+	int cellCount = GetMax(total.m_cellCount, 1);
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("IK workspace: %s, %d^3 cells, %d iterations max, threshold %.3f, dead zone %.2f",
+		GetRigName(m_config.m_rig), m_config.m_cellsPerAxis, m_config.m_maxIterations, m_config.m_threshold, m_config.m_deadZoneRadius));
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Sweep: %.2fs on %d threads, %.2fus/cell, converged %.1f%%, hit max %d, mean iterations %.2f, mean residual %.4f",
+		m_sweepSeconds, m_threadsUsed, total.m_microsecondSum / cellCount, 100.0 * total.m_convergedCount / cellCount,
+		total.m_hitMaxCount, total.m_iterationSum / cellCount, total.m_residualSum / cellCount));
+	if (AllocationCounter::IsTracking())
+	{
+		g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Solve allocations: %llu (%.2f/cell)", m_solveAllocations, static_cast<double>(m_solveAllocations) / cellCount));
+	}
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, "  radius       cells  conv%   iters  residual     us  deadzone");
+
+	for (int bandIndex = 0; bandIndex <= IK_RADIAL_BAND_COUNT; ++bandIndex)
+	{
+		RadialBand const& band = bands[bandIndex];
+		if (band.m_cellCount == 0)
+		{
+			continue;
+		}
+		std::string range = (bandIndex < IK_RADIAL_BAND_COUNT) ? Stringf("%5.2f-%5.2f", bandIndex * bandWidth, (bandIndex + 1) * bandWidth) : Stringf("%5.2f+     ", m_chainLength);
+		g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  %s  %6d  %5.1f  %6.2f  %8.4f  %5.1f  %8d", range.c_str(), band.m_cellCount,
+			100.0 * band.m_convergedCount / band.m_cellCount, band.m_iterationSum / band.m_cellCount,
+			band.m_residualSum / band.m_cellCount, band.m_microsecondSum / band.m_cellCount, band.m_deadZoneCount));
+	}
+
+	// Smallest radius past which every reachable band converges; only meaningful when swept with deadzone=0
+	int firstGoodBand = IK_RADIAL_BAND_COUNT;
+	for (int bandIndex = IK_RADIAL_BAND_COUNT - 1; bandIndex >= 0; --bandIndex)
+	{
+		RadialBand const& band = bands[bandIndex];
+		if (band.m_cellCount > 0 && band.m_convergedCount < band.m_cellCount * 95 / 100)
+		{
+			break;
+		}
+		firstGoodBand = bandIndex;
+	}
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Bands converge >= 95%% beyond radius %.2f", firstGoodBand * bandWidth));
+}
+
+char const* IKWorkspaceProfiler::GetRigName(IKProfileRig rig)
+{
+	switch (rig)
+	{
+	case IKProfileRig::ROBOTIC_ARM:				return "arm";
+	case IKProfileRig::ROBOTIC_ARM_CONSTRAINED: return "armc";
+	case IKProfileRig::CCD_CHAIN:				return "ccd";
+	case IKProfileRig::FABRIK_CHAIN:			return "fabrik";
+	default:									return "unknown";
+	}
+}
+
+bool IKWorkspaceProfiler::Command_ProfileIKWorkspace(EventArgs& args)
+{
+	IKWorkspaceConfig config;
+	std::string rigName = args.GetValue("rig", std::string("armc"));
+	config.m_rig = IKProfileRig::COUNT;
+	for (int rigIndex = 0; rigIndex < static_cast<int>(IKProfileRig::COUNT); ++rigIndex)
+	{
+		if (rigName == GetRigName(static_cast<IKProfileRig>(rigIndex)))
+		{
+			config.m_rig = static_cast<IKProfileRig>(rigIndex);
+		}
+	}
+	if (config.m_rig == IKProfileRig::COUNT)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, Stringf("Unknown rig '%s', expected arm, armc, ccd or fabrik", rigName.c_str()));
+		return false;
+	}
+
+	config.m_cellsPerAxis = args.GetValue("cells", config.m_cellsPerAxis);
+	config.m_maxIterations = args.GetValue("iterations", config.m_maxIterations);
+	config.m_threshold = args.GetValue("threshold", config.m_threshold);
+	config.m_deadZoneRadius = args.GetValue("deadzone", ROBOTIC_ARM_DEAD_ZONE_RADIUS);
+	config.m_threadCount = args.GetValue("threads", config.m_threadCount);
+	config.m_outputName = args.GetValue("out", Stringf("IKWorkspace_%s", rigName.c_str()));
+
+	IKWorkspaceProfiler profiler(config);
+	profiler.Run();
+
+	std::string directory = "Data/Profiles";
+	std::error_code errorCode;
+	std::filesystem::create_directories(directory, errorCode);
+	bool wroteSlices = profiler.WriteSlices(directory);
+	bool wroteVolume = profiler.WriteVolume(directory);
+
+	profiler.PrintSummary();
+	if (!wroteSlices || !wroteVolume)
+	{
+		g_theDevConsole->AddLine(Rgba8::RED, Stringf("Failed to write workspace profile to %s", directory.c_str()));
+		return false;
+	}
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Wrote %s/%s_*.ppm and %s.ikvol", directory.c_str(), config.m_outputName.c_str(), config.m_outputName.c_str()));
+	return true;
+}
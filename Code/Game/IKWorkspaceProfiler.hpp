@@ -0,0 +1,92 @@
+#pragma once
+#include "Game/RoboticArm.hpp"
+#include "Engine/Math/Vec3.h"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Skeleton/Skeleton.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+// -----------------------------------------------------------------------------
+enum class IKProfileRig
+{
+	ROBOTIC_ARM,
+	ROBOTIC_ARM_CONSTRAINED,
+	CCD_CHAIN,
+	FABRIK_CHAIN,
+	COUNT
+};
+// -----------------------------------------------------------------------------
+enum IKCellFlags : uint8_t
+{
+	IK_CELL_CONVERGED	= 1 << 0,
+	IK_CELL_UNREACHABLE = 1 << 1,
+	IK_CELL_DEAD_ZONE	= 1 << 2,
+	IK_CELL_HIT_MAX		= 1 << 3,
+};
+// -----------------------------------------------------------------------------
+struct IKWorkspaceConfig
+{
+	IKProfileRig m_rig = IKProfileRig::ROBOTIC_ARM_CONSTRAINED;
+	int   m_cellsPerAxis = 32;
+	int   m_maxIterations = 10;
+	float m_threshold = 0.01f;
+	float m_deadZoneRadius = ROBOTIC_ARM_DEAD_ZONE_RADIUS;
+	int   m_threadCount = 0;	// 0 = hardware concurrency
+	std::string m_outputName = "IKWorkspace";
+};
+// -----------------------------------------------------------------------------
+struct IKWorkspaceCell
+{
+	float	m_iterations = 0.f;
+	float	m_residual = 0.f;
+	float	m_microseconds = 0.f;
+	uint32_t m_flags = 0;
+};
+// -----------------------------------------------------------------------------
+// Binary volume (.ikvol) layout: header followed by cellsPerAxis^3 IKWorkspaceCells, x fastest then y then z
+struct IKWorkspaceVolumeHeader
+{
+	char	 m_magic[4] = { 'I', 'K', 'W', 'V' };
+	uint32_t m_version = 1;
+	uint32_t m_rig = 0;
+	uint32_t m_cellsPerAxis = 0;
+	float	 m_mins[3] = {};
+	float	 m_maxs[3] = {};
+	float	 m_rootPosition[3] = {};
+	uint32_t m_maxIterations = 0;
+	float	 m_threshold = 0.f;
+	float	 m_deadZoneRadius = 0.f;
+};
+// -----------------------------------------------------------------------------
+class IKWorkspaceProfiler
+{
+public:
+	IKWorkspaceProfiler(IKWorkspaceConfig const& config);
+
+	void Run();
+	bool WriteSlices(std::string const& directory) const;
+	bool WriteVolume(std::string const& directory) const;
+	void PrintSummary() const;
+
+	static bool Command_ProfileIKWorkspace(EventArgs& args);
+	static char const* GetRigName(IKProfileRig rig);
+
+private:
+	Skeleton CreateRig() const;
+	void	 SolveCell(Skeleton& rig, Skeleton const& restPose, int cellIndex);
+	Vec3	 GetCellCenter(int cellIndex) const;
+	bool	 WriteSlicePPM(std::string const& filePath, int metric) const;
+
+private:
+	IKWorkspaceConfig m_config;
+	std::vector<int>  m_chainIndices;
+	int	  m_endEffector = 0;
+	Vec3  m_rootPosition;
+	float m_chainLength = 0.f;
+	Vec3  m_mins;
+	Vec3  m_maxs;
+	std::vector<IKWorkspaceCell> m_cells;
+	double m_sweepSeconds = 0.0;
+	uint64_t m_solveAllocations = 0;
+	int	   m_threadsUsed = 0;
+};
@@ -5,6 +5,7 @@
 #include <cassert>
 #include <crtdbg.h>
 #include "App.h"
+#include "Game/IKSolveServer.hpp"
 #include "Engine/Input/InputSystem.h"
 
 extern HDC g_displayDeviceContext;
@@ -13,9 +14,14 @@ extern App* g_theApp;				// Created and owned by Main_Windows.cpp
 //-----------------------------------------------------------------------------------------------
 int WINAPI WinMain(HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR commandLineString, int)
 {
-	UNUSED(commandLineString);
 	UNUSED(applicationInstanceHandle);
 
+	// Headless solve server for external tools; skips the window, renderer and game entirely
+	if (IKSolveServer::IsHeadlessRequested(commandLineString))
+	{
+		return IKSolveServer::RunHeadless(commandLineString);
+	}
+
 	g_theApp = new App();
 	g_theApp->Startup();
 
@@ -1,10 +1,13 @@
 #include "Game/Octopus.hpp"
 #include "Game/GameCommon.h"
 #include "Game/Terrain.hpp"
+#include "Game/FrameProfiler.hpp"
 #include "Game/AnimalMode.hpp"
 #include "Engine/Renderer/Renderer.h"
 #include "Engine/Math/MathUtils.h"
 
+constexpr float OCTOPUS_BOUNDS_PADDING = 1.2f;	// The mantle hangs below the head bone
+
 Octopus::Octopus(AnimalMode* mode, Vec3 position)
 	:Entity(mode, position)
 {
@@ -13,33 +16,56 @@ Octopus::Octopus(AnimalMode* mode, Vec3 position)
 
 Octopus::~Octopus()
 {
+	m_animalMode->m_timerWheel.Cancel(m_directionChangeTimer);
 }
 
 void Octopus::Initialize()
 {
-	m_octopus = CreateOctopusSkeleton();
+	m_definition = &GetSkeletonDefinition();
+	m_pose = m_definition->CreateRestPose();
 
-	m_octopusInitialPositions.clear();
-	for (int octopusBoneIndex = 0; octopusBoneIndex < static_cast<int>(m_octopus.m_bones.size()); ++octopusBoneIndex)
+	m_speed = 1.f;
+	m_boundingRadius = 2.5f;
+	m_directionChangeTimer = m_animalMode->m_timerWheel.Schedule(m_timeToChangeDir, ChangeDirection, this);
+}
+
+void Octopus::Simulate(float deltaSeconds)
+{
+	// While asleep the previous pose already matches the current one
+	if (!m_isAsleep)
 	{
-		Bone& octopusBone = m_octopus.m_bones[octopusBoneIndex];
-		m_octopusInitialPositions.push_back(octopusBone.m_localPosition);
+		m_previousPose = m_pose;
 	}
-
-	m_speed = 1.f;
+	m_isPreviousPoseValid = m_hasSimulated;
+	{
+		ScopedFrameTimer poseTimer(FRAME_SUBSYSTEM_POSE);
+		UpdateOctopusPose(deltaSeconds);
+	}
+	if (m_isAsleep)
+	{
+		return;
+	}
+	UpdateBounds(m_pose, OCTOPUS_BOUNDS_PADDING);
+	m_hasSimulated = true;
 }
 
-void Octopus::Update(float deltaSeconds)
+void Octopus::UpdateMesh(float interpolation)
 {
-	UpdateOctopusPose(deltaSeconds);
+	if (!BeginMeshUpdate())
+	{
+		return;
+	}
+	ScopedFrameTimer vertsTimer(FRAME_SUBSYSTEM_VERTS);
+	m_drawPose.SetInterpolated(m_previousPose, m_pose, m_isPreviousPoseValid ? interpolation : 1.f);
 	UpdateOctopusVerts();
 }
 
 void Octopus::UpdateOctopusPose(float deltaSeconds)
 {
-	static float elapsedTime = 0.f;
-	elapsedTime += deltaSeconds;
-	m_directionChangeTimer += deltaSeconds;
+	if (!m_isParked)
+	{
+		m_animationTime += deltaSeconds;
+	}
 
 	if (!m_isStationary)
 	{
@@ -58,32 +84,39 @@ void Octopus::UpdateOctopusPose(float deltaSeconds)
 		if (!m_animalMode->m_terrain->IsInBounds(static_cast<int>(m_worldPosition.x), static_cast<int>(m_worldPosition.y)))
 		{
 			m_worldPosition = Vec3(85.f, 35.f, m_animalMode->m_terrain->GetHeightAtXY(85.f, 35.f));
-			elapsedTime = 0.f;
+			m_animationTime = 0.f;
+			m_isPreviousPoseValid = false;
 		}
 	}
 
-	float bobbingHeight = sinf(elapsedTime * 2.f) * 0.5f;
+	if (TrySleep(GetPoseInputs()))
+	{
+		return;
+	}
+
+	float bobbingHeight = sinf(m_animationTime * 2.f) * 0.5f;
 
-	Bone& headBone = m_octopus.m_bones[0];
-	Vec3  baseHeadPos = m_octopusInitialPositions[0];
+	Skeleton& octopus = m_definition->BindPose(m_pose);
+	Bone& headBone = octopus.m_bones[0];
+	Vec3  baseHeadPos = m_definition->GetRestLocalPosition(0);
 	headBone.SetLocalBonePosition(baseHeadPos + Vec3(0.f, 0.f, bobbingHeight));
 
 	float normalizedBobbing = bobbingHeight + 0.5f;
 
 	// Arm curling
-	for (int boneIndex = 1; boneIndex < static_cast<int>(m_octopus.m_bones.size()); ++boneIndex)
+	for (int boneIndex = 1; boneIndex < static_cast<int>(octopus.m_bones.size()); ++boneIndex)
 	{
-		Bone& bone = m_octopus.m_bones[boneIndex];
+		Bone& bone = octopus.m_bones[boneIndex];
 
 		// Positional
-		//Vec3 basePos = m_octopusInitialPositions[boneIndex];
+		//Vec3 basePos = m_definition->GetRestLocalPosition(boneIndex);
 		//float curlAmount = GetClamped(bobbingHeight * 0.75f, -1.f, 1.f);
 		//Vec3  curledPosition = basePos;
 		//curledPosition.z += curlAmount;
 		//bone.SetLocalBonePosition(curledPosition);
 
 		// Rotational
-		float wave = sinf(elapsedTime * 3.f + boneIndex * 0.4f);
+		float wave = sinf(m_animationTime * 3.f + boneIndex * 0.4f);
 		float curlStrength = 0.4f;
 		float curlAngle = wave * curlStrength * normalizedBobbing;
 		Quat curlRotation = Quat::MakeFromAxisAngle(Vec3::ZAXE, curlAngle);
@@ -92,7 +125,7 @@ void Octopus::UpdateOctopusPose(float deltaSeconds)
 
 
 	float offset = 1.f;
-	Terrain* terrain = m_animalMode->m_terrain;
+	Terrain const* terrain = m_animalMode->m_terrain;
 
 	// Get current and neighbor positions
 	float hCenter = terrain->GetHeightAtXY(m_worldPosition.x, m_worldPosition.y);
@@ -115,14 +148,59 @@ void Octopus::UpdateOctopusPose(float deltaSeconds)
 	orientation.SetTranslation3D(m_worldPosition);
 
 	// Apply it to the skeleton
-	m_octopus.m_skeletonModelTransform = orientation;
-	m_octopus.UpdateSkeletonPose();
+	octopus.m_skeletonModelTransform = orientation;
+	octopus.UpdateSkeletonPose();
+	m_definition->StorePose(m_pose);
 }
 
 void Octopus::UpdateOctopusVerts()
 {
+	// Both buffers keep their capacity between frames, so steady-state updates do not allocate
+	m_octoVerts.clear();
+
+	Mat44 const& headTransform = m_drawPose.m_worldTransforms[0];
+	Vec3 headPos = headTransform.GetTranslation3D();
+
+	Vec3 iBasis = headTransform.GetIBasis3D(); 
+	Vec3 jBasis = headTransform.GetJBasis3D();  
+	Vec3 kBasis = headTransform.GetKBasis3D(); 
+
+	int sphereSlices = m_lod.GetSlices(32);
+	int sphereStacks = m_lod.GetStacks(16);
+	int limbSlices = m_lod.GetSlices(8);
+	AddVertsForSphere3D(m_octoVerts, headPos + kBasis * -0.4f, 0.8f, Rgba8(180, 40, 180), AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
+	AddVertsForSphere3D(m_octoVerts, headPos, 0.25f, Rgba8(200, 60, 200), AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
+
+	Vec3 eyeOffset = (iBasis * 0.60f + kBasis * 0.025f);
+	AddVertsForSphere3D(m_octoVerts, headPos + eyeOffset, 0.12f, Rgba8::BLACK, AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
+	AddVertsForSphere3D(m_octoVerts, headPos - eyeOffset, 0.12f, Rgba8::BLACK, AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
+
+	SkeletonBoneTable const& boneTable = m_definition->GetBoneTable();
+	for (int boneIndex = 1; boneIndex < m_drawPose.GetNumBones(); ++boneIndex)
+	{
+		Vec3 start = m_drawPose.GetWorldBonePosition3D(boneIndex);
+
+		Vec3 end = start;
+		int parentIndex = m_definition->GetParentIndex(boneIndex);
+		if (parentIndex >= 0)
+		{
+			end = m_drawPose.GetWorldBonePosition3D(parentIndex);
+		}
+
+		bool isTip = boneTable.HasRole(boneIndex, BONE_ROLE_TIP);
+
+		if (isTip)
+		{
+			AddVertsForCone3D(m_octoVerts, end, start, 0.08f, Rgba8(160, 30, 160), AABB2::ZERO_TO_ONE, limbSlices);
+		}
+		else
+		{
+			AddVertsForCylinder3D(m_octoVerts, end, start, 0.08f, Rgba8(150, 35, 150), AABB2::ZERO_TO_ONE, limbSlices);
+		}
+	}
+
 	m_octoSkeletonVerts.clear();
-	m_octopus.AddVertsForSkeleton3D(m_octoSkeletonVerts);
+	m_definition->BindPose(m_drawPose).AddVertsForSkeleton3D(m_octoSkeletonVerts);
 }
 
 void Octopus::Render() const
@@ -142,17 +220,24 @@ void Octopus::Render() const
 	}
 }
 
+SkeletonDefinition const& Octopus::GetSkeletonDefinition()
+{
+	static SkeletonDefinition const s_octopusDefinition("Octopus", &CreateOctopusSkeleton);
+	return s_octopusDefinition;
+}
+
 Skeleton Octopus::CreateOctopusSkeleton()
 {
 	Skeleton octopusSkeleton;
 	octopusSkeleton.m_bones.clear();
+	octopusSkeleton.m_bones.reserve(1 + NUM_OCTOPUS_ARMS * 3);
 
 	// Central head
 	Bone head;
 	head.m_boneName = "Head";
 	head.SetLocalBonePosition(Vec3::ZERO);
 	head.SetLocalBoneRotation(Quat::MakeFromAxisAngle(Vec3::ZAXE, ConvertDegreesToRadians(90.f)));
-	octopusSkeleton.m_bones.push_back(head);
+	octopusSkeleton.m_bones.push_back(std::move(head));
 
 	// Separating the octopus arms by 45 degrees
 	float angleStep = 360.f / NUM_OCTOPUS_ARMS;
@@ -177,7 +262,7 @@ Skeleton Octopus::CreateOctopusSkeleton()
 		armBase.m_boneName = "Arm" + std::to_string(armIndex + 1) + "_Base";
 		armBase.m_parentBoneIndex = 0;
 		armBase.SetLocalBonePosition(baseOffset * armLength);
-		octopusSkeleton.m_bones.push_back(armBase);
+		octopusSkeleton.m_bones.push_back(std::move(armBase));
 		int baseIndex = static_cast<int>(octopusSkeleton.m_bones.size() - 1);
 
 		// Arm Middle
@@ -185,7 +270,7 @@ Skeleton Octopus::CreateOctopusSkeleton()
 		armMiddle.m_boneName = "Arm" + std::to_string(armIndex + 1) + "_Mid";
 		armMiddle.m_parentBoneIndex = baseIndex;
 		armMiddle.SetLocalBonePosition(middleOffset * armLength);
-		octopusSkeleton.m_bones.push_back(armMiddle);
+		octopusSkeleton.m_bones.push_back(std::move(armMiddle));
 		int middleIndex = static_cast<int>(octopusSkeleton.m_bones.size() - 1);
 
 		// Arm Tip
@@ -193,7 +278,7 @@ Skeleton Octopus::CreateOctopusSkeleton()
 		armTip.m_boneName = "Arm" + std::to_string(armIndex + 1) + "_Tip";
 		armTip.m_parentBoneIndex = middleIndex;
 		armTip.SetLocalBonePosition(tipOffset * armLength);
-		octopusSkeleton.m_bones.push_back(armTip);
+		octopusSkeleton.m_bones.push_back(std::move(armTip));
 	}
 
 	octopusSkeleton.UpdateSkeletonPose();
@@ -202,53 +287,13 @@ Skeleton Octopus::CreateOctopusSkeleton()
 
 void Octopus::DrawOctopus() const
 {
-	std::vector<Vertex_PCU> octoVerts;
-
-	Bone const& head = m_octopus.m_bones[0];
-	Vec3 headPos = head.GetWorldBonePosition3D();
-
-	Vec3 iBasis = head.m_worldBoneTransform.GetIBasis3D(); 
-	Vec3 jBasis = head.m_worldBoneTransform.GetJBasis3D();  
-	Vec3 kBasis = head.m_worldBoneTransform.GetKBasis3D(); 
-
-	AddVertsForSphere3D(octoVerts, headPos + kBasis * -0.4f, 0.8f, Rgba8(180, 40, 180));
-	AddVertsForSphere3D(octoVerts, headPos, 0.25f, Rgba8(200, 60, 200));
-
-	Vec3 eyeOffset = (iBasis * 0.60f + kBasis * 0.025f);
-	AddVertsForSphere3D(octoVerts, headPos + eyeOffset, 0.12f, Rgba8::BLACK);
-	AddVertsForSphere3D(octoVerts, headPos - eyeOffset, 0.12f, Rgba8::BLACK);
-
-	for (int boneIndex = 1; boneIndex < static_cast<int>(m_octopus.m_bones.size()); ++boneIndex)
-	{
-		Bone const& bone = m_octopus.m_bones[boneIndex];
-		Vec3 start = bone.GetWorldBonePosition3D();
-
-		Vec3 end = start;
-		if (bone.m_parentBoneIndex >= 0)
-		{
-			Bone const& parent = m_octopus.m_bones[bone.m_parentBoneIndex];
-			end = parent.GetWorldBonePosition3D();
-		}
-
-		bool isTip = (bone.m_boneName.find("_Tip") != std::string::npos);
-
-		if (isTip)
-		{
-			AddVertsForCone3D(octoVerts, end, start, 0.08f, Rgba8(160, 30, 160));
-		}
-		else
-		{
-			AddVertsForCylinder3D(octoVerts, end, start, 0.08f, Rgba8(150, 35, 150));
-		}
-	}
-
 	g_theRenderer->BindTexture(nullptr);
 	g_theRenderer->SetBlendMode(BlendMode::OPAQUE);
 	g_theRenderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_theRenderer->SetDepthMode(DepthMode::READ_WRITE_LESS_EQUAL);
 	if (m_animalMode->m_isAnimalVertsBeingDrawn)
 	{
-		g_theRenderer->DrawVertexArray(octoVerts);
+		g_theRenderer->DrawVertexArray(m_octoVerts);
 	}
 }
 
@@ -256,26 +301,19 @@ void Octopus::OctopusRoam(float deltaSeconds)
 {
 	if (m_isRoaming)
 	{
-		if (m_directionChangeTimer >= m_timeToChangeDir)
-		{
-			m_directionChangeTimer = 0.f;
-
-			// Picking a new random direction for the octopus to go
-			float angle = g_rng->RollRandomFloatInRange(0.f, 360.f);
-			Vec2 directionXY = Vec2(CosDegrees(angle), SinDegrees(angle));
-			Vec3 newDirection = Vec3(directionXY.x, directionXY.y, 0.f).GetNormalized();
-			m_targetMoveDirection = newDirection;
-			m_directionInterpTime = 0.f;
-		}
-
 		// Smoothly interpolate move direction
-		if (m_moveDirection != m_targetMoveDirection)
-		{
-			m_directionInterpTime += deltaSeconds;
-			float fractionTowardEnd = GetClamped(m_directionInterpTime / m_directionInterpDuration, 0.f, 1.f);
+		UpdateTurn(deltaSeconds);
+	}
+	SteerAwayFromNeighbors(deltaSeconds);
+}
 
-			float easedFraction = SmoothStep3(fractionTowardEnd);
-			m_moveDirection = SLerp(m_moveDirection, m_targetMoveDirection, easedFraction).GetNormalized();
-		}
+void Octopus::ChangeDirection(void* octopus, int payload)
+{
+	UNUSED(payload);
+	Octopus* roamingOctopus = static_cast<Octopus*>(octopus);
+	if (roamingOctopus->m_isRoaming && !roamingOctopus->m_isStationary)
+	{
+		roamingOctopus->TurnTowardRandomDirection();
 	}
+	roamingOctopus->m_directionChangeTimer = roamingOctopus->m_animalMode->m_timerWheel.Schedule(roamingOctopus->m_timeToChangeDir, ChangeDirection, octopus);
 }
\ No newline at end of file
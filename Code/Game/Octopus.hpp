@@ -1,38 +1,42 @@
 #pragma once
 #include "Game/Entity.hpp"
-#include "Engine/Skeleton/Skeleton.hpp"
+#include "Game/SkeletonDefinition.hpp"
 // -----------------------------------------------------------------------------
 class AnimalMode;
 // -----------------------------------------------------------------------------
 constexpr int NUM_OCTOPUS_ARMS = 8;
 // -----------------------------------------------------------------------------
-class Octopus : public Entity
+class Octopus final : public Entity
 {
 public:
 	Octopus(AnimalMode* mode, Vec3 position);
 	~Octopus();
 
 	virtual void Initialize() override;
-	virtual void Update(float deltaSeconds) override;
+	virtual void Simulate(float deltaSeconds) override;
+	virtual void UpdateMesh(float interpolation) override;
 	virtual void Render() const override;
 
+	static SkeletonDefinition const& GetSkeletonDefinition();
+
 private:
-	Skeleton CreateOctopusSkeleton();
+	static Skeleton CreateOctopusSkeleton();
 	void DrawOctopus() const;
 	void OctopusRoam(float deltaSeconds);
+	static void ChangeDirection(void* octopus, int payload);
 	void UpdateOctopusPose(float deltaSeconds);
 	void UpdateOctopusVerts();
 
 private:
-	Skeleton m_octopus;
+	SkeletonDefinition const* m_definition = nullptr;
+	SkeletonPose m_pose;
+	SkeletonPose m_previousPose;
+	SkeletonPose m_drawPose;
+	std::vector<Vertex_PCU> m_octoVerts;
 	std::vector<Vertex_PCU> m_octoSkeletonVerts;
-	std::vector<Vec3> m_octopusInitialPositions;
 
 	// Directional changes
-	Vec3  m_targetMoveDirection = Vec3::XAXE;
-	float m_directionInterpTime = 0.f;
-	float m_directionInterpDuration = 10.f;
-	float m_directionChangeTimer = 0.f;
+	TimerHandle m_directionChangeTimer;
 	float m_timeToChangeDir = 7.f;
 	bool  m_isRoaming = true;
 };
\ No newline at end of file
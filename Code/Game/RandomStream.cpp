@@ -0,0 +1,179 @@
+#include "Game/RandomStream.hpp"
+#include "Game/GameCommon.h"
+
+#if defined(GAME_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"
+	constexpr uint32_t PHILOX_MULTIPLIER_0 = 0xD2511F53u;
+	constexpr uint32_t PHILOX_MULTIPLIER_1 = 0xCD9E8D57u;
+	constexpr uint32_t PHILOX_WEYL_0 = 0x9E3779B9u;
+	constexpr uint32_t PHILOX_WEYL_1 = 0xBB67AE85u;
+	constexpr int      PHILOX_ROUNDS = 10;
+
+	// Top 24 bits, so every result is exactly representable and strictly below one
+	constexpr float UINT_TO_UNIT_FLOAT = 1.f / 16777216.f;
+
+	float GetUnitFloat(uint32_t value)
+	{
+		return static_cast<float>(value >> 8) * UINT_TO_UNIT_FLOAT;
+	}
+
+#if defined(GAME_USE_SSE2)
+	// Four 32x32 multiplies; SSE2 only multiplies the even lanes, so the odd ones are shifted down
+	void MultiplyWide(__m128i values, __m128i multiplier, __m128i& outHigh, __m128i& outLow)
+	{
+		__m128i evenProducts = _mm_mul_epu32(values, multiplier);
+		__m128i oddProducts = _mm_mul_epu32(_mm_srli_epi64(values, 32), multiplier);
+		outLow = _mm_unpacklo_epi32(_mm_shuffle_epi32(evenProducts, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(oddProducts, _MM_SHUFFLE(0, 0, 2, 0)));
+		outHigh = _mm_unpacklo_epi32(_mm_shuffle_epi32(evenProducts, _MM_SHUFFLE(0, 0, 3, 1)), _mm_shuffle_epi32(oddProducts, _MM_SHUFFLE(0, 0, 3, 1)));
+	}
+
+	__m128 GetUnitFloats(__m128i values)
+	{
+		return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(values, 8)), _mm_set1_ps(UINT_TO_UNIT_FLOAT));
+	}
+#endif
+}
+
+RandomStream::RandomStream(uint32_t ownerID, uint32_t purpose, uint64_t frame)
+	:m_frame(frame)
+{
+	m_key[0] = ownerID;
+	m_key[1] = purpose;
+}
+
+void RandomStream::SetFrame(uint64_t frame)
+{
+	if (frame == m_frame)
+	{
+		return;
+	}
+	m_frame = frame;
+	m_nextBlockIndex = 0;
+	m_numBlockValuesUsed = 4;
+}
+
+uint64_t RandomStream::GetFrame() const
+{
+	return m_frame;
+}
+
+uint32_t RandomStream::RollRandomUInt()
+{
+	if (m_numBlockValuesUsed == 4)
+	{
+		RefillBlock();
+	}
+	return m_block[m_numBlockValuesUsed++];
+}
+
+float RandomStream::RollRandomFloatZeroToOne()
+{
+	return GetUnitFloat(RollRandomUInt());
+}
+
+float RandomStream::RollRandomFloatInRange(float minInclusive, float maxInclusive)
+{
+	return minInclusive + (maxInclusive - minInclusive) * RollRandomFloatZeroToOne();
+}
+
+// Multiply-shift rather than modulo; the bias over these small ranges is far below a part in a million
+int RandomStream::RollRandomIntInRange(int minInclusive, int maxInclusive)
+{
+	uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(maxInclusive) - minInclusive + 1);
+	return minInclusive + static_cast<int>((static_cast<uint64_t>(RollRandomUInt()) * range) >> 32);
+}
+
+void RandomStream::FillRandomFloatsInRange(float* outValues, int count, float minInclusive, float maxInclusive)
+{
+	float range = maxInclusive - minInclusive;
+	int valueIndex = 0;
+
+	// Finish the block already started so the sequence matches single draws
+	while (valueIndex < count && m_numBlockValuesUsed < 4)
+	{
+		outValues[valueIndex++] = minInclusive + range * GetUnitFloat(m_block[m_numBlockValuesUsed++]);
+	}
+
+#if defined(GAME_USE_SSE2)
+	// Four blocks side by side, one per lane, then transposed so each block's values land together
+	__m128i const multiplier0 = _mm_set1_epi32(static_cast<int>(PHILOX_MULTIPLIER_0));
+	__m128i const multiplier1 = _mm_set1_epi32(static_cast<int>(PHILOX_MULTIPLIER_1));
+	__m128 const minimums = _mm_set1_ps(minInclusive);
+	__m128 const ranges = _mm_set1_ps(range);
+	for (; count - valueIndex >= 16; valueIndex += 16)
+	{
+		__m128i counter0 = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(m_nextBlockIndex)), _mm_setr_epi32(0, 1, 2, 3));
+		__m128i counter1 = _mm_setzero_si128();
+		__m128i counter2 = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(m_frame)));
+		__m128i counter3 = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(m_frame >> 32)));
+		uint32_t key0 = m_key[0];
+		uint32_t key1 = m_key[1];
+		for (int round = 0; round < PHILOX_ROUNDS; ++round)
+		{
+			__m128i high0, low0, high1, low1;
+			MultiplyWide(counter0, multiplier0, high0, low0);
+			MultiplyWide(counter2, multiplier1, high1, low1);
+			counter0 = _mm_xor_si128(_mm_xor_si128(high1, counter1), _mm_set1_epi32(static_cast<int>(key0)));
+			counter1 = low1;
+			counter2 = _mm_xor_si128(_mm_xor_si128(high0, counter3), _mm_set1_epi32(static_cast<int>(key1)));
+			counter3 = low0;
+			key0 += PHILOX_WEYL_0;
+			key1 += PHILOX_WEYL_1;
+		}
+		m_nextBlockIndex += 4;
+
+		__m128 values0 = _mm_add_ps(minimums, _mm_mul_ps(ranges, GetUnitFloats(counter0)));
+		__m128 values1 = _mm_add_ps(minimums, _mm_mul_ps(ranges, GetUnitFloats(counter1)));
+		__m128 values2 = _mm_add_ps(minimums, _mm_mul_ps(ranges, GetUnitFloats(counter2)));
+		__m128 values3 = _mm_add_ps(minimums, _mm_mul_ps(ranges, GetUnitFloats(counter3)));
+		_MM_TRANSPOSE4_PS(values0, values1, values2, values3);
+		_mm_storeu_ps(outValues + valueIndex, values0);
+		_mm_storeu_ps(outValues + valueIndex + 4, values1);
+		_mm_storeu_ps(outValues + valueIndex + 8, values2);
+		_mm_storeu_ps(outValues + valueIndex + 12, values3);
+	}
+#endif
+
+	for (; valueIndex < count; ++valueIndex)
+	{
+		outValues[valueIndex] = minInclusive + range * RollRandomFloatZeroToOne();
+	}
+}
+
+void RandomStream::GenerateBlock(uint32_t const counter[4], uint32_t const key[2], uint32_t outBlock[4])
+{
+	uint32_t counter0 = counter[0];
+	uint32_t counter1 = counter[1];
+	uint32_t counter2 = counter[2];
+	uint32_t counter3 = counter[3];
+	uint32_t key0 = key[0];
+	uint32_t key1 = key[1];
+	for (int round = 0; round < PHILOX_ROUNDS; ++round)
+	{
+		uint64_t product0 = static_cast<uint64_t>(PHILOX_MULTIPLIER_0) * counter0;
+		uint64_t product1 = static_cast<uint64_t>(PHILOX_MULTIPLIER_1) * counter2;
+		counter0 = static_cast<uint32_t>(product1 >> 32) ^ counter1 ^ key0;
+		counter1 = static_cast<uint32_t>(product1);
+		counter2 = static_cast<uint32_t>(product0 >> 32) ^ counter3 ^ key1;
+		counter3 = static_cast<uint32_t>(product0);
+		key0 += PHILOX_WEYL_0;
+		key1 += PHILOX_WEYL_1;
+	}
+	outBlock[0] = counter0;
+	outBlock[1] = counter1;
+	outBlock[2] = counter2;
+	outBlock[3] = counter3;
+}
+
+void RandomStream::RefillBlock()
+{
+	uint32_t counter[4] = { m_nextBlockIndex, 0u, static_cast<uint32_t>(m_frame), static_cast<uint32_t>(m_frame >> 32) };
+	GenerateBlock(counter, m_key, m_block);
+	++m_nextBlockIndex;
+	m_numBlockValuesUsed = 0;
+}
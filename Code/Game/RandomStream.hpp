@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+// -----------------------------------------------------------------------------
+// Which draws a stream is for; two streams of one owner never overlap
+enum RandomStreamPurpose : uint32_t
+{
+	RANDOM_STREAM_GAMEPLAY,
+	RANDOM_STREAM_HAIR,
+	RANDOM_STREAM_BEHAVIOR,
+};
+// -----------------------------------------------------------------------------
+// Counter-based generator (Philox4x32-10). Each block of four numbers is a pure function of the
+// key (owner ID, purpose) and the counter (frame, block index), so a stream holds no shared
+// state: an entity can draw from its own stream on any thread, and what it gets depends only on
+// which frame it is and how many numbers it has already drawn that frame, never on update order.
+class RandomStream
+{
+public:
+	RandomStream() = default;
+	explicit RandomStream(uint32_t ownerID, uint32_t purpose = RANDOM_STREAM_GAMEPLAY, uint64_t frame = 0);
+
+	// Restarts the draws for a new frame; a no-op when already on that frame
+	void SetFrame(uint64_t frame);
+	uint64_t GetFrame() const;
+
+	uint32_t RollRandomUInt();
+	float RollRandomFloatZeroToOne();
+	float RollRandomFloatInRange(float minInclusive, float maxInclusive);
+	int   RollRandomIntInRange(int minInclusive, int maxInclusive);
+
+	// Same numbers, in the same order, as that many RollRandomFloatInRange calls; whole blocks are
+	// generated four at a time
+	void FillRandomFloatsInRange(float* outValues, int count, float minInclusive, float maxInclusive);
+
+	static void GenerateBlock(uint32_t const counter[4], uint32_t const key[2], uint32_t outBlock[4]);
+
+private:
+	void RefillBlock();
+
+private:
+	uint32_t m_key[2] = {};
+	uint64_t m_frame = 0;
+	uint32_t m_nextBlockIndex = 0;
+	uint32_t m_block[4] = {};
+	int      m_numBlockValuesUsed = 4;
+};
@@ -0,0 +1,643 @@
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include "Game/RigAsset.hpp"
+#include "Game/SkeletonBoneTable.hpp"
+#include "Game/SkeletonDefinition.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+static_assert(sizeof(Vec3) == 3 * sizeof(float), "Rest positions are read straight out of the file as Vec3");
+static_assert(sizeof(RigFileRotation) == 16, "RigFileRotation layout is part of the file format");
+static_assert(sizeof(RigFileConstraint) == 28, "RigFileConstraint layout is part of the file format");
+
+namespace
+{
+	constexpr uint32_t RIG_SECTION_ALIGNMENT = 16;
+
+	struct RigRoleName
+	{
+		char const*  m_name;
+		unsigned int m_role;
+	};
+
+	RigRoleName const ROLE_NAMES[] =
+	{
+		{ "ROOT",		BONE_ROLE_ROOT },
+		{ "HEAD",		BONE_ROLE_HEAD },
+		{ "BODY",		BONE_ROLE_BODY },
+		{ "ABDOMEN",	BONE_ROLE_ABDOMEN },
+		{ "FEMUR",		BONE_ROLE_FEMUR },
+		{ "TIBIA",		BONE_ROLE_TIBIA },
+		{ "METATARSUS", BONE_ROLE_METATARSUS },
+		{ "TARSUS",		BONE_ROLE_TARSUS },
+		{ "SHOULDER",	BONE_ROLE_SHOULDER },
+		{ "HAND",		BONE_ROLE_HAND },
+		{ "FOOT",		BONE_ROLE_FOOT },
+		{ "TIP",		BONE_ROLE_TIP },
+		{ "LEFT",		BONE_ROLE_LEFT },
+		{ "RIGHT",		BONE_ROLE_RIGHT },
+		{ "LEAF",		BONE_ROLE_LEAF },
+	};
+
+	struct RigTextBone
+	{
+		std::string		  m_name;
+		int32_t			  m_parentIndex = -1;
+		uint32_t		  m_roles = BONE_ROLE_NONE;
+		bool			  m_hasExplicitRoles = false;
+		float			  m_position[3] = {};
+		RigFileRotation	  m_rotation;
+		RigFileConstraint m_constraint;
+		uint8_t			  m_flags = 0;
+	};
+
+	uint32_t AlignOffset(uint32_t offset)
+	{
+		return (offset + RIG_SECTION_ALIGNMENT - 1) & ~(RIG_SECTION_ALIGNMENT - 1);
+	}
+
+	std::vector<std::string> SplitOnDelimiter(std::string const& text, char delimiter)
+	{
+		std::vector<std::string> parts;
+		std::istringstream stream(text);
+		std::string part;
+		while (std::getline(stream, part, delimiter))
+		{
+			parts.push_back(part);
+		}
+		return parts;
+	}
+
+	bool ParseFloats(std::string const& text, float* out_values, int count)
+	{
+		std::vector<std::string> parts = SplitOnDelimiter(text, ',');
+		if (static_cast<int>(parts.size()) != count)
+		{
+			return false;
+		}
+		for (int valueIndex = 0; valueIndex < count; ++valueIndex)
+		{
+			out_values[valueIndex] = static_cast<float>(atof(parts[valueIndex].c_str()));
+		}
+		return true;
+	}
+
+	bool ParseConstraintType(std::string const& text, uint8_t& out_type)
+	{
+		if (text == "free")		{ out_type = static_cast<uint8_t>(CONSTRAINT_TYPE::FREE);	 return true; }
+		if (text == "limited")	{ out_type = static_cast<uint8_t>(CONSTRAINT_TYPE::LIMITED); return true; }
+		if (text == "locked")	{ out_type = static_cast<uint8_t>(CONSTRAINT_TYPE::LOCKED);	 return true; }
+		return false;
+	}
+
+	bool ParseRoles(std::string const& text, uint32_t& out_roles)
+	{
+		out_roles = BONE_ROLE_NONE;
+		std::vector<std::string> parts = SplitOnDelimiter(text, '|');
+		for (std::string const& part : parts)
+		{
+			bool isKnown = false;
+			for (RigRoleName const& roleName : ROLE_NAMES)
+			{
+				if (part == roleName.m_name)
+				{
+					out_roles |= roleName.m_role;
+					isKnown = true;
+				}
+			}
+			if (!isKnown)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool ParseBoneLine(std::istringstream& tokens, std::vector<RigTextBone> const& bones, RigTextBone& out_bone, std::string& errorMessage)
+	{
+		std::string parentName;
+		if (!(tokens >> out_bone.m_name >> parentName >> out_bone.m_position[0] >> out_bone.m_position[1] >> out_bone.m_position[2]))
+		{
+			errorMessage = "expected: bone <name> <parent|-> <x> <y> <z>";
+			return false;
+		}
+
+		if (parentName != "-")
+		{
+			for (int boneIndex = 0; boneIndex < static_cast<int>(bones.size()); ++boneIndex)
+			{
+				if (bones[boneIndex].m_name == parentName)
+				{
+					out_bone.m_parentIndex = boneIndex;
+					break;
+				}
+			}
+			if (out_bone.m_parentIndex < 0)
+			{
+				errorMessage = Stringf("parent '%s' must be declared before '%s'", parentName.c_str(), out_bone.m_name.c_str());
+				return false;
+			}
+		}
+
+		std::string option;
+		while (tokens >> option)
+		{
+			size_t equalsIndex = option.find('=');
+			std::string key = option.substr(0, equalsIndex);
+			std::string value = (equalsIndex == std::string::npos) ? "" : option.substr(equalsIndex + 1);
+
+			bool isValid = true;
+			if (key == "hidden")
+			{
+				out_bone.m_flags |= RIG_BONE_HIDDEN;
+			}
+			else if (key == "rot")
+			{
+				float rotation[4] = {};
+				isValid = ParseFloats(value, rotation, 4);
+				memcpy(out_bone.m_rotation.m_axis, rotation, sizeof(out_bone.m_rotation.m_axis));
+				out_bone.m_rotation.m_degrees = rotation[3];
+			}
+			else if (key == "roles")
+			{
+				isValid = ParseRoles(value, out_bone.m_roles);
+				out_bone.m_hasExplicitRoles = true;
+			}
+			else if (key == "constraint")
+			{
+				std::vector<std::string> types = SplitOnDelimiter(value, ',');
+				isValid = (types.size() == 3);
+				for (int axisIndex = 0; isValid && axisIndex < 3; ++axisIndex)
+				{
+					isValid = ParseConstraintType(types[axisIndex], out_bone.m_constraint.m_types[axisIndex]);
+				}
+			}
+			else if (key == "min")
+			{
+				isValid = ParseFloats(value, out_bone.m_constraint.m_minDegrees, 3);
+			}
+			else if (key == "max")
+			{
+				isValid = ParseFloats(value, out_bone.m_constraint.m_maxDegrees, 3);
+			}
+			else
+			{
+				isValid = false;
+			}
+
+			if (!isValid)
+			{
+				errorMessage = Stringf("bad option '%s' on bone '%s'", option.c_str(), out_bone.m_name.c_str());
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool IsSectionInRange(uint32_t offset, size_t sectionSize, size_t fileSize)
+	{
+		return (offset % RIG_SECTION_ALIGNMENT) == 0 && offset <= fileSize && sectionSize <= fileSize - offset;
+	}
+
+	// Rigs LoadSkeleton has mapped; the profiler's workers can load concurrently
+	std::mutex s_rigCacheMutex;
+	std::map<std::string, std::unique_ptr<RigAsset>> s_rigCache;
+}
+
+RigAsset::~RigAsset()
+{
+	Unload();
+}
+
+bool RigAsset::Load(std::string const& binaryPath)
+{
+	Unload();
+
+	HANDLE fileHandle = CreateFileA(binaryPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	// The mapping keeps its own reference to the file, so the handle is not needed past here
+	LARGE_INTEGER fileSize;
+	bool hasHeader = GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart >= static_cast<long long>(sizeof(RigFileHeader));
+	if (hasHeader)
+	{
+		m_size = static_cast<size_t>(fileSize.QuadPart);
+		m_mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+	CloseHandle(fileHandle);
+	if (m_mappingHandle == nullptr)
+	{
+		Unload();
+		return false;
+	}
+
+	m_data = static_cast<uint8_t const*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (m_data == nullptr)
+	{
+		Unload();
+		return false;
+	}
+
+	// Validate once up front so the accessors never have to
+	RigFileHeader const* header = reinterpret_cast<RigFileHeader const*>(m_data);
+	size_t boneCount = header->m_boneCount;
+	bool isValid = memcmp(header->m_magic, "RIGB", 4) == 0 && header->m_version == RIG_FILE_VERSION && header->m_fileSize == m_size;
+	isValid = isValid && IsSectionInRange(header->m_parentOffset, boneCount * sizeof(int32_t), m_size);
+	isValid = isValid && IsSectionInRange(header->m_roleOffset, boneCount * sizeof(uint32_t), m_size);
+	isValid = isValid && IsSectionInRange(header->m_restPositionOffset, boneCount * sizeof(Vec3), m_size);
+	isValid = isValid && IsSectionInRange(header->m_restRotationOffset, boneCount * sizeof(RigFileRotation), m_size);
+	isValid = isValid && IsSectionInRange(header->m_constraintOffset, boneCount * sizeof(RigFileConstraint), m_size);
+	isValid = isValid && IsSectionInRange(header->m_flagsOffset, boneCount, m_size);
+	isValid = isValid && IsSectionInRange(header->m_nameIndexOffset, (boneCount + 1) * sizeof(uint32_t), m_size);
+	isValid = isValid && header->m_nameBlobOffset <= m_size && header->m_rigName[RIG_FILE_MAX_NAME - 1] == '\0';
+	if (isValid)
+	{
+		m_header = header;
+		int32_t const* parentIndices = GetParentIndices();
+		uint32_t const* nameIndices = GetSection<uint32_t>(header->m_nameIndexOffset);
+		size_t nameBlobSize = m_size - header->m_nameBlobOffset;
+		for (size_t boneIndex = 0; isValid && boneIndex < boneCount; ++boneIndex)
+		{
+			isValid = parentIndices[boneIndex] < static_cast<int32_t>(boneIndex) && parentIndices[boneIndex] >= -1;
+			isValid = isValid && nameIndices[boneIndex] < nameIndices[boneIndex + 1] && nameIndices[boneIndex + 1] <= nameBlobSize;
+			isValid = isValid && m_data[header->m_nameBlobOffset + nameIndices[boneIndex + 1] - 1] == '\0';
+		}
+	}
+
+	if (!isValid)
+	{
+		OutputDebugStringA(Stringf("RigAsset: '%s' is not a valid version %u rig\n", binaryPath.c_str(), RIG_FILE_VERSION).c_str());
+		Unload();
+		return false;
+	}
+	return true;
+}
+
+bool RigAsset::LoadOrCook(std::string const& textPath, std::string const& binaryPath)
+{
+	Unload();
+
+	std::error_code error;
+	bool hasText = std::filesystem::exists(textPath, error);
+	bool hasBinary = std::filesystem::exists(binaryPath, error);
+	if (hasText && (!hasBinary || std::filesystem::last_write_time(binaryPath, error) < std::filesystem::last_write_time(textPath, error)))
+	{
+		std::string errorMessage;
+		if (!ConvertTextToBinary(textPath, binaryPath, errorMessage))
+		{
+			OutputDebugStringA(Stringf("RigAsset: %s\n", errorMessage.c_str()).c_str());
+			return false;
+		}
+	}
+	return Load(binaryPath);
+}
+
+void RigAsset::Unload()
+{
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+		m_data = nullptr;
+	}
+	if (m_mappingHandle)
+	{
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = nullptr;
+	}
+	m_header = nullptr;
+	m_size = 0;
+}
+
+bool RigAsset::IsLoaded() const
+{
+	return m_header != nullptr;
+}
+
+char const* RigAsset::GetRigName() const
+{
+	return m_header->m_rigName;
+}
+
+int RigAsset::GetNumBones() const
+{
+	return m_header ? static_cast<int>(m_header->m_boneCount) : 0;
+}
+
+size_t RigAsset::GetSizeBytes() const
+{
+	return m_size;
+}
+
+int32_t const* RigAsset::GetParentIndices() const
+{
+	return GetSection<int32_t>(m_header->m_parentOffset);
+}
+
+uint32_t const* RigAsset::GetRoles() const
+{
+	return GetSection<uint32_t>(m_header->m_roleOffset);
+}
+
+Vec3 const* RigAsset::GetRestPositions() const
+{
+	return GetSection<Vec3>(m_header->m_restPositionOffset);
+}
+
+RigFileRotation const* RigAsset::GetRestRotations() const
+{
+	return GetSection<RigFileRotation>(m_header->m_restRotationOffset);
+}
+
+RigFileConstraint const* RigAsset::GetConstraints() const
+{
+	return GetSection<RigFileConstraint>(m_header->m_constraintOffset);
+}
+
+uint8_t const* RigAsset::GetFlags() const
+{
+	return GetSection<uint8_t>(m_header->m_flagsOffset);
+}
+
+char const* RigAsset::GetBoneName(int boneIndex) const
+{
+	uint32_t const* nameIndices = GetSection<uint32_t>(m_header->m_nameIndexOffset);
+	return reinterpret_cast<char const*>(m_data + m_header->m_nameBlobOffset + nameIndices[boneIndex]);
+}
+
+Skeleton RigAsset::CreateSkeleton() const
+{
+	Skeleton skeleton;
+	int numBones = GetNumBones();
+	skeleton.m_bones.resize(numBones);
+
+	int32_t const* parentIndices = GetParentIndices();
+	Vec3 const* restPositions = GetRestPositions();
+	RigFileRotation const* restRotations = GetRestRotations();
+	RigFileConstraint const* constraints = GetConstraints();
+	uint8_t const* flags = GetFlags();
+
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+	{
+		Bone& bone = skeleton.m_bones[boneIndex];
+		bone.m_boneName = GetBoneName(boneIndex);
+		bone.m_parentBoneIndex = parentIndices[boneIndex];
+		bone.m_isRenderable = (flags[boneIndex] & RIG_BONE_HIDDEN) == 0;
+		bone.SetLocalBonePosition(restPositions[boneIndex]);
+
+		RigFileRotation const& rotation = restRotations[boneIndex];
+		if (rotation.m_degrees != 0.f)
+		{
+			Vec3 axis(rotation.m_axis[0], rotation.m_axis[1], rotation.m_axis[2]);
+			bone.SetLocalBoneRotation(Quat::MakeFromAxisAngle(axis, ConvertDegreesToRadians(rotation.m_degrees)));
+		}
+
+		RigFileConstraint const& constraint = constraints[boneIndex];
+		for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+		{
+			bone.m_boneConstraint.m_rotationConstraints[axisIndex] = static_cast<CONSTRAINT_TYPE>(constraint.m_types[axisIndex]);
+		}
+		bone.m_boneConstraint.m_minRotationDegrees = EulerAngles(constraint.m_minDegrees[0], constraint.m_minDegrees[1], constraint.m_minDegrees[2]);
+		bone.m_boneConstraint.m_maxRotationDegrees = EulerAngles(constraint.m_maxDegrees[0], constraint.m_maxDegrees[1], constraint.m_maxDegrees[2]);
+
+		if (bone.m_parentBoneIndex >= 0)
+		{
+			skeleton.m_bones[bone.m_parentBoneIndex].m_childBoneIndices.push_back(static_cast<unsigned int>(boneIndex));
+		}
+	}
+
+	skeleton.UpdateSkeletonPose();
+	return skeleton;
+}
+
+bool RigAsset::ConvertTextToBinary(std::string const& textPath, std::string const& binaryPath, std::string& errorMessage)
+{
+	std::ifstream textFile(textPath);
+	if (!textFile)
+	{
+		errorMessage = Stringf("could not open '%s'", textPath.c_str());
+		return false;
+	}
+
+	std::string rigName;
+	std::vector<RigTextBone> bones;
+	std::string line;
+	for (int lineNumber = 1; std::getline(textFile, line); ++lineNumber)
+	{
+		std::istringstream tokens(line);
+		std::string keyword;
+		if (!(tokens >> keyword) || keyword[0] == '#')
+		{
+			continue;
+		}
+
+		std::string lineError;
+		if (keyword == "rig")
+		{
+			tokens >> rigName;
+		}
+		else if (keyword == "bone")
+		{
+			RigTextBone bone;
+			if (ParseBoneLine(tokens, bones, bone, lineError))
+			{
+				bones.push_back(bone);
+			}
+		}
+		else
+		{
+			lineError = Stringf("unknown keyword '%s'", keyword.c_str());
+		}
+
+		if (!lineError.empty())
+		{
+			errorMessage = Stringf("%s(%d): %s", textPath.c_str(), lineNumber, lineError.c_str());
+			return false;
+		}
+	}
+
+	if (bones.empty() || rigName.empty() || rigName.size() >= RIG_FILE_MAX_NAME)
+	{
+		errorMessage = Stringf("%s: needs a 'rig <name>' line (under %d chars) and at least one bone", textPath.c_str(), RIG_FILE_MAX_NAME);
+		return false;
+	}
+
+	// Roles not given explicitly come from the name, structural roles always from the hierarchy
+	std::vector<bool> hasChildren(bones.size(), false);
+	for (RigTextBone const& bone : bones)
+	{
+		if (bone.m_parentIndex >= 0)
+		{
+			hasChildren[bone.m_parentIndex] = true;
+		}
+	}
+	for (int boneIndex = 0; boneIndex < static_cast<int>(bones.size()); ++boneIndex)
+	{
+		RigTextBone& bone = bones[boneIndex];
+		if (!bone.m_hasExplicitRoles)
+		{
+			bone.m_roles = SkeletonBoneTable::ClassifyBoneName(bone.m_name);
+		}
+		if (bone.m_parentIndex < 0)
+		{
+			bone.m_roles |= BONE_ROLE_ROOT;
+		}
+		if (!hasChildren[boneIndex])
+		{
+			bone.m_roles |= BONE_ROLE_LEAF;
+		}
+	}
+
+	// Lay out the sections
+	uint32_t boneCount = static_cast<uint32_t>(bones.size());
+	RigFileHeader header;
+	header.m_boneCount = boneCount;
+	memcpy(header.m_rigName, rigName.c_str(), rigName.size());
+
+	uint32_t offset = AlignOffset(sizeof(RigFileHeader));
+	header.m_parentOffset = offset;			offset = AlignOffset(offset + boneCount * sizeof(int32_t));
+	header.m_roleOffset = offset;			offset = AlignOffset(offset + boneCount * sizeof(uint32_t));
+	header.m_restPositionOffset = offset;	offset = AlignOffset(offset + boneCount * 3 * sizeof(float));
+	header.m_restRotationOffset = offset;	offset = AlignOffset(offset + boneCount * sizeof(RigFileRotation));
+	header.m_constraintOffset = offset;		offset = AlignOffset(offset + boneCount * sizeof(RigFileConstraint));
+	header.m_flagsOffset = offset;			offset = AlignOffset(offset + boneCount);
+	header.m_nameIndexOffset = offset;		offset = AlignOffset(offset + (boneCount + 1) * sizeof(uint32_t));
+	header.m_nameBlobOffset = offset;
+
+	uint32_t nameBlobSize = 0;
+	for (RigTextBone const& bone : bones)
+	{
+		nameBlobSize += static_cast<uint32_t>(bone.m_name.size()) + 1;
+	}
+	header.m_fileSize = offset + nameBlobSize;
+
+	std::vector<uint8_t> buffer(header.m_fileSize, 0);
+	memcpy(buffer.data(), &header, sizeof(header));
+
+	uint32_t nameCursor = 0;
+	for (uint32_t boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		RigTextBone const& bone = bones[boneIndex];
+		memcpy(&buffer[header.m_parentOffset + boneIndex * sizeof(int32_t)], &bone.m_parentIndex, sizeof(int32_t));
+		memcpy(&buffer[header.m_roleOffset + boneIndex * sizeof(uint32_t)], &bone.m_roles, sizeof(uint32_t));
+		memcpy(&buffer[header.m_restPositionOffset + boneIndex * 3 * sizeof(float)], bone.m_position, 3 * sizeof(float));
+		memcpy(&buffer[header.m_restRotationOffset + boneIndex * sizeof(RigFileRotation)], &bone.m_rotation, sizeof(RigFileRotation));
+		memcpy(&buffer[header.m_constraintOffset + boneIndex * sizeof(RigFileConstraint)], &bone.m_constraint, sizeof(RigFileConstraint));
+		buffer[header.m_flagsOffset + boneIndex] = bone.m_flags;
+
+		memcpy(&buffer[header.m_nameIndexOffset + boneIndex * sizeof(uint32_t)], &nameCursor, sizeof(uint32_t));
+		memcpy(&buffer[header.m_nameBlobOffset + nameCursor], bone.m_name.c_str(), bone.m_name.size() + 1);
+		nameCursor += static_cast<uint32_t>(bone.m_name.size()) + 1;
+	}
+	memcpy(&buffer[header.m_nameIndexOffset + boneCount * sizeof(uint32_t)], &nameCursor, sizeof(uint32_t));
+
+	// Cooked beside the target and swapped in whole, so a failed write never leaves a torn rig.
+	// The swap fails while anything still maps the old file; Command_ConvertRig releases those first.
+	std::string tempPath = binaryPath + ".tmp";
+	{
+		std::ofstream binaryFile(tempPath, std::ios::binary | std::ios::trunc);
+		binaryFile.write(reinterpret_cast<char const*>(buffer.data()), buffer.size());
+		if (!binaryFile)
+		{
+			errorMessage = Stringf("could not write '%s'", tempPath.c_str());
+			return false;
+		}
+	}
+	if (!MoveFileExA(tempPath.c_str(), binaryPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		errorMessage = Stringf("could not replace '%s' (error %lu)", binaryPath.c_str(), GetLastError());
+		DeleteFileA(tempPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+// Rigs stay mapped until re-cooked or the process exits
+bool RigAsset::LoadSkeleton(std::string const& rigName, Skeleton& out_skeleton)
+{
+	std::lock_guard<std::mutex> lock(s_rigCacheMutex);
+	std::unique_ptr<RigAsset>& rig = s_rigCache[rigName];
+	if (!rig)
+	{
+		rig = std::make_unique<RigAsset>();
+		rig->LoadOrCook(GetTextPath(rigName), GetBinaryPath(rigName));
+	}
+	if (!rig->IsLoaded())
+	{
+		return false;
+	}
+
+	out_skeleton = rig->CreateSkeleton();
+	return true;
+}
+
+// The next LoadSkeleton of this rig maps the file again
+void RigAsset::EvictCachedRig(std::string const& rigName)
+{
+	std::lock_guard<std::mutex> lock(s_rigCacheMutex);
+	s_rigCache.erase(rigName);
+}
+
+std::string RigAsset::GetTextPath(std::string const& rigName)
+{
+	return "Data/Rigs/" + rigName + ".txt";
+}
+
+std::string RigAsset::GetBinaryPath(std::string const& rigName)
+{
+	return "Data/Rigs/" + rigName + ".rig";
+}
+
+bool RigAsset::Command_ConvertRig(EventArgs& args)
+{
+	std::vector<std::string> rigNames;
+	std::string rigName = args.GetValue("rig", std::string());
+	if (!rigName.empty())
+	{
+		rigNames.push_back(rigName);
+	}
+	else
+	{
+		std::error_code error;
+		for (std::filesystem::directory_entry const& entry : std::filesystem::directory_iterator("Data/Rigs", error))
+		{
+			if (entry.path().extension() == ".txt")
+			{
+				rigNames.push_back(entry.path().stem().string());
+			}
+		}
+	}
+
+	bool isSuccessful = true;
+	for (std::string const& name : rigNames)
+	{
+		EvictCachedRig(name);
+		SkeletonDefinition::ReleaseRigAsset(name);
+
+		std::string errorMessage;
+		if (ConvertTextToBinary(GetTextPath(name), GetBinaryPath(name), errorMessage))
+		{
+			RigAsset rig;
+			rig.Load(GetBinaryPath(name));
+			g_theDevConsole->AddLine(Rgba8::GREEN, Stringf("Cooked %s: %d bones, %zu bytes", GetBinaryPath(name).c_str(), rig.GetNumBones(), rig.GetSizeBytes()));
+		}
+		else
+		{
+			g_theDevConsole->AddLine(Rgba8::RED, Stringf("ConvertRig failed: %s", errorMessage.c_str()));
+			isSuccessful = false;
+		}
+	}
+	return isSuccessful;
+}
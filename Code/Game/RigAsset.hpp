@@ -0,0 +1,94 @@
+#pragma once
+#include "Engine/Skeleton/Skeleton.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Math/Vec3.h"
+#include <cstdint>
+#include <string>
+// -----------------------------------------------------------------------------
+constexpr uint32_t RIG_FILE_VERSION = 1;
+constexpr int RIG_FILE_MAX_NAME = 32;
+// -----------------------------------------------------------------------------
+enum RigBoneFlags : uint8_t
+{
+	RIG_BONE_HIDDEN = 1 << 0,
+};
+// -----------------------------------------------------------------------------
+struct RigFileRotation
+{
+	float m_axis[3] = { 0.f, 0.f, 1.f };
+	float m_degrees = 0.f;
+};
+// -----------------------------------------------------------------------------
+struct RigFileConstraint
+{
+	uint8_t m_types[3] = {};		// CONSTRAINT_TYPE per yaw, pitch, roll
+	uint8_t m_padding = 0;
+	float   m_minDegrees[3] = {};
+	float   m_maxDegrees[3] = {};
+};
+// -----------------------------------------------------------------------------
+// Every array is 16-byte aligned and indexed by bone, so the loader can hand out
+// pointers into the mapped file without copying or parsing anything.
+struct RigFileHeader
+{
+	char	 m_magic[4] = { 'R', 'I', 'G', 'B' };
+	uint32_t m_version = RIG_FILE_VERSION;
+	uint32_t m_boneCount = 0;
+	uint32_t m_fileSize = 0;
+	uint32_t m_parentOffset = 0;		// int32_t[boneCount]
+	uint32_t m_roleOffset = 0;			// uint32_t[boneCount], BoneRole bits
+	uint32_t m_restPositionOffset = 0;	// float[3 * boneCount]
+	uint32_t m_restRotationOffset = 0;	// RigFileRotation[boneCount]
+	uint32_t m_constraintOffset = 0;	// RigFileConstraint[boneCount]
+	uint32_t m_flagsOffset = 0;			// uint8_t[boneCount], RigBoneFlags
+	uint32_t m_nameIndexOffset = 0;		// uint32_t[boneCount + 1] into the name blob
+	uint32_t m_nameBlobOffset = 0;		// Null-terminated bone names
+	char	 m_rigName[RIG_FILE_MAX_NAME] = {};
+};
+// -----------------------------------------------------------------------------
+// Read-only view of a cooked rig. Load maps the file and validates the header; the
+// accessors return pointers straight into the mapping, which stays alive with the asset.
+// A mapped rig cannot be replaced on disk, so re-cooking one releases every mapping of it first.
+class RigAsset
+{
+public:
+	RigAsset() = default;
+	~RigAsset();
+	RigAsset(RigAsset const& copy) = delete;
+	RigAsset& operator=(RigAsset const& copy) = delete;
+
+	bool Load(std::string const& binaryPath);
+	bool LoadOrCook(std::string const& textPath, std::string const& binaryPath);
+	void Unload();
+	bool IsLoaded() const;
+
+	char const* GetRigName() const;
+	int GetNumBones() const;
+	size_t GetSizeBytes() const;
+	int32_t const* GetParentIndices() const;
+	uint32_t const* GetRoles() const;
+	Vec3 const* GetRestPositions() const;
+	RigFileRotation const* GetRestRotations() const;
+	RigFileConstraint const* GetConstraints() const;
+	uint8_t const* GetFlags() const;
+	char const* GetBoneName(int boneIndex) const;
+
+	Skeleton CreateSkeleton() const;
+
+	static bool ConvertTextToBinary(std::string const& textPath, std::string const& binaryPath, std::string& errorMessage);
+	static bool LoadSkeleton(std::string const& rigName, Skeleton& out_skeleton);
+	static void EvictCachedRig(std::string const& rigName);
+	static std::string GetTextPath(std::string const& rigName);
+	static std::string GetBinaryPath(std::string const& rigName);
+	static bool Command_ConvertRig(EventArgs& args);
+
+private:
+	template <typename T>
+	T const* GetSection(uint32_t offset) const { return reinterpret_cast<T const*>(m_data + offset); }
+
+private:
+	void*		   m_mappingHandle = nullptr;
+	uint8_t const* m_data = nullptr;
+	size_t		   m_size = 0;
+	RigFileHeader const* m_header = nullptr;
+};
@@ -0,0 +1,170 @@
+#include "Game/RigidTransform.hpp"
+
+void RotationQuat::Normalize()
+{
+	float lengthSquared = x * x + y * y + z * z + w * w;
+	if (lengthSquared <= 0.f)
+	{
+		*this = RotationQuat();
+		return;
+	}
+	float inverseLength = 1.f / sqrtf(lengthSquared);
+	x *= inverseLength;
+	y *= inverseLength;
+	z *= inverseLength;
+	w *= inverseLength;
+}
+
+// The engine's Quat only takes axis-angle or matrices; axis-angle keeps this conversion matrix-free
+Quat RotationQuat::GetAsEngineQuat() const
+{
+	float clampedW = GetClamped(w, -1.f, 1.f);
+	float sinHalfAngle = sqrtf(1.f - clampedW * clampedW);
+	if (sinHalfAngle < 0.000001f)
+	{
+		return Quat::DEFAULT;
+	}
+
+	float inverseSin = 1.f / sinHalfAngle;
+	return Quat::MakeFromAxisAngle(Vec3(x * inverseSin, y * inverseSin, z * inverseSin), 2.f * acosf(clampedW));
+}
+
+RotationQuat RotationQuat::MakeFromAxisAngle(Vec3 const& unitAxis, float radians)
+{
+	float halfAngle = radians * 0.5f;
+	float sinHalfAngle = sinf(halfAngle);
+	return RotationQuat(unitAxis.x * sinHalfAngle, unitAxis.y * sinHalfAngle, unitAxis.z * sinHalfAngle, cosf(halfAngle));
+}
+
+// Identity when the directions are already aligned or too short to say
+RotationQuat RotationQuat::MakeRotationFromTwoVectors(Vec3 const& fromUnit, Vec3 const& toUnit)
+{
+	Vec3 axis = CrossProduct3D(fromUnit, toUnit);
+	if (axis.GetLengthSquared() < 0.00001f)
+	{
+		return RotationQuat();
+	}
+	float angle = acosf(GetClamped(DotProduct3D(fromUnit, toUnit), -1.f, 1.f));
+	return MakeFromAxisAngle(axis.GetNormalized(), angle);
+}
+
+// Shepperd's method, branching on the largest diagonal term so the square root never sees a small number
+RotationQuat RotationQuat::MakeFromBasis(Vec3 const& iBasis, Vec3 const& jBasis, Vec3 const& kBasis)
+{
+	RotationQuat result;
+	float trace = iBasis.x + jBasis.y + kBasis.z;
+	if (trace > 0.f)
+	{
+		float s = sqrtf(trace + 1.f) * 2.f;
+		result = RotationQuat((jBasis.z - kBasis.y) / s, (kBasis.x - iBasis.z) / s, (iBasis.y - jBasis.x) / s, 0.25f * s);
+	}
+	else if (iBasis.x > jBasis.y && iBasis.x > kBasis.z)
+	{
+		float s = sqrtf(1.f + iBasis.x - jBasis.y - kBasis.z) * 2.f;
+		result = RotationQuat(0.25f * s, (jBasis.x + iBasis.y) / s, (kBasis.x + iBasis.z) / s, (jBasis.z - kBasis.y) / s);
+	}
+	else if (jBasis.y > kBasis.z)
+	{
+		float s = sqrtf(1.f + jBasis.y - iBasis.x - kBasis.z) * 2.f;
+		result = RotationQuat((jBasis.x + iBasis.y) / s, 0.25f * s, (kBasis.y + jBasis.z) / s, (kBasis.x - iBasis.z) / s);
+	}
+	else
+	{
+		float s = sqrtf(1.f + kBasis.z - iBasis.x - jBasis.y) * 2.f;
+		result = RotationQuat((kBasis.x + iBasis.z) / s, (kBasis.y + jBasis.z) / s, 0.25f * s, (iBasis.y - jBasis.x) / s);
+	}
+	result.Normalize();
+	return result;
+}
+
+Mat44 RigidTransform::GetAsMat44() const
+{
+	return Mat44(GetIBasis3D(), GetJBasis3D(), GetKBasis3D(), m_translation);
+}
+
+RigidTransform RigidTransform::MakeFromMat44(Mat44 const& transform)
+{
+	RotationQuat rotation = RotationQuat::MakeFromBasis(transform.GetIBasis3D().GetNormalized(), transform.GetJBasis3D().GetNormalized(), transform.GetKBasis3D().GetNormalized());
+	return RigidTransform(rotation, transform.GetTranslation3D());
+}
+
+// Normalized lerp on the shorter arc; close enough to a slerp for the small steps between poses
+RigidTransform RigidTransform::Interpolate(RigidTransform const& start, RigidTransform const& end, float fraction)
+{
+	RotationQuat const& a = start.m_rotation;
+	RotationQuat const& b = end.m_rotation;
+	float sign = (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w) < 0.f ? -1.f : 1.f;
+	float startWeight = 1.f - fraction;
+	float endWeight = fraction * sign;
+	RotationQuat rotation(a.x * startWeight + b.x * endWeight, a.y * startWeight + b.y * endWeight, a.z * startWeight + b.z * endWeight, a.w * startWeight + b.w * endWeight);
+	rotation.Normalize();
+	return RigidTransform(rotation, start.m_translation + (end.m_translation - start.m_translation) * fraction);
+}
+
+DualQuat DualQuat::operator*(DualQuat const& b) const
+{
+	RotationQuat realTimesDual = m_real * b.m_dual;
+	RotationQuat dualTimesReal = m_dual * b.m_real;
+	return DualQuat(m_real * b.m_real, RotationQuat(realTimesDual.x + dualTimesReal.x, realTimesDual.y + dualTimesReal.y, realTimesDual.z + dualTimesReal.z, realTimesDual.w + dualTimesReal.w));
+}
+
+// q and -q are the same rotation; flip to the first transform's hemisphere so the blend takes the short way
+void DualQuat::AddWeighted(DualQuat const& other, float weight)
+{
+	float hemisphereDot = m_real.x * other.m_real.x + m_real.y * other.m_real.y + m_real.z * other.m_real.z + m_real.w * other.m_real.w;
+	float signedWeight = hemisphereDot < 0.f ? -weight : weight;
+
+	m_real.x += other.m_real.x * signedWeight;
+	m_real.y += other.m_real.y * signedWeight;
+	m_real.z += other.m_real.z * signedWeight;
+	m_real.w += other.m_real.w * signedWeight;
+	m_dual.x += other.m_dual.x * signedWeight;
+	m_dual.y += other.m_dual.y * signedWeight;
+	m_dual.z += other.m_dual.z * signedWeight;
+	m_dual.w += other.m_dual.w * signedWeight;
+}
+
+void DualQuat::Normalize()
+{
+	float lengthSquared = m_real.x * m_real.x + m_real.y * m_real.y + m_real.z * m_real.z + m_real.w * m_real.w;
+	if (lengthSquared <= 0.f)
+	{
+		*this = DualQuat();
+		return;
+	}
+	float inverseLength = 1.f / sqrtf(lengthSquared);
+	m_real = RotationQuat(m_real.x * inverseLength, m_real.y * inverseLength, m_real.z * inverseLength, m_real.w * inverseLength);
+	m_dual = RotationQuat(m_dual.x * inverseLength, m_dual.y * inverseLength, m_dual.z * inverseLength, m_dual.w * inverseLength);
+}
+
+RigidTransform DualQuat::GetAsRigidTransform() const
+{
+	// t = 2 * dual * conjugate(real)
+	RotationQuat translation = m_dual * m_real.GetInverse();
+	return RigidTransform(m_real, Vec3(translation.x * 2.f, translation.y * 2.f, translation.z * 2.f));
+}
+
+DualQuat DualQuat::MakeFromRigidTransform(RigidTransform const& transform)
+{
+	Vec3 const& t = transform.m_translation;
+	RotationQuat halfTranslation = RotationQuat(t.x * 0.5f, t.y * 0.5f, t.z * 0.5f, 0.f) * transform.m_rotation;
+	return DualQuat(transform.m_rotation, halfTranslation);
+}
+
+DualQuat DualQuat::Blend(DualQuat const* transforms, float const* weights, int count)
+{
+	if (count <= 0)
+	{
+		return DualQuat();
+	}
+
+	DualQuat result(RotationQuat(0.f, 0.f, 0.f, 0.f), RotationQuat(0.f, 0.f, 0.f, 0.f));
+	result.m_real = RotationQuat(transforms[0].m_real.x * weights[0], transforms[0].m_real.y * weights[0], transforms[0].m_real.z * weights[0], transforms[0].m_real.w * weights[0]);
+	result.m_dual = RotationQuat(transforms[0].m_dual.x * weights[0], transforms[0].m_dual.y * weights[0], transforms[0].m_dual.z * weights[0], transforms[0].m_dual.w * weights[0]);
+	for (int transformIndex = 1; transformIndex < count; ++transformIndex)
+	{
+		result.AddWeighted(transforms[transformIndex], weights[transformIndex]);
+	}
+	result.Normalize();
+	return result;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "Engine/Skeleton/Skeleton.hpp"
+#include "Engine/Math/Vec3.h"
+#include "Engine/Math/MathUtils.h"
+#include <cmath>
+// -----------------------------------------------------------------------------
+// Unit quaternion with its components exposed, so poses can be composed and converted
+// without going through a Mat44. a * b applies b first, the same order as Mat44 appends.
+struct RotationQuat
+{
+	float x = 0.f;
+	float y = 0.f;
+	float z = 0.f;
+	float w = 1.f;
+
+	RotationQuat() = default;
+	RotationQuat(float qx, float qy, float qz, float qw) : x(qx), y(qy), z(qz), w(qw) {}
+
+	RotationQuat operator*(RotationQuat const& b) const
+	{
+		return RotationQuat(w * b.x + x * b.w + y * b.z - z * b.y,
+							w * b.y - x * b.z + y * b.w + z * b.x,
+							w * b.z + x * b.y - y * b.x + z * b.w,
+							w * b.w - x * b.x - y * b.y - z * b.z);
+	}
+
+	RotationQuat GetInverse() const { return RotationQuat(-x, -y, -z, w); }
+
+	Vec3 Rotate(Vec3 const& vector) const
+	{
+		// v + 2w(q x v) + 2q x (q x v)
+		Vec3 axis(x, y, z);
+		Vec3 twiceCross = CrossProduct3D(axis, vector) * 2.f;
+		return vector + twiceCross * w + CrossProduct3D(axis, twiceCross);
+	}
+
+	void Normalize();
+	Quat GetAsEngineQuat() const;
+
+	static RotationQuat MakeFromAxisAngle(Vec3 const& unitAxis, float radians);
+	static RotationQuat MakeRotationFromTwoVectors(Vec3 const& fromUnit, Vec3 const& toUnit);
+	static RotationQuat MakeFromBasis(Vec3 const& iBasis, Vec3 const& jBasis, Vec3 const& kBasis);
+};
+// -----------------------------------------------------------------------------
+// Rotation plus translation, 28 bytes against a Mat44's 64. Bones never scale, so this
+// covers every local and world pose; GetAsMat44 is for the renderer and engine calls.
+struct RigidTransform
+{
+	RotationQuat m_rotation;
+	Vec3		 m_translation = Vec3::ZERO;
+
+	RigidTransform() = default;
+	RigidTransform(RotationQuat const& rotation, Vec3 const& translation) : m_rotation(rotation), m_translation(translation) {}
+
+	RigidTransform operator*(RigidTransform const& local) const
+	{
+		return RigidTransform(m_rotation * local.m_rotation, m_translation + m_rotation.Rotate(local.m_translation));
+	}
+
+	RigidTransform GetInverse() const
+	{
+		RotationQuat inverseRotation = m_rotation.GetInverse();
+		return RigidTransform(inverseRotation, inverseRotation.Rotate(m_translation * -1.f));
+	}
+
+	Vec3 TransformPosition3D(Vec3 const& position) const { return m_translation + m_rotation.Rotate(position); }
+	Vec3 TransformVectorQuantity3D(Vec3 const& vector) const { return m_rotation.Rotate(vector); }
+	Vec3 GetTranslation3D() const { return m_translation; }
+	Vec3 GetIBasis3D() const { return m_rotation.Rotate(Vec3::XAXE); }
+	Vec3 GetJBasis3D() const { return m_rotation.Rotate(Vec3::YAXE); }
+	Vec3 GetKBasis3D() const { return m_rotation.Rotate(Vec3::ZAXE); }
+
+	Mat44 GetAsMat44() const;
+	static RigidTransform MakeFromMat44(Mat44 const& transform);
+	static RigidTransform Interpolate(RigidTransform const& start, RigidTransform const& end, float fraction);
+};
+// -----------------------------------------------------------------------------
+// Rigid transform as a dual quaternion, for blending several poses without the shrinking
+// that linear matrix blends give. Convert to RigidTransform to apply it.
+struct DualQuat
+{
+	RotationQuat m_real;
+	RotationQuat m_dual = RotationQuat(0.f, 0.f, 0.f, 0.f);
+
+	DualQuat() = default;
+	DualQuat(RotationQuat const& real, RotationQuat const& dual) : m_real(real), m_dual(dual) {}
+
+	DualQuat operator*(DualQuat const& b) const;
+	void AddWeighted(DualQuat const& other, float weight);
+	void Normalize();
+	RigidTransform GetAsRigidTransform() const;
+
+	static DualQuat MakeFromRigidTransform(RigidTransform const& transform);
+	static DualQuat Blend(DualQuat const* transforms, float const* weights, int count);
+};
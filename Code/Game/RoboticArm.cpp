@@ -1,5 +1,7 @@
 #include "Game/RoboticArm.hpp"
 #include "Game/App.h"
+#include "Game/RigAsset.hpp"
+#include "Game/FixedChainIK.hpp"
 #include "Engine/Input/InputSystem.h"
 #include "Engine/Core/DebugRender.hpp"
 
@@ -49,11 +51,11 @@ void RoboticArmMode::Update()
 	midBone.m_worldBoneTransform.SetTranslation3D(midpoint);
 	if (!m_isArmConstrained)
 	{
-		SolveCCDIK({ 0, 1, 2, 3, 8 }, m_targetPosition, 8);
+		SolveFixedChainCCDIK(m_roboticArm, m_targetPosition);
 	}
 	else
 	{
-		SolveCCDIKConstrained({ 0, 1, 2, 3, 8 }, m_targetPosition, 8);
+		SolveCCDIKConstrained(m_roboticArm, { 0, 1, 2, 3, 8 }, m_targetPosition, 8);
 	}
 	UpdateVerts();
 
@@ -90,7 +92,12 @@ void RoboticArmMode::Shutdown()
 Skeleton RoboticArmMode::InitializeRoboticArm()
 {
 	Skeleton roboticArm;
+	if (RigAsset::LoadSkeleton("RoboticArm", roboticArm))
+	{
+		return roboticArm;
+	}
 	roboticArm.m_bones.clear();
+	roboticArm.m_bones.reserve(9);
 
 	Bone rootRotator;
 	rootRotator.SetLocalBonePosition(Vec3::ZERO);
@@ -99,7 +106,7 @@ Skeleton RoboticArmMode::InitializeRoboticArm()
 	rootRotator.m_boneConstraint.m_rotationConstraints[2] = CONSTRAINT_TYPE::LOCKED;  
 	rootRotator.m_boneConstraint.m_minRotationDegrees = EulerAngles(-45.f, -45.f, 0.f);
 	rootRotator.m_boneConstraint.m_maxRotationDegrees = EulerAngles(45.f, 45.f, 0.f);
-	roboticArm.m_bones.push_back(rootRotator);
+	roboticArm.m_bones.push_back(std::move(rootRotator));
 
 	Bone lowerExtender;
 	lowerExtender.m_parentBoneIndex = 0;
@@ -109,7 +116,7 @@ Skeleton RoboticArmMode::InitializeRoboticArm()
 	lowerExtender.m_boneConstraint.m_rotationConstraints[2] = CONSTRAINT_TYPE::LOCKED;
 	lowerExtender.m_boneConstraint.m_minRotationDegrees = EulerAngles(-90.f, 0.f, 0.f);
 	lowerExtender.m_boneConstraint.m_maxRotationDegrees = EulerAngles(90.f, 0.f, 0.f);
-	roboticArm.m_bones.push_back(lowerExtender);
+	roboticArm.m_bones.push_back(std::move(lowerExtender));
 
 	Bone upperExtender;
 	upperExtender.m_parentBoneIndex = 1;
@@ -119,7 +126,7 @@ Skeleton RoboticArmMode::InitializeRoboticArm()
 	upperExtender.m_boneConstraint.m_rotationConstraints[2] = CONSTRAINT_TYPE::LOCKED;
 	upperExtender.m_boneConstraint.m_minRotationDegrees = EulerAngles(-135.f, 0.f, 0.f);
 	upperExtender.m_boneConstraint.m_maxRotationDegrees = EulerAngles(135.f, 0.f, 0.f);
-	roboticArm.m_bones.push_back(upperExtender);
+	roboticArm.m_bones.push_back(std::move(upperExtender));
 
 	Bone endEffector;
 	endEffector.m_parentBoneIndex = 2;
@@ -129,33 +136,33 @@ Skeleton RoboticArmMode::InitializeRoboticArm()
 	endEffector.m_boneConstraint.m_rotationConstraints[2] = CONSTRAINT_TYPE::LOCKED;
 	endEffector.m_boneConstraint.m_minRotationDegrees = EulerAngles(-30.f, -45.f, 0.f);
 	endEffector.m_boneConstraint.m_maxRotationDegrees = EulerAngles(30.f, 45.f, 0.f);
-	roboticArm.m_bones.push_back(endEffector);
+	roboticArm.m_bones.push_back(std::move(endEffector));
 
 	// ---- CLAW ----
 	Bone clawBase1;
 	clawBase1.m_parentBoneIndex = 3;
 	clawBase1.SetLocalBonePosition(Vec3(0.f, 0.5f, 0.5f));
-	roboticArm.m_bones.push_back(clawBase1);
+	roboticArm.m_bones.push_back(std::move(clawBase1));
 
 	Bone clawTip1;
 	clawTip1.m_parentBoneIndex = 4;
 	clawTip1.SetLocalBonePosition(Vec3(0.f, -0.25f, 0.5f));
-	roboticArm.m_bones.push_back(clawTip1);
+	roboticArm.m_bones.push_back(std::move(clawTip1));
 
 	Bone clawBase2;
 	clawBase2.m_parentBoneIndex = 3;
 	clawBase2.SetLocalBonePosition(Vec3(0.f, -0.5f, 0.5f));
-	roboticArm.m_bones.push_back(clawBase2);
+	roboticArm.m_bones.push_back(std::move(clawBase2));
 
 	Bone clawTip2;
 	clawTip2.m_parentBoneIndex = 6;
 	clawTip2.SetLocalBonePosition(Vec3(0.f, 0.25f, 0.5f));
-	roboticArm.m_bones.push_back(clawTip2);
+	roboticArm.m_bones.push_back(std::move(clawTip2));
 
 	Bone clawMidpoint;
 	clawMidpoint.m_parentBoneIndex = -1; 
 	clawMidpoint.m_isRenderable = false;
-	roboticArm.m_bones.push_back(clawMidpoint);
+	roboticArm.m_bones.push_back(std::move(clawMidpoint));
 
 	roboticArm.UpdateSkeletonPose();
 	return roboticArm;
@@ -317,12 +324,39 @@ void RoboticArmMode::ToggleConstraints()
 	}
 }
 
-void RoboticArmMode::SolveCCDIK(std::vector<int> const& chainIndices, Vec3 const& targetPosition, int endEffector, int maxIterations, float threshold)
+void RoboticArmMode::UpdateClawMidpoint(Skeleton& roboticArm, int endEffector)
+{
+	Vec3 tip1 = roboticArm.m_bones[5].GetWorldBonePosition3D();
+	Vec3 tip2 = roboticArm.m_bones[7].GetWorldBonePosition3D();
+	Vec3 midpoint = (tip1 + tip2) * 0.5f;
+	roboticArm.m_bones[endEffector].m_worldBoneTransform.SetTranslation3D(midpoint);
+}
+
+// The arm's chain never changes, so the unconstrained solve runs on the fixed-size chain
+IKSolveStats RoboticArmMode::SolveFixedChainCCDIK(Skeleton& roboticArm, Vec3 const& targetPosition, int maxIterations, float threshold)
+{
+	constexpr int endEffector = ROBOTIC_ARM_CHAIN_BONES[ROBOTIC_ARM_CHAIN_JOINTS - 1];
+
+	FixedChain<ROBOTIC_ARM_CHAIN_JOINTS> chain;
+	chain.Load(roboticArm, ROBOTIC_ARM_CHAIN_BONES);
+	IKSolveStats stats = SolveCCD(chain, targetPosition, maxIterations, threshold);
+	chain.ApplyToSkeleton(roboticArm);
+	roboticArm.UpdateSkeletonPose();
+	UpdateClawMidpoint(roboticArm, endEffector);
+
+	stats.m_residual = (roboticArm.m_bones[endEffector].GetWorldBonePosition3D() - targetPosition).GetLength();
+	stats.m_hasConverged = stats.m_residual <= threshold;
+	return stats;
+}
+
+IKSolveStats RoboticArmMode::SolveCCDIK(Skeleton& roboticArm, std::vector<int> const& chainIndices, Vec3 const& targetPosition, int endEffector, int maxIterations, float threshold)
 {
+	IKSolveStats stats;
+
 	// Check if there are enough bones for a chain
 	if (chainIndices.size() < 2)
 	{
-		return;
+		return stats;
 	}
 
 	float totalChainLength = 0.f;
@@ -331,13 +365,13 @@ void RoboticArmMode::SolveCCDIK(std::vector<int> const& chainIndices, Vec3 const
 	{
 		int chainIndexA = chainIndices[chainIndex];
 		int chainIndexB = chainIndices[chainIndex + 1];
-		Vec3 chainIndexAPosition = m_roboticArm.m_bones[chainIndexA].GetWorldBonePosition3D();
-		Vec3 chainIndexBPosition = m_roboticArm.m_bones[chainIndexB].GetWorldBonePosition3D();
+		Vec3 chainIndexAPosition = roboticArm.m_bones[chainIndexA].GetWorldBonePosition3D();
+		Vec3 chainIndexBPosition = roboticArm.m_bones[chainIndexB].GetWorldBonePosition3D();
 		totalChainLength += (chainIndexBPosition - chainIndexAPosition).GetLength();
 	}
 
 	// Clamp if target is unreachable
-	Vec3  rootPosition = m_roboticArm.m_bones[chainIndices[0]].GetWorldBonePosition3D();
+	Vec3  rootPosition = roboticArm.m_bones[chainIndices[0]].GetWorldBonePosition3D();
 	float distToTarget = (targetPosition - rootPosition).GetLength();
 
 	Vec3 clampedTargetPos = targetPosition;
@@ -361,8 +395,8 @@ void RoboticArmMode::SolveCCDIK(std::vector<int> const& chainIndices, Vec3 const
 			int jointIndex = chainIndices[chainIndex];
 			int nextIndex = chainIndices[chainIndex + 1];
 
-			Vec3 jointPos = m_roboticArm.m_bones[jointIndex].GetWorldBonePosition3D();
-			Vec3 nextPos = m_roboticArm.m_bones[nextIndex].GetWorldBonePosition3D();
+			Vec3 jointPos = roboticArm.m_bones[jointIndex].GetWorldBonePosition3D();
+			Vec3 nextPos = roboticArm.m_bones[nextIndex].GetWorldBonePosition3D();
 			Vec3 toNext = (nextPos - jointPos).GetNormalized();
 
 			float dot = DotProduct3D(toNext, direction);
@@ -376,33 +410,32 @@ void RoboticArmMode::SolveCCDIK(std::vector<int> const& chainIndices, Vec3 const
 				{
 					axis.Normalize();
 					Quat rotation = Quat::MakeFromAxisAngle(axis, angle);
-					m_roboticArm.m_bones[jointIndex].SetLocalBoneRotation(rotation * m_roboticArm.m_bones[jointIndex].m_localRotation);
+					roboticArm.m_bones[jointIndex].SetLocalBoneRotation(rotation * roboticArm.m_bones[jointIndex].m_localRotation);
 				}
 			}
 		}
 
-		m_roboticArm.UpdateSkeletonPose();
-
-		// Claw midpoint recompute
-		Vec3 tip1 = m_roboticArm.m_bones[5].GetWorldBonePosition3D();
-		Vec3 tip2 = m_roboticArm.m_bones[7].GetWorldBonePosition3D();
-		Vec3 midpoint = (tip1 + tip2) * 0.5f;
-		m_roboticArm.m_bones[endEffector].m_worldBoneTransform.SetTranslation3D(midpoint);
+		roboticArm.UpdateSkeletonPose();
+		UpdateClawMidpoint(roboticArm, endEffector);
 
-		return;
+		stats.m_iterations = 1;
+		stats.m_wasUnreachable = true;
+		stats.m_residual = (roboticArm.m_bones[endEffector].GetWorldBonePosition3D() - targetPosition).GetLength();
+		return stats;
 	}
 
 	for (int iterationIndex = 0; iterationIndex < maxIterations; ++iterationIndex)
 	{
 		bool breakLoop = false;
+		stats.m_iterations = iterationIndex + 1;
 
 		for (int chainIndex = static_cast<int>(chainIndices.size()) - 2; chainIndex >= 0; --chainIndex)
 		{
 			int jointIndex = chainIndices[chainIndex];
 			int endEffectorIndex = endEffector;
 
-			Vec3 jointPos = m_roboticArm.m_bones[jointIndex].GetWorldBonePosition3D();
-			Vec3 endEffectorPos = m_roboticArm.m_bones[endEffectorIndex].GetWorldBonePosition3D();
+			Vec3 jointPos = roboticArm.m_bones[jointIndex].GetWorldBonePosition3D();
+			Vec3 endEffectorPos = roboticArm.m_bones[endEffectorIndex].GetWorldBonePosition3D();
 
 			Vec3 toEndEffector = endEffectorPos - jointPos;
 			Vec3 toTarget = clampedTargetPos - jointPos;
@@ -434,16 +467,11 @@ void RoboticArmMode::SolveCCDIK(std::vector<int> const& chainIndices, Vec3 const
 				if (rotationAxis.GetLengthSquared() > 0.00001f)
 				{
 					Quat rotationQuat = Quat::MakeFromAxisAngle(rotationAxis, angle);
-					Quat currentLocalRotation = m_roboticArm.m_bones[jointIndex].m_localRotation;
-					m_roboticArm.m_bones[jointIndex].SetLocalBoneRotation(rotationQuat * currentLocalRotation);
+					Quat currentLocalRotation = roboticArm.m_bones[jointIndex].m_localRotation;
+					roboticArm.m_bones[jointIndex].SetLocalBoneRotation(rotationQuat * currentLocalRotation);
 
-					m_roboticArm.UpdateSkeletonPose();
-
-					// Claw midpoint recompute
-					Vec3 tip1 = m_roboticArm.m_bones[5].GetWorldBonePosition3D();
-					Vec3 tip2 = m_roboticArm.m_bones[7].GetWorldBonePosition3D();
-					Vec3 midpoint = (tip1 + tip2) * 0.5f;
-					m_roboticArm.m_bones[endEffector].m_worldBoneTransform.SetTranslation3D(midpoint);
+					roboticArm.UpdateSkeletonPose();
+					UpdateClawMidpoint(roboticArm, endEffector);
 				}
 			}
 		}
@@ -455,20 +483,27 @@ void RoboticArmMode::SolveCCDIK(std::vector<int> const& chainIndices, Vec3 const
 		}
 
 		// Convergence check
-		Vec3 newEffectorPos = m_roboticArm.m_bones[endEffector].GetWorldBonePosition3D();
+		Vec3 newEffectorPos = roboticArm.m_bones[endEffector].GetWorldBonePosition3D();
 		if ((newEffectorPos - clampedTargetPos).GetLength() <= threshold)
 		{
+			stats.m_hasConverged = true;
 			break;
 		}
 	}
+
+	stats.m_residual = (roboticArm.m_bones[endEffector].GetWorldBonePosition3D() - targetPosition).GetLength();
+	stats.m_hasConverged = stats.m_hasConverged || stats.m_residual <= threshold;
+	return stats;
 }
 
-void RoboticArmMode::SolveCCDIKConstrained(std::vector<int> const& chainIndices, Vec3 const& targetPosition, int endEffector, int maxIterations, float threshold)
+IKSolveStats RoboticArmMode::SolveCCDIKConstrained(Skeleton& roboticArm, std::vector<int> const& chainIndices, Vec3 const& targetPosition, int endEffector, int maxIterations, float threshold, float deadZoneRadius)
 {
+	IKSolveStats stats;
+
 	// Check if there are enough bones for a chain
 	if (chainIndices.size() < 2)
 	{
-		return;
+		return stats;
 	}
 
 	float totalChainLength = 0.f;
@@ -477,13 +512,13 @@ void RoboticArmMode::SolveCCDIKConstrained(std::vector<int> const& chainIndices,
 	{
 		int chainIndexA = chainIndices[chainIndex];
 		int chainIndexB = chainIndices[chainIndex + 1];
-		Vec3 chainIndexAPosition = m_roboticArm.m_bones[chainIndexA].GetWorldBonePosition3D();
-		Vec3 chainIndexBPosition = m_roboticArm.m_bones[chainIndexB].GetWorldBonePosition3D();
+		Vec3 chainIndexAPosition = roboticArm.m_bones[chainIndexA].GetWorldBonePosition3D();
+		Vec3 chainIndexBPosition = roboticArm.m_bones[chainIndexB].GetWorldBonePosition3D();
 		totalChainLength += (chainIndexBPosition - chainIndexAPosition).GetLength();
 	}
 
 	// Clamp if target is unreachable
-	Vec3  rootPosition = m_roboticArm.m_bones[chainIndices[0]].GetWorldBonePosition3D();
+	Vec3  rootPosition = roboticArm.m_bones[chainIndices[0]].GetWorldBonePosition3D();
 	float distToTarget = (targetPosition - rootPosition).GetLength();
 
 	Vec3 clampedTargetPos = targetPosition;
@@ -507,8 +542,8 @@ void RoboticArmMode::SolveCCDIKConstrained(std::vector<int> const& chainIndices,
 			int jointIndex = chainIndices[chainIndex];
 			int nextIndex = chainIndices[chainIndex + 1];
 
-			Vec3 jointPos = m_roboticArm.m_bones[jointIndex].GetWorldBonePosition3D();
-			Vec3 nextPos = m_roboticArm.m_bones[nextIndex].GetWorldBonePosition3D();
+			Vec3 jointPos = roboticArm.m_bones[jointIndex].GetWorldBonePosition3D();
+			Vec3 nextPos = roboticArm.m_bones[nextIndex].GetWorldBonePosition3D();
 			Vec3 toNext = (nextPos - jointPos).GetNormalized();
 
 			float dot = DotProduct3D(toNext, direction);
@@ -521,43 +556,44 @@ void RoboticArmMode::SolveCCDIKConstrained(std::vector<int> const& chainIndices,
 				if (axis.GetLengthSquared() > 0.00001f)
 				{
 					Quat rotation = Quat::MakeFromAxisAngle(axis, angle);
-					Quat currentLocalRotation = m_roboticArm.m_bones[jointIndex].m_localRotation;
+					Quat currentLocalRotation = roboticArm.m_bones[jointIndex].m_localRotation;
 					Quat newRotation = rotation * currentLocalRotation;
 
-					newRotation = m_roboticArm.m_bones[jointIndex].m_boneConstraint.ApplyRotationConstraint(newRotation);
-					m_roboticArm.m_bones[jointIndex].SetLocalBoneRotation(newRotation);
+					newRotation = roboticArm.m_bones[jointIndex].m_boneConstraint.ApplyRotationConstraint(newRotation);
+					roboticArm.m_bones[jointIndex].SetLocalBoneRotation(newRotation);
 				}
 			}
 		}
 
-		m_roboticArm.UpdateSkeletonPose();
-
-		// Claw midpoint recompute
-		Vec3 tip1 = m_roboticArm.m_bones[5].GetWorldBonePosition3D();
-		Vec3 tip2 = m_roboticArm.m_bones[7].GetWorldBonePosition3D();
-		Vec3 midpoint = (tip1 + tip2) * 0.5f;
-		m_roboticArm.m_bones[endEffector].m_worldBoneTransform.SetTranslation3D(midpoint);
+		roboticArm.UpdateSkeletonPose();
+		UpdateClawMidpoint(roboticArm, endEffector);
 
-		return;
+		stats.m_iterations = 1;
+		stats.m_wasUnreachable = true;
+		stats.m_residual = (roboticArm.m_bones[endEffector].GetWorldBonePosition3D() - targetPosition).GetLength();
+		return stats;
 	}
 
 	// Dead zone check
-	if (distToTarget < 2.1f)
+	if (distToTarget < deadZoneRadius)
 	{
-		return;
+		stats.m_wasInDeadZone = true;
+		stats.m_residual = (roboticArm.m_bones[endEffector].GetWorldBonePosition3D() - targetPosition).GetLength();
+		return stats;
 	}
 
 	for (int iterationIndex = 0; iterationIndex < maxIterations; ++iterationIndex)
 	{
 		bool breakLoop = false;
+		stats.m_iterations = iterationIndex + 1;
 
 		for (int chainIndex = static_cast<int>(chainIndices.size()) - 2; chainIndex >= 0; --chainIndex)
 		{
 			int jointIndex = chainIndices[chainIndex];
 			int endEffectorIndex = endEffector;
 
-			Vec3 jointPos = m_roboticArm.m_bones[jointIndex].GetWorldBonePosition3D();
-			Vec3 endEffectorPos = m_roboticArm.m_bones[endEffectorIndex].GetWorldBonePosition3D();
+			Vec3 jointPos = roboticArm.m_bones[jointIndex].GetWorldBonePosition3D();
+			Vec3 endEffectorPos = roboticArm.m_bones[endEffectorIndex].GetWorldBonePosition3D();
 
 			Vec3 toEndEffector = endEffectorPos - jointPos;
 			Vec3 toTarget = clampedTargetPos - jointPos;
@@ -589,19 +625,14 @@ void RoboticArmMode::SolveCCDIKConstrained(std::vector<int> const& chainIndices,
 				if (rotationAxis.GetLengthSquared() > 0.00001f)
 				{
 					Quat rotationQuat = Quat::MakeFromAxisAngle(rotationAxis, angle);
-					Quat currentLocalRotation = m_roboticArm.m_bones[jointIndex].m_localRotation;
+					Quat currentLocalRotation = roboticArm.m_bones[jointIndex].m_localRotation;
 					Quat newRotation = rotationQuat * currentLocalRotation;
 
-					newRotation = m_roboticArm.m_bones[jointIndex].m_boneConstraint.ApplyRotationConstraint(newRotation);
-					m_roboticArm.m_bones[jointIndex].SetLocalBoneRotation(newRotation);
-
-					m_roboticArm.UpdateSkeletonPose();
+					newRotation = roboticArm.m_bones[jointIndex].m_boneConstraint.ApplyRotationConstraint(newRotation);
+					roboticArm.m_bones[jointIndex].SetLocalBoneRotation(newRotation);
 
-					// Claw midpoint recompute
-					Vec3 tip1 = m_roboticArm.m_bones[5].GetWorldBonePosition3D();
-					Vec3 tip2 = m_roboticArm.m_bones[7].GetWorldBonePosition3D();
-					Vec3 midpoint = (tip1 + tip2) * 0.5f;
-					m_roboticArm.m_bones[endEffector].m_worldBoneTransform.SetTranslation3D(midpoint);
+					roboticArm.UpdateSkeletonPose();
+					UpdateClawMidpoint(roboticArm, endEffector);
 				}
 			}
 		}
@@ -613,12 +644,17 @@ void RoboticArmMode::SolveCCDIKConstrained(std::vector<int> const& chainIndices,
 		}
 
 		// Convergence check
-		Vec3 newEffectorPos = m_roboticArm.m_bones[endEffector].GetWorldBonePosition3D();
+		Vec3 newEffectorPos = roboticArm.m_bones[endEffector].GetWorldBonePosition3D();
 		if ((newEffectorPos - clampedTargetPos).GetLength() <= threshold)
 		{
+			stats.m_hasConverged = true;
 			break;
 		}
 	}
+
+	stats.m_residual = (roboticArm.m_bones[endEffector].GetWorldBonePosition3D() - targetPosition).GetLength();
+	stats.m_hasConverged = stats.m_hasConverged || stats.m_residual <= threshold;
+	return stats;
 }
 
 void RoboticArmMode::RenderRoboticArm() const
@@ -3,6 +3,17 @@
 // -----------------------------------------------------------------------------
 class App;
 // -----------------------------------------------------------------------------
+constexpr float ROBOTIC_ARM_DEAD_ZONE_RADIUS = 2.1f;
+// -----------------------------------------------------------------------------
+struct IKSolveStats
+{
+	int   m_iterations = 0;
+	float m_residual = 0.f;
+	bool  m_hasConverged = false;
+	bool  m_wasUnreachable = false;
+	bool  m_wasInDeadZone = false;
+};
+// -----------------------------------------------------------------------------
 class RoboticArmMode : public Game
 {
 public:
@@ -14,7 +25,7 @@ public:
 	void Shutdown() override;
 
 	// Initialization
-	Skeleton InitializeRoboticArm();
+	static Skeleton InitializeRoboticArm();
 	void	 CreateBuffers();
 
 	// Updating
@@ -23,8 +34,12 @@ public:
 	void TargetPositionMovement(float deltaSeconds);
 	void DebugVisuals();
 	void ToggleConstraints();
-	void SolveCCDIK(std::vector<int> const& chainIndices, Vec3 const& targetPosition, int endEffector, int maxIterations = 10, float threshold = 0.01f);
-	void SolveCCDIKConstrained(std::vector<int> const& chainIndices, Vec3 const& targetPosition, int endEffector, int maxIterations = 10, float threshold = 0.01f);
+
+	// Solvers are static so tools can run them on their own copy of the arm
+	static void UpdateClawMidpoint(Skeleton& roboticArm, int endEffector);
+	static IKSolveStats SolveFixedChainCCDIK(Skeleton& roboticArm, Vec3 const& targetPosition, int maxIterations = 10, float threshold = 0.01f);
+	static IKSolveStats SolveCCDIK(Skeleton& roboticArm, std::vector<int> const& chainIndices, Vec3 const& targetPosition, int endEffector, int maxIterations = 10, float threshold = 0.01f);
+	static IKSolveStats SolveCCDIKConstrained(Skeleton& roboticArm, std::vector<int> const& chainIndices, Vec3 const& targetPosition, int endEffector, int maxIterations = 10, float threshold = 0.01f, float deadZoneRadius = ROBOTIC_ARM_DEAD_ZONE_RADIUS);
 
 	// Rendering
 	void RenderRoboticArm() const;
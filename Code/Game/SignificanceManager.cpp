@@ -0,0 +1,112 @@
+#include "Game/SignificanceManager.hpp"
+#include "Game/Entity.hpp"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <cmath>
+
+bool SignificanceManager::s_isEnabled = true;
+int  SignificanceManager::s_forcedTier = -1;
+
+int EntityLOD::GetSlices(int fullSlices) const
+{
+	return GetMax(static_cast<int>(static_cast<float>(fullSlices) * m_tessellationScale + 0.5f), 3);
+}
+
+int EntityLOD::GetStacks(int fullStacks) const
+{
+	return GetMax(static_cast<int>(static_cast<float>(fullStacks) * m_tessellationScale + 0.5f), 2);
+}
+
+SignificanceManager::SignificanceManager()
+{
+	// Screen fraction is the bounding radius over the half-height of the view at that distance
+	m_tiers[SIGNIFICANCE_FULL] = { SIGNIFICANCE_FULL, 0.1f, 1, true, HAIR_DETAIL_FULL, 1, 1.f };
+	m_tiers[SIGNIFICANCE_REDUCED] = { SIGNIFICANCE_REDUCED, 0.04f, 2, true, HAIR_DETAIL_REDUCED, 2, 0.5f };
+	m_tiers[SIGNIFICANCE_LOW] = { SIGNIFICANCE_LOW, 0.015f, 4, false, HAIR_DETAIL_REDUCED, 4, 0.25f };
+	m_tiers[SIGNIFICANCE_MINIMAL] = { SIGNIFICANCE_MINIMAL, 0.f, 8, false, HAIR_DETAIL_FROZEN, 4, 0.25f };
+}
+
+void SignificanceManager::SetCamera(Vec3 const& cameraPosition, Vec3 const& cameraForward, float verticalFovDegrees, float farPlane)
+{
+	m_cameraPosition = cameraPosition;
+	m_cameraForward = cameraForward;
+	m_inverseTanHalfFov = 1.f / tanf(ConvertDegreesToRadians(verticalFovDegrees * 0.5f));
+	m_farPlane = farPlane;
+}
+
+void SignificanceManager::BeginFrame()
+{
+	++m_frameIndex;
+	for (int tierIndex = 0; tierIndex < NUM_SIGNIFICANCE_TIERS; ++tierIndex)
+	{
+		m_numEntitiesInTier[tierIndex] = 0;
+	}
+}
+
+void SignificanceManager::ScoreEntity(Entity& entity)
+{
+	SignificanceTier tier = SIGNIFICANCE_FULL;
+	if (s_forcedTier >= 0 && s_forcedTier < NUM_SIGNIFICANCE_TIERS)
+	{
+		tier = static_cast<SignificanceTier>(s_forcedTier);
+	}
+	else if (s_isEnabled)
+	{
+		entity.m_screenFraction = ComputeScreenFraction(entity.m_worldPosition, entity.m_boundingRadius);
+		tier = SIGNIFICANCE_MINIMAL;
+		for (int tierIndex = 0; tierIndex < NUM_SIGNIFICANCE_TIERS; ++tierIndex)
+		{
+			if (entity.m_screenFraction >= m_tiers[tierIndex].m_minScreenFraction)
+			{
+				tier = static_cast<SignificanceTier>(tierIndex);
+				break;
+			}
+		}
+	}
+
+	entity.m_lod = m_tiers[tier];
+	++m_numEntitiesInTier[tier];
+}
+
+// Entities on the same interval are spread across frames by their index instead of all updating together
+bool SignificanceManager::ShouldUpdateEntity(Entity const& entity, int entityIndex) const
+{
+	int interval = entity.m_lod.m_updateInterval;
+	return interval <= 1 || (m_frameIndex + static_cast<unsigned int>(entityIndex)) % static_cast<unsigned int>(interval) == 0;
+}
+
+float SignificanceManager::ComputeScreenFraction(Vec3 const& worldCenter, float boundingRadius) const
+{
+	Vec3 toEntity = worldCenter - m_cameraPosition;
+	float distance = toEntity.GetLength();
+	if (distance <= boundingRadius)
+	{
+		return 1.f;
+	}
+
+	float depth = DotProduct3D(toEntity, m_cameraForward);
+	if (depth < -boundingRadius || depth - boundingRadius > m_farPlane)
+	{
+		return 0.f;
+	}
+	return boundingRadius * m_inverseTanHalfFov / distance;
+}
+
+EntityLOD const& SignificanceManager::GetTierSettings(SignificanceTier tier) const
+{
+	return m_tiers[tier];
+}
+
+int SignificanceManager::GetNumEntitiesInTier(SignificanceTier tier) const
+{
+	return m_numEntitiesInTier[tier];
+}
+
+bool SignificanceManager::Command_Significance(EventArgs& args)
+{
+	s_isEnabled = args.GetValue("enabled", s_isEnabled);
+	s_forcedTier = GetClamped(args.GetValue("tier", s_forcedTier), -1, NUM_SIGNIFICANCE_TIERS - 1);
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Significance %s, forced tier %d", s_isEnabled ? "enabled" : "disabled (everything full)", s_forcedTier));
+	return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "Engine/Math/Vec3.h"
+#include "Engine/Core/EventSystem.hpp"
+// -----------------------------------------------------------------------------
+class Entity;
+// -----------------------------------------------------------------------------
+enum SignificanceTier
+{
+	SIGNIFICANCE_FULL,
+	SIGNIFICANCE_REDUCED,
+	SIGNIFICANCE_LOW,
+	SIGNIFICANCE_MINIMAL,
+	NUM_SIGNIFICANCE_TIERS
+};
+
+enum HairDetail
+{
+	HAIR_DETAIL_FULL,
+	HAIR_DETAIL_REDUCED,	// Every m_hairStrandStride-th strand is simulated and drawn
+	HAIR_DETAIL_FROZEN		// Strands are drawn at rest, no simulation
+};
+// -----------------------------------------------------------------------------
+// What an entity is allowed to spend this frame. Full is what every entity used to get.
+struct EntityLOD
+{
+	SignificanceTier m_tier = SIGNIFICANCE_FULL;
+	float	   m_minScreenFraction = 0.f;		// Tier applies at or above this projected size
+	int		   m_updateInterval = 1;			// Frames between updates; skipped time is handed to the next one
+	bool	   m_allowsAnimationBlending = true;
+	HairDetail m_hairDetail = HAIR_DETAIL_FULL;
+	int		   m_hairStrandStride = 1;
+	float	   m_tessellationScale = 1.f;
+
+	int GetSlices(int fullSlices) const;
+	int GetStacks(int fullStacks) const;
+};
+// -----------------------------------------------------------------------------
+// Scores every entity by how large it projects on screen from the game camera and hands it
+// the matching tier, so frame cost follows what is visible rather than how many animals exist.
+// Entities behind the camera or past the far plane drop to the lowest tier.
+class SignificanceManager
+{
+public:
+	SignificanceManager();
+
+	void SetCamera(Vec3 const& cameraPosition, Vec3 const& cameraForward, float verticalFovDegrees, float farPlane);
+	void BeginFrame();
+	void ScoreEntity(Entity& entity);
+	bool ShouldUpdateEntity(Entity const& entity, int entityIndex) const;
+
+	float ComputeScreenFraction(Vec3 const& worldCenter, float boundingRadius) const;
+	EntityLOD const& GetTierSettings(SignificanceTier tier) const;
+	int GetNumEntitiesInTier(SignificanceTier tier) const;
+
+	static bool Command_Significance(EventArgs& args);
+
+public:
+	static bool s_isEnabled;
+	static int  s_forcedTier;		// -1 scores normally
+
+private:
+	EntityLOD m_tiers[NUM_SIGNIFICANCE_TIERS];
+	int		  m_numEntitiesInTier[NUM_SIGNIFICANCE_TIERS] = {};
+	Vec3	  m_cameraPosition = Vec3::ZERO;
+	Vec3	  m_cameraForward = Vec3::XAXE;
+	float	  m_inverseTanHalfFov = 1.f;
+	float	  m_farPlane = 750.f;
+	unsigned int m_frameIndex = 0;
+};
@@ -0,0 +1,149 @@
+#include "Game/SkeletonBoneTable.hpp"
+
+void SkeletonBoneTable::Build(Skeleton const& skeleton, unsigned int const* roles)
+{
+	Clear();
+
+	int numBones = static_cast<int>(skeleton.m_bones.size());
+	m_indexByName.reserve(numBones);
+	m_roles.resize(numBones, BONE_ROLE_NONE);
+
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+	{
+		Bone const& bone = skeleton.m_bones[boneIndex];
+
+		// First bone with a given name wins, matching Skeleton::FindBoneIndexByName
+		m_indexByName.emplace(bone.m_boneName, boneIndex);
+
+		unsigned int boneRoles = roles ? roles[boneIndex] : ClassifyBoneName(bone.m_boneName);
+		if (bone.m_parentBoneIndex < 0)
+		{
+			boneRoles |= BONE_ROLE_ROOT;
+		}
+		m_roles[boneIndex] |= boneRoles;
+	}
+
+	// Leaves are found from the parent links since child lists aren't filled in by every rig
+	std::vector<bool> hasChildren(numBones, false);
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+	{
+		int parentIndex = skeleton.m_bones[boneIndex].m_parentBoneIndex;
+		if (parentIndex >= 0 && parentIndex < numBones)
+		{
+			hasChildren[parentIndex] = true;
+		}
+	}
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+	{
+		if (!hasChildren[boneIndex])
+		{
+			m_roles[boneIndex] |= BONE_ROLE_LEAF;
+		}
+	}
+}
+
+void SkeletonBoneTable::Clear()
+{
+	m_indexByName.clear();
+	m_roles.clear();
+}
+
+int SkeletonBoneTable::FindBoneIndex(std::string const& boneName) const
+{
+	auto found = m_indexByName.find(boneName);
+	if (found == m_indexByName.end())
+	{
+		return -1;
+	}
+	return found->second;
+}
+
+unsigned int SkeletonBoneTable::GetRoles(int boneIndex) const
+{
+	if (boneIndex < 0 || boneIndex >= static_cast<int>(m_roles.size()))
+	{
+		return BONE_ROLE_NONE;
+	}
+	return m_roles[boneIndex];
+}
+
+bool SkeletonBoneTable::HasRole(int boneIndex, unsigned int roleMask) const
+{
+	return (GetRoles(boneIndex) & roleMask) != 0;
+}
+
+void SkeletonBoneTable::AddRoles(int boneIndex, unsigned int roleMask)
+{
+	if (boneIndex >= 0 && boneIndex < static_cast<int>(m_roles.size()))
+	{
+		m_roles[boneIndex] |= roleMask;
+	}
+}
+
+std::vector<int> SkeletonBoneTable::GetBoneIndicesWithRole(unsigned int roleMask) const
+{
+	std::vector<int> boneIndices;
+	for (int boneIndex = 0; boneIndex < static_cast<int>(m_roles.size()); ++boneIndex)
+	{
+		if (m_roles[boneIndex] & roleMask)
+		{
+			boneIndices.push_back(boneIndex);
+		}
+	}
+	return boneIndices;
+}
+
+int SkeletonBoneTable::GetNumBones() const
+{
+	return static_cast<int>(m_roles.size());
+}
+
+size_t SkeletonBoneTable::GetMemoryBytes() const
+{
+	// Rough node cost for the hash map: key, value, next pointer and cached hash
+	size_t bytes = m_roles.capacity() * sizeof(unsigned int);
+	bytes += m_indexByName.bucket_count() * sizeof(void*);
+	for (auto const& entry : m_indexByName)
+	{
+		bytes += sizeof(entry) + 2 * sizeof(void*) + entry.first.capacity();
+	}
+	return bytes;
+}
+
+unsigned int SkeletonBoneTable::ClassifyBoneName(std::string const& boneName)
+{
+	auto contains = [&boneName](char const* token) { return boneName.find(token) != std::string::npos; };
+
+	unsigned int roles = BONE_ROLE_NONE;
+	if (contains("Head"))		roles |= BONE_ROLE_HEAD;
+	if (contains("Body"))		roles |= BONE_ROLE_BODY;
+	if (contains("Abdomen"))	roles |= BONE_ROLE_ABDOMEN;
+	if (contains("Femur"))		roles |= BONE_ROLE_FEMUR;
+	if (contains("Tibia"))		roles |= BONE_ROLE_TIBIA;
+	if (contains("Shoulder"))	roles |= BONE_ROLE_SHOULDER;
+	if (contains("Hand"))		roles |= BONE_ROLE_HAND;
+	if (contains("Foot"))		roles |= BONE_ROLE_FOOT;
+	if (contains("Tip"))		roles |= BONE_ROLE_TIP;
+
+	// "MetaTarsus" also contains "Tarsus", so only one of the two applies
+	if (contains("MetaTarsus"))
+	{
+		roles |= BONE_ROLE_METATARSUS;
+	}
+	else if (contains("Tarsus"))
+	{
+		roles |= BONE_ROLE_TARSUS;
+	}
+
+	// Sides are either spelled out ("LeftFrontFemur") or a single capital prefix ("LShoulder")
+	bool hasSidePrefix = boneName.size() > 1 && boneName[1] >= 'A' && boneName[1] <= 'Z';
+	if (boneName.rfind("Left", 0) == 0 || (hasSidePrefix && boneName[0] == 'L'))
+	{
+		roles |= BONE_ROLE_LEFT;
+	}
+	else if (boneName.rfind("Right", 0) == 0 || (hasSidePrefix && boneName[0] == 'R'))
+	{
+		roles |= BONE_ROLE_RIGHT;
+	}
+	return roles;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "Engine/Skeleton/Skeleton.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+// -----------------------------------------------------------------------------
+enum BoneRole : unsigned int
+{
+	BONE_ROLE_NONE		 = 0,
+	BONE_ROLE_ROOT		 = 1 << 0,
+	BONE_ROLE_HEAD		 = 1 << 1,
+	BONE_ROLE_BODY		 = 1 << 2,
+	BONE_ROLE_ABDOMEN	 = 1 << 3,
+	BONE_ROLE_FEMUR		 = 1 << 4,
+	BONE_ROLE_TIBIA		 = 1 << 5,
+	BONE_ROLE_METATARSUS = 1 << 6,
+	BONE_ROLE_TARSUS	 = 1 << 7,
+	BONE_ROLE_SHOULDER	 = 1 << 8,
+	BONE_ROLE_HAND		 = 1 << 9,
+	BONE_ROLE_FOOT		 = 1 << 10,
+	BONE_ROLE_TIP		 = 1 << 11,
+	BONE_ROLE_LEFT		 = 1 << 12,
+	BONE_ROLE_RIGHT		 = 1 << 13,
+	BONE_ROLE_LEAF		 = 1 << 14,
+};
+// -----------------------------------------------------------------------------
+// Built once when a skeleton is created. Name lookups go through a hash instead of a
+// linear scan, and every bone gets a role mask so per-frame loops can test roles with
+// a single AND rather than searching bone names. Roles come from the names unless the
+// caller already has them (e.g. from a rig asset).
+class SkeletonBoneTable
+{
+public:
+	void Build(Skeleton const& skeleton, unsigned int const* roles = nullptr);
+	void Clear();
+
+	int  FindBoneIndex(std::string const& boneName) const;
+	unsigned int GetRoles(int boneIndex) const;
+	bool HasRole(int boneIndex, unsigned int roleMask) const;
+	void AddRoles(int boneIndex, unsigned int roleMask);
+	std::vector<int> GetBoneIndicesWithRole(unsigned int roleMask) const;
+	int  GetNumBones() const;
+	size_t GetMemoryBytes() const;
+
+	static unsigned int ClassifyBoneName(std::string const& boneName);
+
+private:
+	std::unordered_map<std::string, int> m_indexByName;
+	std::vector<unsigned int> m_roles;
+};
@@ -0,0 +1,326 @@
+#include "Game/SkeletonDefinition.hpp"
+#include "Game/ThreadPool.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+	// MSVC keeps strings up to this length in the inline buffer
+	constexpr size_t SMALL_STRING_CAPACITY = 15;
+
+	// Definitions that currently point into a mapped rig
+	std::mutex& GetMappedDefinitionsMutex()
+	{
+		static std::mutex s_mutex;
+		return s_mutex;
+	}
+
+	std::vector<SkeletonDefinition*>& GetMappedDefinitions()
+	{
+		static std::vector<SkeletonDefinition*> s_definitions;
+		return s_definitions;
+	}
+
+	void CopySkeletonIntoPose(Skeleton const& skeleton, SkeletonPose& pose)
+	{
+		int numBones = static_cast<int>(skeleton.m_bones.size());
+		pose.m_localPositions.resize(numBones);
+		pose.m_localRotations.resize(numBones);
+		pose.m_worldTransforms.resize(numBones);
+
+		for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+		{
+			Bone const& bone = skeleton.m_bones[boneIndex];
+			pose.m_localPositions[boneIndex] = bone.m_localPosition;
+			pose.m_localRotations[boneIndex] = bone.m_localRotation;
+			pose.m_worldTransforms[boneIndex] = bone.m_worldBoneTransform;
+		}
+		pose.m_modelTransform = skeleton.m_skeletonModelTransform;
+	}
+}
+
+int SkeletonPose::GetNumBones() const
+{
+	return static_cast<int>(m_localPositions.size());
+}
+
+Vec3 SkeletonPose::GetWorldBonePosition3D(int boneIndex) const
+{
+	return m_worldTransforms[boneIndex].GetTranslation3D();
+}
+
+Mat44 const& SkeletonPose::GetWorldBoneMat44(int boneIndex) const
+{
+	return m_worldTransforms[boneIndex];
+}
+
+// Centered on the box around the bone origins; callers pad the radius for whatever they draw around the bones
+void SkeletonPose::ComputeBoundingSphere(Vec3& outCenter, float& outRadius) const
+{
+	int numBones = GetNumBones();
+	if (numBones == 0)
+	{
+		outCenter = m_modelTransform.GetTranslation3D();
+		outRadius = 0.f;
+		return;
+	}
+
+	Vec3 mins = GetWorldBonePosition3D(0);
+	Vec3 maxs = mins;
+	for (int boneIndex = 1; boneIndex < numBones; ++boneIndex)
+	{
+		Vec3 bonePosition = GetWorldBonePosition3D(boneIndex);
+		mins = Vec3(GetMin(mins.x, bonePosition.x), GetMin(mins.y, bonePosition.y), GetMin(mins.z, bonePosition.z));
+		maxs = Vec3(GetMax(maxs.x, bonePosition.x), GetMax(maxs.y, bonePosition.y), GetMax(maxs.z, bonePosition.z));
+	}
+
+	outCenter = (mins + maxs) * 0.5f;
+	float radiusSquared = 0.f;
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+	{
+		radiusSquared = GetMax(radiusSquared, (GetWorldBonePosition3D(boneIndex) - outCenter).GetLengthSquared());
+	}
+	outRadius = sqrtf(radiusSquared);
+}
+
+// For drawing between two simulated poses: world transforms blend as rigid transforms, locals
+// are taken from current. The only matrix to quaternion conversion a pose goes through.
+void SkeletonPose::SetInterpolated(SkeletonPose const& previous, SkeletonPose const& current, float fraction)
+{
+	m_localPositions = current.m_localPositions;
+	m_localRotations = current.m_localRotations;
+	m_modelTransform = current.m_modelTransform;
+	if (fraction >= 1.f || previous.GetNumBones() != current.GetNumBones())
+	{
+		m_worldTransforms = current.m_worldTransforms;
+		return;
+	}
+
+	int numBones = current.GetNumBones();
+	m_worldTransforms.resize(numBones);
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+	{
+		RigidTransform previousTransform = RigidTransform::MakeFromMat44(previous.m_worldTransforms[boneIndex]);
+		RigidTransform currentTransform = RigidTransform::MakeFromMat44(current.m_worldTransforms[boneIndex]);
+		m_worldTransforms[boneIndex] = RigidTransform::Interpolate(previousTransform, currentTransform, fraction).GetAsMat44();
+	}
+}
+
+size_t SkeletonPose::GetMemoryBytes() const
+{
+	return sizeof(SkeletonPose) + m_localPositions.capacity() * sizeof(Vec3) + m_localRotations.capacity() * sizeof(Quat) + m_worldTransforms.capacity() * sizeof(Mat44);
+}
+
+SkeletonDefinition::SkeletonDefinition(std::string const& name, Skeleton restSkeleton)
+	:m_name(name)
+	,m_restSkeleton(std::move(restSkeleton))
+{
+	Initialize(nullptr);
+}
+
+SkeletonDefinition::SkeletonDefinition(std::string const& rigName, Skeleton (*createFallbackSkeleton)())
+	:m_name(rigName)
+	,m_rigAsset(std::make_unique<RigAsset>())
+{
+	if (m_rigAsset->LoadOrCook(RigAsset::GetTextPath(rigName), RigAsset::GetBinaryPath(rigName)))
+	{
+		m_restSkeleton = m_rigAsset->CreateSkeleton();
+		m_parentIndices = m_rigAsset->GetParentIndices();
+		m_restPositions = m_rigAsset->GetRestPositions();
+		Initialize(m_rigAsset->GetRoles());
+
+		std::lock_guard<std::mutex> lock(GetMappedDefinitionsMutex());
+		GetMappedDefinitions().push_back(this);
+		return;
+	}
+
+	m_rigAsset.reset();
+	m_restSkeleton = createFallbackSkeleton();
+	Initialize(nullptr);
+}
+
+SkeletonDefinition::~SkeletonDefinition()
+{
+	std::lock_guard<std::mutex> lock(GetMappedDefinitionsMutex());
+	std::vector<SkeletonDefinition*>& definitions = GetMappedDefinitions();
+	definitions.erase(std::remove(definitions.begin(), definitions.end(), this), definitions.end());
+}
+
+void SkeletonDefinition::Initialize(uint32_t const* rigRoles)
+{
+	m_restSkeleton.UpdateSkeletonPose();
+	m_boneTable.Build(m_restSkeleton, rigRoles);
+	m_standaloneSkeletonBytes = GetSkeletonMemoryBytes(m_restSkeleton);
+
+	int numBones = static_cast<int>(m_restSkeleton.m_bones.size());
+	if (m_parentIndices == nullptr)
+	{
+		m_ownedParentIndices.reserve(numBones);
+		m_ownedRestPositions.reserve(numBones);
+		for (Bone const& bone : m_restSkeleton.m_bones)
+		{
+			m_ownedParentIndices.push_back(bone.m_parentBoneIndex);
+			m_ownedRestPositions.push_back(bone.m_localPosition);
+		}
+		m_parentIndices = m_ownedParentIndices.data();
+		m_restPositions = m_ownedRestPositions.data();
+	}
+
+	// Names only live in the bone table (and a debug copy); resolve anything else by index
+	for (Bone& bone : m_restSkeleton.m_bones)
+	{
+#if defined(_DEBUG)
+		m_debugBoneNames.push_back(bone.m_boneName);
+#else
+		std::string().swap(bone.m_boneName);
+#endif
+	}
+
+	m_workingSkeletons.assign(ThreadPool::GetMaxNumThreads(), m_restSkeleton);
+}
+
+SkeletonPose SkeletonDefinition::CreateRestPose() const
+{
+	SkeletonPose pose;
+	CopySkeletonIntoPose(m_restSkeleton, pose);
+	return pose;
+}
+
+Skeleton& SkeletonDefinition::BindPose(SkeletonPose const& pose) const
+{
+	Skeleton& workingSkeleton = m_workingSkeletons[ThreadPool::GetThreadIndex()];
+	int numBones = GetNumBones();
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
+	{
+		Bone& bone = workingSkeleton.m_bones[boneIndex];
+		bone.SetLocalBonePosition(pose.m_localPositions[boneIndex]);
+		bone.SetLocalBoneRotation(pose.m_localRotations[boneIndex]);
+		bone.m_worldBoneTransform = pose.m_worldTransforms[boneIndex];
+	}
+	workingSkeleton.m_skeletonModelTransform = pose.m_modelTransform;
+	return workingSkeleton;
+}
+
+void SkeletonDefinition::StorePose(SkeletonPose& pose) const
+{
+	CopySkeletonIntoPose(m_workingSkeletons[ThreadPool::GetThreadIndex()], pose);
+}
+
+std::string const& SkeletonDefinition::GetName() const
+{
+	return m_name;
+}
+
+int SkeletonDefinition::GetNumBones() const
+{
+	return static_cast<int>(m_restSkeleton.m_bones.size());
+}
+
+int SkeletonDefinition::GetParentIndex(int boneIndex) const
+{
+	return m_parentIndices[boneIndex];
+}
+
+Vec3 SkeletonDefinition::GetRestLocalPosition(int boneIndex) const
+{
+	return m_restPositions[boneIndex];
+}
+
+Skeleton const& SkeletonDefinition::GetRestSkeleton() const
+{
+	return m_restSkeleton;
+}
+
+SkeletonBoneTable const& SkeletonDefinition::GetBoneTable() const
+{
+	return m_boneTable;
+}
+
+std::string SkeletonDefinition::GetBoneName(int boneIndex) const
+{
+#if defined(_DEBUG)
+	return m_debugBoneNames[boneIndex];
+#else
+	return std::to_string(boneIndex);
+#endif
+}
+
+size_t SkeletonDefinition::GetSharedMemoryBytes() const
+{
+	size_t bytes = sizeof(SkeletonDefinition) + m_name.capacity();
+	bytes += GetSkeletonMemoryBytes(m_restSkeleton);
+	for (Skeleton const& workingSkeleton : m_workingSkeletons)
+	{
+		bytes += GetSkeletonMemoryBytes(workingSkeleton);
+	}
+	bytes += m_ownedParentIndices.capacity() * sizeof(int32_t) + m_ownedRestPositions.capacity() * sizeof(Vec3);
+	bytes += m_boneTable.GetMemoryBytes();
+	if (m_rigAsset)
+	{
+		bytes += sizeof(RigAsset) + m_rigAsset->GetSizeBytes();
+	}
+#if defined(_DEBUG)
+	bytes += m_debugBoneNames.capacity() * sizeof(std::string);
+	for (std::string const& boneName : m_debugBoneNames)
+	{
+		if (boneName.capacity() > SMALL_STRING_CAPACITY)
+		{
+			bytes += boneName.capacity() + 1;
+		}
+	}
+#endif
+	return bytes;
+}
+
+bool SkeletonDefinition::IsLoadedFromRigAsset() const
+{
+	return m_rigAsset != nullptr;
+}
+
+// Called before a rig is re-cooked, while nothing is updating on the workers
+void SkeletonDefinition::ReleaseRigAsset(std::string const& rigName)
+{
+	std::lock_guard<std::mutex> lock(GetMappedDefinitionsMutex());
+	std::vector<SkeletonDefinition*>& definitions = GetMappedDefinitions();
+	for (auto iterator = definitions.begin(); iterator != definitions.end();)
+	{
+		if ((*iterator)->m_name == rigName)
+		{
+			(*iterator)->DetachFromRigAsset();
+			iterator = definitions.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+}
+
+void SkeletonDefinition::DetachFromRigAsset()
+{
+	int numBones = GetNumBones();
+	m_ownedParentIndices.assign(m_parentIndices, m_parentIndices + numBones);
+	m_ownedRestPositions.assign(m_restPositions, m_restPositions + numBones);
+	m_parentIndices = m_ownedParentIndices.data();
+	m_restPositions = m_ownedRestPositions.data();
+	m_rigAsset.reset();
+}
+
+size_t SkeletonDefinition::GetStandaloneSkeletonBytes() const
+{
+	return m_standaloneSkeletonBytes;
+}
+
+size_t SkeletonDefinition::GetSkeletonMemoryBytes(Skeleton const& skeleton)
+{
+	size_t bytes = sizeof(Skeleton) + skeleton.m_bones.capacity() * sizeof(Bone);
+	for (Bone const& bone : skeleton.m_bones)
+	{
+		if (bone.m_boneName.capacity() > SMALL_STRING_CAPACITY)
+		{
+			bytes += bone.m_boneName.capacity() + 1;
+		}
+		bytes += bone.m_childBoneIndices.capacity() * sizeof(unsigned int);
+	}
+	return bytes;
+}
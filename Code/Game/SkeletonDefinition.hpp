@@ -0,0 +1,83 @@
+#pragma once
+#include "Game/SkeletonBoneTable.hpp"
+#include "Game/RigAsset.hpp"
+#include "Game/RigidTransform.hpp"
+#include "Engine/Skeleton/Skeleton.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+// -----------------------------------------------------------------------------
+// The only per-instance skeleton state: local TRS and the resulting world transforms.
+// World poses stay in the Mat44s the engine's FK produces, so binding and storing a pose
+// is a copy; only interpolating between two poses goes through RigidTransform.
+struct SkeletonPose
+{
+	std::vector<Vec3>  m_localPositions;
+	std::vector<Quat>  m_localRotations;
+	std::vector<Mat44> m_worldTransforms;
+	Mat44 m_modelTransform;
+
+	int    GetNumBones() const;
+	Vec3   GetWorldBonePosition3D(int boneIndex) const;
+	Mat44 const& GetWorldBoneMat44(int boneIndex) const;
+	void   ComputeBoundingSphere(Vec3& outCenter, float& outRadius) const;
+	void   SetInterpolated(SkeletonPose const& previous, SkeletonPose const& current, float fraction);
+	size_t GetMemoryBytes() const;
+};
+// -----------------------------------------------------------------------------
+// Immutable rig shared by every instance of a species: hierarchy, rest pose, constraints
+// and the bone table. Engine calls that need a full Skeleton run on a working copy owned
+// by the definition; BindPose loads an instance's pose into it and StorePose reads the
+// result back, so instances never carry names, constraints or child lists of their own.
+// There is one working copy per ThreadPool thread, so instances can update in parallel as
+// long as each thread binds and stores its own.
+// When built from a rig asset, the parent indices, rest positions and roles are read
+// straight out of the mapped file. Re-cooking that rig copies them out and drops the
+// mapping; live instances keep the rig they were built with until the next launch.
+class SkeletonDefinition
+{
+public:
+	SkeletonDefinition(std::string const& name, Skeleton restSkeleton);
+	SkeletonDefinition(std::string const& rigName, Skeleton (*createFallbackSkeleton)());
+	~SkeletonDefinition();
+	SkeletonDefinition(SkeletonDefinition const& copy) = delete;
+	SkeletonDefinition& operator=(SkeletonDefinition const& copy) = delete;
+
+	SkeletonPose CreateRestPose() const;
+	Skeleton& BindPose(SkeletonPose const& pose) const;
+	void StorePose(SkeletonPose& pose) const;
+
+	std::string const& GetName() const;
+	int  GetNumBones() const;
+	int  GetParentIndex(int boneIndex) const;
+	Vec3 GetRestLocalPosition(int boneIndex) const;
+	Skeleton const& GetRestSkeleton() const;
+	SkeletonBoneTable const& GetBoneTable() const;
+	std::string GetBoneName(int boneIndex) const;
+
+	size_t GetSharedMemoryBytes() const;
+	size_t GetStandaloneSkeletonBytes() const;
+	static size_t GetSkeletonMemoryBytes(Skeleton const& skeleton);
+
+	bool IsLoadedFromRigAsset() const;
+	static void ReleaseRigAsset(std::string const& rigName);
+
+private:
+	void Initialize(uint32_t const* rigRoles);
+	void DetachFromRigAsset();
+
+private:
+	std::string m_name;
+	std::unique_ptr<RigAsset> m_rigAsset;
+	Skeleton m_restSkeleton;
+	int32_t const* m_parentIndices = nullptr;
+	Vec3 const* m_restPositions = nullptr;
+	std::vector<int32_t> m_ownedParentIndices;
+	std::vector<Vec3> m_ownedRestPositions;
+	SkeletonBoneTable m_boneTable;
+	size_t m_standaloneSkeletonBytes = 0;
+	mutable std::vector<Skeleton> m_workingSkeletons;	// Indexed by ThreadPool::GetThreadIndex
+#if defined(_DEBUG)
+	std::vector<std::string> m_debugBoneNames;
+#endif
+};
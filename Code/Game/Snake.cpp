@@ -2,10 +2,27 @@
 #include "Game/GameCommon.h"
 #include "Game/AnimalMode.hpp"
 #include "Game/Terrain.hpp"
+#include "Game/FrameProfiler.hpp"
 #include "Engine/Input/InputSystem.h"
 #include "Engine/Renderer/Renderer.h"
-#include "Engine/Animation/Animation.hpp"
 #include "Engine/AI/BehaviorTree.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <iterator>
+
+constexpr float SNAKE_ANIM_CROSSFADE_SECONDS = 0.3f;
+constexpr float SNAKE_BOUNDS_PADDING = 0.35f;
+
+// Graph names in SnakeAnimClip and SnakeAnimTrigger order. States and triggers get dense IDs in
+// the order they are added, so registering from these tables makes every ID its enum value and
+// runtime checks are integer compares; names only matter here and to tools
+static constexpr char const* SNAKE_ANIM_STATE_NAMES[] = { "Idle", "IdleTailFlick", "IdleHeadRaise", "Slither" };
+static constexpr char const* SNAKE_ANIM_TRIGGER_NAMES[] = { "StartSlither", "StopSlither" };
+static_assert(std::size(SNAKE_ANIM_STATE_NAMES) == NUM_SNAKE_ANIM_CLIPS, "One state name per SnakeAnimClip");
+static_assert(std::size(SNAKE_ANIM_TRIGGER_NAMES) == NUM_SNAKE_ANIM_TRIGGERS, "One trigger name per SnakeAnimTrigger");
+
+bool Snake::s_playsBakedClips = true;
 
 Snake::Snake(AnimalMode* animalMode, Vec3 position)
 	:Entity(animalMode, position)
@@ -16,96 +33,97 @@ Snake::Snake(AnimalMode* animalMode, Vec3 position)
 
 Snake::~Snake()
 {
-	DeleteAnimations();
-
-	delete m_snakeBT;
-	m_snakeBT = nullptr;
+	m_animalMode->m_snakeBehaviors.RemoveInstance(m_behaviorInstance);
 }
 
 void Snake::Initialize()
 {
 	// Initialize the skeleton
-	m_snakeSkeleton = CreateSkeleton();
-
-	m_snakeInitialPositions.clear();
-	for (int snakeBoneIndex = 0; snakeBoneIndex < static_cast<int>(m_snakeSkeleton.m_bones.size()); ++snakeBoneIndex)
-	{
-		Bone& snakeBone = m_snakeSkeleton.m_bones[snakeBoneIndex];
-		m_snakeInitialPositions.push_back(snakeBone.m_localPosition);
-
-		Vec3 direction = Vec3::XAXE;
-		if (snakeBone.m_parentBoneIndex != -1)
-		{
-			Vec3 parentPos = m_snakeSkeleton.m_bones[snakeBone.m_parentBoneIndex].m_localPosition;
-			direction = snakeBone.m_localPosition - parentPos;
-			if (!direction.IsNearlyZero())
-			{
-				direction.Normalize();
-			}
-		}
-		m_snakeAnimationDirs.push_back(direction);
-	}
+	m_definition = &GetSkeletonDefinition();
+	m_pose = m_definition->CreateRestPose();
+	m_boundingRadius = 2.5f;
 
 	SetupAnimations();
-	m_snakeBT = CreateSnakeBehaviorTree(this);
+	m_behaviorInstance = m_animalMode->m_snakeBehaviors.AddInstance(this);
 }
 
-void Snake::Update(float deltaSeconds)
+void Snake::Simulate(float deltaSeconds)
 {
-	if (m_snakeBT)
+	// While asleep the previous pose already matches the current one
+	if (!m_isAsleep)
 	{
-		m_snakeBT->Update(deltaSeconds);
+		m_previousPose = m_pose;
 	}
-
+	m_isPreviousPoseValid = m_hasSimulated;
 	CheckTransitions();
-	m_snakeStateMachine.Update(m_snakeSkeleton, static_cast<float>(deltaSeconds));
+	float animationSeconds = m_isParked ? 0.f : deltaSeconds;
+	m_animState.Update(animationSeconds);
+	m_animPlayer.Update(animationSeconds);
+
+	EntityPoseInputs poseInputs = GetPoseInputs();
+	poseInputs.m_animState = m_animState.GetCurrentState();
+	poseInputs.m_animStateTime = m_animState.GetStateTime();
+	if (TrySleep(poseInputs))
+	{
+		return;
+	}
 
-	if (!IsMoving())
 	{
-		UpdateVerts();
+		ScopedFrameTimer poseTimer(FRAME_SUBSYSTEM_POSE);
+		Skeleton& snakeSkeleton = m_definition->BindPose(m_pose);
+		m_animPlayer.SetClip(&GetAnimClip(static_cast<SnakeAnimClip>(m_animState.GetCurrentState())), m_animState.GetStateTime());
+		m_animPlayer.Evaluate(snakeSkeleton, m_lod.m_allowsAnimationBlending);
+
+		if (IsMoving())
+		{
+			UpdateSnakePose(snakeSkeleton, animationSeconds);
+		}
+		m_definition->StorePose(m_pose);
 	}
-	else
+	UpdateBounds(m_pose, SNAKE_BOUNDS_PADDING);
+	m_hasSimulated = true;
+}
+
+void Snake::UpdateMesh(float interpolation)
+{
+	if (!BeginMeshUpdate())
 	{
-		UpdateSnakePose(static_cast<float>(deltaSeconds));
-		UpdateVerts();
+		return;
 	}
+	ScopedFrameTimer vertsTimer(FRAME_SUBSYSTEM_VERTS);
+	m_drawPose.SetInterpolated(m_previousPose, m_pose, m_isPreviousPoseValid ? interpolation : 1.f);
+	UpdateVerts();
 }
 
 void Snake::CheckTransitions()
 {
 	if (IsMoving())
 	{
-		if (m_snakeStateMachine.GetCurrentAnimStateName() != "Slither")
+		if (m_animState.GetCurrentState() != SNAKE_ANIM_SLITHER)
 		{
-			m_snakeStateMachine.TriggerTransition("StartSlither");
+			m_animState.TriggerTransition(SNAKE_TRIGGER_START_SLITHER);
 		}
 	}
 	else
 	{
-		if (m_snakeStateMachine.GetCurrentAnimStateName() != "Idle")
+		if (m_animState.GetCurrentState() != SNAKE_ANIM_IDLE)
 		{
-			m_snakeStateMachine.TriggerTransition("StopSlither");
+			m_animState.TriggerTransition(SNAKE_TRIGGER_STOP_SLITHER);
 		}
 	}
 }
 
-void Snake::UpdateSnakePose(float deltaSeconds)
+void Snake::UpdateSnakePose(Skeleton& snakeSkeleton, float deltaSeconds)
 {
-	static float elapsedTime = 0.f;
-	elapsedTime += deltaSeconds;
+	m_animationTime += deltaSeconds;
 
 	// Smoothly interpolate move direction
-	if (m_moveDirection != m_targetMoveDirection)
-	{
-		m_directionInterpTime += deltaSeconds;
-		float fractionTowardEnd = GetClamped(m_directionInterpTime / m_directionInterpDuration, 0.f, 1.f);
-
-		float easedFraction = SmoothStep3(fractionTowardEnd);
-		m_moveDirection = SLerp(m_moveDirection, m_targetMoveDirection, easedFraction).GetNormalized();
-	}
+	UpdateTurn(deltaSeconds);
 
 	if (!m_isStationary)
 	{
+		SteerAwayFromNeighbors(deltaSeconds);
+
 		// Move snake forward
 		Vec3 snakeMove = -m_moveDirection * m_speed * deltaSeconds;
 		m_worldPosition += snakeMove;
@@ -118,12 +136,13 @@ void Snake::UpdateSnakePose(float deltaSeconds)
 		if (!m_animalMode->m_terrain->IsInBounds(static_cast<int>(m_worldPosition.x), static_cast<int>(m_worldPosition.y)))
 		{
 			m_worldPosition = Vec3(85.f, 45.f, m_animalMode->m_terrain->GetHeightAtXY(85.f, 15.f));
-			elapsedTime = 0.f;
+			m_animationTime = 0.f;
+			m_isPreviousPoseValid = false;
 		}
 	}
 
 	float offset = 1.f;
-	Terrain* terrain = m_animalMode->m_terrain;
+	Terrain const* terrain = m_animalMode->m_terrain;
 
 	// Get current and neighbor positions
 	float hCenter = terrain->GetHeightAtXY(m_worldPosition.x, m_worldPosition.y);
@@ -139,14 +158,14 @@ void Snake::UpdateSnakePose(float deltaSeconds)
 	Mat44 rotation;
 	rotation.SetIJK3D(forward, left, up);
 
-	Vec3 headLocalPos = m_snakeSkeleton.m_bones[0].m_localPosition;
+	Vec3 headLocalPos = snakeSkeleton.m_bones[0].m_localPosition;
 	Vec3 headWorldOffset = rotation.TransformPosition3D(headLocalPos);
 
 	Vec3 skeletonHeadOrigin = m_worldPosition - headWorldOffset;
 	rotation.SetTranslation3D(skeletonHeadOrigin);
 
-	m_snakeSkeleton.m_skeletonModelTransform = rotation;
-	m_snakeSkeleton.UpdateSkeletonPose();
+	snakeSkeleton.m_skeletonModelTransform = rotation;
+	snakeSkeleton.UpdateSkeletonPose();
 }
 
 void Snake::UpdateVerts()
@@ -160,65 +179,68 @@ void Snake::UpdateVerts()
 
 	if (m_animalMode->m_isSkeletonBeingDrawn)
 	{
-		m_snakeSkeleton.AddVertsForSkeleton3D(m_snakeSkeletonVerts);
+		m_definition->BindPose(m_drawPose).AddVertsForSkeleton3D(m_snakeSkeletonVerts);
 	}
 
-	for (int boneIndex = 0; boneIndex < static_cast<int>(m_snakeSkeleton.m_bones.size()); ++boneIndex)
+	int sphereSlices = m_lod.GetSlices(32);
+	int sphereStacks = m_lod.GetStacks(16);
+	int numBones = m_drawPose.GetNumBones();
+	for (int boneIndex = 0; boneIndex < numBones; ++boneIndex)
 	{
-		Bone const& bone = m_snakeSkeleton.m_bones[boneIndex];
-		Vec3 worldPosition = bone.m_worldBoneTransform.GetTranslation3D();
+		Mat44 const& boneTransform = m_drawPose.m_worldTransforms[boneIndex];
+		int parentIndex = m_definition->GetParentIndex(boneIndex);
+		Vec3 worldPosition = boneTransform.GetTranslation3D();
 		float radius = 0.25f;
 
 		// HEAD
 		if (boneIndex == 0)
 		{
 			// Head sphere
-			AddVertsForSphere3D(m_snakeVerts, worldPosition, 0.3f, Rgba8::BROWN);
+			AddVertsForSphere3D(m_snakeVerts, worldPosition, 0.3f, Rgba8::BROWN, AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
 
 			// Eyes offset from head position
-			Vec3 forward = bone.m_worldBoneTransform.GetIBasis3D();
-			Vec3 left = bone.m_worldBoneTransform.GetJBasis3D();
-			Vec3 up = bone.m_worldBoneTransform.GetKBasis3D();
+			Vec3 forward = boneTransform.GetIBasis3D();
+			Vec3 left = boneTransform.GetJBasis3D();
+			Vec3 up = boneTransform.GetKBasis3D();
 
 			// Positioning the eyes
 			Vec3 leftEyePosition = worldPosition - forward * 0.2f + left * 0.1f + up * 0.25f;
 			Vec3 rightEyePosition = worldPosition - forward * 0.2f - left * 0.1f + up * 0.25f;
 
 			// White eye bases
-			AddVertsForSphere3D(m_snakeVertsUntextured, leftEyePosition, 0.05f, Rgba8::WHITE);
-			AddVertsForSphere3D(m_snakeVertsUntextured, rightEyePosition, 0.05f, Rgba8::WHITE);
+			AddVertsForSphere3D(m_snakeVertsUntextured, leftEyePosition, 0.05f, Rgba8::WHITE, AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
+			AddVertsForSphere3D(m_snakeVertsUntextured, rightEyePosition, 0.05f, Rgba8::WHITE, AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
 
 			// Black pupils
 			Vec3 pupilOffset = forward * 0.03f; 
-			AddVertsForSphere3D(m_snakeVertsUntextured, leftEyePosition - pupilOffset, 0.025f, Rgba8::BLACK);
-			AddVertsForSphere3D(m_snakeVertsUntextured, rightEyePosition - pupilOffset, 0.025f, Rgba8::BLACK);
+			AddVertsForSphere3D(m_snakeVertsUntextured, leftEyePosition - pupilOffset, 0.025f, Rgba8::BLACK, AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
+			AddVertsForSphere3D(m_snakeVertsUntextured, rightEyePosition - pupilOffset, 0.025f, Rgba8::BLACK, AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
 		}
 		// TAIL
-		else if (boneIndex == static_cast<int>(m_snakeSkeleton.m_bones.size()) - 1)
+		else if (boneIndex == numBones - 1)
 		{
-			int parentIndex = bone.m_parentBoneIndex;
 			if (parentIndex != -1)
 			{
-				Vec3 parentPosition = m_snakeSkeleton.m_bones[parentIndex].m_worldBoneTransform.GetTranslation3D();
+				Vec3 parentPosition = m_drawPose.GetWorldBonePosition3D(parentIndex);
 				Vec3 tailTip = worldPosition;
 				Vec3 tailBase = parentPosition;
-				AddVertsForCone3D(m_snakeVerts, tailBase, tailTip, radius, Rgba8::BROWN, AABB2::ZERO_TO_ONE, 24);
+				AddVertsForCone3D(m_snakeVerts, tailBase, tailTip, radius, Rgba8::BROWN, AABB2::ZERO_TO_ONE, m_lod.GetSlices(24));
 			}
 		}
 		// BODY SEGMENTS
 		else
 		{
-			AddVertsForSphere3D(m_snakeVerts, worldPosition, radius, Rgba8::BROWN);
+			AddVertsForSphere3D(m_snakeVerts, worldPosition, radius, Rgba8::BROWN, AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
 
-			if (bone.m_parentBoneIndex == -1)
+			if (parentIndex == -1)
 			{
 				continue;
 			}
 
-			Vec3 start = m_snakeSkeleton.m_bones[bone.m_parentBoneIndex].m_worldBoneTransform.GetTranslation3D();
-			Vec3 end = bone.m_worldBoneTransform.GetTranslation3D();
+			Vec3 start = m_drawPose.GetWorldBonePosition3D(parentIndex);
+			Vec3 end = worldPosition;
 
-			AddVertsForCylinder3D(m_snakeVerts, start, end, radius, Rgba8::BROWN, AABB2::ZERO_TO_ONE, 8);
+			AddVertsForCylinder3D(m_snakeVerts, start, end, radius, Rgba8::BROWN, AABB2::ZERO_TO_ONE, m_lod.GetSlices(8));
 		}
 	}
 }
@@ -261,45 +283,208 @@ bool Snake::IsMoving() const
 	return m_isMoving;
 }
 
-AnimStateMachine Snake::GetSnakeStateMachine() const
+AnimStateInstance const& Snake::GetAnimState() const
+{
+	return m_animState;
+}
+
+SkeletonDefinition const& Snake::GetSkeletonDefinition()
+{
+	static SkeletonDefinition const s_snakeDefinition("Snake", &CreateSkeleton);
+	return s_snakeDefinition;
+}
+
+// Unit direction from each bone's parent at rest; the idle and slither waves push along it
+std::vector<Vec3> const& Snake::GetAnimationDirections()
+{
+	static std::vector<Vec3> const s_animationDirs = []()
+	{
+		SkeletonDefinition const& definition = GetSkeletonDefinition();
+		std::vector<Vec3> directions;
+		directions.reserve(definition.GetNumBones());
+		for (int snakeBoneIndex = 0; snakeBoneIndex < definition.GetNumBones(); ++snakeBoneIndex)
+		{
+			Vec3 direction = Vec3::XAXE;
+			int parentIndex = definition.GetParentIndex(snakeBoneIndex);
+			if (parentIndex != -1)
+			{
+				Vec3 parentPos = definition.GetRestLocalPosition(parentIndex);
+				direction = definition.GetRestLocalPosition(snakeBoneIndex) - parentPos;
+				if (!direction.IsNearlyZero())
+				{
+					direction.Normalize();
+				}
+			}
+			directions.push_back(direction);
+		}
+		return directions;
+	}();
+	return s_animationDirs;
+}
+
+// The authored animations. They only depend on the shared definition, so they can be baked once per species.
+AnimationSampler Snake::GetProceduralAnimation(SnakeAnimClip clip)
+{
+	switch (clip)
+	{
+	case SNAKE_ANIM_IDLE:
+		return [](Skeleton& skeleton, float time)
+		{
+			SkeletonDefinition const& definition = GetSkeletonDefinition();
+			std::vector<Vec3> const& animationDirs = GetAnimationDirections();
+			for (int snakeBoneIndex = 0; snakeBoneIndex < static_cast<int>(skeleton.m_bones.size()); ++snakeBoneIndex)
+			{
+				Bone& bone = skeleton.m_bones[snakeBoneIndex];
+				Vec3 basePosition = definition.GetRestLocalPosition(snakeBoneIndex);
+				float wave = sinf(time * 1.f + snakeBoneIndex * 0.5f) * 0.05f;
+				Vec3 offset = animationDirs[snakeBoneIndex] * wave;
+				bone.SetLocalBonePosition(basePosition + offset);
+			}
+			skeleton.UpdateSkeletonPose();
+		};
+
+	case SNAKE_ANIM_TAIL_FLICK_IDLE:
+		return [](Skeleton& skeleton, float time)
+		{
+			float flickDegrees = SinDegrees(time * 720.f) * 20.f;
+			Quat tailRotation = Quat::MakeFromEulerAngles(EulerAngles(0.f, 0.f, flickDegrees)); 
+
+			Bone& tailConnector = skeleton.m_bones[3];
+			Bone& tailBone = skeleton.m_bones[4];
+			tailConnector.SetLocalBoneRotation(tailRotation);
+			tailBone.SetLocalBoneRotation(tailRotation);
+
+			skeleton.UpdateSkeletonPose();
+		};
+
+	case SNAKE_ANIM_HEAD_RAISE_IDLE:
+		return [](Skeleton& skeleton, float time)
+		{
+			float raiseAmountDegrees = SinDegrees(time * 180.f) * 15.f;
+			Quat headRotation = Quat::MakeFromEulerAngles(EulerAngles(0.f, raiseAmountDegrees, 0.f));
+
+			Bone& headBone = skeleton.m_bones[0];
+			headBone.SetLocalBoneRotation(headRotation);
+
+			skeleton.UpdateSkeletonPose();
+		};
+
+	case SNAKE_ANIM_SLITHER:
+	default:
+		return [](Skeleton& skeleton, float time)
+		{
+			SkeletonDefinition const& definition = GetSkeletonDefinition();
+			std::vector<Vec3> const& animationDirs = GetAnimationDirections();
+			for (int snakeBoneIndex = 0; snakeBoneIndex < static_cast<int>(skeleton.m_bones.size()); ++snakeBoneIndex)
+			{
+				Bone& bone = skeleton.m_bones[snakeBoneIndex];
+				Vec3 basePosition = definition.GetRestLocalPosition(snakeBoneIndex);
+				float wave = sinf(time * 4.f + snakeBoneIndex * 0.7f) * 0.5f;
+				Vec3 offset = animationDirs[snakeBoneIndex] * wave;
+				bone.SetLocalBonePosition(basePosition + offset);
+			}
+			skeleton.UpdateSkeletonPose();
+		};
+	}
+}
+
+// Each clip is baked over exactly one period of its callback, so its last frame meets its first
+// and a state can hold for any length of time. The per-bone phase offsets don't change the period.
+BakedAnimClip const& Snake::GetBakedAnimation(SnakeAnimClip clip)
+{
+	static std::vector<BakedAnimClip> const s_bakedClips = []()
+	{
+		float const clipPeriods[NUM_SNAKE_ANIM_CLIPS] = {
+			6.2831853f,		// Idle: sinf(time)
+			0.5f,			// Tail flick: SinDegrees(time * 720)
+			2.f,			// Head raise: SinDegrees(time * 180)
+			1.5707963f };	// Slither: sinf(time * 4)
+		Skeleton const& restSkeleton = GetSkeletonDefinition().GetRestSkeleton();
+		std::vector<BakedAnimClip> clips;
+		clips.reserve(NUM_SNAKE_ANIM_CLIPS);
+		for (int clipIndex = 0; clipIndex < NUM_SNAKE_ANIM_CLIPS; ++clipIndex)
+		{
+			clips.push_back(BakedAnimClip::Bake(SNAKE_ANIM_STATE_NAMES[clipIndex], clipPeriods[clipIndex], true, GetProceduralAnimation(static_cast<SnakeAnimClip>(clipIndex)), restSkeleton));
+		}
+		return clips;
+	}();
+	return s_bakedClips[clip];
+}
+
+ProceduralAnimClip const& Snake::GetProceduralClip(SnakeAnimClip clip)
+{
+	static std::vector<ProceduralAnimClip> const s_proceduralClips = []()
+	{
+		Skeleton const& restSkeleton = GetSkeletonDefinition().GetRestSkeleton();
+		std::vector<ProceduralAnimClip> clips;
+		clips.reserve(NUM_SNAKE_ANIM_CLIPS);
+		for (int clipIndex = 0; clipIndex < NUM_SNAKE_ANIM_CLIPS; ++clipIndex)
+		{
+			clips.emplace_back(SNAKE_ANIM_STATE_NAMES[clipIndex], GetProceduralAnimation(static_cast<SnakeAnimClip>(clipIndex)), restSkeleton);
+		}
+		return clips;
+	}();
+	return s_proceduralClips[clip];
+}
+
+AnimClip const& Snake::GetAnimClip(SnakeAnimClip clip)
+{
+	if (s_playsBakedClips)
+	{
+		return GetBakedAnimation(clip);
+	}
+	return GetProceduralClip(clip);
+}
+
+// Switching mid-state crossfades like any other clip change
+bool Snake::Command_SnakeAnimSource(EventArgs& args)
+{
+	s_playsBakedClips = args.GetValue("baked", s_playsBakedClips);
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("Snakes play %s clips", s_playsBakedClips ? "baked" : "procedural"));
+	return true;
+}
+
+PoseBuffer const& Snake::GetRestPoseBuffer()
 {
-	return m_snakeStateMachine;
+	static PoseBuffer const s_restPose = PoseBuffer::MakeFromSkeleton(GetSkeletonDefinition().GetRestSkeleton());
+	return s_restPose;
 }
 
 Skeleton Snake::CreateSkeleton()
 {
 	Skeleton snakeSkeleton;
 	snakeSkeleton.m_bones.clear();
+	snakeSkeleton.m_bones.reserve(5);
 
 	// Ascending to descending
 	Bone head;
 	head.m_boneName = "Head";
 	head.SetLocalBonePosition(Vec3(0.f, 3.f, 0.2f));
-	snakeSkeleton.m_bones.push_back(head);
+	snakeSkeleton.m_bones.push_back(std::move(head));
 
 	Bone firstConnector;
 	firstConnector.m_boneName = "FirstCoil";
 	firstConnector.m_parentBoneIndex = 0;
 	firstConnector.SetLocalBonePosition(Vec3(1.f, 0.25f, 0.f));
-	snakeSkeleton.m_bones.push_back(firstConnector);
+	snakeSkeleton.m_bones.push_back(std::move(firstConnector));
 
 	Bone secondConnector;
 	secondConnector.m_boneName = "SecondCoil";
 	secondConnector.m_parentBoneIndex = 1;
 	secondConnector.SetLocalBonePosition(Vec3(1.f, -0.25f, 0.f));
-	snakeSkeleton.m_bones.push_back(secondConnector);
+	snakeSkeleton.m_bones.push_back(std::move(secondConnector));
 
 	Bone thirdConnector;
 	thirdConnector.m_boneName = "ThirdCoil";
 	thirdConnector.m_parentBoneIndex = 2;
 	thirdConnector.SetLocalBonePosition(Vec3(1.f, 0.25f, 0.f));
-	snakeSkeleton.m_bones.push_back(thirdConnector);
+	snakeSkeleton.m_bones.push_back(std::move(thirdConnector));
 
 	Bone tail;
 	tail.m_boneName = "Tail";
 	tail.m_parentBoneIndex = 3;
 	tail.SetLocalBonePosition(Vec3(1.f, -0.25f, 0.f));
-	snakeSkeleton.m_bones.push_back(tail);
+	snakeSkeleton.m_bones.push_back(std::move(tail));
 
 	snakeSkeleton.UpdateSkeletonPose();
 	return snakeSkeleton;
@@ -307,189 +492,382 @@ Skeleton Snake::CreateSkeleton()
 
 void Snake::SetupAnimations()
 {
-	// Snake's stored anim sequences
-	m_snakeIdleAnim = new Animation("Idle", 30.f, false, [this](Skeleton& skeleton, float time)
+	// Snake's stored anim sequences are baked once and shared by every snake. The state graph
+	// picks the clip, baked or procedural; the player samples it and crossfades when the state changes.
+	m_animPlayer.Initialize(&GetRestPoseBuffer(), SNAKE_ANIM_CROSSFADE_SECONDS);
+	m_animState.Initialize(&GetAnimStateGraph(), SNAKE_ANIM_IDLE);
+}
+
+AnimStateGraph const& Snake::GetAnimStateGraph()
+{
+	static AnimStateGraph const s_stateGraph = []()
 	{
-		for (int snakeBoneIndex = 0; snakeBoneIndex < static_cast<int>(skeleton.m_bones.size()); ++snakeBoneIndex)
+		AnimStateGraph graph;
+		for (char const* stateName : SNAKE_ANIM_STATE_NAMES)
 		{
-			Bone& bone = skeleton.m_bones[snakeBoneIndex];
-			Vec3 basePosition = m_snakeInitialPositions[snakeBoneIndex];
-			float wave = sinf(time * 1.f + snakeBoneIndex * 0.5f) * 0.05f;
-			Vec3 offset = m_snakeAnimationDirs[snakeBoneIndex] * wave;
-			bone.SetLocalBonePosition(basePosition + offset);
+			graph.AddState(stateName);
+		}
+		for (char const* triggerName : SNAKE_ANIM_TRIGGER_NAMES)
+		{
+			graph.AddTrigger(triggerName);
 		}
-		skeleton.UpdateSkeletonPose();
-	});
 
-	m_snakeTailFlickIdleAnim = new Animation("IdleTailFlick", 30.f, false, [this](Skeleton& skeleton, float time)
-	{
-		float flickDegrees = SinDegrees(time * 720.f) * 20.f;
-		Quat tailRotation = Quat::MakeFromEulerAngles(EulerAngles(0.f, 0.f, flickDegrees)); 
+		graph.AddTransition(ANIM_NAME("Idle"), ANIM_NAME("StartSlither"), ANIM_NAME("Slither"));
+		graph.AddTransition(ANIM_NAME("IdleTailFlick"), ANIM_NAME("StartSlither"), ANIM_NAME("Slither"));
+		//graph.AddTransition(ANIM_NAME("IdleHeadRaise"), ANIM_NAME("StartSlither"), ANIM_NAME("Slither"));
+		graph.AddTransition(ANIM_NAME("Slither"), ANIM_NAME("StopSlither"), ANIM_NAME("Idle"));
+		return graph;
+	}();
+	return s_stateGraph;
+}
 
-		Bone& tailConnector = skeleton.m_bones[3];
-		Bone& tailBone = skeleton.m_bones[4];
-		tailConnector.SetLocalBoneRotation(tailRotation);
-		tailBone.SetLocalBoneRotation(tailRotation);
+// Same skeleton, same sample times: the authored callbacks against their baked clips, per instance
+// and batched, with the worst bone position difference between the two
+bool Snake::Command_BenchmarkAnimClips(EventArgs& args)
+{
+	int instanceCount = GetClamped(args.GetValue("instances", 256), 1, 65536);
+	int frameCount = GetMax(args.GetValue("frames", 120), 1);
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Snake animations, procedural vs baked, %d instances x %d frames, times per instance-frame", instanceCount, frameCount));
 
-		skeleton.UpdateSkeletonPose();
-	});
+	SkeletonDefinition const& definition = GetSkeletonDefinition();
+	Skeleton const& restSkeleton = definition.GetRestSkeleton();
+	std::vector<SkeletonPose> poses(instanceCount, definition.CreateRestPose());
+	std::vector<float> times(instanceCount);
+	double sampleCount = static_cast<double>(instanceCount) * frameCount;
 
-	m_snakeHeadRaiseIdleAnim = new Animation("IdleHeadRaise", 30.f, false, [this](Skeleton& skeleton, float time)
+	for (int clipIndex = 0; clipIndex < NUM_SNAKE_ANIM_CLIPS; ++clipIndex)
 	{
-		float raiseAmountDegrees = SinDegrees(time * 180.f) * 15.f;
-		Quat headRotation = Quat::MakeFromEulerAngles(EulerAngles(0.f, raiseAmountDegrees, 0.f));
-
-		Bone& headBone = skeleton.m_bones[0];
-		headBone.SetLocalBoneRotation(headRotation);
-
-		skeleton.UpdateSkeletonPose();
-	});
+		AnimationSampler procedural = GetProceduralAnimation(static_cast<SnakeAnimClip>(clipIndex));
+		BakedAnimClip const& baked = GetBakedAnimation(static_cast<SnakeAnimClip>(clipIndex));
+		auto getTime = [&baked](int instanceIndex, int frame)
+		{
+			return fmodf(static_cast<float>(instanceIndex) * 0.37f + static_cast<float>(frame) / 60.f, baked.GetDuration());
+		};
 
-	m_snakeSlitherAnim = new Animation("Slither", 30.f, false, [this](Skeleton& skeleton, float time)
-	{
-		for (int snakeBoneIndex = 0; snakeBoneIndex < static_cast<int>(skeleton.m_bones.size()); ++snakeBoneIndex)
+		Skeleton skeleton = restSkeleton;
+		double startTime = GetCurrentTimeSeconds();
+		for (int frame = 0; frame < frameCount; ++frame)
 		{
-			Bone& bone = skeleton.m_bones[snakeBoneIndex];
-			Vec3 basePosition = m_snakeInitialPositions[snakeBoneIndex];
-			float wave = sinf(time * 4.f + snakeBoneIndex * 0.7f) * 0.5f;
-			Vec3 offset = m_snakeAnimationDirs[snakeBoneIndex] * wave;
-			bone.SetLocalBonePosition(basePosition + offset);
+			for (int instanceIndex = 0; instanceIndex < instanceCount; ++instanceIndex)
+			{
+				procedural(skeleton, getTime(instanceIndex, frame));
+			}
 		}
-		skeleton.UpdateSkeletonPose();
-	});
-
-	// Snake's state machine
-	m_snakeStateMachine.AddAnimationState("Idle", m_snakeIdleAnim);
-	m_snakeStateMachine.AddAnimationState("IdleTailFlick", m_snakeTailFlickIdleAnim);
-	m_snakeStateMachine.AddAnimationState("IdleHeadRaise", m_snakeHeadRaiseIdleAnim);
-	m_snakeStateMachine.AddAnimationState("Slither", m_snakeSlitherAnim);
-	m_snakeStateMachine.AddTransition("Idle", "StartSlither", "Slither");
-	m_snakeStateMachine.AddTransition("IdleTailFlick", "StartSlither", "Slither");
-	//m_snakeStateMachine.AddTransition("IdleHeadRaise", "StartSlither", "Slither");
-	m_snakeStateMachine.AddTransition("Slither", "StopSlither", "Idle");
-	m_snakeStateMachine.SetAnimationState("Idle");
-}
+		double proceduralSeconds = GetCurrentTimeSeconds() - startTime;
 
-void Snake::DeleteAnimations()
-{
-	delete m_snakeIdleAnim;
-	m_snakeIdleAnim = nullptr;
+		startTime = GetCurrentTimeSeconds();
+		for (int frame = 0; frame < frameCount; ++frame)
+		{
+			for (int instanceIndex = 0; instanceIndex < instanceCount; ++instanceIndex)
+			{
+				baked.Evaluate(skeleton, getTime(instanceIndex, frame));
+			}
+		}
+		double bakedSeconds = GetCurrentTimeSeconds() - startTime;
 
-	delete m_snakeSlitherAnim;
-	m_snakeSlitherAnim = nullptr;
+		startTime = GetCurrentTimeSeconds();
+		for (int frame = 0; frame < frameCount; ++frame)
+		{
+			for (int instanceIndex = 0; instanceIndex < instanceCount; ++instanceIndex)
+			{
+				times[instanceIndex] = getTime(instanceIndex, frame);
+			}
+			BakedAnimClip::EvaluateBatch(baked, times.data(), poses.data(), instanceCount);
+		}
+		double batchSeconds = GetCurrentTimeSeconds() - startTime;
 
-	delete m_snakeTailFlickIdleAnim;
-	m_snakeTailFlickIdleAnim = nullptr;
+		float maxError = 0.f;
+		Skeleton proceduralSkeleton = restSkeleton;
+		Skeleton bakedSkeleton = restSkeleton;
+		for (int frame = 0; frame < frameCount; ++frame)
+		{
+			float time = getTime(0, frame);
+			procedural(proceduralSkeleton, time);
+			baked.Evaluate(bakedSkeleton, time);
+			for (int boneIndex = 0; boneIndex < static_cast<int>(restSkeleton.m_bones.size()); ++boneIndex)
+			{
+				maxError = GetMax(maxError, (proceduralSkeleton.m_bones[boneIndex].GetWorldBonePosition3D() - bakedSkeleton.m_bones[boneIndex].GetWorldBonePosition3D()).GetLength());
+			}
+		}
 
-	delete m_snakeHeadRaiseIdleAnim;
-	m_snakeHeadRaiseIdleAnim = nullptr;
+		g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  %-13s %d pos/%d rot tracks, %4d keys from %d frames, %5.1fKB | procedural %.3fus | baked %.3fus | batch locals %.3fus | max err %.4f",
+			baked.GetName().c_str(), baked.GetNumPositionTracks(), baked.GetNumRotationTracks(), baked.GetNumKeys(), baked.GetNumSampledFrames(), static_cast<float>(baked.GetMemoryBytes()) / 1024.f,
+			proceduralSeconds * 1000000.0 / sampleCount, bakedSeconds * 1000000.0 / sampleCount, batchSeconds * 1000000.0 / sampleCount, maxError));
+	}
+	return true;
 }
 
-void Snake::ReflectOffBounds()
+// Sampling one clip against sampling and blending two or four; the 4-way blend masks its last two
+// inputs to the head and tail so the per-bone weights are on the measured path
+bool Snake::Command_BenchmarkPoseBlend(EventArgs& args)
 {
-	bool bounced = false;
-
-	if (!m_animalMode->m_terrain->IsInBounds(static_cast<int>(m_worldPosition.x), static_cast<int>(m_worldPosition.y)))
+	int runCount = GetMax(args.GetValue("runs", 20000), 1);
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Snake pose blending, %d runs, times per evaluation", runCount));
+
+	PoseBuffer const& restPose = GetRestPoseBuffer();
+	PoseBuffer sampledPoses[NUM_SNAKE_ANIM_CLIPS];
+	PoseBuffer blendedPose = restPose;
+	BoneMask headMask = MakeBoneMask(restPose, 0.f);
+	BoneMask tailMask = MakeBoneMask(restPose, 0.f);
+	headMask[0] = 1.f;
+	tailMask[restPose.m_numBones - 1] = 1.f;
+	PoseBlendInput const inputs[NUM_SNAKE_ANIM_CLIPS] = {
+		{ &sampledPoses[SNAKE_ANIM_IDLE], 0.4f, nullptr },
+		{ &sampledPoses[SNAKE_ANIM_SLITHER], 0.6f, nullptr },
+		{ &sampledPoses[SNAKE_ANIM_HEAD_RAISE_IDLE], 0.5f, headMask.data() },
+		{ &sampledPoses[SNAKE_ANIM_TAIL_FLICK_IDLE], 0.5f, tailMask.data() } };
+	SnakeAnimClip const inputClips[NUM_SNAKE_ANIM_CLIPS] = { SNAKE_ANIM_IDLE, SNAKE_ANIM_SLITHER, SNAKE_ANIM_HEAD_RAISE_IDLE, SNAKE_ANIM_TAIL_FLICK_IDLE };
+
+	double timesMicroseconds[3] = {};
+	int const inputCounts[3] = { 1, 2, 4 };
+	for (int caseIndex = 0; caseIndex < 3; ++caseIndex)
 	{
-		m_moveDirection *= -1.f;
-		bounced = true;
+		int inputCount = inputCounts[caseIndex];
+		double startTime = GetCurrentTimeSeconds();
+		for (int runIndex = 0; runIndex < runCount; ++runIndex)
+		{
+			float time = fmodf(static_cast<float>(runIndex) * 0.0131f, 30.f);
+			for (int inputIndex = 0; inputIndex < inputCount; ++inputIndex)
+			{
+				GetBakedAnimation(inputClips[inputIndex]).SamplePose(time, restPose, sampledPoses[inputClips[inputIndex]]);
+			}
+			if (inputCount > 1)
+			{
+				BlendPoses(inputs, inputCount, blendedPose);
+			}
+		}
+		timesMicroseconds[caseIndex] = (GetCurrentTimeSeconds() - startTime) * 1000000.0 / runCount;
 	}
 
-	if (bounced)
+	// Writing back to the engine skeleton is the same for every case, so it is timed on its own
+	Skeleton skeleton = GetSkeletonDefinition().GetRestSkeleton();
+	double startTime = GetCurrentTimeSeconds();
+	for (int runIndex = 0; runIndex < runCount; ++runIndex)
 	{
-		m_moveDirection.Normalize();
+		blendedPose.ApplyToSkeleton(skeleton);
+		skeleton.UpdateSkeletonPose();
 	}
+	double applyMicroseconds = (GetCurrentTimeSeconds() - startTime) * 1000000.0 / runCount;
+
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  single clip %.3fus | 2-way %.3fus (%.2fx) | 4-way masked %.3fus (%.2fx) | apply to skeleton %.3fus",
+		timesMicroseconds[0], timesMicroseconds[1], timesMicroseconds[1] / GetMax(static_cast<float>(timesMicroseconds[0]), 0.000001f),
+		timesMicroseconds[2], timesMicroseconds[2] / GetMax(static_cast<float>(timesMicroseconds[0]), 0.000001f), applyMicroseconds));
+	return true;
 }
 
-BehaviorTree* Snake::CreateSnakeBehaviorTree(Snake* snake)
+// The old per-snake tree for comparison: a selector over two timer leaves, all ticked every frame
+namespace
 {
-	auto moveNode = std::make_shared<SnakeMoveNode>(snake);
-	auto idleNode = std::make_shared<SnakeIdleNode>(snake, moveNode.get());
+	struct BenchmarkSnake
+	{
+		bool m_isMoving = false;
+		int  m_directionChanges = 0;
+	};
 
-	auto root = std::make_shared<SelectorNode>(std::vector<BehaviorNodePtr>{moveNode, idleNode});
-	return new BehaviorTree(root);
-}
-// -----------------------------------------------------------------------------
-BehaviorResult SnakeMoveNode::Update(float deltaSeconds)
-{
-	if (m_doneMoving)
+	class LegacyMoveNode : public BehaviorNode
 	{
-		return BehaviorResult::FAILURE;
-	}
+	public:
+		LegacyMoveNode(BenchmarkSnake* snake) : m_snake(snake) {}
+		BehaviorResult Update(float deltaSeconds) override
+		{
+			if (m_doneMoving)
+			{
+				return BehaviorResult::FAILURE;
+			}
+			m_directionChangeTimer += deltaSeconds;
+			m_moveDuration += deltaSeconds;
+			if (m_directionChangeTimer >= 7.f)
+			{
+				m_directionChangeTimer = 0.f;
+				++m_snake->m_directionChanges;
+			}
+			if (m_moveDuration >= 10.f)
+			{
+				m_moveDuration = 0.f;
+				m_doneMoving = true;
+				return BehaviorResult::FAILURE;
+			}
+			m_snake->m_isMoving = true;
+			return BehaviorResult::SUCCESS;
+		}
 
-	m_directionChangeTimer += deltaSeconds;
-	m_moveDuration += deltaSeconds;
+		BenchmarkSnake* m_snake = nullptr;
+		float m_directionChangeTimer = 0.f;
+		float m_moveDuration = 0.f;
+		bool  m_doneMoving = false;
+	};
 
-	if (m_directionChangeTimer >= m_timeToChangeDir)
+	class LegacyIdleNode : public BehaviorNode
 	{
-		m_directionChangeTimer = 0.f;
+	public:
+		LegacyIdleNode(BenchmarkSnake* snake, LegacyMoveNode* moveNode) : m_snake(snake), m_moveNode(moveNode) {}
+		BehaviorResult Update(float deltaSeconds) override
+		{
+			m_idleDuration += deltaSeconds;
+			m_snake->m_isMoving = false;
+			if (m_idleDuration >= 3.f)
+			{
+				m_idleDuration = 0.f;
+				m_moveNode->m_moveDuration = 0.f;
+				m_moveNode->m_doneMoving = false;
+				return BehaviorResult::FAILURE;
+			}
+			return BehaviorResult::SUCCESS;
+		}
+
+		BenchmarkSnake* m_snake = nullptr;
+		LegacyMoveNode* m_moveNode = nullptr;
+		float m_idleDuration = 0.f;
+	};
 
-		// Picking a new random direction for the snake to go
-		float angle = g_rng->RollRandomFloatInRange(0.f, 360.f);
-		Vec2 directionXY = Vec2(CosDegrees(angle), SinDegrees(angle));
-		Vec3 newDirection = Vec3(directionXY.x, directionXY.y, 0.f).GetNormalized();
-		m_snake->m_targetMoveDirection = newDirection;
-		m_snake->m_directionInterpTime = 0.f;
+	BehaviorResult BenchmarkStartMoving(void* context)
+	{
+		static_cast<BenchmarkSnake*>(context)->m_isMoving = true;
+		return BehaviorResult::SUCCESS;
 	}
 
-	if (m_moveDuration >= m_maxMoveDuration)
+	BehaviorResult BenchmarkChangeDirection(void* context)
 	{
-		m_moveDuration = 0.f;
-		m_doneMoving = true;
-		return BehaviorResult::FAILURE;
+		++static_cast<BenchmarkSnake*>(context)->m_directionChanges;
+		return BehaviorResult::SUCCESS;
 	}
 
-	m_snake->m_isMoving = true;
-	return BehaviorResult::SUCCESS;
+	BehaviorResult BenchmarkStartIdle(void* context)
+	{
+		static_cast<BenchmarkSnake*>(context)->m_isMoving = false;
+		return BehaviorResult::SUCCESS;
+	}
 }
 
-void SnakeMoveNode::Reset()
+// Same tree shape as GetBehaviorGraph with side-effect-free actions, so no Snake or AnimalMode is needed.
+// Instances are brought in 64 a frame so their timers don't all fire on the same tick.
+bool Snake::Command_BenchmarkBehavior(EventArgs& args)
 {
-	m_moveDuration = 0.f;
-	m_doneMoving   = false;
-}
-// -----------------------------------------------------------------------------
-BehaviorResult SnakeIdleNode::Update(float deltaSeconds)
-{
-	if (!m_startedIdle)
+	int instanceCount = GetMax(args.GetValue("count", 10000), 1);
+	int frameCount = GetMax(args.GetValue("frames", 600), 1);
+	float const deltaSeconds = 1.f / 60.f;
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Snake behavior, %d instances, %d frames at 60Hz, times per frame", instanceCount, frameCount));
+
+	std::vector<BenchmarkSnake> legacySnakes(instanceCount);
+	std::vector<BehaviorTree*> legacyTrees(instanceCount);
+	for (int instanceIndex = 0; instanceIndex < instanceCount; ++instanceIndex)
 	{
-		PlayRandomIdleAnimation();
-		m_startedIdle = true;
+		auto moveNode = std::make_shared<LegacyMoveNode>(&legacySnakes[instanceIndex]);
+		auto idleNode = std::make_shared<LegacyIdleNode>(&legacySnakes[instanceIndex], moveNode.get());
+		legacyTrees[instanceIndex] = new BehaviorTree(std::make_shared<SelectorNode>(std::vector<BehaviorNodePtr>{ moveNode, idleNode }));
 	}
-
-	m_idleDuration += deltaSeconds;
-	m_snake->m_isMoving = false;
-
-	if (m_idleDuration >= m_maxIdleTime)
+	double startTime = GetCurrentTimeSeconds();
+	for (int frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+	{
+		for (int instanceIndex = 0; instanceIndex < instanceCount && instanceIndex <= frameIndex * 64; ++instanceIndex)
+		{
+			legacyTrees[instanceIndex]->Update(deltaSeconds);
+		}
+	}
+	double legacyMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0 / frameCount;
+	for (BehaviorTree* tree : legacyTrees)
 	{
-		m_idleDuration = 0.f;
+		delete tree;
+	}
 
-		if (m_snakeMoveNode != nullptr)
+	BehaviorGraph graph;
+	BehaviorNodeId root = graph.AddSequence(INVALID_BEHAVIOR_ID);
+	graph.AddAction(root, BenchmarkStartMoving);
+	graph.AddWait(root, 7.f, 7.f);
+	graph.AddAction(root, BenchmarkChangeDirection);
+	graph.AddWait(root, 3.f, 3.f);
+	graph.AddAction(root, BenchmarkStartIdle);
+	graph.AddWait(root, 3.f, 3.f);
+
+	std::vector<BenchmarkSnake> flatSnakes(instanceCount);
+	TimerWheel timerWheel;
+	BehaviorRunner runner;
+	runner.Initialize(&graph, &timerWheel, instanceCount);
+	int64_t totalWoken = 0;
+	int64_t totalVisited = 0;
+	startTime = GetCurrentTimeSeconds();
+	for (int frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+	{
+		for (int instanceIndex = runner.GetNumInstances(); instanceIndex < instanceCount && instanceIndex <= frameIndex * 64; ++instanceIndex)
 		{
-			m_snakeMoveNode->Reset();
-			Reset();
+			runner.AddInstance(&flatSnakes[instanceIndex]);
 		}
+		timerWheel.Advance(deltaSeconds);
+		runner.Tick();
+		totalWoken += runner.GetNumInstancesWokenLastTick();
+		totalVisited += runner.GetNumNodesVisitedLastTick();
+	}
+	double flatMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0 / frameCount;
+
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  shared_ptr tree %.3fms | flat graph %.3fms (%.1fx) | %.1f instances woken, %.1f nodes visited per frame",
+		legacyMilliseconds, flatMilliseconds, legacyMilliseconds / GetMax(static_cast<float>(flatMilliseconds), 0.000001f),
+		static_cast<double>(totalWoken) / frameCount, static_cast<double>(totalVisited) / frameCount));
+	return true;
+}
+
+void Snake::ReflectOffBounds()
+{
+	bool bounced = false;
 
-		return BehaviorResult::FAILURE;
+	if (!m_animalMode->m_terrain->IsInBounds(static_cast<int>(m_worldPosition.x), static_cast<int>(m_worldPosition.y)))
+	{
+		m_moveDirection *= -1.f;
+		bounced = true;
 	}
 
-	return BehaviorResult::SUCCESS;
+	if (bounced)
+	{
+		m_moveDirection.Normalize();
+	}
 }
 
-void SnakeIdleNode::PlayRandomIdleAnimation()
+void Snake::PlayRandomIdleAnimation()
 {
-	int randomIdle = g_rng->RollRandomIntInRange(0, 2);
+	int randomIdle = GetRandomStream().RollRandomIntInRange(0, 2);
 	switch (randomIdle)
 	{
-		case 0: m_snake->m_snakeStateMachine.SetAnimationState("Idle"); break;
-		case 1: m_snake->m_snakeStateMachine.SetAnimationState("IdleTailFlick"); break;
-		//case 2: m_snake->m_snakeStateMachine.SetAnimationState("IdleHeadRaise"); break;
+		case 0: m_animState.SetState(SNAKE_ANIM_IDLE); break;
+		case 1: m_animState.SetState(SNAKE_ANIM_TAIL_FLICK_IDLE); break;
+		//case 2: m_animState.SetState(SNAKE_ANIM_HEAD_RAISE_IDLE); break;
 	}
 }
 
-void SnakeIdleNode::Reset()
+// Slither for ten seconds with a heading change seven seconds in, then idle for three.
+// Every node is either instant or a wait, so a snake is only touched when one of its waits ends.
+BehaviorGraph const& Snake::GetBehaviorGraph()
+{
+	static BehaviorGraph const s_behaviorGraph = []()
+	{
+		BehaviorGraph graph;
+		BehaviorNodeId root = graph.AddSequence(INVALID_BEHAVIOR_ID);
+		graph.AddAction(root, StartMovingAction);
+		graph.AddWait(root, 7.f, 7.f);
+		graph.AddAction(root, ChangeDirectionAction);
+		graph.AddWait(root, 3.f, 3.f);
+		graph.AddAction(root, StartIdleAction);
+		graph.AddWait(root, 3.f, 3.f);
+		return graph;
+	}();
+	return s_behaviorGraph;
+}
+
+BehaviorResult Snake::StartMovingAction(void* context)
+{
+	Snake* snake = static_cast<Snake*>(context);
+	snake->m_isMoving = true;
+	return BehaviorResult::SUCCESS;
+}
+
+BehaviorResult Snake::ChangeDirectionAction(void* context)
+{
+	static_cast<Snake*>(context)->TurnTowardRandomDirection();
+	return BehaviorResult::SUCCESS;
+}
+
+BehaviorResult Snake::StartIdleAction(void* context)
 {
-	m_startedIdle = false;
-	m_idleDuration = 0.f; 
+	Snake* snake = static_cast<Snake*>(context);
+	snake->m_isMoving = false;
+	snake->PlayRandomIdleAnimation();
+	return BehaviorResult::SUCCESS;
 }
-// -----------------------------------------------------------------------------
@@ -1,99 +1,87 @@
 #pragma once
 #include "Game/Entity.hpp"
-#include "Engine/Skeleton/Skeleton.hpp"
-#include "Engine/Animation/AnimStateMachine.hpp"
-#include "Engine/AI/BehaviorNode.hpp"
+#include "Game/SkeletonDefinition.hpp"
+#include "Game/BakedAnimClip.hpp"
+#include "Game/AnimStateGraph.hpp"
+#include "Game/BehaviorGraph.hpp"
+#include "Engine/Core/EventSystem.hpp"
 #include <vector>
 // -----------------------------------------------------------------------------
 class AnimalMode;
-class Animation;
-class BehaviorTree;
 // -----------------------------------------------------------------------------
-class Snake : public Entity
+enum SnakeAnimClip
+{
+	SNAKE_ANIM_IDLE,
+	SNAKE_ANIM_TAIL_FLICK_IDLE,
+	SNAKE_ANIM_HEAD_RAISE_IDLE,
+	SNAKE_ANIM_SLITHER,
+	NUM_SNAKE_ANIM_CLIPS
+};
+
+enum SnakeAnimTrigger
+{
+	SNAKE_TRIGGER_START_SLITHER,
+	SNAKE_TRIGGER_STOP_SLITHER,
+	NUM_SNAKE_ANIM_TRIGGERS
+};
+// -----------------------------------------------------------------------------
+class Snake final : public Entity
 {
 public:
 	Snake(AnimalMode* animalMode, Vec3 position);
 	~Snake();
 
 	virtual void Initialize() override;
-	virtual void Update(float deltaSeconds) override;
+	virtual void Simulate(float deltaSeconds) override;
+	virtual void UpdateMesh(float interpolation) override;
 	virtual void Render() const override;
 
 	bool IsMoving() const;
-	AnimStateMachine GetSnakeStateMachine() const;
+	AnimStateInstance const& GetAnimState() const;
+
+	static SkeletonDefinition const& GetSkeletonDefinition();
+	static AnimationSampler GetProceduralAnimation(SnakeAnimClip clip);
+	static BakedAnimClip const& GetBakedAnimation(SnakeAnimClip clip);
+	static ProceduralAnimClip const& GetProceduralClip(SnakeAnimClip clip);
+	static AnimClip const& GetAnimClip(SnakeAnimClip clip);
+	static AnimStateGraph const& GetAnimStateGraph();
+	static BehaviorGraph const& GetBehaviorGraph();
+	static bool Command_BenchmarkAnimClips(EventArgs& args);
+	static bool Command_BenchmarkPoseBlend(EventArgs& args);
+	static bool Command_BenchmarkBehavior(EventArgs& args);
+	static bool Command_SnakeAnimSource(EventArgs& args);
 
 public:
-	Vec3  m_targetMoveDirection = Vec3::XAXE;
-	float m_directionInterpTime = 0.f;
-	float m_directionInterpDuration = 10.f;
-	AnimStateMachine m_snakeStateMachine;
+	AnimStateInstance m_animState;
+	static bool s_playsBakedClips;
 
 private:
-	Skeleton CreateSkeleton();
-	void UpdateSnakePose(float deltaSeconds);
+	static Skeleton CreateSkeleton();
+	static std::vector<Vec3> const& GetAnimationDirections();
+	static PoseBuffer const& GetRestPoseBuffer();
+	void UpdateSnakePose(Skeleton& snakeSkeleton, float deltaSeconds);
 	void UpdateVerts();
 
 	void SetupAnimations();
 	void CheckTransitions();
-	void DeleteAnimations();
 
 	void ReflectOffBounds();
-	BehaviorTree* CreateSnakeBehaviorTree(Snake* snake);
+	void PlayRandomIdleAnimation();
+
+	static BehaviorResult StartMovingAction(void* context);
+	static BehaviorResult ChangeDirectionAction(void* context);
+	static BehaviorResult StartIdleAction(void* context);
 
 private:
-	Skeleton m_snakeSkeleton;
+	SkeletonDefinition const* m_definition = nullptr;
+	SkeletonPose m_pose;
+	SkeletonPose m_previousPose;
+	SkeletonPose m_drawPose;
 	std::vector<Vertex_PCU> m_snakeVerts;
 	std::vector<Vertex_PCU> m_snakeVertsUntextured;
 	std::vector<Vertex_PCU> m_snakeSkeletonVerts;
 
-	Animation* m_snakeIdleAnim = nullptr;
-	Animation* m_snakeTailFlickIdleAnim = nullptr;
-	Animation* m_snakeHeadRaiseIdleAnim = nullptr;
-	Animation* m_snakeSlitherAnim = nullptr;
-	BehaviorTree* m_snakeBT = nullptr;
+	AnimCrossfadePlayer m_animPlayer;
+	BehaviorInstanceId m_behaviorInstance = INVALID_BEHAVIOR_ID;
 	Texture* m_snakeTexture = nullptr;
-
-	std::vector<Vec3> m_snakeInitialPositions;
-	std::vector<Vec3> m_snakeAnimationDirs;
-};
-// -----------------------------------------------------------------------------
-/* Leaf Nodes */
-class SnakeMoveNode : public BehaviorNode
-{
-public:
-	SnakeMoveNode(Snake* snake)
-		:m_snake(snake) {}
-
-	BehaviorResult Update(float deltaSeconds) override;
-	void Reset();
-
-private:
-	Snake* m_snake = nullptr;
-	float m_directionChangeTimer = 0.f;
-	const float m_timeToChangeDir = 7.f;
-
-	float m_moveDuration = 0.f;
-	const float m_maxMoveDuration = 10.f;
-	bool m_doneMoving = false;
-};
-
-class SnakeIdleNode : public BehaviorNode
-{
-public:
-	SnakeIdleNode(Snake* snake, SnakeMoveNode* moveNode)
-		:m_snake(snake), m_snakeMoveNode(moveNode) {}
-
-	BehaviorResult Update(float deltaSeconds) override;
-	void PlayRandomIdleAnimation();
-	void Reset();
-
-private:
-	Snake* m_snake = nullptr;
-	SnakeMoveNode* m_snakeMoveNode = nullptr;
-
-	float m_idleDuration = 0.f;
-	const float m_maxIdleTime = 3.f;
-
-	bool m_startedIdle = false;
 };
-// -----------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "Game/SpatialGrid.hpp"
+#include "Game/GameCommon.h"
+#include "Game/Terrain.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.h"
+#include <cfloat>
+
+SpatialGrid::SpatialGrid(Vec2 const& mins, Vec2 const& maxs, float cellSize)
+	:m_mins(mins),
+	 m_cellSize(cellSize),
+	 m_inverseCellSize(1.f / cellSize)
+{
+	m_numCellsX = GetMax(static_cast<int>(ceilf((maxs.x - mins.x) * m_inverseCellSize)), 1);
+	m_numCellsY = GetMax(static_cast<int>(ceilf((maxs.y - mins.y) * m_inverseCellSize)), 1);
+	m_cellHeads.assign(m_numCellsX * m_numCellsY, -1);
+}
+
+int SpatialGrid::AddProxy(Entity* entity, Vec2 const& position)
+{
+	int proxyIndex = m_firstFreeProxy;
+	if (proxyIndex != -1)
+	{
+		m_firstFreeProxy = m_proxies[proxyIndex].m_next;
+	}
+	else
+	{
+		proxyIndex = static_cast<int>(m_proxies.size());
+		m_proxies.emplace_back();
+	}
+
+	Proxy& proxy = m_proxies[proxyIndex];
+	proxy.m_x = position.x;
+	proxy.m_y = position.y;
+	proxy.m_entity = entity;
+	LinkIntoCell(proxyIndex, GetCellY(position.y) * m_numCellsX + GetCellX(position.x));
+	++m_numProxies;
+	return proxyIndex;
+}
+
+// Only relinks when the proxy crosses into another cell
+void SpatialGrid::MoveProxy(int proxyIndex, Vec2 const& position)
+{
+	Proxy& proxy = m_proxies[proxyIndex];
+	proxy.m_x = position.x;
+	proxy.m_y = position.y;
+	int cell = GetCellY(position.y) * m_numCellsX + GetCellX(position.x);
+	if (cell != proxy.m_cell)
+	{
+		UnlinkFromCell(proxyIndex);
+		LinkIntoCell(proxyIndex, cell);
+	}
+}
+
+void SpatialGrid::RemoveProxy(int proxyIndex)
+{
+	if (proxyIndex < 0 || proxyIndex >= static_cast<int>(m_proxies.size()) || m_proxies[proxyIndex].m_cell == -1)
+	{
+		return;
+	}
+	UnlinkFromCell(proxyIndex);
+	Proxy& proxy = m_proxies[proxyIndex];
+	proxy.m_entity = nullptr;
+	proxy.m_next = m_firstFreeProxy;
+	m_firstFreeProxy = proxyIndex;
+	--m_numProxies;
+}
+
+void SpatialGrid::Clear()
+{
+	m_cellHeads.assign(m_cellHeads.size(), -1);
+	m_proxies.clear();
+	m_firstFreeProxy = -1;
+	m_numProxies = 0;
+}
+
+void SpatialGrid::QueryRadius(Vec2 const& center, float radius, std::vector<SpatialGridHit>& outHits) const
+{
+	outHits.clear();
+	ForEachInRadius(center, radius, [&outHits](SpatialGridHit const& hit) { outHits.push_back(hit); });
+}
+
+// Searches rings of cells outward from the center's cell, stopping once no cell in the next
+// ring can be closer than the farthest of the hits kept so far. Hits come back nearest first.
+void SpatialGrid::QueryNearest(Vec2 const& center, int count, std::vector<SpatialGridHit>& outHits, float maxRadius) const
+{
+	outHits.clear();
+	if (count <= 0)
+	{
+		return;
+	}
+
+	float maxDistanceSquared = maxRadius < 0.f ? FLT_MAX : maxRadius * maxRadius;
+	int centerCellX = GetCellX(center.x);
+	int centerCellY = GetCellY(center.y);
+	int maxRing = GetMax(m_numCellsX, m_numCellsY);
+	for (int ring = 0; ring <= maxRing; ++ring)
+	{
+		if (ring > 0)
+		{
+			float ringDistance = static_cast<float>(ring - 1) * m_cellSize;
+			float ringDistanceSquared = ringDistance * ringDistance;
+			if (ringDistanceSquared > maxDistanceSquared)
+			{
+				break;
+			}
+			if (static_cast<int>(outHits.size()) == count && ringDistanceSquared > outHits.back().m_distanceSquared)
+			{
+				break;
+			}
+		}
+
+		for (int cellY = centerCellY - ring; cellY <= centerCellY + ring; ++cellY)
+		{
+			if (cellY < 0 || cellY >= m_numCellsY)
+			{
+				continue;
+			}
+
+			// Inner rows only contribute the two cells on the ring's edge
+			bool isEdgeRow = cellY == centerCellY - ring || cellY == centerCellY + ring;
+			int cellXStep = isEdgeRow || ring == 0 ? 1 : 2 * ring;
+			for (int cellX = centerCellX - ring; cellX <= centerCellX + ring; cellX += cellXStep)
+			{
+				if (cellX < 0 || cellX >= m_numCellsX)
+				{
+					continue;
+				}
+
+				for (int proxyIndex = m_cellHeads[cellY * m_numCellsX + cellX]; proxyIndex != -1; proxyIndex = m_proxies[proxyIndex].m_next)
+				{
+					Proxy const& proxy = m_proxies[proxyIndex];
+					float deltaX = proxy.m_x - center.x;
+					float deltaY = proxy.m_y - center.y;
+					float distanceSquared = deltaX * deltaX + deltaY * deltaY;
+					if (distanceSquared > maxDistanceSquared)
+					{
+						continue;
+					}
+					if (static_cast<int>(outHits.size()) == count)
+					{
+						if (distanceSquared >= outHits.back().m_distanceSquared)
+						{
+							continue;
+						}
+						outHits.pop_back();
+					}
+
+					SpatialGridHit hit;
+					hit.m_entity = proxy.m_entity;
+					hit.m_proxy = proxyIndex;
+					hit.m_distanceSquared = distanceSquared;
+					int insertIndex = static_cast<int>(outHits.size());
+					outHits.push_back(hit);
+					while (insertIndex > 0 && outHits[insertIndex - 1].m_distanceSquared > distanceSquared)
+					{
+						outHits[insertIndex] = outHits[insertIndex - 1];
+						--insertIndex;
+					}
+					outHits[insertIndex] = hit;
+				}
+			}
+		}
+	}
+}
+
+void SpatialGrid::QueryRadiusBatch(Vec2 const* centers, int numCenters, float radius, std::vector<int>& outOffsets, std::vector<SpatialGridHit>& outHits) const
+{
+	outOffsets.clear();
+	outHits.clear();
+	outOffsets.reserve(numCenters + 1);
+	outOffsets.push_back(0);
+	for (int centerIndex = 0; centerIndex < numCenters; ++centerIndex)
+	{
+		ForEachInRadius(centers[centerIndex], radius, [&outHits](SpatialGridHit const& hit) { outHits.push_back(hit); });
+		outOffsets.push_back(static_cast<int>(outHits.size()));
+	}
+}
+
+Vec2 SpatialGrid::GetProxyPosition(int proxyIndex) const
+{
+	Proxy const& proxy = m_proxies[proxyIndex];
+	return Vec2(proxy.m_x, proxy.m_y);
+}
+
+Entity* SpatialGrid::GetProxyEntity(int proxyIndex) const
+{
+	return m_proxies[proxyIndex].m_entity;
+}
+
+int SpatialGrid::GetNumProxies() const
+{
+	return m_numProxies;
+}
+
+float SpatialGrid::GetCellSize() const
+{
+	return m_cellSize;
+}
+
+int SpatialGrid::GetCellX(float x) const
+{
+	int cellX = static_cast<int>(floorf((x - m_mins.x) * m_inverseCellSize));
+	return GetClamped(cellX, 0, m_numCellsX - 1);
+}
+
+int SpatialGrid::GetCellY(float y) const
+{
+	int cellY = static_cast<int>(floorf((y - m_mins.y) * m_inverseCellSize));
+	return GetClamped(cellY, 0, m_numCellsY - 1);
+}
+
+void SpatialGrid::LinkIntoCell(int proxyIndex, int cell)
+{
+	Proxy& proxy = m_proxies[proxyIndex];
+	proxy.m_cell = cell;
+	proxy.m_prev = -1;
+	proxy.m_next = m_cellHeads[cell];
+	if (proxy.m_next != -1)
+	{
+		m_proxies[proxy.m_next].m_prev = proxyIndex;
+	}
+	m_cellHeads[cell] = proxyIndex;
+}
+
+void SpatialGrid::UnlinkFromCell(int proxyIndex)
+{
+	Proxy& proxy = m_proxies[proxyIndex];
+	if (proxy.m_prev != -1)
+	{
+		m_proxies[proxy.m_prev].m_next = proxy.m_next;
+	}
+	else
+	{
+		m_cellHeads[proxy.m_cell] = proxy.m_next;
+	}
+	if (proxy.m_next != -1)
+	{
+		m_proxies[proxy.m_next].m_prev = proxy.m_prev;
+	}
+	proxy.m_cell = -1;
+	proxy.m_prev = -1;
+	proxy.m_next = -1;
+}
+
+// Random walkers over the terrain: every frame moves them all, then counts each one's neighbors
+bool SpatialGrid::Command_BenchmarkSpatialGrid(EventArgs& args)
+{
+	int count = GetClamped(args.GetValue("count", 10000), 1, 200000);
+	int frameCount = GetClamped(args.GetValue("frames", 60), 1, 10000);
+	float radius = GetClamped(args.GetValue("radius", 1.5f), 0.1f, 10.f);
+	float extent = static_cast<float>(TERRAIN_SIZE) * TERRAIN_SCALE;
+
+	std::vector<Vec2> positions(count);
+	for (Vec2& position : positions)
+	{
+		position = Vec2(g_rng->RollRandomFloatInRange(0.f, extent), g_rng->RollRandomFloatInRange(0.f, extent));
+	}
+
+	SpatialGrid grid(Vec2(0.f, 0.f), Vec2(extent, extent), radius);
+	std::vector<int> proxies(count);
+	for (int pointIndex = 0; pointIndex < count; ++pointIndex)
+	{
+		proxies[pointIndex] = grid.AddProxy(nullptr, positions[pointIndex]);
+	}
+
+	uint64_t gridNeighborCount = 0;
+	double startTime = GetCurrentTimeSeconds();
+	for (int frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+	{
+		for (int pointIndex = 0; pointIndex < count; ++pointIndex)
+		{
+			Vec2& position = positions[pointIndex];
+			position.x = GetClamped(position.x + g_rng->RollRandomFloatInRange(-0.05f, 0.05f), 0.f, extent);
+			position.y = GetClamped(position.y + g_rng->RollRandomFloatInRange(-0.05f, 0.05f), 0.f, extent);
+			grid.MoveProxy(proxies[pointIndex], position);
+		}
+		gridNeighborCount = 0;
+		for (int pointIndex = 0; pointIndex < count; ++pointIndex)
+		{
+			grid.ForEachInRadius(positions[pointIndex], radius, [&gridNeighborCount](SpatialGridHit const&) { ++gridNeighborCount; });
+		}
+	}
+	double gridMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0 / frameCount;
+
+	// All pairs, once, on the final positions
+	uint64_t bruteForceNeighborCount = 0;
+	float radiusSquared = radius * radius;
+	startTime = GetCurrentTimeSeconds();
+	for (int pointIndex = 0; pointIndex < count; ++pointIndex)
+	{
+		for (int otherIndex = 0; otherIndex < count; ++otherIndex)
+		{
+			float deltaX = positions[otherIndex].x - positions[pointIndex].x;
+			float deltaY = positions[otherIndex].y - positions[pointIndex].y;
+			if (deltaX * deltaX + deltaY * deltaY <= radiusSquared)
+			{
+				++bruteForceNeighborCount;
+			}
+		}
+	}
+	double bruteForceMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Spatial grid, %d walkers, radius %.2f, %dx%d cells:", count, radius, grid.m_numCellsX, grid.m_numCellsY));
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  grid move + query   %8.3fms per frame", gridMilliseconds));
+	g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  all pairs           %8.3fms per frame", bruteForceMilliseconds));
+	g_theDevConsole->AddLine(gridNeighborCount == bruteForceNeighborCount ? Rgba8::LIGHTYELLOW : Rgba8::RED,
+		Stringf("  neighbors found     %llu grid, %llu all pairs", gridNeighborCount, bruteForceNeighborCount));
+	return true;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include <vector>
+// -----------------------------------------------------------------------------
+class Entity;
+// -----------------------------------------------------------------------------
+struct SpatialGridHit
+{
+	Entity* m_entity = nullptr;
+	int		m_proxy = -1;
+	float	m_distanceSquared = 0.f;
+};
+// -----------------------------------------------------------------------------
+// Uniform grid over the XY extent of the terrain. Each entity owns a proxy holding the position
+// it was last synced at; a proxy sits in an intrusive list per cell, so moving to another cell
+// is an unlink and a link with no allocation. Positions outside the extent clamp to edge cells.
+// Queries only read, so any number of threads may query while nothing is being moved.
+class SpatialGrid
+{
+public:
+	SpatialGrid(Vec2 const& mins, Vec2 const& maxs, float cellSize);
+
+	int  AddProxy(Entity* entity, Vec2 const& position);
+	void MoveProxy(int proxy, Vec2 const& position);
+	void RemoveProxy(int proxy);
+	void Clear();
+
+	template <typename Visitor>
+	void ForEachInRadius(Vec2 const& center, float radius, Visitor const& visitor) const;
+	void QueryRadius(Vec2 const& center, float radius, std::vector<SpatialGridHit>& outHits) const;
+	void QueryNearest(Vec2 const& center, int count, std::vector<SpatialGridHit>& outHits, float maxRadius = -1.f) const;
+
+	// Results for center i are outHits[outOffsets[i]] up to outHits[outOffsets[i + 1]]
+	void QueryRadiusBatch(Vec2 const* centers, int numCenters, float radius, std::vector<int>& outOffsets, std::vector<SpatialGridHit>& outHits) const;
+
+	Vec2 GetProxyPosition(int proxy) const;
+	Entity* GetProxyEntity(int proxy) const;
+	int  GetNumProxies() const;
+	float GetCellSize() const;
+
+	static bool Command_BenchmarkSpatialGrid(EventArgs& args);
+
+private:
+	struct Proxy
+	{
+		float	m_x = 0.f;
+		float	m_y = 0.f;
+		Entity* m_entity = nullptr;
+		int		m_cell = -1;
+		int		m_prev = -1;
+		int		m_next = -1;	// Doubles as the free list link once removed
+	};
+
+	int  GetCellX(float x) const;
+	int  GetCellY(float y) const;
+	void LinkIntoCell(int proxy, int cell);
+	void UnlinkFromCell(int proxy);
+
+private:
+	Vec2  m_mins;
+	float m_cellSize = 1.f;
+	float m_inverseCellSize = 1.f;
+	int   m_numCellsX = 1;
+	int   m_numCellsY = 1;
+	std::vector<int>   m_cellHeads;
+	std::vector<Proxy> m_proxies;
+	int m_firstFreeProxy = -1;
+	int m_numProxies = 0;
+};
+// -----------------------------------------------------------------------------
+template <typename Visitor>
+void SpatialGrid::ForEachInRadius(Vec2 const& center, float radius, Visitor const& visitor) const
+{
+	int minCellX = GetCellX(center.x - radius);
+	int maxCellX = GetCellX(center.x + radius);
+	int minCellY = GetCellY(center.y - radius);
+	int maxCellY = GetCellY(center.y + radius);
+	float radiusSquared = radius * radius;
+
+	for (int cellY = minCellY; cellY <= maxCellY; ++cellY)
+	{
+		for (int cellX = minCellX; cellX <= maxCellX; ++cellX)
+		{
+			for (int proxyIndex = m_cellHeads[cellY * m_numCellsX + cellX]; proxyIndex != -1; proxyIndex = m_proxies[proxyIndex].m_next)
+			{
+				Proxy const& proxy = m_proxies[proxyIndex];
+				float deltaX = proxy.m_x - center.x;
+				float deltaY = proxy.m_y - center.y;
+				float distanceSquared = deltaX * deltaX + deltaY * deltaY;
+				if (distanceSquared <= radiusSquared)
+				{
+					SpatialGridHit hit;
+					hit.m_entity = proxy.m_entity;
+					hit.m_proxy = proxyIndex;
+					hit.m_distanceSquared = distanceSquared;
+					visitor(hit);
+				}
+			}
+		}
+	}
+}
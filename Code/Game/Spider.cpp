@@ -1,9 +1,14 @@
 #include "Game/Spider.hpp"
 #include "Game/AnimalMode.hpp"
 #include "Game/Terrain.hpp"
+#include "Game/FrameProfiler.hpp"
 #include "Game/GameCommon.h"
 #include "Engine/Renderer/Renderer.h"
-#include "Engine/Core/Time.hpp"
+
+constexpr float SPIDER_BOUNDS_PADDING = 0.7f;	// Bone spheres plus the longest hair
+constexpr int   HAIR_RANDOMS_PER_STRAND = 10;
+
+int Spider::s_hairSubsteps = 2;
 
 Spider::Spider(AnimalMode* mode, Vec3 position)
 	:Entity(mode, position)
@@ -13,33 +18,79 @@ Spider::Spider(AnimalMode* mode, Vec3 position)
 
 Spider::~Spider()
 {
+	m_animalMode->m_timerWheel.Cancel(m_directionChangeTimer);
 }
 
 void Spider::Initialize()
 {
 	m_speed = 2.5f;
-	m_spider = CreateSkeleton();
+	m_boundingRadius = 2.f;
+	m_directionChangeTimer = m_animalMode->m_timerWheel.Schedule(m_timeToChangeDir, ChangeDirection, this);
+	m_definition = &GetSkeletonDefinition();
+	m_pose = m_definition->CreateRestPose();
 	PopulateSpiderLegs();
 	ComputeLegBoneLengths();
 	GenerateHair();
 }
 
-void Spider::Update(float deltaSeconds)
+void Spider::Simulate(float deltaSeconds)
+{
+	// While asleep the previous pose already matches the current one
+	if (!m_isAsleep)
+	{
+		m_previousPose = m_pose;
+	}
+	m_isPreviousPoseValid = m_hasSimulated;
+	{
+		ScopedFrameTimer poseTimer(FRAME_SUBSYSTEM_POSE);
+		UpdateSpiderPose(deltaSeconds);
+	}
+	if (m_isAsleep)
+	{
+		return;
+	}
+	UpdateBounds(m_pose, SPIDER_BOUNDS_PADDING);
+	m_hasSimulated = true;
+
+	// Verlet hair is the stiffest thing in the scene; substeps walk the roots along the step
+	// so a fast-moving spider doesn't fling its tips. A lower tier hands over several fixed
+	// steps at once, so the count follows the elapsed time and hair always steps at hz * substeps.
+	if (m_lod.m_hairDetail != HAIR_DETAIL_FROZEN)
+	{
+		ScopedFrameTimer hairTimer(FRAME_SUBSYSTEM_HAIR);
+		int numFixedSteps = GetMax(static_cast<int>(deltaSeconds * AnimalMode::s_simulationHz + 0.5f), 1);
+		int numSubsteps = numFixedSteps * GetMax(s_hairSubsteps, 1);
+		float substepSeconds = deltaSeconds / static_cast<float>(numSubsteps);
+		for (int substep = 1; substep <= numSubsteps; ++substep)
+		{
+			float fraction = m_isPreviousPoseValid ? static_cast<float>(substep) / static_cast<float>(numSubsteps) : 1.f;
+			m_drawPose.SetInterpolated(m_previousPose, m_pose, fraction);
+			SimulateHair(m_drawPose, substepSeconds);
+		}
+	}
+}
+
+void Spider::UpdateMesh(float interpolation)
 {
-	UpdateSpiderPose(deltaSeconds);
-	SimulateHair(deltaSeconds);
+	if (!BeginMeshUpdate())
+	{
+		return;
+	}
+	ScopedFrameTimer vertsTimer(FRAME_SUBSYSTEM_VERTS);
+	m_drawPose.SetInterpolated(m_previousPose, m_pose, m_isPreviousPoseValid ? interpolation : 1.f);
 	UpdateSpiderVerts();
 	if (m_animalMode->m_isSkeletonBeingDrawn)
 	{
-		m_spider.AddVertsForSkeleton3D(m_spiderSkeletonVerts);
+		m_definition->BindPose(m_drawPose).AddVertsForSkeleton3D(m_spiderSkeletonVerts);
 	}
 }
 
 void Spider::UpdateSpiderPose(float deltaSeconds)
 {
-	static float elapsedTime = 0.f;
-	elapsedTime += deltaSeconds;
-	m_directionChangeTimer += deltaSeconds;
+	if (!m_isParked)
+	{
+		m_animationTime += deltaSeconds;
+	}
 
 	// Direction change
 	SpiderRoam(deltaSeconds);
@@ -58,17 +109,25 @@ void Spider::UpdateSpiderPose(float deltaSeconds)
 		if (!m_animalMode->m_terrain->IsInBounds(static_cast<int>(m_worldPosition.x), static_cast<int>(m_worldPosition.y)))
 		{
 			m_worldPosition = Vec3(85.f, 35.f, m_animalMode->m_terrain->GetHeightAtXY(85.f, 35.f));
-			elapsedTime = 0.f;
+			m_animationTime = 0.f;
+			m_isPreviousPoseValid = false;
 		}
 	}
 
+	if (TrySleep(GetPoseInputs()))
+	{
+		return;
+	}
+
 	// Animate spider legs
-	for (int spiderBoneIndex = 0; spiderBoneIndex < static_cast<int>(m_spider.m_bones.size()); ++spiderBoneIndex)
+	Skeleton& spider = m_definition->BindPose(m_pose);
+	SkeletonBoneTable const& boneTable = m_definition->GetBoneTable();
+	for (int spiderBoneIndex = 0; spiderBoneIndex < static_cast<int>(spider.m_bones.size()); ++spiderBoneIndex)
 	{
-		Bone& spiderBone = m_spider.m_bones[spiderBoneIndex];
-		if (spiderBone.m_boneName.find("Femur") != std::string::npos)
+		if (boneTable.HasRole(spiderBoneIndex, BONE_ROLE_FEMUR))
 		{
-			float legMovement = sinf(elapsedTime * spiderBoneIndex * 0.4f) * 0.5f;
+			Bone& spiderBone = spider.m_bones[spiderBoneIndex];
+			float legMovement = sinf(m_animationTime * spiderBoneIndex * 0.4f) * 0.5f;
 			spiderBone.SetLocalBoneRotation(Quat::MakeFromAxisAngle(Vec3::XAXE, legMovement));
 		}
 	}
@@ -77,10 +136,10 @@ void Spider::UpdateSpiderPose(float deltaSeconds)
 	for (int spiderLegIndex = 0; spiderLegIndex < static_cast<int>(m_legs.size()); ++spiderLegIndex)
 	{
 		SpiderLeg& spiderLeg = m_legs[spiderLegIndex];
-		Vec3 baseLegPosition = m_spider.m_bones[1].GetWorldBonePosition3D();
+		Vec3 baseLegPosition = spider.m_bones[1].GetWorldBonePosition3D();
 
 		// Transform local offset into world space
-		Vec3 defaultWorldPos = m_spider.m_skeletonModelTransform.TransformPosition3D(spiderLeg.m_defaultFootOffset);
+		Vec3 defaultWorldPos = spider.m_skeletonModelTransform.TransformPosition3D(spiderLeg.m_defaultFootOffset);
 
 		// Sampling terrain directly (may change to raycast)
 		float footHeight = m_animalMode->m_terrain->GetHeightAtXY(defaultWorldPos.x, defaultWorldPos.y);
@@ -92,7 +151,7 @@ void Spider::UpdateSpiderPose(float deltaSeconds)
 
 
 	float offset = 1.f;
-	Terrain* terrain = m_animalMode->m_terrain;
+	Terrain const* terrain = m_animalMode->m_terrain;
 
 	// Get current and neighbor positions
 	float hCenter = terrain->GetHeightAtXY(m_worldPosition.x, m_worldPosition.y);
@@ -115,60 +174,62 @@ void Spider::UpdateSpiderPose(float deltaSeconds)
 	orientation.SetTranslation3D(m_worldPosition);
 
 	// Apply it to the skeleton
-	m_spider.m_skeletonModelTransform = orientation;
-	m_spider.UpdateSkeletonPose();
+	spider.m_skeletonModelTransform = orientation;
+	spider.UpdateSkeletonPose();
 
 	//if (m_isLegCurling)
 	//{
 	//	for (SpiderLeg& leg : m_legs)
 	//	{
-	//		RunFABRIK(leg);
+	//		RunFABRIK(spider, leg);
 	//	}
-	//	//m_spider.UpdateSkeletonPose();
+	//	//spider.UpdateSkeletonPose();
 	//}
+
+	m_definition->StorePose(m_pose);
 }
 
 void Spider::SpiderRoam(float deltaSeconds)
 {
 	if (m_isRoaming)
 	{
-		if (m_directionChangeTimer >= m_timeToChangeDir)
-		{
-			m_directionChangeTimer = 0.f;
-
-			// Picking a new random direction for the spider to go
-			float angle = g_rng->RollRandomFloatInRange(0.f, 360.f);
-			Vec2 directionXY = Vec2(CosDegrees(angle), SinDegrees(angle));
-			Vec3 newDirection = Vec3(directionXY.x, directionXY.y, 0.f).GetNormalized();
-			m_targetMoveDirection = newDirection;
-			m_directionInterpTime = 0.f;
-		}
-
 		// Smoothly interpolate move direction
-		if (m_moveDirection != m_targetMoveDirection)
-		{
-			m_directionInterpTime += deltaSeconds;
-			float fractionTowardEnd = GetClamped(m_directionInterpTime / m_directionInterpDuration, 0.f, 1.f);
+		UpdateTurn(deltaSeconds);
+	}
+	if (!m_isStationary)
+	{
+		SteerAwayFromNeighbors(deltaSeconds);
+	}
+}
 
-			float easedFraction = SmoothStep3(fractionTowardEnd);
-			m_moveDirection = SLerp(m_moveDirection, m_targetMoveDirection, easedFraction).GetNormalized();
-		}
+// Reschedules itself; only a roaming spider actually turns
+void Spider::ChangeDirection(void* spider, int payload)
+{
+	UNUSED(payload);
+	Spider* roamingSpider = static_cast<Spider*>(spider);
+	if (roamingSpider->m_isRoaming)
+	{
+		roamingSpider->TurnTowardRandomDirection();
 	}
+	roamingSpider->m_directionChangeTimer = roamingSpider->m_animalMode->m_timerWheel.Schedule(roamingSpider->m_timeToChangeDir, ChangeDirection, spider);
 }
 
-void Spider::SimulateHair(float deltaSeconds)
+void Spider::SimulateHair(SkeletonPose const& rootPose, float deltaSeconds)
 {
 	Vec3 gravity = Vec3(0.f, 0.f, -9.8f);
 	float damping = 0.95f;
 	int numConstraintIterations = 2;
+	if (m_lod.m_hairDetail == HAIR_DETAIL_FROZEN)
+	{
+		return;
+	}
 
-	for (int boneIndex = 0; boneIndex < static_cast<int>(m_spider.m_bones.size()); ++boneIndex)
+	for (int boneIndex = 0; boneIndex < rootPose.GetNumBones(); ++boneIndex)
 	{
-		Bone const& bone = m_spider.m_bones[boneIndex];
-		Mat44 const& boneTransform = bone.m_worldBoneTransform;
+		Mat44 const& boneTransform = rootPose.GetWorldBoneMat44(boneIndex);
 
 		std::vector<SpiderHair>& hairs = m_hairsPerBone[boneIndex];
-		for (int hairIndex = 0; hairIndex < static_cast<int>(hairs.size()); ++hairIndex)
+		for (int hairIndex = 0; hairIndex < static_cast<int>(hairs.size()); hairIndex += m_lod.m_hairStrandStride)
 		{
 			SpiderHair& hair = hairs[hairIndex];
 			Vec3 rootWorld = boneTransform.TransformPosition3D(hair.m_localOffset);
@@ -193,7 +254,7 @@ void Spider::SimulateHair(float deltaSeconds)
 					hair.m_tipPos -= direction * error * 0.5f;
 				}
 
-				Vec3 wind = Vec3(sinf(static_cast<float>(GetCurrentTimeSeconds()) * 2.f + boneIndex) * 0.2f, cosf(static_cast<float>(GetCurrentTimeSeconds()) * 3.f + boneIndex) * 0.2f, 0.f);
+				Vec3 wind = Vec3(sinf(m_animationTime * 2.f + boneIndex) * 0.2f, cosf(m_animationTime * 3.f + boneIndex) * 0.2f, 0.f);
 				hair.m_tipPos += wind * deltaSeconds;
 			}
 
@@ -212,23 +273,26 @@ void Spider::UpdateSpiderVerts()
 		m_spiderSkeletonVerts.clear();
 	}
 
-	for (int boneIndex = 0; boneIndex < static_cast<int>(m_spider.m_bones.size()); ++boneIndex)
+	int sphereSlices = m_lod.GetSlices(32);
+	int sphereStacks = m_lod.GetStacks(16);
+	int limbSlices = m_lod.GetSlices(8);
+	for (int boneIndex = 0; boneIndex < m_drawPose.GetNumBones(); ++boneIndex)
 	{
-		Bone const& bone = m_spider.m_bones[boneIndex];
-		Vec3 boneWorldPos = bone.GetWorldBonePosition3D();
+		Vec3 boneWorldPos = m_drawPose.GetWorldBonePosition3D(boneIndex);
 		float radius = 0.25f;
 
-		AddVertsForSphere3D(m_spiderVerts, boneWorldPos, 0.25f, Rgba8::BLACK);
+		AddVertsForSphere3D(m_spiderVerts, boneWorldPos, 0.25f, Rgba8::BLACK, AABB2::ZERO_TO_ONE, sphereSlices, sphereStacks);
 
-		if (bone.m_parentBoneIndex == -1)
+		int parentIndex = m_definition->GetParentIndex(boneIndex);
+		if (parentIndex == -1)
 		{
 			continue;
 		}
 
-		Vec3 start = m_spider.m_bones[bone.m_parentBoneIndex].m_worldBoneTransform.GetTranslation3D();
-		Vec3 end = bone.m_worldBoneTransform.GetTranslation3D();
+		Vec3 start = m_drawPose.GetWorldBonePosition3D(parentIndex);
+		Vec3 end = boneWorldPos;
 
-		AddVertsForCylinder3D(m_spiderVerts, start, end, radius, Rgba8::BLACK);
+		AddVertsForCylinder3D(m_spiderVerts, start, end, radius, Rgba8::BLACK, AABB2::ZERO_TO_ONE, limbSlices);
 	}
 
 	AddHairGeometry();
@@ -237,26 +301,37 @@ void Spider::UpdateSpiderVerts()
 void Spider::AddHairGeometry()
 {
 	float baseHairRadius = 0.002f;
+	int hairSlices = m_lod.GetSlices(8);
+	bool isFrozen = m_lod.m_hairDetail == HAIR_DETAIL_FROZEN;
 
 	if (m_hairsPerBone.empty())
 	{
 		GenerateHair();
 	}
 
-	for (int boneIndex = 0; boneIndex < static_cast<int>(m_spider.m_bones.size()); ++boneIndex)
+	for (int boneIndex = 0; boneIndex < m_pose.GetNumBones(); ++boneIndex)
 	{
-		Bone const& bone = m_spider.m_bones[boneIndex];
-		Mat44 const& boneTransform = bone.m_worldBoneTransform;
+		Mat44 const& boneTransform = m_pose.GetWorldBoneMat44(boneIndex);
+		Mat44 const& drawTransform = m_drawPose.GetWorldBoneMat44(boneIndex);
 
-		std::vector<SpiderHair> const& hairs = m_hairsPerBone[boneIndex];
-		for (int hairIndex = 0; hairIndex < static_cast<int>(hairs.size()); ++hairIndex)
+		std::vector<SpiderHair>& hairs = m_hairsPerBone[boneIndex];
+		for (int hairIndex = 0; hairIndex < static_cast<int>(hairs.size()); hairIndex += m_lod.m_hairStrandStride)
 		{
-			SpiderHair const& hair = hairs[hairIndex];
+			SpiderHair& hair = hairs[hairIndex];
 			Vec3 worldRoot = boneTransform.TransformPosition3D(hair.m_localOffset);
 			Vec3 worldDir = boneTransform.TransformVectorQuantity3D(hair.m_localDirection).GetNormalized();
 
-			Vec3 worldTip = hair.m_tipPos;
-			AddVertsForCylinder3D(m_spiderVerts, worldRoot, worldTip, baseHairRadius, hair.m_hairColor);
+			// Frozen hair hangs at rest; the tip is reset so it resumes cleanly when promoted
+			if (isFrozen)
+			{
+				hair.m_tipPos = worldRoot + worldDir * hair.m_hairLength;
+				hair.m_prevTipPos = hair.m_tipPos;
+			}
+
+			// Tips are simulated against the latest pose; carry them along with the interpolated root
+			Vec3 drawRoot = drawTransform.TransformPosition3D(hair.m_localOffset);
+			Vec3 drawTip = hair.m_tipPos + (drawRoot - worldRoot);
+			AddVertsForCylinder3D(m_spiderVerts, drawRoot, drawTip, baseHairRadius, hair.m_hairColor, AABB2::ZERO_TO_ONE, hairSlices);
 		}
 	}
 }
@@ -264,20 +339,25 @@ void Spider::AddHairGeometry()
 void Spider::GenerateHair()
 {
 	m_hairsPerBone.clear();
-	m_hairsPerBone.resize(m_spider.m_bones.size());
+	m_hairsPerBone.resize(m_pose.GetNumBones());
+
+	// Hair is a function of the entity alone, so a spider regrows the same coat after a reset
+	RandomStream hairRandom(m_entityID, RANDOM_STREAM_HAIR);
+	std::vector<float> hairRandoms;
 
-	for (int boneIndex = 0; boneIndex < static_cast<int>(m_spider.m_bones.size()); ++boneIndex)
+	SkeletonBoneTable const& boneTable = m_definition->GetBoneTable();
+	for (int boneIndex = 0; boneIndex < m_pose.GetNumBones(); ++boneIndex)
 	{
-		Bone const& bone = m_spider.m_bones[boneIndex];
 		std::vector<SpiderHair>& hairs = m_hairsPerBone[boneIndex];
 		int numHairs = 0;
 
 		// Here I do a check so that there are more hairs on the body and less hairs on the legs
-		if (bone.m_boneName.find("Abdomen") != std::string::npos)
+		unsigned int boneRoles = boneTable.GetRoles(boneIndex);
+		if (boneRoles & BONE_ROLE_ABDOMEN)
 		{
 			numHairs = 100;
 		}
-		else if (bone.m_boneName.find("Head") != std::string::npos)
+		else if (boneRoles & BONE_ROLE_HEAD)
 		{
 			numHairs = 50;
 		}
@@ -286,33 +366,39 @@ void Spider::GenerateHair()
 			numHairs = 20;
 		}
 
+		// One bulk draw per bone, HAIR_RANDOMS_PER_STRAND in [0, 1) for each strand
+		hairRandoms.resize(static_cast<size_t>(numHairs) * HAIR_RANDOMS_PER_STRAND);
+		hairRandom.FillRandomFloatsInRange(hairRandoms.data(), static_cast<int>(hairRandoms.size()), 0.f, 1.f);
+
 		for (int hairIndex = 0; hairIndex < numHairs; ++hairIndex)
 		{
 			SpiderHair hair;
+			float const* randoms = &hairRandoms[static_cast<size_t>(hairIndex) * HAIR_RANDOMS_PER_STRAND];
 
 			// Random local offset
-			hair.m_localOffset = Vec3(g_rng->RollRandomFloatInRange(-1.f, 1.f) * 0.05f, g_rng->RollRandomFloatInRange(-1.f, 1.f) * 0.05f, g_rng->RollRandomFloatInRange(0.f, 1.f) * 0.05f);
+			hair.m_localOffset = Vec3((randoms[0] * 2.f - 1.f) * 0.05f, (randoms[1] * 2.f - 1.f) * 0.05f, randoms[2] * 0.05f);
 
 			// Local direction around z
-			Vec3 randomDir(g_rng->RollRandomFloatInRange(-1.f, 1.f), g_rng->RollRandomFloatInRange(-1.f, 1.f), g_rng->RollRandomFloatInRange(0.f, 1.f));
+			Vec3 randomDir(randoms[3] * 2.f - 1.f, randoms[4] * 2.f - 1.f, randoms[5]);
 			randomDir.Normalize();
 			float variation = 0.75f;
 			Vec3 baseDir = Vec3::ZAXE;
 			hair.m_localDirection = (baseDir * (1.f - variation) + randomDir * variation).GetNormalized();
 
 			// Random length
-			hair.m_hairLength = 0.25f * g_rng->RollRandomFloatInRange(0.8f, 1.5f);
+			hair.m_hairLength = 0.25f * (0.8f + randoms[6] * 0.7f);
 
-			// Slight hair color variation
-			hair.m_hairColor = Rgba8(static_cast<unsigned char>(g_rng->RollRandomIntInRange(80, 150)), 
-				                     static_cast<unsigned char>(g_rng->RollRandomIntInRange(80, 150)), 
-				                     static_cast<unsigned char>(g_rng->RollRandomIntInRange(80, 150)));
+			// Slight hair color variation, 80 to 150 per channel
+			hair.m_hairColor = Rgba8(static_cast<unsigned char>(80.f + randoms[7] * 71.f),
+				                     static_cast<unsigned char>(80.f + randoms[8] * 71.f),
+				                     static_cast<unsigned char>(80.f + randoms[9] * 71.f));
 
 			hairs.push_back(hair);
 
 			// Update verlet
-			Vec3 rootWorld = m_spider.m_bones[boneIndex].m_worldBoneTransform.TransformPosition3D(hair.m_localOffset);
-			Vec3 dirWorld = m_spider.m_bones[boneIndex].m_worldBoneTransform.TransformVectorQuantity3D(hair.m_localDirection).GetNormalized();
+			Mat44 const& boneTransform = m_pose.m_worldTransforms[boneIndex];
+			Vec3 rootWorld = boneTransform.TransformPosition3D(hair.m_localOffset);
+			Vec3 dirWorld = boneTransform.TransformVectorQuantity3D(hair.m_localDirection).GetNormalized();
 			hair.m_tipPos = rootWorld + dirWorld * hair.m_hairLength;
 			hair.m_prevTipPos = hair.m_tipPos;
 		}
@@ -356,22 +442,29 @@ void Spider::SetIsCurlingLegs(bool isLegCurling)
 	m_isLegCurling = isLegCurling;
 }
 
+SkeletonDefinition const& Spider::GetSkeletonDefinition()
+{
+	static SkeletonDefinition const s_spiderDefinition("Spider", &CreateSkeleton);
+	return s_spiderDefinition;
+}
+
 Skeleton Spider::CreateSkeleton()
 {
 	Skeleton spiderSkeleton;
 	spiderSkeleton.m_bones.clear();
+	spiderSkeleton.m_bones.reserve(2 + 8 * 4);
 
 	Bone abdomen;
 	abdomen.m_boneName = "Abdomen";
 	abdomen.SetLocalBonePosition(Vec3(0.f, 0.f, 0.75f));
-	spiderSkeleton.m_bones.push_back(abdomen);
+	spiderSkeleton.m_bones.push_back(std::move(abdomen));
 
 	/* ----------------Spider Head----------------- */
 	Bone head;
 	head.m_boneName = "Head";
 	head.m_parentBoneIndex = 0;
 	head.SetLocalBonePosition(Vec3(-0.4f, 0.f, 0.f));
-	spiderSkeleton.m_bones.push_back(head);
+	spiderSkeleton.m_bones.push_back(std::move(head));
 	/* -------------------------------------------- */
 
 	/* ------------Spider Left front leg-----------*/
@@ -379,25 +472,25 @@ Skeleton Spider::CreateSkeleton()
 	leftFrontFemur.m_boneName = "LeftFrontFemur";
 	leftFrontFemur.m_parentBoneIndex = 1;
 	leftFrontFemur.SetLocalBonePosition(Vec3(-0.4f, 0.25f, 0.5f));
-	spiderSkeleton.m_bones.push_back(leftFrontFemur);
+	spiderSkeleton.m_bones.push_back(std::move(leftFrontFemur));
 
 	Bone leftFrontTibia;
 	leftFrontTibia.m_boneName = "LeftFrontTibia";
 	leftFrontTibia.m_parentBoneIndex = 2;
 	leftFrontTibia.SetLocalBonePosition(Vec3(-0.4f, 0.25f, 0.0f));
-	spiderSkeleton.m_bones.push_back(leftFrontTibia);
+	spiderSkeleton.m_bones.push_back(std::move(leftFrontTibia));
 
 	Bone leftFrontMetaTarsus;
 	leftFrontMetaTarsus.m_boneName = "LeftFrontMetaTarsus";
 	leftFrontMetaTarsus.m_parentBoneIndex = 3;
 	leftFrontMetaTarsus.SetLocalBonePosition(Vec3(-0.2f, 0.25f, -0.5f));
-	spiderSkeleton.m_bones.push_back(leftFrontMetaTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(leftFrontMetaTarsus));
 
 	Bone leftFrontTarsus;
 	leftFrontTarsus.m_boneName = "LeftFrontTarsus";
 	leftFrontTarsus.m_parentBoneIndex = 4;
 	leftFrontTarsus.SetLocalBonePosition(Vec3(-0.2f, 0.25f, -0.5f));
-	spiderSkeleton.m_bones.push_back(leftFrontTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(leftFrontTarsus));
 	/* -------------------------------------------- */
 
 	/* ------------Spider Right front leg-----------*/
@@ -405,25 +498,25 @@ Skeleton Spider::CreateSkeleton()
 	rightFrontFemur.m_boneName = "RightFrontFemur";
 	rightFrontFemur.m_parentBoneIndex = 1;
 	rightFrontFemur.SetLocalBonePosition(Vec3(-0.4f, -0.25f, 0.5f));
-	spiderSkeleton.m_bones.push_back(rightFrontFemur);
+	spiderSkeleton.m_bones.push_back(std::move(rightFrontFemur));
 
 	Bone rightFrontTibia;
 	rightFrontTibia.m_boneName = "RightFrontTibia";
 	rightFrontTibia.m_parentBoneIndex = 6;
 	rightFrontTibia.SetLocalBonePosition(Vec3(-0.4f, -0.25f, 0.0f));
-	spiderSkeleton.m_bones.push_back(rightFrontTibia);
+	spiderSkeleton.m_bones.push_back(std::move(rightFrontTibia));
 
 	Bone rightFrontMetaTarsus;
 	rightFrontMetaTarsus.m_boneName = "RightFrontMetaTarsus";
 	rightFrontMetaTarsus.m_parentBoneIndex = 7;
 	rightFrontMetaTarsus.SetLocalBonePosition(Vec3(-0.2f, -0.25f, -0.5f));
-	spiderSkeleton.m_bones.push_back(rightFrontMetaTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(rightFrontMetaTarsus));
 
 	Bone rightFrontTarsus;
 	rightFrontTarsus.m_boneName = "RightFrontTarsus";
 	rightFrontTarsus.m_parentBoneIndex = 8;
 	rightFrontTarsus.SetLocalBonePosition(Vec3(-0.2f, -0.25f, -0.5f));
-	spiderSkeleton.m_bones.push_back(rightFrontTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(rightFrontTarsus));
 	/* -------------------------------------------- */
 
 	/* ----------Spider Left Front Middle Leg------ */
@@ -431,25 +524,25 @@ Skeleton Spider::CreateSkeleton()
 	leftFrontMiddleFemur.m_boneName = "LeftFrontMidFemur";
 	leftFrontMiddleFemur.m_parentBoneIndex = 1;
 	leftFrontMiddleFemur.SetLocalBonePosition(Vec3(-0.15f, 0.5f, 0.f));
-	spiderSkeleton.m_bones.push_back(leftFrontMiddleFemur);
+	spiderSkeleton.m_bones.push_back(std::move(leftFrontMiddleFemur));
 
 	Bone leftFrontMiddleTibia;
 	leftFrontMiddleTibia.m_boneName = "LeftFrontMiddleTibia";
 	leftFrontMiddleTibia.m_parentBoneIndex = 10;
 	leftFrontMiddleTibia.SetLocalBonePosition(Vec3(-0.15f, 0.25f, 0.f));
-	spiderSkeleton.m_bones.push_back(leftFrontMiddleTibia);
+	spiderSkeleton.m_bones.push_back(std::move(leftFrontMiddleTibia));
 
 	Bone leftFrontMiddleMetaTarsus;
 	leftFrontMiddleMetaTarsus.m_boneName = "LeftFrontMiddleMetaTarsus";
 	leftFrontMiddleMetaTarsus.m_parentBoneIndex = 11;
 	leftFrontMiddleMetaTarsus.SetLocalBonePosition(Vec3(-0.15f, 0.15f, -0.3f));
-	spiderSkeleton.m_bones.push_back(leftFrontMiddleMetaTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(leftFrontMiddleMetaTarsus));
 
 	Bone leftFrontMiddleTarsus;
 	leftFrontMiddleTarsus.m_boneName = "LeftFrontMiddleTarsus";
 	leftFrontMiddleTarsus.m_parentBoneIndex = 12;
 	leftFrontMiddleTarsus.SetLocalBonePosition(Vec3(-0.15f, 0.1f, -0.2f));
-	spiderSkeleton.m_bones.push_back(leftFrontMiddleTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(leftFrontMiddleTarsus));
 	/* -------------------------------------------- */
 
 	/* ----------Spider Right Front Middle Leg------ */
@@ -457,25 +550,25 @@ Skeleton Spider::CreateSkeleton()
 	rightFrontMiddleFemur.m_boneName = "RightFrontMidFemur";
 	rightFrontMiddleFemur.m_parentBoneIndex = 1;
 	rightFrontMiddleFemur.SetLocalBonePosition(Vec3(-0.15f, -0.5f, 0.f));
-	spiderSkeleton.m_bones.push_back(rightFrontMiddleFemur);
+	spiderSkeleton.m_bones.push_back(std::move(rightFrontMiddleFemur));
 
 	Bone rightFrontMiddleTibia;
 	rightFrontMiddleTibia.m_boneName = "RightFrontMiddleTibia";
 	rightFrontMiddleTibia.m_parentBoneIndex = 14;
 	rightFrontMiddleTibia.SetLocalBonePosition(Vec3(-0.15f, -0.25f, 0.f));
-	spiderSkeleton.m_bones.push_back(rightFrontMiddleTibia);
+	spiderSkeleton.m_bones.push_back(std::move(rightFrontMiddleTibia));
 
 	Bone rightFrontMiddleMetaTarsus;
 	rightFrontMiddleMetaTarsus.m_boneName = "RightFrontMiddleMetaTarsus";
 	rightFrontMiddleMetaTarsus.m_parentBoneIndex = 15;
 	rightFrontMiddleMetaTarsus.SetLocalBonePosition(Vec3(-0.15f, -0.15f, -0.3f));
-	spiderSkeleton.m_bones.push_back(rightFrontMiddleMetaTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(rightFrontMiddleMetaTarsus));
 
 	Bone rightFrontMiddleTarsus;
 	rightFrontMiddleTarsus.m_boneName = "RightFrontMiddleTarsus";
 	rightFrontMiddleTarsus.m_parentBoneIndex = 16;
 	rightFrontMiddleTarsus.SetLocalBonePosition(Vec3(-0.15f, -0.1f, -0.2f));
-	spiderSkeleton.m_bones.push_back(rightFrontMiddleTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(rightFrontMiddleTarsus));
 	/* -------------------------------------------- */
 
 	/* ----------Spider Left Back Middle Leg------ */
@@ -483,25 +576,25 @@ Skeleton Spider::CreateSkeleton()
 	leftBackMiddleFemur.m_boneName = "LeftBackMidFemur";
 	leftBackMiddleFemur.m_parentBoneIndex = 1;
 	leftBackMiddleFemur.SetLocalBonePosition(Vec3(0.15f, 0.5f, 0.f));
-	spiderSkeleton.m_bones.push_back(leftBackMiddleFemur);
+	spiderSkeleton.m_bones.push_back(std::move(leftBackMiddleFemur));
 
 	Bone leftBackMiddleTibia;
 	leftBackMiddleTibia.m_boneName = "LeftBackMiddleTibia";
 	leftBackMiddleTibia.m_parentBoneIndex = 18;
 	leftBackMiddleTibia.SetLocalBonePosition(Vec3(0.15f, 0.25f, 0.f));
-	spiderSkeleton.m_bones.push_back(leftBackMiddleTibia);
+	spiderSkeleton.m_bones.push_back(std::move(leftBackMiddleTibia));
 
 	Bone leftBackMiddleMetaTarsus;
 	leftBackMiddleMetaTarsus.m_boneName = "LeftBackMiddleMetaTarsus";
 	leftBackMiddleMetaTarsus.m_parentBoneIndex = 19;
 	leftBackMiddleMetaTarsus.SetLocalBonePosition(Vec3(0.15f, 0.15f, -0.3f));
-	spiderSkeleton.m_bones.push_back(leftBackMiddleMetaTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(leftBackMiddleMetaTarsus));
 
 	Bone leftBackMiddleTarsus;
 	leftBackMiddleTarsus.m_boneName = "LeftBackMiddleTarsus";
 	leftBackMiddleTarsus.m_parentBoneIndex = 20;
 	leftBackMiddleTarsus.SetLocalBonePosition(Vec3(0.15f, 0.1f, -0.2f));
-	spiderSkeleton.m_bones.push_back(leftBackMiddleTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(leftBackMiddleTarsus));
 	/* -------------------------------------------- */
 
 	/* ----------Spider Right Back Middle Leg------ */
@@ -509,25 +602,25 @@ Skeleton Spider::CreateSkeleton()
 	rightBackMiddleFemur.m_boneName = "RightBackMidFemur";
 	rightBackMiddleFemur.m_parentBoneIndex = 1;
 	rightBackMiddleFemur.SetLocalBonePosition(Vec3(0.15f, -0.5f, 0.f));
-	spiderSkeleton.m_bones.push_back(rightBackMiddleFemur);
+	spiderSkeleton.m_bones.push_back(std::move(rightBackMiddleFemur));
 
 	Bone rightBackMiddleTibia;
 	rightBackMiddleTibia.m_boneName = "RightBackMiddleTibia";
 	rightBackMiddleTibia.m_parentBoneIndex = 22;
 	rightBackMiddleTibia.SetLocalBonePosition(Vec3(0.15f, -0.25f, 0.f));
-	spiderSkeleton.m_bones.push_back(rightBackMiddleTibia);
+	spiderSkeleton.m_bones.push_back(std::move(rightBackMiddleTibia));
 
 	Bone rightBackMiddleMetaTarsus;
 	rightBackMiddleMetaTarsus.m_boneName = "RightBackMiddleMetaTarsus";
 	rightBackMiddleMetaTarsus.m_parentBoneIndex = 23;
 	rightBackMiddleMetaTarsus.SetLocalBonePosition(Vec3(0.15f, -0.15f, -0.3f));
-	spiderSkeleton.m_bones.push_back(rightBackMiddleMetaTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(rightBackMiddleMetaTarsus));
 
 	Bone rightBackMiddleTarsus;
 	rightBackMiddleTarsus.m_boneName = "RightBackMiddleTarsus";
 	rightBackMiddleTarsus.m_parentBoneIndex = 24;
 	rightBackMiddleTarsus.SetLocalBonePosition(Vec3(0.15f, -0.1f, -0.2f));
-	spiderSkeleton.m_bones.push_back(rightBackMiddleTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(rightBackMiddleTarsus));
 	/* -------------------------------------------- */
 
 	/* ------------Spider Left back leg-----------*/
@@ -535,25 +628,25 @@ Skeleton Spider::CreateSkeleton()
 	leftBackFemur.m_boneName = "LeftBackFemur";
 	leftBackFemur.m_parentBoneIndex = 1;
 	leftBackFemur.SetLocalBonePosition(Vec3(0.4f, 0.25f, 0.5f));
-	spiderSkeleton.m_bones.push_back(leftBackFemur);
+	spiderSkeleton.m_bones.push_back(std::move(leftBackFemur));
 
 	Bone leftBackTibia;
 	leftBackTibia.m_boneName = "LeftBackTibia";
 	leftBackTibia.m_parentBoneIndex = 26;
 	leftBackTibia.SetLocalBonePosition(Vec3(0.4f, 0.25f, 0.0f));
-	spiderSkeleton.m_bones.push_back(leftBackTibia);
+	spiderSkeleton.m_bones.push_back(std::move(leftBackTibia));
 
 	Bone leftBackMetaTarsus;
 	leftBackMetaTarsus.m_boneName = "LeftBackMetaTarsus";
 	leftBackMetaTarsus.m_parentBoneIndex = 27;
 	leftBackMetaTarsus.SetLocalBonePosition(Vec3(0.2f, 0.25f, -0.5f));
-	spiderSkeleton.m_bones.push_back(leftBackMetaTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(leftBackMetaTarsus));
 
 	Bone leftBackTarsus;
 	leftBackTarsus.m_boneName = "LeftBackTarsus";
 	leftBackTarsus.m_parentBoneIndex = 28;
 	leftBackTarsus.SetLocalBonePosition(Vec3(0.2f, 0.25f, -0.5f));
-	spiderSkeleton.m_bones.push_back(leftBackTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(leftBackTarsus));
 	/* -------------------------------------------- */
 
 	/* ------------Spider Right back leg-----------*/
@@ -561,25 +654,25 @@ Skeleton Spider::CreateSkeleton()
 	rightBackFemur.m_boneName = "RightBackFemur";
 	rightBackFemur.m_parentBoneIndex = 1;
 	rightBackFemur.SetLocalBonePosition(Vec3(0.4f, -0.25f, 0.5f));
-	spiderSkeleton.m_bones.push_back(rightBackFemur);
+	spiderSkeleton.m_bones.push_back(std::move(rightBackFemur));
 
 	Bone rightBackTibia;
 	rightBackTibia.m_boneName = "RightBackTibia";
 	rightBackTibia.m_parentBoneIndex = 30;
 	rightBackTibia.SetLocalBonePosition(Vec3(0.4f, -0.25f, 0.0f));
-	spiderSkeleton.m_bones.push_back(rightBackTibia);
+	spiderSkeleton.m_bones.push_back(std::move(rightBackTibia));
 
 	Bone rightBackMetaTarsus;
 	rightBackMetaTarsus.m_boneName = "RightBackMetaTarsus";
 	rightBackMetaTarsus.m_parentBoneIndex = 31;
 	rightBackMetaTarsus.SetLocalBonePosition(Vec3(0.2f, -0.25f, -0.5f));
-	spiderSkeleton.m_bones.push_back(rightBackMetaTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(rightBackMetaTarsus));
 
 	Bone rightBackTarsus;
 	rightBackTarsus.m_boneName = "RightBackTarsus";
 	rightBackTarsus.m_parentBoneIndex = 32;
 	rightBackTarsus.SetLocalBonePosition(Vec3(0.2f, -0.25f, -0.5f));
-	spiderSkeleton.m_bones.push_back(rightBackTarsus);
+	spiderSkeleton.m_bones.push_back(std::move(rightBackTarsus));
 	/* -------------------------------------------- */
 
 	spiderSkeleton.UpdateSkeletonPose();
@@ -588,24 +681,25 @@ Skeleton Spider::CreateSkeleton()
 
 void Spider::PopulateSpiderLegs()
 {
+	SkeletonBoneTable const& boneTable = m_definition->GetBoneTable();
 	m_legs =
 	{
-		{m_spider.FindBoneIndexByName("LeftFrontFemur"), m_spider.FindBoneIndexByName("LeftFrontTibia"),
-		 m_spider.FindBoneIndexByName("LeftFrontMetaTarsus"), m_spider.FindBoneIndexByName("LeftFrontTarsus"), Vec3(-0.4f, 0.25f, -0.5f)},
-		{m_spider.FindBoneIndexByName("RightFrontFemur"), m_spider.FindBoneIndexByName("RightFrontTibia"), 
-		 m_spider.FindBoneIndexByName("RightFrontMetaTarsus"), m_spider.FindBoneIndexByName("RightFrontTarsus"), Vec3(-0.4f, -0.25f, -0.5f)},
-		{m_spider.FindBoneIndexByName("LeftFrontMidFemur"), m_spider.FindBoneIndexByName("LeftFrontMiddleTibia"),
-		 m_spider.FindBoneIndexByName("LeftFrontMiddleMetaTarsus"), m_spider.FindBoneIndexByName("LeftFrontMiddleTarsus"), Vec3(-0.15f, 0.5f, 0.f)},
-		{m_spider.FindBoneIndexByName("RightFrontMidFemur"), m_spider.FindBoneIndexByName("RightFrontMiddleTibia"),
-		 m_spider.FindBoneIndexByName("RightFrontMiddleMetaTarsus"), m_spider.FindBoneIndexByName("RightFrontMiddleTarsus"), Vec3(-0.15f, -0.5f, 0.f)},
-		{m_spider.FindBoneIndexByName("LeftBackMidFemur"), m_spider.FindBoneIndexByName("LeftBackMiddleTibia"),
-		 m_spider.FindBoneIndexByName("LeftBackMiddleMetaTarsus"), m_spider.FindBoneIndexByName("LeftBackMiddleTarsus"), Vec3(0.15f, 0.5f, 0.f)},
-		{m_spider.FindBoneIndexByName("RightBackMidFemur"), m_spider.FindBoneIndexByName("RightBackMiddleTibia"),
-		 m_spider.FindBoneIndexByName("RightBackMiddleMetaTarsus"), m_spider.FindBoneIndexByName("RightBackMiddleTarsus"), Vec3(0.15f, -0.5f, 0.f)},
-		{m_spider.FindBoneIndexByName("LeftBackFemur"), m_spider.FindBoneIndexByName("LeftBackTibia"),
-		 m_spider.FindBoneIndexByName("LeftBackMetaTarsus"), m_spider.FindBoneIndexByName("LeftBackTarsus"), Vec3(0.4f, 0.25f, 0.5f)},
-		{m_spider.FindBoneIndexByName("RightBackFemur"), m_spider.FindBoneIndexByName("RightBackTibia"),
-		 m_spider.FindBoneIndexByName("RightBackMetaTarsus"), m_spider.FindBoneIndexByName("RightBackTarsus"), Vec3(0.4f, -0.25f, 0.5f)}
+		{boneTable.FindBoneIndex("LeftFrontFemur"), boneTable.FindBoneIndex("LeftFrontTibia"),
+		 boneTable.FindBoneIndex("LeftFrontMetaTarsus"), boneTable.FindBoneIndex("LeftFrontTarsus"), Vec3(-0.4f, 0.25f, -0.5f)},
+		{boneTable.FindBoneIndex("RightFrontFemur"), boneTable.FindBoneIndex("RightFrontTibia"), 
+		 boneTable.FindBoneIndex("RightFrontMetaTarsus"), boneTable.FindBoneIndex("RightFrontTarsus"), Vec3(-0.4f, -0.25f, -0.5f)},
+		{boneTable.FindBoneIndex("LeftFrontMidFemur"), boneTable.FindBoneIndex("LeftFrontMiddleTibia"),
+		 boneTable.FindBoneIndex("LeftFrontMiddleMetaTarsus"), boneTable.FindBoneIndex("LeftFrontMiddleTarsus"), Vec3(-0.15f, 0.5f, 0.f)},
+		{boneTable.FindBoneIndex("RightFrontMidFemur"), boneTable.FindBoneIndex("RightFrontMiddleTibia"),
+		 boneTable.FindBoneIndex("RightFrontMiddleMetaTarsus"), boneTable.FindBoneIndex("RightFrontMiddleTarsus"), Vec3(-0.15f, -0.5f, 0.f)},
+		{boneTable.FindBoneIndex("LeftBackMidFemur"), boneTable.FindBoneIndex("LeftBackMiddleTibia"),
+		 boneTable.FindBoneIndex("LeftBackMiddleMetaTarsus"), boneTable.FindBoneIndex("LeftBackMiddleTarsus"), Vec3(0.15f, 0.5f, 0.f)},
+		{boneTable.FindBoneIndex("RightBackMidFemur"), boneTable.FindBoneIndex("RightBackMiddleTibia"),
+		 boneTable.FindBoneIndex("RightBackMiddleMetaTarsus"), boneTable.FindBoneIndex("RightBackMiddleTarsus"), Vec3(0.15f, -0.5f, 0.f)},
+		{boneTable.FindBoneIndex("LeftBackFemur"), boneTable.FindBoneIndex("LeftBackTibia"),
+		 boneTable.FindBoneIndex("LeftBackMetaTarsus"), boneTable.FindBoneIndex("LeftBackTarsus"), Vec3(0.4f, 0.25f, 0.5f)},
+		{boneTable.FindBoneIndex("RightBackFemur"), boneTable.FindBoneIndex("RightBackTibia"),
+		 boneTable.FindBoneIndex("RightBackMetaTarsus"), boneTable.FindBoneIndex("RightBackTarsus"), Vec3(0.4f, -0.25f, 0.5f)}
 	};
 
 	for (SpiderLeg& leg : m_legs)
@@ -627,14 +721,14 @@ void Spider::ComputeLegBoneLengths()
 		leg.m_boneLengths.clear();
 		for (int legBoneIndex = 0; legBoneIndex < 3; ++legBoneIndex)
 		{
-			Vec3 boneA = m_spider.m_bones[leg.m_boneIndices[legBoneIndex]].GetWorldBonePosition3D();
-			Vec3 boneB = m_spider.m_bones[leg.m_boneIndices[legBoneIndex + 1]].GetWorldBonePosition3D();
+			Vec3 boneA = m_pose.GetWorldBonePosition3D(leg.m_boneIndices[legBoneIndex]);
+			Vec3 boneB = m_pose.GetWorldBonePosition3D(leg.m_boneIndices[legBoneIndex + 1]);
 			leg.m_boneLengths.push_back((boneB - boneA).GetLength());
 		}
 	}
 }
 
-void Spider::RunFABRIK(SpiderLeg& leg)
+void Spider::RunFABRIK(Skeleton& spider, SpiderLeg& leg)
 {
 	int legBoneSize = static_cast<int>(leg.m_boneIndices.size());
 
@@ -642,7 +736,7 @@ void Spider::RunFABRIK(SpiderLeg& leg)
 	std::vector<Vec3> joints(legBoneSize);
 	for (int legBoneIndex = 0; legBoneIndex < legBoneSize; ++legBoneIndex)
 	{
-		joints[legBoneIndex] = m_spider.m_bones[leg.m_boneIndices[legBoneIndex]].GetWorldBonePosition3D();
+		joints[legBoneIndex] = spider.m_bones[leg.m_boneIndices[legBoneIndex]].GetWorldBonePosition3D();
 	}
 
 	Vec3 target = leg.m_footTargetWorldPos;
@@ -683,33 +777,39 @@ void Spider::RunFABRIK(SpiderLeg& leg)
 	}
 
 	// Convert new joint positions into bone rotations
-	ApplyFABRIKToSkeletonBones(leg, joints);
+	ApplyFABRIKToSkeletonBones(spider, leg, joints);
 }
 
-void Spider::ApplyFABRIKToSkeletonBones(SpiderLeg const& leg, std::vector<Vec3> const& joints)
+void Spider::ApplyFABRIKToSkeletonBones(Skeleton& spider, SpiderLeg const& leg, std::vector<Vec3> const& joints)
 {
-	for (int jointIndex = 0; jointIndex < static_cast<int>(joints.size() - 1); ++jointIndex)
+	// World poses are read once as rigid transforms; each bone is then turned onto its solved
+	// segment and the change carried down the leg without rebuilding any matrices
+	int legBoneSize = static_cast<int>(leg.m_boneIndices.size());
+	int parentIndex = spider.m_bones[leg.m_boneIndices[0]].m_parentBoneIndex;
+	RigidTransform parentWorld;
+	if (parentIndex != -1)
 	{
-		int boneIndex = leg.m_boneIndices[jointIndex];
-		Bone& bone = m_spider.m_bones[boneIndex];
-
-		Vec3 worldA = joints[jointIndex];
-		Vec3 worldB = joints[jointIndex + 1];
+		parentWorld = RigidTransform::MakeFromMat44(spider.m_bones[parentIndex].m_worldBoneTransform);
+	}
 
-		Vec3 desiredDir = (worldB - worldA).GetNormalized();
-		Vec3 boneWorldDir = (worldB - worldA).GetNormalized();
-		Quat worldRot = Quat::MakeRotationFromTwoVectors(boneWorldDir, desiredDir);
+	RigidTransform originalWorld = RigidTransform::MakeFromMat44(spider.m_bones[leg.m_boneIndices[0]].m_worldBoneTransform);
+	RigidTransform currentWorld = originalWorld;
+	for (int jointIndex = 0; jointIndex < legBoneSize - 1; ++jointIndex)
+	{
+		Bone& bone = spider.m_bones[leg.m_boneIndices[jointIndex]];
+		RigidTransform originalChildWorld = RigidTransform::MakeFromMat44(spider.m_bones[leg.m_boneIndices[jointIndex + 1]].m_worldBoneTransform);
+		RigidTransform childLocal = originalWorld.GetInverse() * originalChildWorld;
 
-		int parent = bone.m_parentBoneIndex;
-		Quat parentWorldRot = Quat::DEFAULT;
-		if (parent != -1)
-		{
-			parentWorldRot = Quat::MakeFromMat44(m_spider.m_bones[parent].m_worldBoneTransform);
-		}
+		Vec3 currentDir = currentWorld.TransformVectorQuantity3D(childLocal.m_translation).GetNormalized();
+		Vec3 desiredDir = (joints[jointIndex + 1] - joints[jointIndex]).GetNormalized();
+		currentWorld.m_rotation = RotationQuat::MakeRotationFromTwoVectors(currentDir, desiredDir) * currentWorld.m_rotation;
 
 		// Computing the bones local rotation
-		Quat localRot = parentWorldRot.QuatInverse() * worldRot;
+		RotationQuat localRot = parentWorld.m_rotation.GetInverse() * currentWorld.m_rotation;
+		bone.SetLocalBoneRotation(localRot.GetAsEngineQuat());
 
-		bone.SetLocalBoneRotation(localRot);
+		parentWorld = currentWorld;
+		currentWorld = currentWorld * childLocal;
+		originalWorld = originalChildWorld;
 	}
 }
\ No newline at end of file
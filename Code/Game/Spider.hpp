@@ -1,6 +1,6 @@
 #pragma once
 #include "Game/Entity.hpp"
-#include "Engine/Skeleton/Skeleton.hpp"
+#include "Game/SkeletonDefinition.hpp"
 #include "Engine/AI/BehaviorNode.hpp"
 // -----------------------------------------------------------------------------
 class AnimalMode;
@@ -30,35 +30,44 @@ struct SpiderHair
 	Vec3 m_prevTipPos = Vec3::ZERO;
 };
 // -----------------------------------------------------------------------------
-class Spider : public Entity
+class Spider final : public Entity
 {
 public:
 	Spider(AnimalMode* mode, Vec3 position);
 	~Spider();
 
 	virtual void Initialize() override;
-	virtual void Update(float deltaSeconds) override;
+	virtual void Simulate(float deltaSeconds) override;
+	virtual void UpdateMesh(float interpolation) override;
 	virtual void Render() const override;
 
 	void SetIsRoaming(bool isRoaming);
 	void SetIsCurlingLegs(bool isLegCurling);
 
+	static SkeletonDefinition const& GetSkeletonDefinition();
+
+	static int s_hairSubsteps;
+
 private:
-	Skeleton CreateSkeleton();
+	static Skeleton CreateSkeleton();
 	void PopulateSpiderLegs();
 	void ComputeLegBoneLengths();
-	void RunFABRIK(SpiderLeg& leg);
-	void ApplyFABRIKToSkeletonBones(SpiderLeg const& spiderLeg, std::vector<Vec3> const& joints);
+	void RunFABRIK(Skeleton& spider, SpiderLeg& leg);
+	void ApplyFABRIKToSkeletonBones(Skeleton& spider, SpiderLeg const& spiderLeg, std::vector<Vec3> const& joints);
 	void UpdateSpiderPose(float deltaSeconds);
 	void SpiderRoam(float deltaSeconds);
+	static void ChangeDirection(void* spider, int payload);
 
-	void SimulateHair(float deltaSeconds);
+	void SimulateHair(SkeletonPose const& rootPose, float deltaSeconds);
 	void UpdateSpiderVerts();
 	void AddHairGeometry();
 	void GenerateHair();
 
 private:
-	Skeleton m_spider;
+	SkeletonDefinition const* m_definition = nullptr;
+	SkeletonPose m_pose;
+	SkeletonPose m_previousPose;
+	SkeletonPose m_drawPose;
 	std::vector<Vertex_PCU> m_spiderVerts;
 	std::vector<Vertex_PCU> m_spiderSkeletonVerts;
 	std::vector<std::vector<SpiderHair>> m_hairsPerBone;
@@ -66,10 +75,7 @@ private:
 	bool m_isLegCurling = false;
 
 	// Directional changes
-	Vec3  m_targetMoveDirection = Vec3::XAXE;
-	float m_directionInterpTime = 0.f;
-	float m_directionInterpDuration = 10.f;
-	float m_directionChangeTimer = 0.f;
+	TimerHandle m_directionChangeTimer;
 	float m_timeToChangeDir = 7.f;
 	bool  m_isRoaming = false;
 };
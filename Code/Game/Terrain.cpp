@@ -1,14 +1,63 @@
 #include "Game/Terrain.hpp"
 #include "Game/GameCommon.h"
+#include "Game/ViewFrustum.hpp"
+#include "Game/ThreadPool.hpp"
 #include "Engine/Renderer/Renderer.h"
-#include "Engine/Math/SmoothNoise.hpp"
 #include "Engine/Math/MathUtils.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
-Terrain::Terrain(Vec3 const& position)
-	:m_terrainWorldPosition(position)
+namespace
+{
+	constexpr float TERRAIN_CHUNK_WORLD_SIZE = static_cast<float>(TERRAIN_CHUNK_CELLS) * TERRAIN_SCALE;
+	constexpr int   HEIGHT_RANGE_ESTIMATE_SAMPLES = 129;
+
+	enum TerrainChunkEdge
+	{
+		CHUNK_EDGE_SOUTH,
+		CHUNK_EDGE_EAST,
+		CHUNK_EDGE_NORTH,
+		CHUNK_EDGE_WEST,
+		NUM_CHUNK_EDGES
+	};
+
+	// Grid point at distance along an edge and depth in from it, in cells at the chunk's LOD
+	void GetEdgeGridPoint(int edge, int numCells, int distanceAlong, int depth, int& outX, int& outY)
+	{
+		switch (edge)
+		{
+			case CHUNK_EDGE_SOUTH: outX = distanceAlong;		   outY = depth;				 break;
+			case CHUNK_EDGE_EAST:  outX = numCells - depth;	   outY = distanceAlong;		 break;
+			case CHUNK_EDGE_NORTH: outX = distanceAlong;		   outY = numCells - depth;	 break;
+			default:			   outX = depth;			   outY = distanceAlong;		 break;
+		}
+	}
+}
+
+Terrain::Terrain(Vec3 const& position, int numSamplesPerSide, ThreadPool* threadPool)
+	:m_numSamplesPerSide(std::max(numSamplesPerSide, 2)),
+	 m_terrainWorldPosition(position),
+	 m_generator(m_numSamplesPerSide, false),
+	 m_threadPool(threadPool)
 {
 	m_shader = g_theRenderer->CreateOrGetShader("Data/Shaders/BlinnPhong", VertexType::VERTEX_PCUTBN);
 	m_texture = g_theRenderer->CreateOrGetTextureFromFile("Data/Images/dirt.jpg");
+
+	int numCells = m_numSamplesPerSide - 1;
+	m_numChunksPerSide = (numCells + TERRAIN_CHUNK_CELLS - 1) / TERRAIN_CHUNK_CELLS;
+	m_chunkSlotForCoords.assign(static_cast<size_t>(m_numChunksPerSide) * m_numChunksPerSide, -1);
+
+	// Enough slots for every chunk within the evict distance of the camera, wherever it stands
+	m_streamRadiusInChunks = static_cast<int>(ceilf((TERRAIN_STREAM_RADIUS + TERRAIN_EVICT_MARGIN) / TERRAIN_CHUNK_WORLD_SIZE)) + 1;
+	int slotsAcross = std::min(2 * m_streamRadiusInChunks + 1, m_numChunksPerSide);
+	int numSlots = slotsAcross * slotsAcross;
+	m_chunks.resize(numSlots);
+	m_freeChunkSlots.reserve(numSlots);
+	for (int slot = numSlots - 1; slot >= 0; --slot)
+	{
+		m_freeChunkSlots.push_back(slot);
+	}
 }
 
 Terrain::~Terrain()
@@ -16,22 +65,38 @@ Terrain::~Terrain()
 	DeleteBuffers();
 }
 
+// Resident chunks are rebuilt at once so their heights never disagree with the hills;
+// everything else is generated from the new hills as it streams in
 void Terrain::InitializeTerrainHills()
 {
-	// Initialize terrain
-	GenerateHeightMap();
-	GenerateMesh();
-	CreateBuffers();
-}
+	m_generator = TerrainGenerator(m_numSamplesPerSide, m_areHillsInverted);
+	EstimateHeightRange();
 
-void Terrain::Render() const
-{
-	if (m_vertexBuffer == nullptr || m_indexBuffer == nullptr)
+	m_scratchSlotsToGenerate.clear();
+	for (int slot = 0; slot < static_cast<int>(m_chunks.size()); ++slot)
 	{
-		return;
+		if (m_chunks[slot].m_isResident)
+		{
+			m_scratchSlotsToGenerate.push_back(slot);
+		}
+	}
+	GenerateChunks(m_scratchSlotsToGenerate);
+	for (int slot : m_scratchSlotsToGenerate)
+	{
+		TerrainChunk& chunk = m_chunks[slot];
+		BuildChunkMesh(chunk, chunk.m_meshLod >= 0 ? chunk.m_meshLod : chunk.m_desiredLod);
 	}
+}
 
-	if (m_indices.empty())
+void Terrain::Update(Vec3 const& cameraPosition, ViewFrustum const& frustum)
+{
+	StreamChunks(Vec2(cameraPosition.x, cameraPosition.y));
+	BuildDrawList(frustum);
+}
+
+void Terrain::Render() const
+{
+	if (m_drawList.empty())
 	{
 		return;
 	}
@@ -47,9 +112,13 @@ void Terrain::Render() const
 	g_theRenderer->BindSampler(SamplerMode::BILINEAR_WRAP, 2);
 	g_theRenderer->BindTexture(nullptr);
 	g_theRenderer->BindShader(m_shader);
-	g_theRenderer->DrawIndexedVertexBuffer(m_vertexBuffer, m_indexBuffer, static_cast<int>(m_indices.size()));
+	for (TerrainDraw const& draw : m_drawList)
+	{
+		g_theRenderer->DrawIndexedVertexBuffer(draw.m_vertexBuffer, draw.m_indexBuffer, draw.m_numIndices);
+	}
 }
 
+// Read from resident chunks when there is one, so animals stand on exactly what is drawn
 float Terrain::GetHeightAtXY(float x, float y) const
 {
 	float terrainX = x / TERRAIN_SCALE;
@@ -66,15 +135,32 @@ float Terrain::GetHeightAtXY(float x, float y) const
 	float terrainIndexX = terrainX - indexX;
 	float terrainIndexY = terrainY - indexY;
 
-	int indexBottomLeft = indexY * TERRAIN_SIZE + indexX;
-	int indexBottomRight = indexY * TERRAIN_SIZE + (indexX + 1);
-	int indexTopLeft = (indexY + 1) * TERRAIN_SIZE + indexX;
-	int indexTopRight = (indexY + 1) * TERRAIN_SIZE + (indexX + 1);
+	float heightBottomLeft = 0.f;
+	float heightBottomRight = 0.f;
+	float heightTopLeft = 0.f;
+	float heightTopRight = 0.f;
 
-	float heightBottomLeft = m_terrainHeights[indexBottomLeft];
-	float heightBottomRight = m_terrainHeights[indexBottomRight];
-	float heightTopLeft = m_terrainHeights[indexTopLeft];
-	float heightTopRight = m_terrainHeights[indexTopRight];
+	int chunkX = indexX / TERRAIN_CHUNK_CELLS;
+	int chunkY = indexY / TERRAIN_CHUNK_CELLS;
+	int slot = GetChunkSlot(chunkX, chunkY);
+	if (slot >= 0)
+	{
+		std::vector<float> const& heights = m_chunks[slot].m_heights;
+		int localX = indexX - chunkX * TERRAIN_CHUNK_CELLS + 1;
+		int localY = indexY - chunkY * TERRAIN_CHUNK_CELLS + 1;
+		int indexBottomLeft = localY * TERRAIN_CHUNK_BORDERED_SAMPLES + localX;
+		heightBottomLeft = heights[indexBottomLeft];
+		heightBottomRight = heights[indexBottomLeft + 1];
+		heightTopLeft = heights[indexBottomLeft + TERRAIN_CHUNK_BORDERED_SAMPLES];
+		heightTopRight = heights[indexBottomLeft + TERRAIN_CHUNK_BORDERED_SAMPLES + 1];
+	}
+	else
+	{
+		heightBottomLeft = m_generator.ComputeHeight(indexX, indexY);
+		heightBottomRight = m_generator.ComputeHeight(indexX + 1, indexY);
+		heightTopLeft = m_generator.ComputeHeight(indexX, indexY + 1);
+		heightTopRight = m_generator.ComputeHeight(indexX + 1, indexY + 1);
+	}
 
 	// Bilinear interpolation
 	float heightBottom = Interpolate(heightBottomLeft, heightBottomRight, terrainIndexX);
@@ -86,139 +172,435 @@ float Terrain::GetHeightAtXY(float x, float y) const
 
 bool Terrain::IsInBounds(int x, int y) const
 {
-	if (x < 0 || y < 0 || x >= TERRAIN_SIZE - 1 || y >= TERRAIN_SIZE - 1)
+	if (x < 0 || y < 0 || x >= m_numSamplesPerSide - 1 || y >= m_numSamplesPerSide - 1)
 	{
 		return false;
 	}
 	return true;
 }
 
-void Terrain::GenerateHeightMap()
+int Terrain::GetNumSamplesPerSide() const
+{
+	return m_numSamplesPerSide;
+}
+
+float Terrain::GetWorldSize() const
+{
+	return static_cast<float>(m_numSamplesPerSide) * TERRAIN_SCALE;
+}
+
+int Terrain::GetNumResidentChunks() const
+{
+	return m_numResidentChunks;
+}
+
+int Terrain::GetNumChunksDrawn() const
+{
+	return static_cast<int>(m_drawList.size());
+}
+
+size_t Terrain::GetResidentBytes() const
+{
+	size_t numBytes = 0;
+	for (TerrainChunk const& chunk : m_chunks)
+	{
+		numBytes += chunk.m_heights.capacity() * sizeof(float);
+		if (chunk.m_vertexBuffer)
+		{
+			numBytes += chunk.m_vertexBuffer->GetSize();
+		}
+	}
+	for (auto const& indexBufferEntry : m_indexBuffers)
+	{
+		numBytes += indexBufferEntry.second.m_indexBuffer->GetSize();
+	}
+	return numBytes;
+}
+
+// Colors band by height across the whole world, which is never generated at once; a coarse
+// sampling finds the range closely enough
+void Terrain::EstimateHeightRange()
 {
-	m_terrainHeights.resize(TERRAIN_SIZE * TERRAIN_SIZE);
 	m_minTerrainHeight = FLT_MAX;
-	m_maxTerrainHeight = FLT_MIN;
+	m_maxTerrainHeight = -FLT_MAX;
+	float lastSample = static_cast<float>(m_numSamplesPerSide - 1);
+	for (int estimateY = 0; estimateY < HEIGHT_RANGE_ESTIMATE_SAMPLES; ++estimateY)
+	{
+		for (int estimateX = 0; estimateX < HEIGHT_RANGE_ESTIMATE_SAMPLES; ++estimateX)
+		{
+			int sampleX = static_cast<int>(roundf(lastSample * static_cast<float>(estimateX) / static_cast<float>(HEIGHT_RANGE_ESTIMATE_SAMPLES - 1)));
+			int sampleY = static_cast<int>(roundf(lastSample * static_cast<float>(estimateY) / static_cast<float>(HEIGHT_RANGE_ESTIMATE_SAMPLES - 1)));
+			float height = m_generator.ComputeHeight(sampleX, sampleY);
+			m_minTerrainHeight = GetMin(m_minTerrainHeight, height);
+			m_maxTerrainHeight = GetMax(m_maxTerrainHeight, height);
+		}
+	}
+}
 
-	for (int terrainIndexY = 0; terrainIndexY < TERRAIN_SIZE; ++terrainIndexY)
+int Terrain::GetChunkSlot(int chunkX, int chunkY) const
+{
+	if (chunkX < 0 || chunkY < 0 || chunkX >= m_numChunksPerSide || chunkY >= m_numChunksPerSide)
+	{
+		return -1;
+	}
+	return m_chunkSlotForCoords[chunkY * m_numChunksPerSide + chunkX];
+}
+
+float Terrain::GetDistanceToChunk(Vec2 const& point, int chunkX, int chunkY) const
+{
+	float minX = static_cast<float>(chunkX) * TERRAIN_CHUNK_WORLD_SIZE;
+	float minY = static_cast<float>(chunkY) * TERRAIN_CHUNK_WORLD_SIZE;
+	float deltaX = point.x - GetClamped(point.x, minX, minX + TERRAIN_CHUNK_WORLD_SIZE);
+	float deltaY = point.y - GetClamped(point.y, minY, minY + TERRAIN_CHUNK_WORLD_SIZE);
+	return sqrtf(deltaX * deltaX + deltaY * deltaY);
+}
+
+int Terrain::GetLodForDistance(float distance) const
+{
+	int lod = 0;
+	float lodDistance = TERRAIN_LOD0_DISTANCE;
+	while (lod < TERRAIN_NUM_LODS - 1 && distance >= lodDistance)
 	{
-		for (int terrainIndexX = 0; terrainIndexX < TERRAIN_SIZE; ++terrainIndexX)
+		++lod;
+		lodDistance *= 2.f;
+	}
+	return lod;
+}
+
+// Evicts what has fallen behind, then spends the frame's budget on the nearest work: chunks
+// missing inside the stream radius and resident chunks meshed at the wrong LOD. The scan covers
+// a fixed square around the camera, so the cost does not grow with the world.
+void Terrain::StreamChunks(Vec2 const& cameraXY)
+{
+	float evictDistance = TERRAIN_STREAM_RADIUS + TERRAIN_EVICT_MARGIN;
+	m_scratchWork.clear();
+	for (int slot = 0; slot < static_cast<int>(m_chunks.size()); ++slot)
+	{
+		TerrainChunk& chunk = m_chunks[slot];
+		if (!chunk.m_isResident)
 		{
-			float terrainWorldX = static_cast<float>(terrainIndexX);
-			float terrainWorldY = static_cast<float>(terrainIndexY);
+			continue;
+		}
 
-			float total = 0.f;
-			int numHills = 3;
-			Vec2 hillCenters[] =
-			{
-				Vec2(TERRAIN_SIZE * 0.3f, TERRAIN_SIZE * 0.3f),
-				Vec2(TERRAIN_SIZE * 0.7f, TERRAIN_SIZE * 0.4f),
-				Vec2(TERRAIN_SIZE * 0.5f, TERRAIN_SIZE * 0.8f)
-			};
+		chunk.m_distance = GetDistanceToChunk(cameraXY, chunk.m_chunkX, chunk.m_chunkY);
+		if (chunk.m_distance > evictDistance)
+		{
+			EvictChunk(slot);
+			continue;
+		}
+		chunk.m_desiredLod = GetLodForDistance(chunk.m_distance);
+		if (chunk.m_meshLod != chunk.m_desiredLod)
+		{
+			m_scratchWork.push_back(std::make_pair(chunk.m_distance, slot));
+		}
+	}
 
-			for (int hillIndex = 0; hillIndex < numHills; ++hillIndex)
+	int cameraChunkX = static_cast<int>(floorf(cameraXY.x / TERRAIN_CHUNK_WORLD_SIZE));
+	int cameraChunkY = static_cast<int>(floorf(cameraXY.y / TERRAIN_CHUNK_WORLD_SIZE));
+	int minChunkX = std::max(cameraChunkX - m_streamRadiusInChunks, 0);
+	int minChunkY = std::max(cameraChunkY - m_streamRadiusInChunks, 0);
+	int maxChunkX = std::min(cameraChunkX + m_streamRadiusInChunks, m_numChunksPerSide - 1);
+	int maxChunkY = std::min(cameraChunkY + m_streamRadiusInChunks, m_numChunksPerSide - 1);
+	for (int chunkY = minChunkY; chunkY <= maxChunkY; ++chunkY)
+	{
+		for (int chunkX = minChunkX; chunkX <= maxChunkX; ++chunkX)
+		{
+			int coordinateIndex = chunkY * m_numChunksPerSide + chunkX;
+			if (m_chunkSlotForCoords[coordinateIndex] >= 0)
+			{
+				continue;
+			}
+			float distance = GetDistanceToChunk(cameraXY, chunkX, chunkY);
+			if (distance <= TERRAIN_STREAM_RADIUS)
 			{
-				float dx = (terrainWorldX - hillCenters[hillIndex].x) / (TERRAIN_SIZE * 0.3f);
-				float dy = (terrainWorldY - hillCenters[hillIndex].y) / (TERRAIN_SIZE * 0.3f);
-				float dist = sqrtf(dx * dx + dy * dy);
-				float falloff = GetClamped(1.f - dist, 0.f, 1.f);
-				if (!m_areHillsInverted)
-				{
-					total += falloff * falloff;
-				}
-				else
-				{
-					total -= falloff * falloff;
-				}
+				m_scratchWork.push_back(std::make_pair(distance, -(coordinateIndex + 1)));
 			}
-			float terrainHeight = total * 0.5f * HEIGHT_SCALE;
+		}
+	}
 
-			m_minTerrainHeight = GetMin(m_minTerrainHeight, terrainHeight);
-			m_maxTerrainHeight = GetMax(m_maxTerrainHeight, terrainHeight);
+	int numWork = std::min(static_cast<int>(m_scratchWork.size()), TERRAIN_CHUNK_MESHES_PER_FRAME);
+	std::partial_sort(m_scratchWork.begin(), m_scratchWork.begin() + numWork, m_scratchWork.end());
+	m_scratchSlotsToGenerate.clear();
+	for (int workIndex = 0; workIndex < numWork; ++workIndex)
+	{
+		std::pair<float, int> const& work = m_scratchWork[workIndex];
+		if (work.second >= 0)
+		{
+			TerrainChunk& chunk = m_chunks[work.second];
+			BuildChunkMesh(chunk, chunk.m_desiredLod);
+			continue;
+		}
 
-			m_terrainHeights[terrainIndexY * TERRAIN_SIZE + terrainIndexX] = terrainHeight;
+		if (m_freeChunkSlots.empty())
+		{
+			break;
 		}
+		int coordinateIndex = -work.second - 1;
+		int slot = m_freeChunkSlots.back();
+		m_freeChunkSlots.pop_back();
+		m_chunkSlotForCoords[coordinateIndex] = slot;
+		++m_numResidentChunks;
+
+		TerrainChunk& chunk = m_chunks[slot];
+		chunk.m_chunkX = coordinateIndex % m_numChunksPerSide;
+		chunk.m_chunkY = coordinateIndex / m_numChunksPerSide;
+		chunk.m_isResident = true;
+		chunk.m_distance = work.first;
+		chunk.m_desiredLod = GetLodForDistance(work.first);
+		m_scratchSlotsToGenerate.push_back(slot);
+	}
+
+	GenerateChunks(m_scratchSlotsToGenerate);
+	for (int slot : m_scratchSlotsToGenerate)
+	{
+		BuildChunkMesh(m_chunks[slot], m_chunks[slot].m_desiredLod);
 	}
 }
 
-void Terrain::GenerateMesh()
+// The slot keeps its height storage for the next chunk that lands in it
+void Terrain::EvictChunk(int slot)
 {
-	m_vertices.clear();
-	m_indices.clear();
+	TerrainChunk& chunk = m_chunks[slot];
+	m_chunkSlotForCoords[chunk.m_chunkY * m_numChunksPerSide + chunk.m_chunkX] = -1;
+	delete chunk.m_vertexBuffer;
+	chunk.m_vertexBuffer = nullptr;
+	chunk.m_isResident = false;
+	chunk.m_meshLod = -1;
+	m_freeChunkSlots.push_back(slot);
+	--m_numResidentChunks;
+}
 
-	float texelsPerWorldUnit = 0.01f;
+void Terrain::GenerateChunkHeights(TerrainChunk& chunk)
+{
+	chunk.m_heights.resize(TERRAIN_CHUNK_BORDERED_SAMPLES * TERRAIN_CHUNK_BORDERED_SAMPLES);
+	int firstSampleX = chunk.m_chunkX * TERRAIN_CHUNK_CELLS;
+	int firstSampleY = chunk.m_chunkY * TERRAIN_CHUNK_CELLS;
+	m_generator.GenerateTile(firstSampleX - 1, firstSampleY - 1, TERRAIN_CHUNK_BORDERED_SAMPLES, TERRAIN_CHUNK_BORDERED_SAMPLES,
+		chunk.m_heights.data(), TERRAIN_CHUNK_BORDERED_SAMPLES);
+
+	// Bounds cover only the samples the mesh can reach
+	chunk.m_minHeight = FLT_MAX;
+	chunk.m_maxHeight = -FLT_MAX;
+	int numMeshSamplesX = std::min(TERRAIN_CHUNK_CELLS, m_numSamplesPerSide - 1 - firstSampleX) + 1;
+	int numMeshSamplesY = std::min(TERRAIN_CHUNK_CELLS, m_numSamplesPerSide - 1 - firstSampleY) + 1;
+	for (int localY = 0; localY < numMeshSamplesY; ++localY)
+	{
+		float const* rowHeights = chunk.m_heights.data() + (localY + 1) * TERRAIN_CHUNK_BORDERED_SAMPLES + 1;
+		for (int localX = 0; localX < numMeshSamplesX; ++localX)
+		{
+			chunk.m_minHeight = GetMin(chunk.m_minHeight, rowHeights[localX]);
+			chunk.m_maxHeight = GetMax(chunk.m_maxHeight, rowHeights[localX]);
+		}
+	}
+}
 
-	for (int terrainIndexY = 0; terrainIndexY < TERRAIN_SIZE - 1; ++terrainIndexY)
+// Each chunk is a tile of the heightmap, generated on whichever thread picks it up
+void Terrain::GenerateChunks(std::vector<int> const& slots)
+{
+	auto generateRange = [this, &slots](int begin, int end)
 	{
-		for (int terrainIndexX = 0; terrainIndexX < TERRAIN_SIZE - 1; ++terrainIndexX)
+		for (int slotIndex = begin; slotIndex < end; ++slotIndex)
 		{
-			int bL = terrainIndexY * TERRAIN_SIZE + terrainIndexX;
-			int bR = terrainIndexY * TERRAIN_SIZE + (terrainIndexX + 1);
-			int tR = (terrainIndexY + 1) * TERRAIN_SIZE + (terrainIndexX + 1);
-			int tL = (terrainIndexY + 1) * TERRAIN_SIZE + terrainIndexX;
+			GenerateChunkHeights(m_chunks[slots[slotIndex]]);
+		}
+	};
 
-			Vec3 point0 = Vec3(static_cast<float>(terrainIndexX) * TERRAIN_SCALE,
-				static_cast<float>(terrainIndexY) * TERRAIN_SCALE,
-				m_terrainHeights[bL]);
+	int numSlots = static_cast<int>(slots.size());
+	if (m_threadPool != nullptr && numSlots > 1)
+	{
+		m_threadPool->ParallelFor(numSlots, 1, generateRange);
+	}
+	else
+	{
+		generateRange(0, numSlots);
+	}
+}
+
+// Vertices past the world's far edge clamp onto it, so a chunk hanging over the edge just
+// produces flat triangles there. Normals use full-resolution neighbors at every LOD, so
+// shading stays continuous across chunk and LOD boundaries.
+void Terrain::BuildChunkMesh(TerrainChunk& chunk, int lod)
+{
+	int step = 1 << lod;
+	int numCells = TERRAIN_CHUNK_CELLS >> lod;
+	int firstSampleX = chunk.m_chunkX * TERRAIN_CHUNK_CELLS;
+	int firstSampleY = chunk.m_chunkY * TERRAIN_CHUNK_CELLS;
+	int lastSample = m_numSamplesPerSide - 1;
+	float texelsPerWorldUnit = 0.01f;
+	std::vector<float> const& heights = chunk.m_heights;
+
+	m_scratchVertices.clear();
+	for (int gridY = 0; gridY <= numCells; ++gridY)
+	{
+		int sampleY = std::min(firstSampleY + gridY * step, lastSample);
+		int borderedY = sampleY - firstSampleY + 1;
+		for (int gridX = 0; gridX <= numCells; ++gridX)
+		{
+			int sampleX = std::min(firstSampleX + gridX * step, lastSample);
+			int borderedX = sampleX - firstSampleX + 1;
+			int heightIndex = borderedY * TERRAIN_CHUNK_BORDERED_SAMPLES + borderedX;
+			float height = heights[heightIndex];
+			float slopeX = (heights[heightIndex + 1] - heights[heightIndex - 1]) / (2.f * TERRAIN_SCALE);
+			float slopeY = (heights[heightIndex + TERRAIN_CHUNK_BORDERED_SAMPLES] - heights[heightIndex - TERRAIN_CHUNK_BORDERED_SAMPLES]) / (2.f * TERRAIN_SCALE);
+
+			Vertex_PCUTBN vertex;
+			vertex.m_position = Vec3(static_cast<float>(sampleX) * TERRAIN_SCALE, static_cast<float>(sampleY) * TERRAIN_SCALE, height);
+			vertex.m_color = GetColorForHeight(height);
+			vertex.m_uvTexCoords = Vec2(vertex.m_position.x, vertex.m_position.y) * texelsPerWorldUnit;
+			vertex.m_tangent = Vec3(1.f, 0.f, slopeX).GetNormalized();
+			vertex.m_bitangent = Vec3(0.f, 1.f, slopeY).GetNormalized();
+			vertex.m_normal = CrossProduct3D(vertex.m_tangent, vertex.m_bitangent).GetNormalized();
+			m_scratchVertices.push_back(vertex);
+		}
+	}
 
-			Vec3 point1 = Vec3(static_cast<float>(terrainIndexX + 1) * TERRAIN_SCALE,
-				static_cast<float>(terrainIndexY) * TERRAIN_SCALE,
-				m_terrainHeights[bR]);
+	unsigned int numBytes = static_cast<unsigned int>(m_scratchVertices.size() * sizeof(Vertex_PCUTBN));
+	if (chunk.m_vertexBuffer == nullptr || chunk.m_vertexBuffer->GetSize() != numBytes)
+	{
+		delete chunk.m_vertexBuffer;
+		chunk.m_vertexBuffer = g_theRenderer->CreateVertexBuffer(numBytes, sizeof(Vertex_PCUTBN));
+	}
+	g_theRenderer->CopyCPUToGPU(m_scratchVertices.data(), numBytes, chunk.m_vertexBuffer);
+	chunk.m_meshLod = lod;
+}
 
-			Vec3 point2 = Vec3(static_cast<float>(terrainIndexX + 1) * TERRAIN_SCALE,
-				static_cast<float>(terrainIndexY + 1) * TERRAIN_SCALE,
-				m_terrainHeights[tR]);
+// Each edge is stitched to the coarser of the two chunks meeting there. Neighbors not yet
+// meshed count as matching, since nothing is drawn next to them.
+void Terrain::BuildDrawList(ViewFrustum const& frustum)
+{
+	static int const s_neighborOffsets[NUM_CHUNK_EDGES][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
 
-			Vec3 point3 = Vec3(static_cast<float>(terrainIndexX) * TERRAIN_SCALE,
-				static_cast<float>(terrainIndexY + 1) * TERRAIN_SCALE,
-				m_terrainHeights[tL]);
+	m_drawList.clear();
+	float halfChunkSize = 0.5f * TERRAIN_CHUNK_WORLD_SIZE;
+	for (TerrainChunk const& chunk : m_chunks)
+	{
+		if (!chunk.m_isResident || chunk.m_meshLod < 0)
+		{
+			continue;
+		}
 
-			float avgHeight = (m_terrainHeights[bL] + m_terrainHeights[bR] + m_terrainHeights[tR] + m_terrainHeights[tL]) * 0.25f;
-			Rgba8 color = GetColorForHeight(avgHeight);
-			
-			// UVs based on world position
-			float x0 = static_cast<float>(terrainIndexX) * TERRAIN_SCALE;
-			float x1 = static_cast<float>(terrainIndexX + 1) * TERRAIN_SCALE;
-			float y0 = static_cast<float>(terrainIndexY) * TERRAIN_SCALE;
-			float y1 = static_cast<float>(terrainIndexY + 1) * TERRAIN_SCALE;
-			Vec2  uvMins = Vec2(x0, y0) * texelsPerWorldUnit;
-			Vec2  uvMaxs = Vec2(x1, y1) * texelsPerWorldUnit;
-			AABB2 uvs = AABB2(uvMins, uvMaxs);
+		float halfHeight = 0.5f * (chunk.m_maxHeight - chunk.m_minHeight);
+		Vec3 boundsCenter = Vec3(static_cast<float>(chunk.m_chunkX) * TERRAIN_CHUNK_WORLD_SIZE + halfChunkSize,
+			static_cast<float>(chunk.m_chunkY) * TERRAIN_CHUNK_WORLD_SIZE + halfChunkSize, chunk.m_minHeight + halfHeight);
+		float boundsRadius = sqrtf(2.f * halfChunkSize * halfChunkSize + halfHeight * halfHeight);
+		if (!frustum.IsSphereVisible(boundsCenter, boundsRadius))
+		{
+			continue;
+		}
 
-			AddVertsForQuad3D(m_vertices, m_indices, point0, point1, point2, point3, color, uvs);
+		int edgeLods[NUM_CHUNK_EDGES];
+		for (int edge = 0; edge < NUM_CHUNK_EDGES; ++edge)
+		{
+			int neighborSlot = GetChunkSlot(chunk.m_chunkX + s_neighborOffsets[edge][0], chunk.m_chunkY + s_neighborOffsets[edge][1]);
+			int neighborLod = (neighborSlot >= 0 && m_chunks[neighborSlot].m_meshLod >= 0) ? m_chunks[neighborSlot].m_meshLod : chunk.m_meshLod;
+			edgeLods[edge] = std::max(chunk.m_meshLod, neighborLod);
 		}
+
+		TerrainIndexBuffer const& indexBuffer = GetOrCreateIndexBuffer(chunk.m_meshLod, edgeLods);
+		TerrainDraw draw;
+		draw.m_vertexBuffer = chunk.m_vertexBuffer;
+		draw.m_indexBuffer = indexBuffer.m_indexBuffer;
+		draw.m_numIndices = indexBuffer.m_numIndices;
+		m_drawList.push_back(draw);
 	}
 }
 
-void Terrain::CreateBuffers()
+TerrainIndexBuffer const& Terrain::GetOrCreateIndexBuffer(int lod, int const edgeLods[4])
 {
-	if (m_vertices.empty())
+	uint32_t key = static_cast<uint32_t>(lod);
+	for (int edge = 0; edge < NUM_CHUNK_EDGES; ++edge)
 	{
-		return;
+		key |= static_cast<uint32_t>(edgeLods[edge]) << (4 * (edge + 1));
 	}
 
-	if (m_indices.empty())
+	auto found = m_indexBuffers.find(key);
+	if (found != m_indexBuffers.end())
 	{
-		return;
+		return found->second;
 	}
 
-	DeleteBuffers();
+	BuildChunkIndices(lod, edgeLods, m_scratchIndices);
+	TerrainIndexBuffer& indexBuffer = m_indexBuffers[key];
+	unsigned int numBytes = static_cast<unsigned int>(m_scratchIndices.size() * sizeof(unsigned int));
+	indexBuffer.m_numIndices = static_cast<int>(m_scratchIndices.size());
+	indexBuffer.m_indexBuffer = g_theRenderer->CreateIndexBuffer(numBytes, sizeof(unsigned int));
+	g_theRenderer->CopyCPUToGPU(m_scratchIndices.data(), numBytes, indexBuffer.m_indexBuffer);
+	return indexBuffer;
+}
 
-	m_vertexBuffer = g_theRenderer->CreateVertexBuffer(static_cast<unsigned int>(m_vertices.size()) * sizeof(Vertex_PCUTBN), sizeof(Vertex_PCUTBN));
-	m_indexBuffer = g_theRenderer->CreateIndexBuffer(static_cast<unsigned int>(m_indices.size()) * sizeof(unsigned int), sizeof(unsigned int));
-	g_theRenderer->CopyCPUToGPU(m_vertices.data(), m_vertexBuffer->GetSize(), m_vertexBuffer);
-	g_theRenderer->CopyCPUToGPU(m_indices.data(), m_indexBuffer->GetSize(), m_indexBuffer);
+// Quads over the interior at the chunk's own step, then a strip along each edge that zips the
+// edge row, at the edge's step, onto the row just inside. The four strips meet on the diagonals,
+// so together they tile the ring between the interior and the chunk's outline exactly.
+void Terrain::BuildChunkIndices(int lod, int const edgeLods[4], std::vector<unsigned int>& outIndices)
+{
+	outIndices.clear();
+	int numCells = TERRAIN_CHUNK_CELLS >> lod;
+	int rowLength = numCells + 1;
+
+	// Counter-clockwise seen from above
+	auto addTriangle = [&outIndices, rowLength](int x0, int y0, int x1, int y1, int x2, int y2)
+	{
+		if ((x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0) < 0)
+		{
+			std::swap(x1, x2);
+			std::swap(y1, y2);
+		}
+		outIndices.push_back(static_cast<unsigned int>(y0 * rowLength + x0));
+		outIndices.push_back(static_cast<unsigned int>(y1 * rowLength + x1));
+		outIndices.push_back(static_cast<unsigned int>(y2 * rowLength + x2));
+	};
+
+	for (int gridY = 1; gridY < numCells - 1; ++gridY)
+	{
+		for (int gridX = 1; gridX < numCells - 1; ++gridX)
+		{
+			addTriangle(gridX, gridY, gridX + 1, gridY, gridX + 1, gridY + 1);
+			addTriangle(gridX, gridY, gridX + 1, gridY + 1, gridX, gridY + 1);
+		}
+	}
+
+	for (int edge = 0; edge < NUM_CHUNK_EDGES; ++edge)
+	{
+		int edgeStep = 1 << (edgeLods[edge] - lod);
+		int outerAlong = 0;
+		int innerAlong = 1;
+		while (outerAlong < numCells || innerAlong < numCells - 1)
+		{
+			int outerX, outerY, innerX, innerY, nextX, nextY;
+			GetEdgeGridPoint(edge, numCells, outerAlong, 0, outerX, outerY);
+			GetEdgeGridPoint(edge, numCells, innerAlong, 1, innerX, innerY);
+			bool isOuterNext = innerAlong >= numCells - 1 || (outerAlong < numCells && outerAlong + edgeStep <= innerAlong + 1);
+			if (isOuterNext)
+			{
+				outerAlong += edgeStep;
+				GetEdgeGridPoint(edge, numCells, outerAlong, 0, nextX, nextY);
+			}
+			else
+			{
+				++innerAlong;
+				GetEdgeGridPoint(edge, numCells, innerAlong, 1, nextX, nextY);
+			}
+			addTriangle(outerX, outerY, nextX, nextY, innerX, innerY);
+		}
+	}
 }
 
 void Terrain::DeleteBuffers()
 {
-	delete m_vertexBuffer;
-	m_vertexBuffer = nullptr;
-
-	delete m_indexBuffer;
-	m_indexBuffer = nullptr;
+	for (TerrainChunk& chunk : m_chunks)
+	{
+		delete chunk.m_vertexBuffer;
+		chunk.m_vertexBuffer = nullptr;
+	}
+	for (auto& indexBufferEntry : m_indexBuffers)
+	{
+		delete indexBufferEntry.second.m_indexBuffer;
+	}
+	m_indexBuffers.clear();
+	m_drawList.clear();
 }
 
-Rgba8 Terrain::GetColorForHeight(float height)
+Rgba8 Terrain::GetColorForHeight(float height) const
 {
 	float t = RangeMapClamped(height, m_minTerrainHeight, m_maxTerrainHeight, 0.f, 1.f);
 
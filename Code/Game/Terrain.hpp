@@ -1,47 +1,120 @@
 #pragma once
+#include "Game/TerrainGenerator.hpp"
 #include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 // -----------------------------------------------------------------------------
 class VertexBuffer;
 class IndexBuffer;
 class Shader;
 class Texture;
+class ViewFrustum;
+class ThreadPool;
 // -----------------------------------------------------------------------------
-constexpr int   TERRAIN_SIZE = 100;
+constexpr int   TERRAIN_SIZE = 100;		// Default samples per side; any size can be built
 constexpr float TERRAIN_SCALE = 1.f;
-constexpr float HEIGHT_SCALE = 27.5f;
 
-constexpr float NOISE_SCALE = 0.05f;
-constexpr int   NOISE_OCTAVES = 6;
-constexpr int   TERRAIN_SEED = 1337;
+// Chunks are a power of two cells across so every LOD step divides them
+constexpr int   TERRAIN_CHUNK_CELLS = 64;
+constexpr int   TERRAIN_CHUNK_BORDERED_SAMPLES = TERRAIN_CHUNK_CELLS + 3;	// A ring past each edge for normals
+constexpr int   TERRAIN_NUM_LODS = 6;					// Steps of 1 to 32 cells
+constexpr float TERRAIN_LOD0_DISTANCE = 96.f;			// Each level after covers twice the distance of the one before
+constexpr float TERRAIN_STREAM_RADIUS = 750.f;			// Matches the animal camera's far plane
+constexpr float TERRAIN_EVICT_MARGIN = 64.f;			// Hysteresis, so a chunk on the boundary isn't rebuilt every frame
+constexpr int   TERRAIN_CHUNK_MESHES_PER_FRAME = 4;
 // -----------------------------------------------------------------------------
+// A resident piece of the heightfield. Heights are kept at full resolution, bordered by one
+// sample each side; the mesh is built at one LOD and rebuilt when the chunk's LOD changes.
+struct TerrainChunk
+{
+	int   m_chunkX = 0;
+	int   m_chunkY = 0;
+	bool  m_isResident = false;
+	int   m_meshLod = -1;		// -1 until the first mesh is built
+	int   m_desiredLod = 0;
+	float m_distance = 0.f;
+	float m_minHeight = 0.f;
+	float m_maxHeight = 0.f;
+	std::vector<float> m_heights;
+	VertexBuffer* m_vertexBuffer = nullptr;
+};
+
+struct TerrainIndexBuffer
+{
+	IndexBuffer* m_indexBuffer = nullptr;
+	int m_numIndices = 0;
+};
+
+struct TerrainDraw
+{
+	VertexBuffer* m_vertexBuffer = nullptr;
+	IndexBuffer*  m_indexBuffer = nullptr;
+	int m_numIndices = 0;
+};
+// -----------------------------------------------------------------------------
+// Procedural heightfield split into square chunks. Chunks around the camera are generated and
+// meshed on demand, a few per frame nearest first, and evicted once they fall behind the stream
+// radius; the slots they occupy are fixed at construction, so memory is bounded by the radius
+// rather than the world size. Each chunk picks a geomipmap LOD from its distance. An edge
+// shared with a coarser chunk is stitched down to the coarser step, so both sides use the same
+// vertices and no cracks open. Heights outside resident chunks are evaluated directly.
 class Terrain
 {
 public:
 	Terrain() = default;
-	Terrain(Vec3 const& position);
+	Terrain(Vec3 const& position, int numSamplesPerSide = TERRAIN_SIZE, ThreadPool* threadPool = nullptr);
 	~Terrain();
 
 	void InitializeTerrainHills();
+	void Update(Vec3 const& cameraPosition, ViewFrustum const& frustum);
 	void Render() const;
 
 	float GetHeightAtXY(float x, float y) const;
 	bool  IsInBounds(int x, int y) const;
+	int   GetNumSamplesPerSide() const;
+	float GetWorldSize() const;
+	int   GetNumResidentChunks() const;
+	int   GetNumChunksDrawn() const;
+	size_t GetResidentBytes() const;
 	bool  m_areHillsInverted = false;
 
 private:
-	void GenerateHeightMap();
-	void GenerateMesh();
-	void CreateBuffers();
+	void  EstimateHeightRange();
+	int   GetChunkSlot(int chunkX, int chunkY) const;
+	float GetDistanceToChunk(Vec2 const& point, int chunkX, int chunkY) const;
+	int   GetLodForDistance(float distance) const;
+
+	void StreamChunks(Vec2 const& cameraXY);
+	void EvictChunk(int slot);
+	void GenerateChunkHeights(TerrainChunk& chunk);
+	void GenerateChunks(std::vector<int> const& slots);
+	void BuildChunkMesh(TerrainChunk& chunk, int lod);
+	void BuildDrawList(ViewFrustum const& frustum);
+	TerrainIndexBuffer const& GetOrCreateIndexBuffer(int lod, int const edgeLods[4]);
+	static void BuildChunkIndices(int lod, int const edgeLods[4], std::vector<unsigned int>& outIndices);
+
 	void DeleteBuffers();
-	Rgba8 GetColorForHeight(float height);
+	Rgba8 GetColorForHeight(float height) const;
 
 private:
 	// Terrain
-	std::vector<float> m_terrainHeights;
+	int   m_numSamplesPerSide = TERRAIN_SIZE;
+	int   m_numChunksPerSide = 1;
 	float m_minTerrainHeight = 0.f;
 	float m_maxTerrainHeight = 0.f;
 	Vec3  m_terrainWorldPosition = Vec3::ZERO;
+	TerrainGenerator m_generator;
+	ThreadPool* m_threadPool = nullptr;		// Chunk heights are generated across it when set
+
+	// Chunks, a fixed pool of slots and a slot index per chunk coordinate (-1 when not resident)
+	std::vector<TerrainChunk> m_chunks;
+	std::vector<int> m_freeChunkSlots;
+	std::vector<int> m_chunkSlotForCoords;
+	int m_streamRadiusInChunks = 1;
+	int m_numResidentChunks = 0;
 
 	// Lighting
 	Texture* m_texture = nullptr;
@@ -50,9 +123,11 @@ private:
 	float m_sunIntensity = 0.85f;
 	float m_ambientIntensity = 0.55f;
 
-	// Buffers
-	VertexBuffer* m_vertexBuffer = nullptr;
-	IndexBuffer* m_indexBuffer = nullptr;
-	std::vector<Vertex_PCUTBN> m_vertices;
-	std::vector<unsigned int> m_indices;
-};
\ No newline at end of file
+	// Buffers. Index buffers depend only on a chunk's LOD and its edges' LODs, so every chunk shares them
+	std::unordered_map<uint32_t, TerrainIndexBuffer> m_indexBuffers;
+	std::vector<TerrainDraw> m_drawList;
+	std::vector<Vertex_PCUTBN> m_scratchVertices;
+	std::vector<unsigned int> m_scratchIndices;
+	std::vector<std::pair<float, int>> m_scratchWork;	// Distance, then a slot to remesh or -(coordinate + 1) to load
+	std::vector<int> m_scratchSlotsToGenerate;
+};
@@ -0,0 +1,315 @@
+#include "Game/TerrainGenerator.hpp"
+#include "Game/GameCommon.h"
+#include "Game/ThreadPool.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(GAME_USE_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	constexpr float HILL_HEIGHT = 0.5f * HEIGHT_SCALE;
+
+	// Lattice coordinates are hashed as (x * PRIME_X) ^ (y * PRIME_Y) ^ seed, then mixed by one
+	// more multiply; the top two bits of the result pick one of four diagonal gradients
+	constexpr uint32_t NOISE_PRIME_X = 0x27D4EB2Du;
+	constexpr uint32_t NOISE_PRIME_Y = 0x165667B1u;
+	constexpr uint32_t NOISE_HASH_MULTIPLIER = 0x2C1B3C6Du;
+	constexpr uint32_t NOISE_SEED_MULTIPLIER = 0x9E3779B9u;
+	constexpr uint32_t SIGN_BIT = 0x80000000u;
+
+	float GetFade(float t)
+	{
+		return t * t * t * (t * (t * 6.f - 15.f) + 10.f);
+	}
+
+	float GetGradientDot(uint32_t hash, float offsetX, float offsetY)
+	{
+		float gradientX = (hash & SIGN_BIT) ? -offsetX : offsetX;
+		float gradientY = ((hash << 1) & SIGN_BIT) ? -offsetY : offsetY;
+		return gradientX + gradientY;
+	}
+
+#if defined(GAME_USE_SSE2)
+	// SSE2 has no 32-bit low multiply; the even lanes multiply directly and the odd ones shifted down
+	__m128i MultiplyLow(__m128i values, __m128i multiplier)
+	{
+		__m128i evenProducts = _mm_mul_epu32(values, multiplier);
+		__m128i oddProducts = _mm_mul_epu32(_mm_srli_epi64(values, 32), _mm_srli_epi64(multiplier, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(evenProducts, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(oddProducts, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	__m128 GetFades(__m128 t)
+	{
+		__m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.f)), _mm_set1_ps(15.f))), _mm_set1_ps(10.f));
+		return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+	}
+
+	__m128 GetGradientDots(__m128i hashes, __m128 offsetX, __m128 offsetY)
+	{
+		__m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(SIGN_BIT)));
+		__m128 gradientX = _mm_xor_ps(offsetX, _mm_and_ps(_mm_castsi128_ps(hashes), signMask));
+		__m128 gradientY = _mm_xor_ps(offsetY, _mm_and_ps(_mm_castsi128_ps(_mm_slli_epi32(hashes, 1)), signMask));
+		return _mm_add_ps(gradientX, gradientY);
+	}
+#endif
+}
+
+TerrainGenerator::TerrainGenerator(int numSamplesPerSide, bool areHillsInverted)
+	:m_numSamplesPerSide(numSamplesPerSide),
+	 m_hillSign(areHillsInverted ? -1.f : 1.f)
+{
+	float worldSize = static_cast<float>(numSamplesPerSide);
+	float const hillFractions[TERRAIN_NUM_HILLS][2] = { { 0.3f, 0.3f }, { 0.7f, 0.4f }, { 0.5f, 0.8f } };
+	for (int hillIndex = 0; hillIndex < TERRAIN_NUM_HILLS; ++hillIndex)
+	{
+		m_hillCenterX[hillIndex] = worldSize * hillFractions[hillIndex][0];
+		m_hillCenterY[hillIndex] = worldSize * hillFractions[hillIndex][1];
+	}
+	m_inverseHillRadius = 1.f / (worldSize * 0.3f);
+
+	// Amplitudes are normalized so the octaves together peak at NOISE_HEIGHT_SCALE
+	float totalAmplitude = 0.f;
+	float amplitude = 1.f;
+	float frequency = NOISE_SCALE;
+	for (int octave = 0; octave < NOISE_OCTAVES; ++octave)
+	{
+		m_octaveFrequencies[octave] = frequency;
+		m_octaveAmplitudes[octave] = amplitude;
+		m_octaveSeeds[octave] = static_cast<uint32_t>(TERRAIN_SEED + octave) * NOISE_SEED_MULTIPLIER;
+		totalAmplitude += amplitude;
+		amplitude *= NOISE_PERSISTENCE;
+		frequency *= NOISE_LACUNARITY;
+	}
+	for (int octave = 0; octave < NOISE_OCTAVES; ++octave)
+	{
+		m_octaveAmplitudes[octave] *= NOISE_HEIGHT_SCALE / totalAmplitude;
+	}
+}
+
+float TerrainGenerator::ComputeHeight(int sampleX, int sampleY) const
+{
+	TerrainRowTerms terms;
+	GetRowTerms(sampleY, terms);
+	return ComputeHeightInRow(sampleX, terms);
+}
+
+void TerrainGenerator::GenerateRow(int firstSampleX, int sampleY, int count, float* outHeights) const
+{
+	TerrainRowTerms terms;
+	GetRowTerms(sampleY, terms);
+	int sampleIndex = 0;
+
+#if defined(GAME_USE_SSE2)
+	__m128 const zeros = _mm_setzero_ps();
+	__m128 const ones = _mm_set1_ps(1.f);
+	__m128i const primeX = _mm_set1_epi32(static_cast<int>(NOISE_PRIME_X));
+	__m128i const hashMultiplier = _mm_set1_epi32(static_cast<int>(NOISE_HASH_MULTIPLIER));
+	for (; count - sampleIndex >= 4; sampleIndex += 4)
+	{
+		__m128 sampleX = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(firstSampleX + sampleIndex), _mm_setr_epi32(0, 1, 2, 3)));
+
+		__m128 hills = zeros;
+		for (int hillIndex = 0; hillIndex < TERRAIN_NUM_HILLS; ++hillIndex)
+		{
+			__m128 offsetX = _mm_mul_ps(_mm_sub_ps(sampleX, _mm_set1_ps(m_hillCenterX[hillIndex])), _mm_set1_ps(m_inverseHillRadius));
+			__m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(offsetX, offsetX), _mm_set1_ps(terms.m_hillOffsetYSquared[hillIndex])));
+			__m128 falloff = _mm_max_ps(_mm_sub_ps(ones, distance), zeros);
+			hills = _mm_add_ps(hills, _mm_mul_ps(_mm_mul_ps(falloff, falloff), _mm_set1_ps(m_hillSign)));
+		}
+
+		__m128 noise = zeros;
+		for (int octave = 0; octave < NOISE_OCTAVES; ++octave)
+		{
+			// Floor by truncating, then stepping down wherever truncation rounded up
+			__m128 latticeX = _mm_mul_ps(sampleX, _mm_set1_ps(m_octaveFrequencies[octave]));
+			__m128i cellX = _mm_cvttps_epi32(latticeX);
+			cellX = _mm_add_epi32(cellX, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(cellX), latticeX)));
+			__m128 fractionX = _mm_sub_ps(latticeX, _mm_cvtepi32_ps(cellX));
+			__m128 fractionXMinusOne = _mm_sub_ps(fractionX, ones);
+
+			__m128i hashX0 = MultiplyLow(cellX, primeX);
+			__m128i hashX1 = _mm_add_epi32(hashX0, primeX);
+			__m128i hashY0 = _mm_set1_epi32(static_cast<int>(terms.m_noiseHashY0[octave]));
+			__m128i hashY1 = _mm_set1_epi32(static_cast<int>(terms.m_noiseHashY1[octave]));
+			__m128 fractionY = _mm_set1_ps(terms.m_noiseFractionY[octave]);
+			__m128 fractionYMinusOne = _mm_sub_ps(fractionY, ones);
+
+			__m128 dot00 = GetGradientDots(MultiplyLow(_mm_xor_si128(hashX0, hashY0), hashMultiplier), fractionX, fractionY);
+			__m128 dot10 = GetGradientDots(MultiplyLow(_mm_xor_si128(hashX1, hashY0), hashMultiplier), fractionXMinusOne, fractionY);
+			__m128 dot01 = GetGradientDots(MultiplyLow(_mm_xor_si128(hashX0, hashY1), hashMultiplier), fractionX, fractionYMinusOne);
+			__m128 dot11 = GetGradientDots(MultiplyLow(_mm_xor_si128(hashX1, hashY1), hashMultiplier), fractionXMinusOne, fractionYMinusOne);
+
+			__m128 fadeX = GetFades(fractionX);
+			__m128 bottom = _mm_add_ps(dot00, _mm_mul_ps(_mm_sub_ps(dot10, dot00), fadeX));
+			__m128 top = _mm_add_ps(dot01, _mm_mul_ps(_mm_sub_ps(dot11, dot01), fadeX));
+			__m128 value = _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(top, bottom), _mm_set1_ps(terms.m_noiseFadeY[octave])));
+			noise = _mm_add_ps(noise, _mm_mul_ps(value, _mm_set1_ps(m_octaveAmplitudes[octave])));
+		}
+
+		_mm_storeu_ps(outHeights + sampleIndex, _mm_add_ps(_mm_mul_ps(hills, _mm_set1_ps(HILL_HEIGHT)), noise));
+	}
+#endif
+
+	for (; sampleIndex < count; ++sampleIndex)
+	{
+		outHeights[sampleIndex] = ComputeHeightInRow(firstSampleX + sampleIndex, terms);
+	}
+}
+
+void TerrainGenerator::GenerateTile(int firstSampleX, int firstSampleY, int width, int height, float* outHeights, int outStride) const
+{
+	for (int row = 0; row < height; ++row)
+	{
+		GenerateRow(firstSampleX, firstSampleY + row, width, outHeights + static_cast<size_t>(row) * outStride);
+	}
+}
+
+void TerrainGenerator::GenerateHeightMap(float* outHeights, ThreadPool* threadPool) const
+{
+	int numTilesPerSide = (m_numSamplesPerSide + TERRAIN_GENERATION_TILE_SIZE - 1) / TERRAIN_GENERATION_TILE_SIZE;
+	auto generateTiles = [this, outHeights, numTilesPerSide](int begin, int end)
+	{
+		for (int tileIndex = begin; tileIndex < end; ++tileIndex)
+		{
+			int firstSampleX = (tileIndex % numTilesPerSide) * TERRAIN_GENERATION_TILE_SIZE;
+			int firstSampleY = (tileIndex / numTilesPerSide) * TERRAIN_GENERATION_TILE_SIZE;
+			int width = std::min(TERRAIN_GENERATION_TILE_SIZE, m_numSamplesPerSide - firstSampleX);
+			int height = std::min(TERRAIN_GENERATION_TILE_SIZE, m_numSamplesPerSide - firstSampleY);
+			GenerateTile(firstSampleX, firstSampleY, width, height, outHeights + static_cast<size_t>(firstSampleY) * m_numSamplesPerSide + firstSampleX, m_numSamplesPerSide);
+		}
+	};
+
+	int numTiles = numTilesPerSide * numTilesPerSide;
+	if (threadPool != nullptr)
+	{
+		threadPool->ParallelFor(numTiles, 1, generateTiles);
+	}
+	else
+	{
+		generateTiles(0, numTiles);
+	}
+}
+
+void TerrainGenerator::GetRowTerms(int sampleY, TerrainRowTerms& outTerms) const
+{
+	float sampleYFloat = static_cast<float>(sampleY);
+	for (int hillIndex = 0; hillIndex < TERRAIN_NUM_HILLS; ++hillIndex)
+	{
+		float offsetY = (sampleYFloat - m_hillCenterY[hillIndex]) * m_inverseHillRadius;
+		outTerms.m_hillOffsetYSquared[hillIndex] = offsetY * offsetY;
+	}
+	for (int octave = 0; octave < NOISE_OCTAVES; ++octave)
+	{
+		float latticeY = sampleYFloat * m_octaveFrequencies[octave];
+		float cellY = floorf(latticeY);
+		uint32_t hashY0 = static_cast<uint32_t>(static_cast<int>(cellY)) * NOISE_PRIME_Y;
+		outTerms.m_noiseFractionY[octave] = latticeY - cellY;
+		outTerms.m_noiseFadeY[octave] = GetFade(latticeY - cellY);
+		outTerms.m_noiseHashY0[octave] = hashY0 ^ m_octaveSeeds[octave];
+		outTerms.m_noiseHashY1[octave] = (hashY0 + NOISE_PRIME_Y) ^ m_octaveSeeds[octave];
+	}
+}
+
+// Mirrors GenerateRow's vector arithmetic one lane at a time
+float TerrainGenerator::ComputeHeightInRow(int sampleX, TerrainRowTerms const& terms) const
+{
+	float sampleXFloat = static_cast<float>(sampleX);
+
+	float hills = 0.f;
+	for (int hillIndex = 0; hillIndex < TERRAIN_NUM_HILLS; ++hillIndex)
+	{
+		float offsetX = (sampleXFloat - m_hillCenterX[hillIndex]) * m_inverseHillRadius;
+		float distance = sqrtf(offsetX * offsetX + terms.m_hillOffsetYSquared[hillIndex]);
+		float falloff = std::max(1.f - distance, 0.f);
+		hills += falloff * falloff * m_hillSign;
+	}
+
+	float noise = 0.f;
+	for (int octave = 0; octave < NOISE_OCTAVES; ++octave)
+	{
+		float latticeX = sampleXFloat * m_octaveFrequencies[octave];
+		float cellX = floorf(latticeX);
+		float fractionX = latticeX - cellX;
+		float fractionY = terms.m_noiseFractionY[octave];
+
+		uint32_t hashX0 = static_cast<uint32_t>(static_cast<int>(cellX)) * NOISE_PRIME_X;
+		uint32_t hashX1 = hashX0 + NOISE_PRIME_X;
+		float dot00 = GetGradientDot((hashX0 ^ terms.m_noiseHashY0[octave]) * NOISE_HASH_MULTIPLIER, fractionX, fractionY);
+		float dot10 = GetGradientDot((hashX1 ^ terms.m_noiseHashY0[octave]) * NOISE_HASH_MULTIPLIER, fractionX - 1.f, fractionY);
+		float dot01 = GetGradientDot((hashX0 ^ terms.m_noiseHashY1[octave]) * NOISE_HASH_MULTIPLIER, fractionX, fractionY - 1.f);
+		float dot11 = GetGradientDot((hashX1 ^ terms.m_noiseHashY1[octave]) * NOISE_HASH_MULTIPLIER, fractionX - 1.f, fractionY - 1.f);
+
+		float fadeX = GetFade(fractionX);
+		float bottom = dot00 + (dot10 - dot00) * fadeX;
+		float top = dot01 + (dot11 - dot01) * fadeX;
+		float value = bottom + (top - bottom) * terms.m_noiseFadeY[octave];
+		noise += value * m_octaveAmplitudes[octave];
+	}
+
+	return hills * HILL_HEIGHT + noise;
+}
+
+// Whole heightmaps from min to max samples per side, doubling: one sample at a time, by rows on
+// this thread, then by tiles across a thread pool. The scalar pass also checks the rows match it.
+bool TerrainGenerator::Command_BenchmarkTerrainGeneration(EventArgs& args)
+{
+	int minSize = GetClamped(args.GetValue("min", 1024), 64, 16384);
+	int maxSize = GetClamped(args.GetValue("max", 8192), minSize, 16384);
+	bool isScalarTimed = args.GetValue("scalar", true);
+
+	ThreadPool threadPool;
+	std::vector<float> heights;
+	std::vector<float> scalarRow;
+	g_theDevConsole->AddLine(Rgba8::CYAN, Stringf("Terrain generation, hills + %d noise octaves, %d threads:", NOISE_OCTAVES, threadPool.GetNumThreads()));
+	for (int size = minSize; size <= maxSize; size *= 2)
+	{
+		TerrainGenerator generator(size, false);
+		heights.resize(static_cast<size_t>(size) * size);
+		double numMegaSamples = static_cast<double>(size) * size / 1000000.0;
+
+		double startTime = GetCurrentTimeSeconds();
+		generator.GenerateHeightMap(heights.data(), &threadPool);
+		double threadedMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+
+		startTime = GetCurrentTimeSeconds();
+		generator.GenerateHeightMap(heights.data(), nullptr);
+		double rowMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+
+		double scalarMilliseconds = 0.0;
+		int numMismatches = 0;
+		if (isScalarTimed)
+		{
+			scalarRow.resize(size);
+			startTime = GetCurrentTimeSeconds();
+			for (int sampleY = 0; sampleY < size; ++sampleY)
+			{
+				for (int sampleX = 0; sampleX < size; ++sampleX)
+				{
+					scalarRow[sampleX] = generator.ComputeHeight(sampleX, sampleY);
+				}
+				if (memcmp(scalarRow.data(), heights.data() + static_cast<size_t>(sampleY) * size, size * sizeof(float)) != 0)
+				{
+					++numMismatches;
+				}
+			}
+			scalarMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+		}
+
+		g_theDevConsole->AddLine(Rgba8::LIGHTYELLOW, Stringf("  %5d^2  scalar %9.1fms  rows %8.1fms  tiles %8.1fms  %7.1f Msamples/s", size,
+			scalarMilliseconds, rowMilliseconds, threadedMilliseconds, numMegaSamples * 1000.0 / threadedMilliseconds));
+		if (numMismatches > 0)
+		{
+			g_theDevConsole->AddLine(Rgba8::RED, Stringf("  %d rows differ from the scalar reference", numMismatches));
+		}
+	}
+	return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+#include <cstdint>
+// -----------------------------------------------------------------------------
+class ThreadPool;
+// -----------------------------------------------------------------------------
+constexpr int   TERRAIN_NUM_HILLS = 3;
+constexpr float HEIGHT_SCALE = 27.5f;
+
+constexpr float NOISE_SCALE = 0.05f;			// Lattice cells per sample at the first octave
+constexpr int   NOISE_OCTAVES = 6;
+constexpr int   TERRAIN_SEED = 1337;
+constexpr float NOISE_HEIGHT_SCALE = 3.f;		// Peak of the summed octaves, in world units
+constexpr float NOISE_PERSISTENCE = 0.5f;
+constexpr float NOISE_LACUNARITY = 2.f;
+constexpr int   TERRAIN_GENERATION_TILE_SIZE = 64;
+// -----------------------------------------------------------------------------
+// Everything about a sample that depends only on its row
+struct TerrainRowTerms
+{
+	float m_hillOffsetYSquared[TERRAIN_NUM_HILLS] = {};
+	float m_noiseFractionY[NOISE_OCTAVES] = {};
+	float m_noiseFadeY[NOISE_OCTAVES] = {};
+	uint32_t m_noiseHashY0[NOISE_OCTAVES] = {};		// Lattice row hashes, already mixed with the octave's seed
+	uint32_t m_noiseHashY1[NOISE_OCTAVES] = {};
+};
+// -----------------------------------------------------------------------------
+// The terrain's height function: three radial hills placed relative to the world size, plus
+// fractal gradient noise. Rows are generated four samples at a time with SSE2; everything that
+// depends only on the row (hill offsets, noise lattice rows and fades) is worked out once per row.
+// ComputeHeight is the scalar reference and does the same arithmetic in the same order, so single
+// samples agree with generated rows to the bit.
+class TerrainGenerator
+{
+public:
+	TerrainGenerator() = default;
+	TerrainGenerator(int numSamplesPerSide, bool areHillsInverted);
+
+	float ComputeHeight(int sampleX, int sampleY) const;
+	void  GenerateRow(int firstSampleX, int sampleY, int count, float* outHeights) const;
+	void  GenerateTile(int firstSampleX, int firstSampleY, int width, int height, float* outHeights, int outStride) const;
+
+	// Whole heightmap, split into square tiles across the pool; serial when the pool is null
+	void  GenerateHeightMap(float* outHeights, ThreadPool* threadPool) const;
+
+	static bool Command_BenchmarkTerrainGeneration(EventArgs& args);
+
+private:
+	void  GetRowTerms(int sampleY, TerrainRowTerms& outTerms) const;
+	float ComputeHeightInRow(int sampleX, TerrainRowTerms const& terms) const;
+
+private:
+	int   m_numSamplesPerSide = 2;
+	float m_hillCenterX[TERRAIN_NUM_HILLS] = {};
+	float m_hillCenterY[TERRAIN_NUM_HILLS] = {};
+	float m_inverseHillRadius = 1.f;
+	float m_hillSign = 1.f;
+	float m_octaveFrequencies[NOISE_OCTAVES] = {};
+	float m_octaveAmplitudes[NOISE_OCTAVES] = {};
+	uint32_t m_octaveSeeds[NOISE_OCTAVES] = {};
+};
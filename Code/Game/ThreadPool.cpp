@@ -0,0 +1,202 @@
+#include "Game/ThreadPool.hpp"
+#include "Engine/Math/MathUtils.h"
+
+static thread_local int s_threadIndex = 0;
+
+ThreadPool::ThreadPool(int numThreads)
+{
+	m_numThreads = numThreads > 0 ? numThreads : GetMaxNumThreads();
+	m_numThreads = GetClamped(m_numThreads, 1, GetMaxNumThreads());
+	m_shares = std::make_unique<WorkShare[]>(m_numThreads);
+
+	m_workers.reserve(m_numThreads - 1);
+	for (int threadIndex = 1; threadIndex < m_numThreads; ++threadIndex)
+	{
+		m_workers.emplace_back(&ThreadPool::WorkerMain, this, threadIndex);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+		m_isShuttingDown = true;
+	}
+	m_jobStarted.notify_all();
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::ParallelFor(int count, int grainSize, RangeFunction function, void* context)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+	grainSize = grainSize > 0 ? grainSize : 1;
+	if (m_isSerial || m_numThreads == 1 || count <= grainSize)
+	{
+		function(context, 0, count);
+		return;
+	}
+
+	// Contiguous shares keep neighbouring entities on one core unless someone has to steal
+	for (int threadIndex = 0; threadIndex < m_numThreads; ++threadIndex)
+	{
+		WorkShare& share = m_shares[threadIndex];
+		std::lock_guard<std::mutex> shareLock(share.m_mutex);
+		share.m_begin = static_cast<int>(static_cast<int64_t>(count) * threadIndex / m_numThreads);
+		share.m_end = static_cast<int>(static_cast<int64_t>(count) * (threadIndex + 1) / m_numThreads);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+		m_function = function;
+		m_context = context;
+		m_grainSize = grainSize;
+		m_numWorkersBusy = m_numThreads - 1;
+		++m_jobGeneration;
+	}
+	m_jobStarted.notify_all();
+
+	RunShares(0);
+
+	std::unique_lock<std::mutex> lock(m_jobMutex);
+	m_jobFinished.wait(lock, [this]() { return m_numWorkersBusy == 0; });
+}
+
+int ThreadPool::GetNumThreads() const
+{
+	return m_numThreads;
+}
+
+void ThreadPool::SetIsSerial(bool isSerial)
+{
+	m_isSerial = isSerial;
+}
+
+bool ThreadPool::IsSerial() const
+{
+	return m_isSerial;
+}
+
+int ThreadPool::GetThreadIndex()
+{
+	return s_threadIndex;
+}
+
+int ThreadPool::GetMaxNumThreads()
+{
+	static int const s_maxNumThreads = GetClamped(static_cast<int>(std::thread::hardware_concurrency()), 1, MAX_THREADS);
+	return s_maxNumThreads;
+}
+
+void ThreadPool::WorkerMain(int threadIndex)
+{
+	s_threadIndex = threadIndex;
+	uint64_t lastGeneration = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_jobMutex);
+			m_jobStarted.wait(lock, [&]() { return m_isShuttingDown || m_jobGeneration != lastGeneration; });
+			if (m_isShuttingDown)
+			{
+				return;
+			}
+			lastGeneration = m_jobGeneration;
+		}
+
+		RunShares(threadIndex);
+
+		bool isLastWorker = false;
+		{
+			std::lock_guard<std::mutex> lock(m_jobMutex);
+			isLastWorker = --m_numWorkersBusy == 0;
+		}
+		if (isLastWorker)
+		{
+			m_jobFinished.notify_one();
+		}
+	}
+}
+
+void ThreadPool::RunShares(int threadIndex)
+{
+	int begin = 0;
+	int end = 0;
+	do
+	{
+		while (TakeFromOwnShare(threadIndex, begin, end))
+		{
+			m_function(m_context, begin, end);
+		}
+	}
+	while (StealShare(threadIndex));
+}
+
+bool ThreadPool::TakeFromOwnShare(int threadIndex, int& outBegin, int& outEnd)
+{
+	WorkShare& share = m_shares[threadIndex];
+	std::lock_guard<std::mutex> shareLock(share.m_mutex);
+	if (share.m_begin >= share.m_end)
+	{
+		return false;
+	}
+	outBegin = share.m_begin;
+	outEnd = share.m_begin + m_grainSize < share.m_end ? share.m_begin + m_grainSize : share.m_end;
+	share.m_begin = outEnd;
+	return true;
+}
+
+// Takes the back half of the victim with the most left, so the victim keeps working the front
+bool ThreadPool::StealShare(int threadIndex)
+{
+	for (;;)
+	{
+		int victimIndex = -1;
+		int mostRemaining = 0;
+		for (int otherIndex = 0; otherIndex < m_numThreads; ++otherIndex)
+		{
+			if (otherIndex == threadIndex)
+			{
+				continue;
+			}
+			WorkShare& other = m_shares[otherIndex];
+			std::lock_guard<std::mutex> otherLock(other.m_mutex);
+			int remaining = other.m_end - other.m_begin;
+			if (remaining > mostRemaining)
+			{
+				mostRemaining = remaining;
+				victimIndex = otherIndex;
+			}
+		}
+		if (victimIndex < 0)
+		{
+			return false;
+		}
+
+		int stolenBegin = 0;
+		int stolenEnd = 0;
+		{
+			WorkShare& victim = m_shares[victimIndex];
+			std::lock_guard<std::mutex> victimLock(victim.m_mutex);
+			int remaining = victim.m_end - victim.m_begin;
+			if (remaining <= 0)
+			{
+				continue;
+			}
+			stolenEnd = victim.m_end;
+			stolenBegin = victim.m_end - (remaining + 1) / 2;
+			victim.m_end = stolenBegin;
+		}
+
+		WorkShare& share = m_shares[threadIndex];
+		std::lock_guard<std::mutex> shareLock(share.m_mutex);
+		share.m_begin = stolenBegin;
+		share.m_end = stolenEnd;
+		return true;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// -----------------------------------------------------------------------------
+// Persistent workers for data-parallel loops. ParallelFor hands every thread, the caller
+// included, one contiguous share of the range; a thread eats its share from the front a
+// grain at a time and, once it runs dry, steals the back half of the fullest share left.
+// Nothing is queued or allocated per call, so the loop costs a wake-up and a few locks.
+// Only one ParallelFor runs at a time, issued from the thread that owns the pool.
+class ThreadPool
+{
+public:
+	static constexpr int MAX_THREADS = 64;
+	using RangeFunction = void (*)(void* context, int begin, int end);
+
+	explicit ThreadPool(int numThreads = 0);	// 0 = hardware concurrency, the caller counts as one
+	ThreadPool(ThreadPool const&) = delete;
+	ThreadPool& operator=(ThreadPool const&) = delete;
+	~ThreadPool();
+
+	void ParallelFor(int count, int grainSize, RangeFunction function, void* context);
+	template <typename Function>
+	void ParallelFor(int count, int grainSize, Function const& function);
+
+	int GetNumThreads() const;
+	void SetIsSerial(bool isSerial);
+	bool IsSerial() const;
+
+	// 0 on any thread that is not a pool worker; indexes per-thread scratch such as working skeletons
+	static int GetThreadIndex();
+	static int GetMaxNumThreads();
+
+private:
+	struct alignas(64) WorkShare
+	{
+		std::mutex m_mutex;
+		int m_begin = 0;
+		int m_end = 0;
+	};
+
+	void WorkerMain(int threadIndex);
+	void RunShares(int threadIndex);
+	bool TakeFromOwnShare(int threadIndex, int& outBegin, int& outEnd);
+	bool StealShare(int threadIndex);
+
+private:
+	std::vector<std::thread> m_workers;
+	std::unique_ptr<WorkShare[]> m_shares;
+	int m_numThreads = 1;
+	bool m_isSerial = false;
+
+	std::mutex m_jobMutex;
+	std::condition_variable m_jobStarted;
+	std::condition_variable m_jobFinished;
+	uint64_t m_jobGeneration = 0;
+	int  m_numWorkersBusy = 0;
+	bool m_isShuttingDown = false;
+
+	RangeFunction m_function = nullptr;
+	void* m_context = nullptr;
+	int m_grainSize = 1;
+};
+// -----------------------------------------------------------------------------
+template <typename Function>
+void ThreadPool::ParallelFor(int count, int grainSize, Function const& function)
+{
+	RangeFunction callRange = [](void* context, int begin, int end)
+	{
+		(*static_cast<Function const*>(context))(begin, end);
+	};
+	ParallelFor(count, grainSize, callRange, const_cast<Function*>(&function));
+}
@@ -0,0 +1,194 @@
+#include "Game/TimerWheel.hpp"
+#include <cmath>
+
+TimerWheel::TimerWheel()
+{
+	for (int& slotHead : m_slotHeads)
+	{
+		slotHead = -1;
+	}
+}
+
+void TimerWheel::Reserve(int numTimers)
+{
+	m_timers.reserve(numTimers);
+}
+
+// Fires on the first tick at or after now + delaySeconds, and never on the tick it was scheduled in
+TimerHandle TimerWheel::Schedule(float delaySeconds, TimerCallback callback, void* context, int payload)
+{
+	int timerIndex = m_freeHead;
+	if (timerIndex >= 0)
+	{
+		m_freeHead = m_timers[timerIndex].m_next;
+	}
+	else
+	{
+		timerIndex = static_cast<int>(m_timers.size());
+		m_timers.emplace_back();
+	}
+
+	float delayTicks = ceilf((m_accumulatedSeconds + delaySeconds) / TIMER_WHEEL_TICK_SECONDS);
+	uint64_t ticksFromNow = delayTicks < 1.f ? 1 : static_cast<uint64_t>(delayTicks);
+
+	Timer& timer = m_timers[timerIndex];
+	timer.m_expiryTick = m_currentTick + ticksFromNow;
+	timer.m_callback = callback;
+	timer.m_context = context;
+	timer.m_payload = payload;
+	InsertTimer(timerIndex);
+	++m_numPendingTimers;
+
+	TimerHandle handle;
+	handle.m_index = timerIndex;
+	handle.m_generation = timer.m_generation;
+	return handle;
+}
+
+void TimerWheel::Cancel(TimerHandle& handle)
+{
+	if (IsPending(handle))
+	{
+		UnlinkTimer(handle.m_index);
+		FreeTimer(handle.m_index);
+	}
+	handle = TimerHandle();
+}
+
+bool TimerWheel::IsPending(TimerHandle const& handle) const
+{
+	if (handle.m_index < 0 || handle.m_index >= static_cast<int>(m_timers.size()))
+	{
+		return false;
+	}
+	Timer const& timer = m_timers[handle.m_index];
+	return timer.m_slot >= 0 && timer.m_generation == handle.m_generation;
+}
+
+void TimerWheel::Advance(float deltaSeconds)
+{
+	m_numFiredLastAdvance = 0;
+	m_accumulatedSeconds += deltaSeconds;
+	while (m_accumulatedSeconds >= TIMER_WHEEL_TICK_SECONDS)
+	{
+		m_accumulatedSeconds -= TIMER_WHEEL_TICK_SECONDS;
+		++m_currentTick;
+
+		// Highest level first, so a cascade that lands in a lower slot due this tick is cascaded again
+		for (int level = TIMER_WHEEL_LEVELS - 1; level > 0; --level)
+		{
+			uint64_t lowerTicksMask = (uint64_t(1) << (level * TIMER_WHEEL_SLOT_BITS)) - 1;
+			if ((m_currentTick & lowerTicksMask) == 0)
+			{
+				CascadeSlot(level, static_cast<int>((m_currentTick >> (level * TIMER_WHEEL_SLOT_BITS)) & (TIMER_WHEEL_SLOTS - 1)));
+			}
+		}
+		FireSlot(static_cast<int>(m_currentTick & (TIMER_WHEEL_SLOTS - 1)));
+	}
+}
+
+double TimerWheel::GetCurrentTime() const
+{
+	return static_cast<double>(m_currentTick) * TIMER_WHEEL_TICK_SECONDS + m_accumulatedSeconds;
+}
+
+int TimerWheel::GetNumPendingTimers() const
+{
+	return m_numPendingTimers;
+}
+
+int TimerWheel::GetNumFiredLastAdvance() const
+{
+	return m_numFiredLastAdvance;
+}
+
+// A timer goes in the lowest level whose span covers its remaining delay. Delays past the top
+// level's span park in its farthest slot and are re-filed each time that slot cascades.
+void TimerWheel::InsertTimer(int timerIndex)
+{
+	Timer& timer = m_timers[timerIndex];
+	uint64_t ticksFromNow = timer.m_expiryTick - m_currentTick;
+	int level = 0;
+	while (level < TIMER_WHEEL_LEVELS - 1 && ticksFromNow >= (uint64_t(1) << ((level + 1) * TIMER_WHEEL_SLOT_BITS)))
+	{
+		++level;
+	}
+
+	uint64_t slotTick = timer.m_expiryTick;
+	uint64_t maxTicksFromNow = (uint64_t(1) << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1;
+	if (ticksFromNow > maxTicksFromNow)
+	{
+		slotTick = m_currentTick + maxTicksFromNow;
+	}
+	int slot = static_cast<int>((slotTick >> (level * TIMER_WHEEL_SLOT_BITS)) & (TIMER_WHEEL_SLOTS - 1));
+
+	timer.m_slot = level * TIMER_WHEEL_SLOTS + slot;
+	timer.m_prev = -1;
+	timer.m_next = m_slotHeads[timer.m_slot];
+	if (timer.m_next >= 0)
+	{
+		m_timers[timer.m_next].m_prev = timerIndex;
+	}
+	m_slotHeads[timer.m_slot] = timerIndex;
+}
+
+void TimerWheel::UnlinkTimer(int timerIndex)
+{
+	Timer& timer = m_timers[timerIndex];
+	if (timer.m_prev >= 0)
+	{
+		m_timers[timer.m_prev].m_next = timer.m_next;
+	}
+	else
+	{
+		m_slotHeads[timer.m_slot] = timer.m_next;
+	}
+	if (timer.m_next >= 0)
+	{
+		m_timers[timer.m_next].m_prev = timer.m_prev;
+	}
+	timer.m_slot = -1;
+	timer.m_prev = -1;
+	timer.m_next = -1;
+}
+
+void TimerWheel::FreeTimer(int timerIndex)
+{
+	Timer& timer = m_timers[timerIndex];
+	++timer.m_generation;
+	timer.m_callback = nullptr;
+	timer.m_context = nullptr;
+	timer.m_next = m_freeHead;
+	m_freeHead = timerIndex;
+	--m_numPendingTimers;
+}
+
+void TimerWheel::CascadeSlot(int level, int slot)
+{
+	int slotIndex = level * TIMER_WHEEL_SLOTS + slot;
+	while (m_slotHeads[slotIndex] >= 0)
+	{
+		int timerIndex = m_slotHeads[slotIndex];
+		UnlinkTimer(timerIndex);
+		InsertTimer(timerIndex);
+	}
+}
+
+// Timers are taken off one at a time so a callback can cancel or schedule others safely.
+// Anything scheduled from a callback is at least a tick out and lands in a different slot.
+void TimerWheel::FireSlot(int slot)
+{
+	while (m_slotHeads[slot] >= 0)
+	{
+		int timerIndex = m_slotHeads[slot];
+		Timer const& timer = m_timers[timerIndex];
+		TimerCallback callback = timer.m_callback;
+		void* context = timer.m_context;
+		int payload = timer.m_payload;
+		UnlinkTimer(timerIndex);
+		FreeTimer(timerIndex);
+
+		++m_numFiredLastAdvance;
+		callback(context, payload);
+	}
+}
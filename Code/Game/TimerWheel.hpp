@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+// -----------------------------------------------------------------------------
+constexpr int	TIMER_WHEEL_SLOT_BITS = 6;
+constexpr int	TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_SLOT_BITS;
+constexpr int	TIMER_WHEEL_LEVELS = 4;							// 64^4 ticks, about 73 hours
+constexpr float TIMER_WHEEL_TICK_SECONDS = 1.f / 64.f;
+
+typedef void (*TimerCallback)(void* context, int payload);
+
+// Stays safe to hold after the timer fires or is cancelled; the generation no longer matches
+struct TimerHandle
+{
+	int		 m_index = -1;
+	uint32_t m_generation = 0;
+};
+// -----------------------------------------------------------------------------
+// Hierarchical timing wheel: level 0 has one slot per tick, and each higher level has one slot
+// per full turn of the level below. Scheduling and cancelling are O(1). A tick touches only the
+// timers due in its slot, plus whatever a higher-level slot cascades down when the level below wraps.
+// Timers live in one array with index links, so scheduling never allocates once it has grown.
+class TimerWheel
+{
+public:
+	TimerWheel();
+
+	void Reserve(int numTimers);
+	TimerHandle Schedule(float delaySeconds, TimerCallback callback, void* context, int payload = 0);
+	void Cancel(TimerHandle& handle);
+	bool IsPending(TimerHandle const& handle) const;
+	void Advance(float deltaSeconds);
+
+	double GetCurrentTime() const;
+	int GetNumPendingTimers() const;
+	int GetNumFiredLastAdvance() const;
+
+private:
+	struct Timer
+	{
+		uint64_t	  m_expiryTick = 0;
+		TimerCallback m_callback = nullptr;
+		void*		  m_context = nullptr;
+		int			  m_payload = 0;
+		int			  m_slot = -1;				// level * TIMER_WHEEL_SLOTS + slot, -1 when free
+		int			  m_prev = -1;
+		int			  m_next = -1;
+		uint32_t	  m_generation = 0;
+	};
+
+	void InsertTimer(int timerIndex);
+	void UnlinkTimer(int timerIndex);
+	void FreeTimer(int timerIndex);
+	void CascadeSlot(int level, int slot);
+	void FireSlot(int slot);
+
+private:
+	std::vector<Timer> m_timers;
+	int		 m_slotHeads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+	int		 m_freeHead = -1;
+	uint64_t m_currentTick = 0;
+	float	 m_accumulatedSeconds = 0.f;
+	int		 m_numPendingTimers = 0;
+	int		 m_numFiredLastAdvance = 0;
+};
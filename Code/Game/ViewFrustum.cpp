@@ -0,0 +1,45 @@
+#include "Game/ViewFrustum.hpp"
+#include "Engine/Math/MathUtils.h"
+#include <cmath>
+
+void ViewFrustum::SetFromCamera(Vec3 const& position, Vec3 const& forward, Vec3 const& left, Vec3 const& up, float verticalFovDegrees, float aspect, float nearPlane, float farPlane)
+{
+	float halfVerticalRadians = ConvertDegreesToRadians(verticalFovDegrees * 0.5f);
+	float halfHorizontalRadians = atanf(aspect * tanf(halfVerticalRadians));
+	float sinVertical = sinf(halfVerticalRadians);
+	float cosVertical = cosf(halfVerticalRadians);
+	float sinHorizontal = sinf(halfHorizontalRadians);
+	float cosHorizontal = cosf(halfHorizontalRadians);
+
+	// Side planes pass through the camera; each normal leans in from the edge of the view
+	Vec3 const sideNormals[4] =
+	{
+		forward * sinVertical - up * cosVertical,
+		forward * sinVertical + up * cosVertical,
+		forward * sinHorizontal - left * cosHorizontal,
+		forward * sinHorizontal + left * cosHorizontal,
+	};
+	for (int sideIndex = 0; sideIndex < 4; ++sideIndex)
+	{
+		m_planes[sideIndex].m_normal = sideNormals[sideIndex];
+		m_planes[sideIndex].m_distance = DotProduct3D(sideNormals[sideIndex], position);
+	}
+
+	float forwardDistance = DotProduct3D(forward, position);
+	m_planes[4].m_normal = forward;
+	m_planes[4].m_distance = forwardDistance + nearPlane;
+	m_planes[5].m_normal = -forward;
+	m_planes[5].m_distance = -(forwardDistance + farPlane);
+}
+
+bool ViewFrustum::IsSphereVisible(Vec3 const& center, float radius) const
+{
+	for (FrustumPlane const& plane : m_planes)
+	{
+		if (DotProduct3D(plane.m_normal, center) - plane.m_distance < -radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Engine/Math/Vec3.h"
+// -----------------------------------------------------------------------------
+// Inward-facing plane: a point is inside when DotProduct3D(m_normal, point) >= m_distance
+struct FrustumPlane
+{
+	Vec3  m_normal = Vec3::XAXE;
+	float m_distance = 0.f;
+};
+// -----------------------------------------------------------------------------
+// Six planes of a symmetric perspective view, used to skip mesh work for what is off screen.
+// The sphere test is conservative: a sphere near a frustum corner may pass without being seen.
+class ViewFrustum
+{
+public:
+	static constexpr int NUM_PLANES = 6;
+
+	void SetFromCamera(Vec3 const& position, Vec3 const& forward, Vec3 const& left, Vec3 const& up, float verticalFovDegrees, float aspect, float nearPlane, float farPlane);
+	bool IsSphereVisible(Vec3 const& center, float radius) const;
+
+private:
+	FrustumPlane m_planes[NUM_PLANES];
+};
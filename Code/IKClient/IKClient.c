@@ -0,0 +1,194 @@
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <string.h>
+#include "IKClient.h"
+
+#define IKCLIENT_SPINS_PER_TIME_CHECK 1024
+
+//-----------------------------------------------------------------------------------------------
+int IKClient_Connect(IKClient* client, char const* mappingName)
+{
+	client->m_mappingHandle = NULL;
+	client->m_header = NULL;
+
+	HANDLE mappingHandle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mappingName ? mappingName : IKSERVER_MAPPING_NAME);
+	if (mappingHandle == NULL)
+	{
+		return -1;
+	}
+
+	IKServerHeader* header = (IKServerHeader*)MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(IKServerHeader));
+	if (header == NULL)
+	{
+		CloseHandle(mappingHandle);
+		return -2;
+	}
+
+	if (header->m_magic != IKSERVER_MAGIC || header->m_version != IKSERVER_VERSION || header->m_slotCount != IKSERVER_SLOT_COUNT ||
+		header->m_maxBatch != IKSERVER_MAX_BATCH || header->m_jointCount != IKSERVER_JOINT_COUNT)
+	{
+		UnmapViewOfFile(header);
+		CloseHandle(mappingHandle);
+		return -3;
+	}
+
+	client->m_mappingHandle = mappingHandle;
+	client->m_header = header;
+	return 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+void IKClient_Disconnect(IKClient* client)
+{
+	if (client->m_header != NULL)
+	{
+		UnmapViewOfFile(client->m_header);
+		client->m_header = NULL;
+	}
+	if (client->m_mappingHandle != NULL)
+	{
+		CloseHandle((HANDLE)client->m_mappingHandle);
+		client->m_mappingHandle = NULL;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void IKClient_RequestServerStop(IKClient* client)
+{
+	InterlockedCompareExchange(&client->m_header->m_serverState, IKSERVER_STATE_STOP_REQUESTED, IKSERVER_STATE_RUNNING);
+}
+
+//-----------------------------------------------------------------------------------------------
+int IKClient_BeginBatch(IKClient* client, IKClientBatch* outBatch, uint32_t timeoutMilliseconds)
+{
+	long ticket = InterlockedIncrement(&client->m_header->m_nextTicket) - 1;
+	long skippedSequence = (long)((unsigned long)ticket + IKSERVER_SLOT_COUNT);
+	IKServerSlot* slot = &client->m_header->m_slots[(unsigned long)ticket % IKSERVER_SLOT_COUNT];
+
+	// Wait for the previous lap's owner to release the slot. Giving up leaves the ticket unsubmitted,
+	// which the server skips once its deadline passes.
+	ULONGLONG startTicks = GetTickCount64();
+	int spinCount = 0;
+	while (slot->m_sequence != ticket)
+	{
+		YieldProcessor();
+		if (++spinCount < IKCLIENT_SPINS_PER_TIME_CHECK)
+		{
+			continue;
+		}
+		spinCount = 0;
+		if (client->m_header->m_serverState != IKSERVER_STATE_RUNNING)
+		{
+			return -1;
+		}
+		if (slot->m_sequence == skippedSequence)
+		{
+			return -3;
+		}
+		if (timeoutMilliseconds > 0 && GetTickCount64() - startTicks > timeoutMilliseconds)
+		{
+			return -2;
+		}
+	}
+
+	outBatch->m_slot = slot;
+	outBatch->m_ticket = ticket;
+	return 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+int IKClient_SubmitBatch(IKClientBatch* batch, uint32_t targetCount, uint32_t requestFlags, uint32_t maxIterations, float threshold)
+{
+	IKServerSlot* slot = batch->m_slot;
+	long ticket = batch->m_ticket;
+	slot->m_targetCount = (targetCount > IKSERVER_MAX_BATCH) ? IKSERVER_MAX_BATCH : targetCount;
+	slot->m_requestFlags = requestFlags;
+	slot->m_maxIterations = maxIterations;
+	slot->m_threshold = threshold;
+	if (InterlockedCompareExchange(&slot->m_sequence, (long)((unsigned long)ticket + 1), ticket) != ticket)
+	{
+		batch->m_slot = NULL;
+		return -3;
+	}
+	return 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+int IKClient_WaitForResults(IKClient* client, IKClientBatch* batch, uint32_t timeoutMilliseconds)
+{
+	long doneSequence = (long)((unsigned long)batch->m_ticket + 2);
+	ULONGLONG startTicks = GetTickCount64();
+	int spinCount = 0;
+	while (batch->m_slot->m_sequence != doneSequence)
+	{
+		YieldProcessor();
+		if (++spinCount < IKCLIENT_SPINS_PER_TIME_CHECK)
+		{
+			continue;
+		}
+		spinCount = 0;
+		if (client->m_header->m_serverState != IKSERVER_STATE_RUNNING)
+		{
+			return -1;
+		}
+		if (timeoutMilliseconds > 0 && GetTickCount64() - startTicks > timeoutMilliseconds)
+		{
+			return -2;
+		}
+	}
+	return 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+void IKClient_EndBatch(IKClientBatch* batch)
+{
+	// Fails harmlessly if the server already moved the slot on after this client overran the deadline
+	long ticket = batch->m_ticket;
+	InterlockedCompareExchange(&batch->m_slot->m_sequence, (long)((unsigned long)ticket + IKSERVER_SLOT_COUNT), (long)((unsigned long)ticket + 2));
+	batch->m_slot = NULL;
+}
+
+//-----------------------------------------------------------------------------------------------
+void IKClient_AbandonBatch(IKClientBatch* batch)
+{
+	long ticket = batch->m_ticket;
+	InterlockedExchange(&batch->m_slot->m_abandonedTicket, ticket);
+
+	// If the results are already in the server will not look again, so release the slot here
+	InterlockedCompareExchange(&batch->m_slot->m_sequence, (long)((unsigned long)ticket + IKSERVER_SLOT_COUNT), (long)((unsigned long)ticket + 2));
+	batch->m_slot = NULL;
+}
+
+//-----------------------------------------------------------------------------------------------
+int IKClient_SolveBatch(IKClient* client, IKServerTarget const* targets, uint32_t targetCount, uint32_t requestFlags, IKServerJointResult* outResults)
+{
+	if (targetCount > IKSERVER_MAX_BATCH)
+	{
+		return -4;
+	}
+
+	IKClientBatch batch;
+	int error = IKClient_BeginBatch(client, &batch, 1000);
+	if (error != 0)
+	{
+		return error;
+	}
+
+	memcpy(batch.m_slot->m_targets, targets, targetCount * sizeof(IKServerTarget));
+	error = IKClient_SubmitBatch(&batch, targetCount, requestFlags, 0, 0.f);
+	if (error != 0)
+	{
+		return error;
+	}
+
+	error = IKClient_WaitForResults(client, &batch, 1000);
+	if (error != 0)
+	{
+		IKClient_AbandonBatch(&batch);
+		return error;
+	}
+
+	memcpy(outResults, batch.m_slot->m_results, targetCount * sizeof(IKServerJointResult));
+	IKClient_EndBatch(&batch);
+	return 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+// Minimal C client for the IKSims headless solve server (IKSims.exe -ikserver).
+// Requests are written straight into the server's shared memory and results are read back in place.
+#include "Game/IKSolveServerProtocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// -----------------------------------------------------------------------------
+typedef struct IKClient
+{
+	void*			m_mappingHandle;
+	IKServerHeader* m_header;
+} IKClient;
+// -----------------------------------------------------------------------------
+// A batch in flight; m_slot points into shared memory
+typedef struct IKClientBatch
+{
+	IKServerSlot* m_slot;
+	long		  m_ticket;
+} IKClientBatch;
+// -----------------------------------------------------------------------------
+// Returns 0 on success
+int  IKClient_Connect(IKClient* client, char const* mappingName);
+void IKClient_Disconnect(IKClient* client);
+void IKClient_RequestServerStop(IKClient* client);
+
+// Zero copy path: Begin, fill batch.m_slot->m_targets, Submit, Wait, read batch.m_slot->m_results, End.
+// Begin returns -2 if the slot isn't free within timeoutMilliseconds (0 = no limit) and -3 if the
+// server skipped the ticket; either way there is nothing to end. Targets must be submitted within
+// IKSERVER_TICKET_DEADLINE_MS of Begin, and Submit returns -3 if the server already skipped them.
+int  IKClient_BeginBatch(IKClient* client, IKClientBatch* outBatch, uint32_t timeoutMilliseconds);
+int  IKClient_SubmitBatch(IKClientBatch* batch, uint32_t targetCount, uint32_t requestFlags, uint32_t maxIterations, float threshold);
+int  IKClient_WaitForResults(IKClient* client, IKClientBatch* batch, uint32_t timeoutMilliseconds);
+void IKClient_EndBatch(IKClientBatch* batch);
+
+// Call instead of End once Submit has been called but Wait failed; the slot is released for the
+// next lap whenever the server gets to it, and the results must not be read
+void IKClient_AbandonBatch(IKClientBatch* batch);
+
+// Copying convenience wrapper around the calls above; returns 0 on success
+int  IKClient_SolveBatch(IKClient* client, IKServerTarget const* targets, uint32_t targetCount, uint32_t requestFlags, IKServerJointResult* outResults);
+// -----------------------------------------------------------------------------
+#ifdef __cplusplus
+}
+#endif
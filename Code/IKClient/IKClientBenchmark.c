@@ -0,0 +1,144 @@
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "IKClient.h"
+
+// Round trip latency against a running "IKSims.exe -ikserver".
+// Usage: IKClientBenchmark [-solve] [-constrained] [-rounds N] [-stop]
+//   default measures transport only (IKSERVER_FLAG_NO_SOLVE); -solve includes the CCD solve itself
+
+#define BENCHMARK_WARMUP_ROUNDS 200
+
+//-----------------------------------------------------------------------------------------------
+static int CompareDoubles(void const* a, void const* b)
+{
+	double lhs = *(double const*)a;
+	double rhs = *(double const*)b;
+	return (lhs > rhs) - (lhs < rhs);
+}
+
+//-----------------------------------------------------------------------------------------------
+static void FillTargets(IKServerTarget* targets, uint32_t count, uint32_t round)
+{
+	for (uint32_t targetIndex = 0; targetIndex < count; ++targetIndex)
+	{
+		// Walk a ring in front of the arm so consecutive solves differ
+		float angle = 0.01f * (float)(round * count + targetIndex);
+		targets[targetIndex].m_position[0] = 4.f + cosf(angle);
+		targets[targetIndex].m_position[1] = sinf(angle) * 2.f;
+		targets[targetIndex].m_position[2] = 3.f + sinf(angle * 0.5f);
+		targets[targetIndex].m_userData = targetIndex;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	uint32_t requestFlags = IKSERVER_FLAG_NO_SOLVE;
+	int roundCount = 5000;
+	int shouldStopServer = 0;
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		if (strcmp(argv[argIndex], "-solve") == 0)
+		{
+			requestFlags &= ~IKSERVER_FLAG_NO_SOLVE;
+		}
+		else if (strcmp(argv[argIndex], "-constrained") == 0)
+		{
+			requestFlags |= IKSERVER_FLAG_CONSTRAINED;
+		}
+		else if (strcmp(argv[argIndex], "-rounds") == 0 && argIndex + 1 < argc)
+		{
+			roundCount = atoi(argv[++argIndex]);
+		}
+		else if (strcmp(argv[argIndex], "-stop") == 0)
+		{
+			shouldStopServer = 1;
+		}
+	}
+	if (roundCount < 1)
+	{
+		roundCount = 1;
+	}
+
+	IKClient client;
+	int error = IKClient_Connect(&client, IKSERVER_MAPPING_NAME);
+	if (error != 0)
+	{
+		printf("Could not connect to %s (error %d). Is \"IKSims.exe -ikserver\" running?\n", IKSERVER_MAPPING_NAME, error);
+		return 1;
+	}
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	double microsecondsPerTick = 1000000.0 / (double)frequency.QuadPart;
+
+	double* samples = (double*)malloc(sizeof(double) * (size_t)roundCount);
+	IKServerTarget* targets = (IKServerTarget*)malloc(sizeof(IKServerTarget) * IKSERVER_MAX_BATCH);
+	printf("%s round trips, %d rounds per batch size\n", (requestFlags & IKSERVER_FLAG_NO_SOLVE) ? "Transport only" : "Solve", roundCount);
+	printf("  batch      min us      p50 us      p99 us      max us   us/target\n");
+
+	for (uint32_t batchSize = 1; batchSize <= IKSERVER_MAX_BATCH && error == 0; batchSize *= 2)
+	{
+		for (int round = -BENCHMARK_WARMUP_ROUNDS; round < roundCount; ++round)
+		{
+			FillTargets(targets, batchSize, (uint32_t)(round + BENCHMARK_WARMUP_ROUNDS));
+
+			// Timed region covers the whole client side of the handshake, including writing targets into the slot
+			LARGE_INTEGER startTicks;
+			LARGE_INTEGER endTicks;
+			QueryPerformanceCounter(&startTicks);
+
+			IKClientBatch batch;
+			error = IKClient_BeginBatch(&client, &batch, 5000);
+			if (error != 0)
+			{
+				break;
+			}
+			memcpy(batch.m_slot->m_targets, targets, batchSize * sizeof(IKServerTarget));
+			error = IKClient_SubmitBatch(&batch, batchSize, requestFlags, 0, 0.f);
+			if (error != 0)
+			{
+				break;
+			}
+			error = IKClient_WaitForResults(&client, &batch, 5000);
+			if (error != 0)
+			{
+				IKClient_AbandonBatch(&batch);
+				break;
+			}
+			volatile uint32_t lastUserData = batch.m_slot->m_results[batchSize - 1].m_userData;
+			(void)lastUserData;
+			IKClient_EndBatch(&batch);
+
+			QueryPerformanceCounter(&endTicks);
+			if (round >= 0)
+			{
+				samples[round] = (double)(endTicks.QuadPart - startTicks.QuadPart) * microsecondsPerTick;
+			}
+		}
+		if (error != 0)
+		{
+			printf("Batch %u failed (error %d)\n", batchSize, error);
+			break;
+		}
+
+		qsort(samples, (size_t)roundCount, sizeof(double), CompareDoubles);
+		double p50 = samples[roundCount / 2];
+		double p99 = samples[(roundCount * 99) / 100];
+		printf("  %5u  %10.2f  %10.2f  %10.2f  %10.2f  %10.3f\n", batchSize, samples[0], p50, p99, samples[roundCount - 1], p50 / (double)batchSize);
+	}
+
+	if (shouldStopServer)
+	{
+		IKClient_RequestServerStop(&client);
+	}
+
+	free(targets);
+	free(samples);
+	IKClient_Disconnect(&client);
+	return error == 0 ? 0 : 1;
+}